@@ -0,0 +1,22 @@
+/**
+ *@file FPGA_TMR1_reroute.bin.h
+ *
+ *@brief
+ *  - FPGA configuration routing TMR1 to the board, for fpga_programmer:
+ *      fpga_programmer((unsigned char *)FPGA_TMR1_reroute_bin,
+ *                      BLOB_SIZE(FPGA_TMR1_reroute_bin));
+ *  - the bitstream is common/res/FPGA_TMR1_reroute.bin, linked by the
+ *    project's FPGA_TMR1_reroute_bin.S
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef FPGA_TMR1_REROUTE_BIN_H
+#define FPGA_TMR1_REROUTE_BIN_H
+
+#include <blob.h>
+
+BLOB_DECLARE(FPGA_TMR1_reroute_bin);
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ *@file blob.h
+ *
+ *@brief
+ *  - binary resources (audio clips, FPGA bitstreams) linked as they are,
+ *    without C hex arrays: nothing to compile, nothing to parse or copy
+ *  - a resource is placed by an assembler source (*.S) with one line
+ *      #include <blob.h>
+ *      BLOB(snd_samples, "snd_sample.raw")
+ *    which includes the file (.incbin, found through -Wa,-I<dir>) into
+ *    .rodata, aligned to BLOB_ALIGN, between the symbols
+ *      snd_samples      first byte
+ *      snd_samples_end  one past the last byte
+ *  - C sources declare it with BLOB_DECLARE(snd_samples) and read it
+ *    through BLOB_SIZE, BLOB_AS and BLOB_COUNT
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: bfin-elf-gcc (GNU as)
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _BLOB_H_
+#define _BLOB_H_
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def BLOB_ALIGN
+ * @brief alignment of every resource in bytes (32 bit DMA and loads)
+ */
+#define BLOB_ALIGN          4
+
+#ifdef __ASSEMBLER__
+
+#ifndef __USER_LABEL_PREFIX__
+#define __USER_LABEL_PREFIX__
+#endif
+
+/* C name -> assembler name (bfin-elf prefixes '_') */
+#define BLOB_CAT2(a, b)     a ## b
+#define BLOB_CAT(a, b)      BLOB_CAT2(a, b)
+#define BLOB_SYM(name)      BLOB_CAT(__USER_LABEL_PREFIX__, name)
+
+/**
+ * @def BLOB(name, file)
+ * @brief place file in .rodata between name and name_end
+ */
+#define BLOB(name, file)                                \
+    .section .rodata;                                   \
+    .balign BLOB_ALIGN;                                 \
+    .global BLOB_SYM(name);                             \
+    .global BLOB_SYM(name ## _end);                     \
+BLOB_SYM(name):                                         \
+    .incbin file;                                       \
+BLOB_SYM(name ## _end):                                 \
+    .previous
+
+#else
+
+/**
+ * @def BLOB_DECLARE(name)
+ * @brief declare a resource placed with BLOB(name, file)
+ */
+#define BLOB_DECLARE(name) \
+    extern const unsigned char name[]; \
+    extern const unsigned char name ## _end[]
+
+/**
+ * @def BLOB_SIZE(name)
+ * @brief size of a resource in bytes
+ */
+#define BLOB_SIZE(name)     ((unsigned int)(name ## _end - name))
+
+/**
+ * @def BLOB_AS(name, type)
+ * @brief resource as an array of type (at most BLOB_ALIGN aligned)
+ */
+#define BLOB_AS(name, type) ((const type *)(const void *)(name))
+
+/**
+ * @def BLOB_COUNT(name, type)
+ * @brief number of whole elements of type in a resource
+ */
+#define BLOB_COUNT(name, type) (BLOB_SIZE(name) / sizeof(type))
+
+#endif /* __ASSEMBLER__ */
+
+#endif
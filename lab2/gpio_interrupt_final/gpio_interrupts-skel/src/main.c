@@ -55,7 +55,7 @@ int main( int argc, char *argv[] )
 	/* FPGA setup function to configure FPGA, make sure the FPGA configuration
 	   binary data is loaded in to SDRAM at "FPGA_DATA_START_ADDR" */
 	ret = fpga_setup(); //returns 0 if successful and -1 if failed
-	//ret = fpga_programmer((unsigned char*) FPGA_TMR1_reroute_bin, sizeof(FPGA_TMR1_reroute_bin));
+	//ret = fpga_programmer((unsigned char*) FPGA_TMR1_reroute_bin, BLOB_SIZE(FPGA_TMR1_reroute_bin));
 	if (ret) {
 		printf("\r\n FPGA Setup Failed");
 		return -1;
@@ -41,7 +41,7 @@ int main(void) {
 	/* FPGA setup function to configure FPGA, make sure the FPGA configuration
 	 binary data is loaded in to SDRAM at "FPGA_DATA_START_ADDR" */
 	status = fpga_setup(); //returns 0 if successful and -1 if failed
-	//status = fpga_programmer((unsigned char*) FPGA_TMR1_reroute_bin, sizeof(FPGA_TMR1_reroute_bin));
+	//status = fpga_programmer((unsigned char*) FPGA_TMR1_reroute_bin, BLOB_SIZE(FPGA_TMR1_reroute_bin));
 	if (status) {
 		printf("\r\n FPGA Setup Failed");
 		return -1;
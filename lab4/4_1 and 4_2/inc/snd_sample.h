@@ -25,6 +25,7 @@
 #define _SND_SAMPLE_H_
 
 #include "ssm2602.h"
+#include <blob.h>
 
 #if AUDIO_DIGITAL_LOOPBACK_FEATURE == ENABLED
 
@@ -33,7 +34,7 @@
 extern char rxbuffer[RXBUFFER_SIZE];
 #endif /* AUDIO_DIGITAL_LOOPBACK_FEATURE */
 
-extern unsigned int  snd_samples_nBytes;
-extern unsigned char snd_samples[] ;
+/* 16 bit little endian samples, BLOB_ALIGN aligned */
+BLOB_DECLARE(snd_samples);
 
 #endif
@@ -263,7 +263,7 @@ void audioPlayer_run(audioPlayer_t *pThis)
     	if(!(realcount % 2))
     		count+=2;
 
-    	if(count > snd_samples_nBytes)
+    	if(count > BLOB_SIZE(snd_samples))
     		count = 0;
 
     	//printf("Count: %d\n", realcount);
@@ -21,14 +21,25 @@
 
 #include <isrDisp.h>
 #include <ssm2602.h>
+#include <resampler.h>
 
+/**
+ * @def AUDIOPLAYER_BLOCK
+ * @brief samples per half of the TX ping-pong buffer
+ */
+#define AUDIOPLAYER_BLOCK (512)
 
 /** audioPlayer object
  */
 typedef struct {
   isrDisp_t      	isrDisp; /* dispatcher for Rx Tx ISR */
   int 					volume;	/* Volume of the audio player */
-  eSsm2602SampleFreq 	frequency;	/* Frequency of the audio player */
+  eSsm2602SampleFreq 	frequency;	/* Frequency of the codec, fixed */
+  resampler_t           resampler;  /* playback rate -> codec rate */
+  volatile int          rateReq;    /* playback rate index requested by the push buttons */
+  int                   rate;       /* playback rate index in use */
+  int                   readPos;    /* next sample of snd_samples */
+  fract16               txBuff[2][AUDIOPLAYER_BLOCK]; /* DMA ping-pong halves */
 } audioPlayer_t;
 
 /** initialize audio player 
@@ -47,12 +47,27 @@
  */
 #define VOLUME_MIN (0x7F)
 
-#define FREQ_MAX (SSM2602_SR_96000)
+/**
+ * @def CODEC_FREQ
+ * @brief The codec runs at a fixed rate, playback rate changes are
+ * done by the resampler
+ */
+#define CODEC_FREQ (SSM2602_SR_48000)
+#define CODEC_RATE (48000)
+
+/**
+ * @def RATE_DEFAULT
+ * @brief index of the native rate of snd_samples (16kHz)
+ */
+#define RATE_DEFAULT (1)
+#define RATE_NUM (sizeof(audioPlayer_rates)/sizeof(audioPlayer_rates[0]))
 
-#define FREQ_MIN 0
+/* playback rates selectable by the push buttons, same steps as the codec */
+static const unsigned int audioPlayer_rates[] = {
+	8000, 16000, 22050, 32000, 44100, 48000, 88200, 96000
+};
 
 int current_volume = 0;
-int current_freq = 0;
 
 /**********************************************************************
 *              Private functions
@@ -106,11 +121,9 @@ void audioPlayer_volumeDecrease(void *_pArg)
 
 /** audioPlayer_freqIncrease.
  *
- * @brief This function configures the frequency on the codec using i2c. This
- * function calls i2c methods to change the frequency of the audio codec
- *
- * Pre-conditions:
- *  - initialized I2C interface
+ * @brief This function requests the next higher playback rate. The codec
+ * keeps running at CODEC_RATE, the main loop redesigns the resampler
+ * (too slow for the push button ISR)
  *
  * Post condtions:
  * Increase frequency
@@ -121,19 +134,16 @@ void audioPlayer_volumeDecrease(void *_pArg)
  */
 void audioPlayer_freqIncrease(void *_pArg)
 {
-    /* Insert your code here */
-	if(current_freq < FREQ_MAX)
-		current_freq += 1;
-	ssm2602_setSamplingFeq(SSM2602_MAIN_OUT, current_freq);
+	audioPlayer_t *pThis = (audioPlayer_t *)_pArg;
+
+	if(pThis->rateReq < RATE_NUM - 1)
+		pThis->rateReq += 1;
 }
 
 /** audioPlayer_freqDecrease.
  *
- * @brief This function configures the frequency on the codec using i2c. This
- * function calls i2c methods to change the frequency of the audio codec
- *
- * Pre-conditions:
- *  - initialized I2C interface
+ * @brief This function requests the next lower playback rate, see
+ * audioPlayer_freqIncrease
  *
  * Post condtions:
  * Decrease frequency
@@ -144,11 +154,49 @@ void audioPlayer_freqIncrease(void *_pArg)
  */
 void audioPlayer_freqDecrease(void *_pArg)
 {
-    /* Insert your code here */
-	if(current_freq > FREQ_MIN)
-			current_freq -= 1;
-	ssm2602_setSamplingFeq(SSM2602_MAIN_OUT, current_freq);
+	audioPlayer_t *pThis = (audioPlayer_t *)_pArg;
 
+	if(pThis->rateReq > 0)
+		pThis->rateReq -= 1;
+}
+
+/** audioPlayer_fill.
+ *
+ * @brief Fill one half of the TX buffer with snd_samples converted from
+ * the playback rate to the codec rate, the samples repeat at the end
+ *
+ * Parameters:
+ * @param pThis  Contains the audioPlayer object.
+ * @param pOut   half of the TX buffer
+ *
+ */
+static void audioPlayer_fill(audioPlayer_t *pThis, fract16 *pOut)
+{
+	fract16 in[AUDIOPLAYER_BLOCK];
+	const fract16 *pPcm = BLOB_AS(snd_samples, fract16);
+	int nSamples = BLOB_COUNT(snd_samples, fract16);
+	int filled = 0;
+
+	while (filled < AUDIOPLAYER_BLOCK) {
+		/* about the input needed for the rest of the half */
+		int length = (AUDIOPLAYER_BLOCK - filled) * pThis->resampler.down / pThis->resampler.up + 1;
+		int i;
+
+		if (length > AUDIOPLAYER_BLOCK)
+			length = AUDIOPLAYER_BLOCK;
+		if (length > nSamples - pThis->readPos)
+			length = nSamples - pThis->readPos;
+
+		/* snd_samples is linked aligned, 16bit little endian */
+		for (i = 0; i < length; i++) {
+			in[i] = pPcm[pThis->readPos + i];
+		}
+		filled += resampler_process(&pThis->resampler, in, &length,
+		                            &pOut[filled], AUDIOPLAYER_BLOCK - filled);
+		pThis->readPos += length;
+		if (pThis->readPos >= nSamples)
+			pThis->readPos = 0;
+	}
 }
 
 
@@ -166,7 +214,16 @@ int audioPlayer_init(audioPlayer_t *pThis)
     
     pThis->volume 		= VOLUME_MIN; /*default volume */
     current_volume = pThis->volume;
-    pThis->frequency 	= SSM2602_SR_16000; /* default frequency */
+    pThis->frequency 	= CODEC_FREQ; /* codec rate, fixed */
+    pThis->rate         = RATE_DEFAULT;
+    pThis->rateReq      = RATE_DEFAULT;
+    pThis->readPos      = 0;
+
+    /* snd_samples play at their native rate until a push button is pressed */
+    status = resampler_init(&pThis->resampler, audioPlayer_rates[pThis->rate], CODEC_RATE, RESAMPLER_TAPS);
+    if ( PASS != status ) {
+        return FAIL;
+    }
 
     /* Initialize the core internal timer for generating delays */
     coreTimer_init();
@@ -202,7 +259,7 @@ int audioPlayer_init(audioPlayer_t *pThis)
         return FAIL;
     }
     /* frequency increase function will be called when the pushbutton 1 go high, the audioPlayer object is sent as an argument */
-    status = extio_callbackRegister(EXTIO_PB0_HIGH , audioPlayer_freqDecrease, &pThis);
+    status = extio_callbackRegister(EXTIO_PB0_HIGH , audioPlayer_freqDecrease, pThis);
     if ( PASS != status) {
 	    return FAIL;
     }
@@ -213,7 +270,7 @@ int audioPlayer_init(audioPlayer_t *pThis)
 		return FAIL;
 	}
     /* frequency decrease function will be called when the pushbutton 3 go high, the audioPlayer object is sent as an argument */
-	status = extio_callbackRegister(EXTIO_PB1_HIGH , audioPlayer_freqIncrease, &pThis);
+	status = extio_callbackRegister(EXTIO_PB1_HIGH , audioPlayer_freqIncrease, pThis);
 	if ( PASS != status) {
 		return FAIL;
 	}
@@ -252,8 +309,8 @@ int audioPlayer_start(audioPlayer_t *pThis)
  **/
 void audioPlayer_run(audioPlayer_t *pThis)
 {
-    int                         status                  = FAIL;
-    int                         count                   = 64000;
+    int                         half                    = 0;
+    int                         playing;
 
     printf("[AP]: run \n");
 
@@ -265,17 +322,33 @@ void audioPlayer_run(audioPlayer_t *pThis)
     *pDMA4_CONFIG = DMAEN | WDSIZE_16 | FLOW_STOP;	// enable DMA;
 */
 
-    // Auto-buffer mode
-    *pDMA4_START_ADDR = snd_samples;
-    *pDMA4_X_COUNT = count;
+    // Auto-buffer mode, ping-pong: two rows of AUDIOPLAYER_BLOCK samples
+    audioPlayer_fill(pThis, pThis->txBuff[0]);
+    audioPlayer_fill(pThis, pThis->txBuff[1]);
+    *pDMA4_START_ADDR = pThis->txBuff;
+    *pDMA4_X_COUNT = AUDIOPLAYER_BLOCK;
     *pDMA4_X_MODIFY = 2;
-    *pDMA4_CONFIG = DMAEN | WDSIZE_16 | FLOW_AUTO;	// enable DMA;
+    *pDMA4_Y_COUNT = 2;
+    *pDMA4_Y_MODIFY = 2;
+    *pDMA4_CONFIG = DMAEN | WDSIZE_16 | DMA2D | FLOW_AUTO;	// enable DMA;
 
     //ssm2602_txDma(snd_samples, count);
     //*pDMA4_CONFIG |= DMAEN;
 
     while(1) {
-    	asm("idle;");
+    	/* rate change from the push buttons: new phases, the stream continues */
+    	if (pThis->rateReq != pThis->rate) {
+    		pThis->rate = pThis->rateReq;
+    		resampler_setRate(&pThis->resampler, audioPlayer_rates[pThis->rate], CODEC_RATE);
+    		printf("[AP]: playback rate %u Hz\n", audioPlayer_rates[pThis->rate]);
+    	}
+
+    	/* Y count runs 2, 1: refill the half the DMA just left */
+    	playing = (2 == *pDMA4_CURR_Y_COUNT) ? 0 : 1;
+    	if (playing != half) {
+    		audioPlayer_fill(pThis, pThis->txBuff[half]);
+    		half = playing;
+    	}
     }
 
 }
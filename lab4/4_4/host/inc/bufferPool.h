@@ -0,0 +1,66 @@
+/**
+ *@file bufferPool.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the board library buffer pool,
+ *    counts the chunks in use
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _BUFFER_POOL_H_
+#define _BUFFER_POOL_H_
+
+#include <chunk.h>
+
+/**
+ * @def BUFFERPOOL_CHUNKS
+ * @brief chunks in the pool
+ */
+#define BUFFERPOOL_CHUNKS   (16)
+
+/** buffer pool object
+ */
+typedef struct {
+  chunk_t       chunk[BUFFERPOOL_CHUNKS];
+  int           used[BUFFERPOOL_CHUNKS];
+  int           inUse;      /* chunks handed out */
+  int           inUseMax;   /* most chunks handed out at once */
+} bufferPool_t;
+
+/** Initialize the pool, all chunks free
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int bufferPool_init(bufferPool_t *pThis);
+
+/** Take a free chunk
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param ppChunk  the chunk
+ *
+ * @return Zero on success, FAIL if the pool is empty
+ */
+int bufferPool_acquire(bufferPool_t *pThis, chunk_t **ppChunk);
+
+/** Return a chunk
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk taken from this pool
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int bufferPool_release(bufferPool_t *pThis, chunk_t *pChunk);
+
+#endif
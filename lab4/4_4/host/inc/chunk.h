@@ -0,0 +1,35 @@
+/**
+ *@file chunk.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the board library chunk, the
+ *    fields lab4 uses
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _CHUNK_H_
+#define _CHUNK_H_
+
+/**
+ * @def CHUNK_BYTES
+ * @brief bytes of data in a chunk
+ */
+#define CHUNK_BYTES         (1024*2)
+
+/** chunk object
+ */
+typedef struct {
+  union {
+    unsigned char       u08_buff[CHUNK_BYTES];
+    unsigned short      u16_buff[CHUNK_BYTES/2];
+  };
+  int           bytesMax;   /* size of the buffer */
+  int           bytesUsed;  /* valid bytes */
+} chunk_t;
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ *@file cycle_count.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the VisualDSP++ cycle counting macros
+ *  - uses the time stamp counter on x86, the monotonic clock elsewhere
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _CYCLE_COUNT_H
+#define _CYCLE_COUNT_H
+
+#include <stdio.h>
+
+/** cycle counter value */
+typedef volatile unsigned long long cycle_t;
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define _GET_CYCLE_COUNT(_cur)  (_cur) = __rdtsc()
+#else
+#include <time.h>
+#define _GET_CYCLE_COUNT(_cur)                                   \
+    do {                                                         \
+        struct timespec _ts;                                     \
+        clock_gettime(CLOCK_MONOTONIC, &_ts);                    \
+        (_cur) = (unsigned long long)_ts.tv_sec * 1000000000ULL  \
+                 + (unsigned long long)_ts.tv_nsec;              \
+    } while (0)
+#endif
+
+#define START_CYCLE_COUNT(_start)       _GET_CYCLE_COUNT(_start)
+
+#define STOP_CYCLE_COUNT(_cycles, _start)                        \
+    do {                                                         \
+        _GET_CYCLE_COUNT(_cycles);                               \
+        (_cycles) -= (_start);                                   \
+    } while (0)
+
+#define PRINT_CYCLES(_str, _cycles) \
+    printf("%s%llu\n", (_str), (unsigned long long)(_cycles))
+
+#endif
@@ -0,0 +1,19 @@
+/**
+ *@file cycle_count_bf.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement, see cycle_count.h
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _CYCLE_COUNT_BF_H
+#define _CYCLE_COUNT_BF_H
+
+#include <cycle_count.h>
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ *@file isrDisp.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the interrupt dispatcher, the
+ *    check calls the consumer side itself
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _ISR_DISP_H_
+#define _ISR_DISP_H_
+
+/** dispatcher object, nothing to dispatch on the host */
+typedef struct {
+  int           unused;
+} isrDisp_t;
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ *@file power_mode.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the power mode control
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _POWER_MODE_H_
+#define _POWER_MODE_H_
+
+/** power modes (no effect on the host) */
+typedef enum {
+    PWR_FULL_ON,
+    PWR_ACTIVE,
+    PWR_SLEEP
+} powerMode_t;
+
+/** change the power mode, no-op on the host */
+#define powerMode_change(mode)  ((void)(mode))
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ *@file queue.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the board library queue, only
+ *    what audioRx uses
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+/**
+ * @def QUEUE_DEPTH_MAX
+ * @brief largest queue depth
+ */
+#define QUEUE_DEPTH_MAX     (16)
+
+/** queue of pointers
+ */
+typedef struct {
+  void          *pElem[QUEUE_DEPTH_MAX];
+  int           depth;      /* capacity */
+  int           count;      /* elements in the queue */
+  int           first;      /* oldest element */
+} queue_t;
+
+/** Initialize an empty queue
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param depth  capacity, at most QUEUE_DEPTH_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int queue_init(queue_t *pThis, int depth);
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ *@file tll_common.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the TLL6527 common definitions
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _TLL_COMMON_H_
+#define _TLL_COMMON_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** return value for success */
+#define PASS    (0)
+/** return value for failure */
+#define FAIL    (-1)
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ *@file tll_config.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement, no board configuration
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _TLL_CONFIG_H_
+#define _TLL_CONFIG_H_
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ *@file tll_sport.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement, no SPORT
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _TLL_SPORT_H_
+#define _TLL_SPORT_H_
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ *@file boardStubs.c
+ *
+ *@brief
+ *  - host (x86 Linux) stand-ins for the board library parts audioRx
+ *    uses (queue, buffer pool); the pool counts its chunks in use so
+ *    the check can tell what a build really takes
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "queue.h"
+#include "bufferPool.h"
+
+
+/** Initialize an empty queue
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param depth  capacity, at most QUEUE_DEPTH_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int queue_init(queue_t *pThis, int depth)
+{
+    if ( NULL == pThis || depth <= 0 || depth > QUEUE_DEPTH_MAX ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->depth = depth;
+    return PASS;
+}
+
+/** Initialize the pool, all chunks free
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int bufferPool_init(bufferPool_t *pThis)
+{
+    int         i;
+
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    for ( i = 0; i < BUFFERPOOL_CHUNKS; i++ ) {
+        pThis->chunk[i].bytesMax = CHUNK_BYTES;
+    }
+    return PASS;
+}
+
+/** Take a free chunk
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param ppChunk  the chunk
+ *
+ * @return Zero on success, FAIL if the pool is empty
+ */
+int bufferPool_acquire(bufferPool_t *pThis, chunk_t **ppChunk)
+{
+    int         i;
+
+    for ( i = 0; i < BUFFERPOOL_CHUNKS; i++ ) {
+        if ( 0 == pThis->used[i] ) {
+            pThis->used[i] = 1;
+            pThis->chunk[i].bytesUsed = 0;
+            pThis->inUse++;
+            if ( pThis->inUse > pThis->inUseMax ) {
+                pThis->inUseMax = pThis->inUse;
+            }
+            *ppChunk = &pThis->chunk[i];
+            return PASS;
+        }
+    }
+    return FAIL;
+}
+
+/** Return a chunk
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk taken from this pool
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int bufferPool_release(bufferPool_t *pThis, chunk_t *pChunk)
+{
+    int         i = pChunk - &pThis->chunk[0];
+
+    if ( i < 0 || i >= BUFFERPOOL_CHUNKS || 0 == pThis->used[i] ) {
+        printf("[POOL]: release of a foreign or free chunk\r\n");
+        return FAIL;
+    }
+    pThis->used[i] = 0;
+    pThis->inUse--;
+    return PASS;
+}
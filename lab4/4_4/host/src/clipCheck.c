@@ -0,0 +1,257 @@
+/**
+ *@file clipCheck.c
+ *
+ *@brief
+ *  - host (x86 Linux) check of the audioRx clip paths, built once per
+ *    clip (see Makefile):
+ *    - clip_check:      ADPCM clip decoded into pool chunks (default build)
+ *    - clip_check_pcm:  PCM clip handed out in place (make CLIP=pcm)
+ *  - audioRx_get is called as the main loop does; the views are kept in
+ *    a FIFO as deep as the TX queue plus the DMA in flight and "played"
+ *    (copied out, released) from its oldest end, like the TX ISR would
+ *  - the played audio is compared bit exact against the reference (block
+ *    wise decode of the clip, or the raw PCM file) and the chunks the
+ *    pool handed out are counted
+ *
+ *  Only the buffer handling is checked here. DMA, SPORT and the codec
+ *  are not simulated; playback on the board is untested.
+ *
+ * Usage: clip_check [raw file]
+ *   raw file  16 bit PCM of the clip (default ../../../common/res/snd_sample.raw)
+ *
+ * Target:   x86 Linux host check
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <math.h>
+#include "tll_common.h"
+#include "audioRx.h"
+#include "audioTx.h"
+#include "bufferPool.h"
+#include "isrDisp.h"
+
+/**
+ * @def CLIPCHECK_RAW
+ * @brief default path of the PCM clip
+ */
+#define CLIPCHECK_RAW       "../../../common/res/snd_sample.raw"
+
+/**
+ * @def CLIPCHECK_LOOPS
+ * @brief times the clip is played, > 1 so the wrap to the start is checked
+ */
+#define CLIPCHECK_LOOPS     (3)
+
+/**
+ * @def CLIPCHECK_OUTSTANDING
+ * @brief views held at once: the TX queue plus the chunk the DMA plays
+ */
+#define CLIPCHECK_OUTSTANDING (AUDIOTX_QUEUE_DEPTH + 1)
+
+/**
+ * @def CLIPCHECK_SNR_MIN
+ * @brief lowest ADPCM SNR against the PCM clip in dB
+ */
+#define CLIPCHECK_SNR_MIN   (25.0)
+
+extern const adpcmClip_t snd_clip;
+
+/** read the raw clip
+ *
+ * Parameters:
+ * @param pName     file name
+ * @param pSamples  samples in the file
+ *
+ * @return samples (malloc'd), NULL on failure
+ */
+static short *clipCheck_readRaw(const char *pName, unsigned int *pSamples)
+{
+    FILE        *pFile = fopen(pName, "rb");
+    short       *pRaw;
+    long        bytes;
+
+    if ( NULL == pFile ) {
+        printf("[CHECK]: cannot open %s\r\n", pName);
+        return NULL;
+    }
+    fseek(pFile, 0, SEEK_END);
+    bytes = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pRaw = malloc(bytes);
+    if ( NULL == pRaw || fread(pRaw, 1, bytes, pFile) != (size_t)bytes ) {
+        printf("[CHECK]: cannot read %s\r\n", pName);
+        free(pRaw);
+        fclose(pFile);
+        return NULL;
+    }
+    fclose(pFile);
+    *pSamples = bytes / 2;
+    return pRaw;
+}
+
+/** reference of the played audio
+ *    - PCM clip: the raw file itself
+ *    - ADPCM clip: each block decoded on its own
+ *
+ * Parameters:
+ * @param pRaw      PCM clip
+ * @param samples   samples of the clip
+ *
+ * @return samples (malloc'd), NULL on failure
+ */
+static short *clipCheck_reference(const short *pRaw, unsigned int samples)
+{
+    short       *pRef = malloc(samples * sizeof(short));
+#ifndef AUDIOSAMPLE_PCM
+    adpcm_t     dec;
+    unsigned int block;
+    unsigned int count = 0;
+#endif
+
+    if ( NULL == pRef ) {
+        return NULL;
+    }
+#ifdef AUDIOSAMPLE_PCM
+    memcpy(pRef, pRaw, samples * sizeof(short));
+#else
+    for ( block = 0; block < snd_clip.blocks && count < samples; block++ ) {
+        int n = ADPCM_BLOCK_SAMPLES;
+
+        if ( count + n > samples ) {
+            n = samples - count;
+        }
+        adpcm_start(&dec, &snd_clip.pData[block * ADPCM_BLOCK_BYTES]);
+        count += adpcm_decode(&dec, &pRef[count], n);
+    }
+#endif
+    return pRef;
+}
+
+/** play a view: compare it with the reference, release it
+ *
+ * Parameters:
+ * @param pRef      view to play
+ * @param pExp      reference clip
+ * @param samples   samples of the clip
+ * @param pPos      position in the clip, advanced
+ * @param pBuffP    buffer pool
+ *
+ * @return samples that differ
+ */
+static unsigned long clipCheck_play(chunkRef_t *pRef, const short *pExp,
+                                    unsigned int samples, unsigned int *pPos,
+                                    bufferPool_t *pBuffP)
+{
+    const short *pData = (const short *)pRef->pData;
+    int         n = pRef->bytesUsed / 2;
+    int         i;
+    unsigned long diff = 0;
+
+    for ( i = 0; i < n; i++ ) {
+        if ( pData[i] != pExp[*pPos] ) {
+            diff++;
+        }
+        *pPos = (*pPos + 1) % samples;
+    }
+    chunkRef_release(pRef, pBuffP);
+    return diff;
+}
+
+/** check the clip path of this build
+ *
+ * @return PASS or FAIL
+ */
+int main(int argc, char *argv[])
+{
+    static audioRx_t    rx;
+    static bufferPool_t buffP;
+    isrDisp_t           isrDisp;
+    chunkRef_t          *pFifo[CLIPCHECK_OUTSTANDING];
+    int                 fifoCount = 0;
+    const char          *pName = argc > 1 ? argv[1] : CLIPCHECK_RAW;
+    unsigned int        samples;
+    unsigned int        pos = 0;
+    unsigned long long  played = 0;
+    unsigned long       diff = 0;
+    double              sig = 0.0;
+    double              err = 0.0;
+    double              snr;
+    short               *pRaw;
+    short               *pExp;
+    unsigned int        i;
+    int                 ok = 1;
+
+    pRaw = clipCheck_readRaw(pName, &samples);
+    if ( NULL == pRaw ) {
+        return FAIL;
+    }
+#ifndef AUDIOSAMPLE_PCM
+    if ( snd_clip.samples != samples ) {
+        printf("[CHECK]: clip %u samples, %s %u\r\n", snd_clip.samples, pName, samples);
+        return FAIL;
+    }
+#endif
+    pExp = clipCheck_reference(pRaw, samples);
+    if ( NULL == pExp ) {
+        return FAIL;
+    }
+
+    bufferPool_init(&buffP);
+    if ( audioRx_init(&rx, &buffP, &isrDisp) != PASS || audioRx_start(&rx) != PASS ) {
+        return FAIL;
+    }
+
+    /** keep the TX side full, play the oldest view once it is */
+    while ( played < (unsigned long long)samples * CLIPCHECK_LOOPS ) {
+        if ( audioRx_get(&rx, &pFifo[fifoCount]) != PASS ) {
+            printf("[CHECK]: audioRx_get failed with %d views held\r\n", fifoCount);
+            return FAIL;
+        }
+        played += pFifo[fifoCount]->bytesUsed / 2;
+        fifoCount++;
+        if ( CLIPCHECK_OUTSTANDING == fifoCount ) {
+            diff += clipCheck_play(pFifo[0], pExp, samples, &pos, &buffP);
+            memmove(&pFifo[0], &pFifo[1], --fifoCount * sizeof(pFifo[0]));
+        }
+    }
+    while ( fifoCount > 0 ) {
+        diff += clipCheck_play(pFifo[0], pExp, samples, &pos, &buffP);
+        memmove(&pFifo[0], &pFifo[1], --fifoCount * sizeof(pFifo[0]));
+    }
+
+    for ( i = 0; i < samples; i++ ) {
+        sig += (double)pRaw[i] * pRaw[i];
+        err += (double)(pExp[i] - pRaw[i]) * (pExp[i] - pRaw[i]);
+    }
+    snr = err > 0.0 ? 10.0 * log10(sig / err) : 99.0;
+
+    printf("[CHECK]: %s clip, %llu samples played (%d loops), %lu differ\r\n",
+#ifdef AUDIOSAMPLE_PCM
+           "PCM",
+#else
+           "ADPCM",
+#endif
+           played, CLIPCHECK_LOOPS, diff);
+    printf("[CHECK]: %d views held, pool chunks in use max %d (of %d), %d at the end\r\n",
+           CLIPCHECK_OUTSTANDING, buffP.inUseMax, BUFFERPOOL_CHUNKS, buffP.inUse);
+    printf("[CHECK]: views into read-only memory %lu, of pool chunks %lu, SNR %.1f dB\r\n",
+           rx.refPool.constViews, rx.refPool.chunkViews, snr);
+
+    ok = ok && 0 == diff && 0 == buffP.inUse;
+#ifdef AUDIOSAMPLE_PCM
+    /** in place: no chunk taken, no copy */
+    ok = ok && 0 == buffP.inUseMax && 0 == rx.refPool.chunkViews;
+#else
+    /** one chunk per view held, none into read-only memory */
+    ok = ok && buffP.inUseMax <= CLIPCHECK_OUTSTANDING && 0 == rx.refPool.constViews
+            && snr >= CLIPCHECK_SNR_MIN;
+#endif
+    printf("[CHECK]: %s\r\n", ok ? "passed" : "FAILED");
+
+    free(pExp);
+    free(pRaw);
+    return ok ? PASS : FAIL;
+}
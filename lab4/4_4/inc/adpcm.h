@@ -0,0 +1,101 @@
+/**
+ *@file adpcm.h
+ *
+ *@brief
+ *  - IMA-ADPCM (4 bit, 4:1) codec for 16 bit mono clips
+ *  - a clip is a sequence of ADPCM_BLOCK_BYTES blocks, each starting with
+ *    a 4 byte header (first sample, step index) so every block decodes on
+ *    its own: seeking is by block
+ *  - the decoder streams: it continues inside a block across calls and
+ *    stops at the block end, so any output size can be filled
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _ADPCM_H_
+#define _ADPCM_H_
+
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def ADPCM_BLOCK_BYTES
+ * @brief bytes per block, header included
+ */
+#define ADPCM_BLOCK_BYTES   (256)
+
+/**
+ * @def ADPCM_BLOCK_SAMPLES
+ * @brief samples per block: the header sample and two per data byte
+ */
+#define ADPCM_BLOCK_SAMPLES ((ADPCM_BLOCK_BYTES - 4) * 2 + 1)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** compressed clip
+ */
+typedef struct {
+  const unsigned char *pData;   /* blocks of ADPCM_BLOCK_BYTES */
+  unsigned int  blocks;         /* number of blocks */
+  unsigned int  samples;        /* samples, the last block may be partial */
+  unsigned int  rate;           /* sample rate in Hz */
+} adpcmClip_t;
+
+/** decoder object
+ */
+typedef struct {
+  const unsigned char *pBlock;  /* block being decoded */
+  int           pos;            /* next sample within the block */
+  int           predictor;      /* last decoded sample */
+  int           index;          /* step index 0 .. 88 */
+} adpcm_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Start decoding a block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pBlock  block of ADPCM_BLOCK_BYTES
+ *
+ * @return None
+ */
+void adpcm_start(adpcm_t *pThis, const unsigned char *pBlock);
+
+/** Decode samples up to the end of the block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pOut    decoded samples
+ * @param n       samples wanted
+ *
+ * @return number of samples decoded, 0 at the block end
+ */
+int adpcm_decode(adpcm_t *pThis, short *pOut, int n);
+
+/** Encode one block (for the clip generator)
+ *   - a short last block is padded with silence
+ *
+ * Parameters:
+ * @param pIn     ADPCM_BLOCK_SAMPLES samples, or fewer
+ * @param n       number of samples in pIn
+ * @param pIndex  step index, carried from block to block
+ * @param pBlock  output block of ADPCM_BLOCK_BYTES
+ *
+ * @return None
+ */
+void adpcm_encodeBlock(const short *pIn, int n, int *pIndex, unsigned char *pBlock);
+
+#endif
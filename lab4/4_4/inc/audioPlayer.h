@@ -34,7 +34,7 @@ typedef struct {
   isrDisp_t      	isrDisp; /* dispatcher for Rx Tx ISR */
   int 					volume;	/* Volume of the audio player */
   eSsm2602SampleFreq 	frequency;	/* Frequency of the audio player */
-  chunk_t            *chunk;  /* Chunk for copy */
+  chunkRef_t         *pRef;   /* view of the audio to play */
 } audioPlayer_t;
 
 /** initialize audio player 
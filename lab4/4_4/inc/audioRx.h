@@ -21,6 +21,7 @@
 #include "bufferPool.h"
 #include "isrDisp.h"
 #include <audioSample.h>
+#include <chunkRef.h>
 
 /***************************************************
             DEFINES
@@ -44,6 +45,7 @@ typedef struct {
   bufferPool_t   *pBuffP; /* pointer to buffer pool */
   FILE              *audioRx_pFile; /* audio file */
   audioSample_t  audioSample;
+  chunkRefPool_t refPool; /* views handed to audioTx */
 } audioRx_t;
 
 
@@ -93,18 +95,17 @@ int audioRx_start(audioRx_t *pThis);
 void audioRx_isr(void *pThis);
 
 /** audio rx get 
- *   copyies a filled chunk into pChunk
- *   blocking call, blocks if queue is empty 
- *     - get from queue 
- *     - copy in to pChunk
- *     - release chunk to buffer pool 
+ *   gets a view of the next audio
+ *     - PCM clip (AUDIOSAMPLE_PCM): points into the clip, no pool chunk
+ *     - otherwise a pool chunk filled from the file or the ADPCM decoder
  * Parameters:
  * @param pThis  pointer to own object
+ * @param ppRef  view of the audio, owned by the caller until put to audioTx
  *
  * @return Zero on success.
  * Negative value on failure.
  */
-int audioRx_get(audioRx_t *pThis, chunk_t **pChunk);
+int audioRx_get(audioRx_t *pThis, chunkRef_t **ppRef);
 
 
 #endif
@@ -1,10 +1,16 @@
 /**
- *@file audioRx.c
+ *@file audioSample.h
  *
  *@brief
- *  - receive audio samples from DMA
+ *  - audio clip source: decodes the IMA-ADPCM clip into chunks on demand
+ *    (4:1 smaller than the 16 bit PCM in the image)
+ *  - built with AUDIOSAMPLE_PCM (make CLIP=pcm) it plays the 16 bit PCM
+ *    clip in place instead: audioSample_getConst hands out views into the
+ *    linked samples for the TX DMA, no copy, no pool chunk
+ *  - seeks by ADPCM block, loops at the clip end
+ *  - counts the decoder cycles per chunk, reported at every clip end
  *
- * Target:   TLL6537v1-1      
+ * Target:   TLL6537v1-1
  * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
  *
  * @author:    Rohan Kangralkar
@@ -17,32 +23,98 @@
 #ifndef _AUDIO_SAMPLE_H_
 #define _AUDIO_SAMPLE_H_
 
+#include <adpcm.h>
+#include <chunkRef.h>
 
 /***************************************************
             DEFINES
-***************************************************/   
+***************************************************/
+
+/**
+ * @def AUDIOSAMPLE_VIEW_BYTES
+ * @brief bytes per view into the PCM clip (AUDIOSAMPLE_PCM)
+ */
+#define AUDIOSAMPLE_VIEW_BYTES  (1024*2)
 
 
 /***************************************************
             DATA TYPES
 ***************************************************/
 
-/** audio RX object
+/** audio sample object
  */
 typedef struct {
-  unsigned char *pmem;
-  unsigned int  size;
-  unsigned int  count;
+  const adpcmClip_t *pClip;     /* compressed clip */
+  const short   *pPcm;          /* PCM clip (AUDIOSAMPLE_PCM) */
+  unsigned int  samples;        /* samples in the clip */
+  adpcm_t       dec;            /* decoder within the current block */
+  unsigned int  block;          /* current block */
+  unsigned int  count;          /* samples decoded since the clip start */
+  unsigned long calls;          /* decoded chunks (PCM: views) */
+  unsigned long decoded;        /* samples in them */
+  unsigned long long cycles;    /* cycles spent decoding them */
+  unsigned long long cyclesMax; /* most expensive chunk */
 }audioSample_t;
 
 
 /***************************************************
-            Access Methods 
+            Access Methods
 ***************************************************/
 
+/** Initialize the clip source at the clip start
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
 int audioSample_init(audioSample_t *pThis);
 
+/** Decode the next chunk of the clip
+ *   - fills the chunk up to bytesMax, less at the clip end
+ *   - the clip restarts after its end
+ *
+ * Parameters:
+ * @param pThis      pointer to own object
+ * @param pchunk_rx  chunk to fill, bytesUsed is set
+ *
+ * @return number of bytes in the chunk
+ */
 int audioSample_get(audioSample_t *pThis, chunk_t *pchunk_rx);
 
+/** Hand out a view of the next part of the PCM clip (AUDIOSAMPLE_PCM)
+ *   - up to AUDIOSAMPLE_VIEW_BYTES, less at the clip end
+ *   - the clip restarts after its end
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pPool   pool of the view
+ * @param pRef    view to point into the clip
+ *
+ * @return number of bytes in the view
+ */
+int audioSample_getConst(audioSample_t *pThis, chunkRefPool_t *pPool, chunkRef_t *pRef);
+
+/** Continue playback at a block of the clip
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param block  block number, ADPCM_BLOCK_SAMPLES samples each
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioSample_seek(audioSample_t *pThis, unsigned int block);
+
+/** Print the decoder cycles per chunk (PCM: views handed out)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return None
+ */
+void audioSample_report(const audioSample_t *pThis);
+
 
 #endif
@@ -20,6 +20,7 @@
 #include "queue.h"
 #include "bufferPool.h"
 #include "isrDisp.h"
+#include "chunkRef.h"
 
 /***************************************************
             DEFINES
@@ -38,7 +39,7 @@
  */
 typedef struct {
   queue_t       queue;  /* queue for received buffers */
-  chunk_t       *pPending; /* pointer to pending chunk just in receiving */
+  chunkRef_t    *pPending; /* view of the data the DMA is sending */
   bufferPool_t  *pBuffP; /* pointer to buffer pool */
   int              running; /* DMA is Running */
 } audioTx_t;
@@ -87,16 +88,17 @@ int audioTx_start(audioTx_t *pThis);
  */
 void audioTx_isr(void *pThis);
 
-/** audio rx put
- *   copyies filled pChunk into the TX queue for transmission
- *    if queue is full, then chunk is dropped 
+/** audio tx put
+ *   puts the view pRef into the TX queue for transmission
+ *    if queue is full, then the view (and its chunk) is dropped 
  * Parameters:
  * @param pThis  pointer to own object
+ * @param pRef   view of the data to play, released once played
  *
  * @return Zero on success.
  * Negative value on failure.
  */
-int audioTx_put(audioTx_t *pThis, chunk_t *pChunk);
+int audioTx_put(audioTx_t *pThis, chunkRef_t *pRef);
 
 
 #endif
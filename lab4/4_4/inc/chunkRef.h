@@ -0,0 +1,124 @@
+/**
+ *@file chunkRef.h
+ *
+ *@brief
+ *  - view of audio data for the TX DMA: address and length of what to
+ *    play, and the pool chunk holding it, if any
+ *  - a view either wraps a chunk of the buffer pool (data that a stage
+ *    wrote) or points straight into read-only memory outside the pool
+ *    (e.g. the PCM clip): the DMA reads it in place, nothing is copied
+ *    and no pool chunk is taken. chunk_t itself comes with the board
+ *    library, its layout is fixed and its buffer lives inside it.
+ *  - views come from a small fixed pool, the ISR releasing a view also
+ *    returns its pool chunk
+ *  - only the PCM clip (make CLIP=pcm) is played in place. The default
+ *    ADPCM build still decodes every block into a pool chunk, so it takes
+ *    as many chunks as views are queued (8 with the TX queue full).
+ *  - the buffer handling of both builds is checked on the host (make -C
+ *    host check); playback on the board is untested
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _CHUNK_REF_H_
+#define _CHUNK_REF_H_
+
+#include <chunk.h>
+#include "bufferPool.h"
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def CHUNKREF_NUM
+ * @brief views in the pool: TX queue, DMA pending and the one being filled
+ */
+#define CHUNKREF_NUM        (12)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** view object
+ */
+typedef struct {
+  const unsigned short *pData;  /* first sample, the TX DMA reads from here */
+  int           bytesUsed;      /* bytes to play */
+  chunk_t       *pChunk;        /* pool chunk holding pData, NULL for read-only memory */
+  volatile int  busy;           /* handed out, cleared by the releasing ISR */
+} chunkRef_t;
+
+/** pool of views
+ */
+typedef struct {
+  chunkRef_t    ref[CHUNKREF_NUM];
+  int           next;           /* first view to try */
+  unsigned long constViews;     /* views into read-only memory handed out */
+  unsigned long chunkViews;     /* views of pool chunks handed out */
+} chunkRefPool_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize the pool, all views free
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int chunkRef_poolInit(chunkRefPool_t *pThis);
+
+/** Take a free view
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param ppRef  the view
+ *
+ * @return Zero on success, FAIL if all views are in use
+ */
+int chunkRef_acquire(chunkRefPool_t *pThis, chunkRef_t **ppRef);
+
+/** Point a view into read-only memory (no pool chunk)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pRef   the view
+ * @param pData  first sample, 16 bit aligned
+ * @param bytes  bytes to play
+ *
+ * @return None
+ */
+void chunkRef_setConst(chunkRefPool_t *pThis, chunkRef_t *pRef, const void *pData, int bytes);
+
+/** Let a view wrap a filled pool chunk, the view owns it from now on
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pRef    the view
+ * @param pChunk  chunk of the buffer pool, bytesUsed set
+ *
+ * @return None
+ */
+void chunkRef_setChunk(chunkRefPool_t *pThis, chunkRef_t *pRef, chunk_t *pChunk);
+
+/** Release a view and the pool chunk it owns (ISR safe)
+ *
+ * Parameters:
+ * @param pRef    the view
+ * @param pBuffP  buffer pool of the chunk
+ *
+ * @return None
+ */
+void chunkRef_release(chunkRef_t *pRef, bufferPool_t *pBuffP);
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ *@file adpcm.c
+ *
+ *@brief
+ *  - IMA-ADPCM (4 bit, 4:1) codec for 16 bit mono clips
+ *
+ *  Block: int16 first sample (little endian), step index, 0, then two
+ *  codes per byte, low nibble first. A code holds sign (bit 3) and the
+ *  difference to the last sample in steps of 1, 1/2, 1/4 (+ 1/8) of the
+ *  current step size; the step index adapts with every code.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <string.h>
+#include "adpcm.h"
+
+
+/** step sizes */
+static const short adpcm_stepTable[89] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/** step index change by code magnitude */
+static const signed char adpcm_indexTable[8] = {
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/** next sample of a code, adapts predictor and index */
+static inline int adpcm_step(int code, int *pPredictor, int *pIndex)
+{
+    int         step = adpcm_stepTable[*pIndex];
+    int         diff = step >> 3;
+    int         p;
+    int         i;
+
+    if ( code & 4 ) {
+        diff += step;
+    }
+    if ( code & 2 ) {
+        diff += step >> 1;
+    }
+    if ( code & 1 ) {
+        diff += step >> 2;
+    }
+    p = code & 8 ? *pPredictor - diff : *pPredictor + diff;
+    p = p > 32767 ? 32767 : p < -32768 ? -32768 : p;
+    i = *pIndex + adpcm_indexTable[code & 7];
+    *pIndex     = i < 0 ? 0 : i > 88 ? 88 : i;
+    *pPredictor = p;
+    return p;
+}
+
+/** Start decoding a block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pBlock  block of ADPCM_BLOCK_BYTES
+ *
+ * @return None
+ */
+void adpcm_start(adpcm_t *pThis, const unsigned char *pBlock)
+{
+    pThis->pBlock    = pBlock;
+    pThis->pos       = 0;
+    pThis->predictor = (short)(pBlock[0] | (pBlock[1] << 8));
+    pThis->index     = pBlock[2] > 88 ? 88 : pBlock[2];
+}
+
+/** Decode samples up to the end of the block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pOut    decoded samples
+ * @param n       samples wanted
+ *
+ * @return number of samples decoded, 0 at the block end
+ */
+int adpcm_decode(adpcm_t *pThis, short *pOut, int n)
+{
+    const unsigned char *pIn;
+    int         predictor = pThis->predictor;
+    int         index     = pThis->index;
+    int         pos       = pThis->pos;
+    int         todo      = ADPCM_BLOCK_SAMPLES - pos;
+    int         i         = 0;
+
+    if ( todo > n ) {
+        todo = n;
+    }
+    if ( 0 >= todo ) {
+        return 0;
+    }
+    if ( 0 == pos ) {
+        pOut[i++] = (short)predictor;
+        pos++;
+    }
+    pIn = &pThis->pBlock[4 + (pos - 1) / 2];
+
+    // odd start: the high nibble of a byte whose low nibble was used
+    if ( i < todo && 0 == (pos & 1) ) {
+        pOut[i++] = (short)adpcm_step(*pIn++ >> 4, &predictor, &index);
+    }
+    // whole bytes
+    for ( ; i + 1 < todo; i += 2 ) {
+        int b = *pIn++;
+
+        pOut[i]     = (short)adpcm_step(b & 0xf, &predictor, &index);
+        pOut[i + 1] = (short)adpcm_step(b >> 4, &predictor, &index);
+    }
+    if ( i < todo ) {
+        pOut[i++] = (short)adpcm_step(*pIn & 0xf, &predictor, &index);
+    }
+
+    pThis->predictor = predictor;
+    pThis->index     = index;
+    pThis->pos      += todo;
+    return todo;
+}
+
+/** Encode one block (for the clip generator)
+ *   - a short last block is padded with silence
+ *
+ * Parameters:
+ * @param pIn     ADPCM_BLOCK_SAMPLES samples, or fewer
+ * @param n       number of samples in pIn
+ * @param pIndex  step index, carried from block to block
+ * @param pBlock  output block of ADPCM_BLOCK_BYTES
+ *
+ * @return None
+ */
+void adpcm_encodeBlock(const short *pIn, int n, int *pIndex, unsigned char *pBlock)
+{
+    int         predictor = 0 < n ? pIn[0] : 0;
+    int         index     = *pIndex;
+    int         k;
+
+    memset(pBlock, 0, ADPCM_BLOCK_BYTES);
+    pBlock[0] = (unsigned char)(predictor & 0xff);
+    pBlock[1] = (unsigned char)((predictor >> 8) & 0xff);
+    pBlock[2] = (unsigned char)index;
+
+    for ( k = 1; k < ADPCM_BLOCK_SAMPLES; k++ ) {
+        int x    = k < n ? pIn[k] : predictor;
+        int step = adpcm_stepTable[index];
+        int diff = x - predictor;
+        int code = 0;
+
+        if ( 0 > diff ) {
+            code = 8;
+            diff = -diff;
+        }
+        // quantize on the same grid the decoder rebuilds
+        if ( diff >= step ) {
+            code |= 4;
+            diff -= step;
+        }
+        if ( diff >= step >> 1 ) {
+            code |= 2;
+            diff -= step >> 1;
+        }
+        if ( diff >= step >> 2 ) {
+            code |= 1;
+        }
+        adpcm_step(code, &predictor, &index);
+        pBlock[4 + (k - 1) / 2] |= (unsigned char)(code << (4 * ((k - 1) & 1)));
+    }
+    *pIndex = index;
+}
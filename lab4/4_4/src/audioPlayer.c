@@ -153,14 +153,14 @@ void audioPlayer_run (audioPlayer_t *pThis) {
     while(1) {
 
     	/** get audio chunk */
-        status = audioRx_get(&pThis->rx, &pThis->chunk);
+        status = audioRx_get(&pThis->rx, &pThis->pRef);
 
         /** If we have chunks that can be played then we provide them
          * to the audio TX
          */
         if ( PASS == status ) {
           /** play audio chunk through speakers */
-          audioTx_put(&pThis->tx, pThis->chunk);
+          audioTx_put(&pThis->tx, pThis->pRef);
         }
     }
 }
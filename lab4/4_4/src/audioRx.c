@@ -59,8 +59,8 @@ int audioRx_fileRead(FILE *pFile, chunk_t *pchunk_rx)
 
     // this is NOT right, however, the second fread call returns a smaller number 
     // although buffer was read completely
-    pchunk_rx->len = pchunk_rx->bytesMax;   
-    return pchunk_rx->len;
+    pchunk_rx->bytesUsed = pchunk_rx->bytesMax;   
+    return pchunk_rx->bytesUsed;
 }
 #endif
 
@@ -112,6 +112,9 @@ int audioRx_init(audioRx_t *pThis, bufferPool_t *pBuffP,
     
     pThis->pPending     = NULL;
     pThis->pBuffP       = pBuffP;
+
+    // views handed to audioTx
+    chunkRef_poolInit(&pThis->refPool);
     
     // init queue with 
     queue_init(&pThis->queue, AUDIORX_QUEUE_DEPTH);   
@@ -148,8 +151,8 @@ int audioRx_start(audioRx_t *pThis)
     }
     fseek(pThis->audioRx_pFile, 44, SEEK_SET); // remove wav header
 #else
-    pThis->audioSample.count = 44; /** we skip the wave header we assume that the data is
-                             16 bit mono*/
+    /** the clip holds no wave header, start at its first block */
+    audioSample_seek(&pThis->audioSample, 0);
 #endif
                              
     return PASS;
@@ -195,29 +198,51 @@ int audioRx_start(audioRx_t *pThis)
 
 
 /** audio rx get 
- * @brief Read the chunk from the file
+ * @brief Get a view of the next audio
+ *   - PCM clip (AUDIOSAMPLE_PCM): points into the clip, no pool chunk
+ *   - otherwise a pool chunk filled from the file or the ADPCM decoder
+ *     (the default build: one chunk per view until audioTx releases it)
  * Parameters:
  * @param pThis  pointer to own object
- * @param pChunk Chunk Pointer to be filled
+ * @param ppRef  view of the audio, owned by the caller until put to audioTx
  *
  * @return Zero on success.
  * Negative value on failure.
  */
-int audioRx_get(audioRx_t *pThis, chunk_t **pChunk)
+int audioRx_get(audioRx_t *pThis, chunkRef_t **ppRef)
 {
 	int size = 0;
+#if defined(ENABLE_FILE_STUB) || !defined(AUDIOSAMPLE_PCM)
+	chunk_t *pChunk = NULL;
+#endif
+
+    if (chunkRef_acquire(&pThis->refPool, ppRef) != PASS) {
+        printf("Could not acquire view for audio sample\n");
+        return FAIL;
+    }
 
-    if (bufferPool_acquire(pThis->pBuffP, pChunk) != PASS) {
+#if defined(ENABLE_FILE_STUB) || !defined(AUDIOSAMPLE_PCM)
+    if (bufferPool_acquire(pThis->pBuffP, &pChunk) != PASS) {
         printf("Could not acquire chunk for audio sample\n");
+        chunkRef_release(*ppRef, pThis->pBuffP);
         return FAIL;
     }
+    chunkRef_setChunk(&pThis->refPool, *ppRef, pChunk);
+#endif
 
 #ifdef ENABLE_FILE_STUB
-    size = audioRx_fileRead(pThis->audioRx_pFile, *pChunk);
+    size = audioRx_fileRead(pThis->audioRx_pFile, pChunk);
+#elif defined(AUDIOSAMPLE_PCM)
+    size = audioSample_getConst(&pThis->audioSample, &pThis->refPool, *ppRef);
 #else
-    size = audioSample_get(&pThis->audioSample, *pChunk);
+    size = audioSample_get(&pThis->audioSample, pChunk);
 #endif
+    if (size <= 0) {
+        chunkRef_release(*ppRef, pThis->pBuffP);
+        return FAIL;
+    }
+    (*ppRef)->bytesUsed = size;
 
-    return size > 0 ? PASS: FAIL;
+    return PASS;
 }
 
@@ -28,19 +28,19 @@
  * Configures the DMA tx with the buffer and the buffer length to 
  * transfer
  * Parameters:
- * @param pchunk  pointer to tx chunk
+ * @param pRef  view of the data to transfer (pool chunk or read-only memory)
  * @return void
  */
-void audioTx_dmaConfig(chunk_t *pchunk)
+void audioTx_dmaConfig(chunkRef_t *pRef)
 {
 	/* 1. Disable DMA 4*/
 	*pDMA4_CONFIG &= ~DMAEN;
 
 	/* 2. Configure start address */
-	*pDMA4_START_ADDR = pchunk->u16_buff;
+	*pDMA4_START_ADDR = (void *)pRef->pData;
 
 	/* 3. set X count */
-	*pDMA4_X_COUNT = pchunk->bytesUsed/2;
+	*pDMA4_X_COUNT = pRef->bytesUsed/2;
    
 	/* 4. set X modify */
 	*pDMA4_X_MODIFY = 2;
@@ -132,7 +132,7 @@ void audioTx_isr(void *pThisArg)
     // create local casted pThis to avoid casting on every single access
     audioTx_t  *pThis = (audioTx_t*) pThisArg;
 
-    chunk_t                  *pchunk              = NULL;
+    chunkRef_t               *pRef                = NULL;
     // validate that TX DMA IRQ was triggered 
     if ( *pDMA4_IRQ_STATUS & 0x1  ) {
         printf("[TXISR]\n");
@@ -140,13 +140,13 @@ void audioTx_isr(void *pThisArg)
            (The data was read previously by the DMA)
 
         1. First, attempt to get the new chunk, and check if it's available: */
-    	if (queue_get(&pThis->queue, &pchunk) == PASS) {
-    		/* 2. If so, release old chunk on success back to buffer pool */
-    		bufferPool_release(pThis->pBuffP, pThis->pPending);
+    	if (queue_get(&pThis->queue, &pRef) == PASS) {
+    		/* 2. If so, release old view, its chunk goes back to buffer pool */
+    		chunkRef_release(pThis->pPending, pThis->pBuffP);
 
 
-        /* 3. Register the new chunk as pending */
-    		pThis->pPending = pchunk;
+        /* 3. Register the new view as pending */
+    		pThis->pPending = pRef;
     	}
        
         *pDMA4_IRQ_STATUS  |= 0x0001;     // Clear the interrupt
@@ -160,19 +160,20 @@ void audioTx_isr(void *pThisArg)
 
 
 /** audio tx put
- *   copyies filled pChunk into the TX queue for transmission
- *    if queue is full, then chunk is dropped 
+ *   puts the view pRef into the TX queue for transmission
+ *    if queue is full, then the view (and its chunk) is dropped 
  * Parameters:
  * @param pThis  pointer to own object
+ * @param pRef   view of the data to play, released once played
  *
  * @return Zero on success.
  * Negative value on failure.
  */
-int audioTx_put(audioTx_t *pThis, chunk_t *pChunk)
+int audioTx_put(audioTx_t *pThis, chunkRef_t *pRef)
 {
     int                         count                   = 0;
     
-    if ( NULL == pThis || NULL == pChunk ) {
+    if ( NULL == pThis || NULL == pRef ) {
         printf("[TX]: Failed to put\r\n");
         return FAIL;
     }
@@ -188,19 +189,19 @@ int audioTx_put(audioTx_t *pThis, chunk_t *pChunk)
     /* If DMA not running ? */
     if ( 0 == pThis->running ) {
     	//printf("DMA Not Running\n");
-        /* directly put chunk to DMA transfer & enable */
+        /* directly put view to DMA transfer & enable */
         pThis->running  = 1;
-        pThis->pPending = pChunk;
+        pThis->pPending = pRef;
         audioTx_dmaConfig(pThis->pPending);  
         ENABLE_SPORT0_TX();
     } else {
     	//printf("DMA Running\n");
         /* DMA is already running, so we need to add chunk to queue
         1. Try to add chunk to queue and check status */
-    	if (queue_put(&pThis->queue, pChunk) != PASS) {
+    	if (queue_put(&pThis->queue, pRef) != PASS) {
     		/* 2.  If we could not add chunk to queue because queue is full,
-    		return chunk to pool, effectivly dropping the chunk */
-			bufferPool_release(pThis->pBuffP, pChunk);
+    		release the view and its chunk, effectivly dropping the chunk */
+			chunkRef_release(pRef, pThis->pBuffP);
 			printf("TX Queue Full\n");
 		}
     }
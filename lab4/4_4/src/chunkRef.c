@@ -0,0 +1,123 @@
+/**
+ *@file chunkRef.c
+ *
+ *@brief
+ *  - views of audio data for the TX DMA
+ *
+ *  The main loop acquires views, the TX ISR releases them. Each side only
+ *  ever writes busy in one direction (set by acquire on a free view,
+ *  cleared by release on a busy one), so the flag needs no lock. It is
+ *  volatile so the acquire loop reads it from memory on every pass.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <string.h>
+#include "tll_common.h"
+#include "chunkRef.h"
+
+
+/** Initialize the pool, all views free
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int chunkRef_poolInit(chunkRefPool_t *pThis)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    return PASS;
+}
+
+/** Take a free view
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param ppRef  the view
+ *
+ * @return Zero on success, FAIL if all views are in use
+ */
+int chunkRef_acquire(chunkRefPool_t *pThis, chunkRef_t **ppRef)
+{
+    int         i;
+
+    for ( i = 0; i < CHUNKREF_NUM; i++ ) {
+        chunkRef_t *pRef = &pThis->ref[(pThis->next + i) % CHUNKREF_NUM];
+
+        if ( 0 == pRef->busy ) {
+            pRef->pData     = NULL;
+            pRef->bytesUsed = 0;
+            pRef->pChunk    = NULL;
+            pRef->busy      = 1;
+            pThis->next     = (pThis->next + i + 1) % CHUNKREF_NUM;
+            *ppRef          = pRef;
+            return PASS;
+        }
+    }
+    return FAIL;
+}
+
+/** Point a view into read-only memory (no pool chunk)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pRef   the view
+ * @param pData  first sample, 16 bit aligned
+ * @param bytes  bytes to play
+ *
+ * @return None
+ */
+void chunkRef_setConst(chunkRefPool_t *pThis, chunkRef_t *pRef, const void *pData, int bytes)
+{
+    pRef->pData     = (const unsigned short *)pData;
+    pRef->bytesUsed = bytes;
+    pRef->pChunk    = NULL;
+    pThis->constViews++;
+}
+
+/** Let a view wrap a filled pool chunk, the view owns it from now on
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pRef    the view
+ * @param pChunk  chunk of the buffer pool, bytesUsed set
+ *
+ * @return None
+ */
+void chunkRef_setChunk(chunkRefPool_t *pThis, chunkRef_t *pRef, chunk_t *pChunk)
+{
+    pRef->pData     = &pChunk->u16_buff[0];
+    pRef->bytesUsed = pChunk->bytesUsed;
+    pRef->pChunk    = pChunk;
+    pThis->chunkViews++;
+}
+
+/** Release a view and the pool chunk it owns (ISR safe)
+ *
+ * Parameters:
+ * @param pRef    the view
+ * @param pBuffP  buffer pool of the chunk
+ *
+ * @return None
+ */
+void chunkRef_release(chunkRef_t *pRef, bufferPool_t *pBuffP)
+{
+    if ( NULL == pRef ) {
+        return;
+    }
+    if ( NULL != pRef->pChunk ) {
+        bufferPool_release(pBuffP, pRef->pChunk);
+        pRef->pChunk = NULL;
+    }
+    // last, volatile: the main loop may take the view from here on
+    pRef->busy = 0;
+}
@@ -0,0 +1,18 @@
+/**
+ *@file snd_clip.c
+ *
+ *@brief
+ *  - IMA-ADPCM clip, 95481 samples 16 bit mono 8000 Hz in 190 blocks of 256 bytes
+ *  - the blocks are snd_clip.adpcm, linked by snd_clip_bin.S
+ *  - generated by tools/adpcmEnc, do not edit
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <blob.h>
+#include <adpcm.h>
+
+BLOB_DECLARE(snd_clip_data);
+
+const adpcmClip_t snd_clip = { snd_clip_data, 190, 95481, 8000 };
@@ -0,0 +1,110 @@
+/**
+ *@file adpcmEnc.c
+ *
+ *@brief
+ *  - host tool: encode a raw 16 bit mono PCM clip (little endian) to
+ *    IMA-ADPCM blocks, written to a binary file that is linked as a blob
+ *    (blob.h), and write the adpcmClip_t describing it as C source
+ *  - prints the SNR of the decoded clip to stderr
+ *
+ *  usage: adpcmEnc in.raw rate name out.adpcm > out.c
+ *
+ * Target:   host (gcc)
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "adpcm.h"
+
+/** write the clip descriptor as C source, the blocks are linked as a blob */
+static void adpcmEnc_write(FILE *pOut, unsigned int blocks, unsigned int samples,
+                           unsigned int rate, const char *pName, const char *pBin)
+{
+    const char      *pBase = strrchr(pBin, '/');
+
+    pBase = NULL != pBase ? pBase + 1 : pBin;
+    fprintf(pOut, "/**\n *@file %s.c\n *\n *@brief\n", pName);
+    fprintf(pOut, " *  - IMA-ADPCM clip, %u samples 16 bit mono %u Hz in %u blocks of %d bytes\n",
+            samples, rate, blocks, ADPCM_BLOCK_BYTES);
+    fprintf(pOut, " *  - the blocks are %s, linked by %s_bin.S\n", pBase, pName);
+    fprintf(pOut, " *  - generated by tools/adpcmEnc, do not edit\n *\n");
+    fprintf(pOut, " * LastChange:\n * $Id$\n *\n");
+    fprintf(pOut, " *******************************************************************************/\n");
+    fprintf(pOut, "#include <blob.h>\n#include <adpcm.h>\n\n");
+    fprintf(pOut, "BLOB_DECLARE(%s_data);\n\n", pName);
+    fprintf(pOut, "const adpcmClip_t %s = { %s_data, %u, %u, %u };\n",
+            pName, pName, blocks, samples, rate);
+}
+
+int main(int argc, char *argv[])
+{
+    FILE            *pIn;
+    FILE            *pBin;
+    short           *pPcm;
+    short           *pDec;
+    unsigned char   *pData;
+    long            n;
+    unsigned int    blocks, b;
+    int             index = 0;
+    double          sig = 0.0, err = 0.0;
+    long            i;
+
+    if ( 5 != argc ) {
+        fprintf(stderr, "usage: %s in.raw rate name out.adpcm > out.c\n", argv[0]);
+        return 1;
+    }
+    pIn = fopen(argv[1], "rb");
+    if ( NULL == pIn ) {
+        fprintf(stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+    fseek(pIn, 0, SEEK_END);
+    n = ftell(pIn) / 2;
+    rewind(pIn);
+
+    blocks = (unsigned int)((n + ADPCM_BLOCK_SAMPLES - 1) / ADPCM_BLOCK_SAMPLES);
+    pPcm   = malloc(blocks * ADPCM_BLOCK_SAMPLES * sizeof(short));
+    pDec   = malloc(blocks * ADPCM_BLOCK_SAMPLES * sizeof(short));
+    pData  = malloc(blocks * ADPCM_BLOCK_BYTES);
+    if ( NULL == pPcm || NULL == pDec || NULL == pData
+      || (size_t)n != fread(pPcm, sizeof(short), n, pIn) ) {
+        fprintf(stderr, "can't read %s\n", argv[1]);
+        return 1;
+    }
+    fclose(pIn);
+
+    for ( b = 0; b < blocks; b++ ) {
+        long    left = n - (long)b * ADPCM_BLOCK_SAMPLES;
+        adpcm_t dec;
+
+        adpcm_encodeBlock(&pPcm[b * ADPCM_BLOCK_SAMPLES],
+                          left < ADPCM_BLOCK_SAMPLES ? (int)left : ADPCM_BLOCK_SAMPLES,
+                          &index, &pData[b * ADPCM_BLOCK_BYTES]);
+        adpcm_start(&dec, &pData[b * ADPCM_BLOCK_BYTES]);
+        adpcm_decode(&dec, &pDec[b * ADPCM_BLOCK_SAMPLES], ADPCM_BLOCK_SAMPLES);
+    }
+    for ( i = 0; i < n; i++ ) {
+        sig += (double)pPcm[i] * pPcm[i];
+        err += (double)(pPcm[i] - pDec[i]) * (pPcm[i] - pDec[i]);
+    }
+    fprintf(stderr, "%ld samples, %u blocks, %ld -> %u bytes, SNR %.1f dB\n",
+            n, blocks, 2 * n, blocks * ADPCM_BLOCK_BYTES,
+            0.0 < err ? 10.0 * log10(sig / err) : 99.0);
+
+    pBin = fopen(argv[4], "wb");
+    if ( NULL == pBin || blocks != fwrite(pData, ADPCM_BLOCK_BYTES, blocks, pBin) ) {
+        fprintf(stderr, "can't write %s\n", argv[4]);
+        return 1;
+    }
+    fclose(pBin);
+    adpcmEnc_write(stdout, blocks, (unsigned int)n, (unsigned int)atoi(argv[2]), argv[3], argv[4]);
+    free(pPcm);
+    free(pDec);
+    free(pData);
+    return 0;
+}
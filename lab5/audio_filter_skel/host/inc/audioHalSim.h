@@ -0,0 +1,69 @@
+/**
+ *@file audioHalSim.h
+ *
+ *@brief
+ *  - control interface of the simulated SPORT0/DMA engine
+ *  - a timer thread plays the role of the codec frame clock, completes
+ *    RX/TX transfers at the configured sample rate and raises the DMA
+ *    interrupts through the dispatcher
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _AUDIO_HAL_SIM_H_
+#define _AUDIO_HAL_SIM_H_
+
+#include <stdio.h>
+#include <audioHal.h>
+
+/** simulation parameters
+ */
+typedef struct {
+  unsigned int  sampleRate; /* samples per second, 0 = rate set by ssm2602_init */
+  double        speedup;    /* simulated time per wall clock time */
+  double        duration;   /* simulated seconds to run */
+  FILE          *pIn;       /* raw 16 bit input, looped; NULL = test tone */
+  FILE          *pOut;      /* raw 16 bit output; NULL = discard */
+  unsigned int  irqDelay;   /* sample periods from DMA completion to ISR */
+} audioHalSim_config_t;
+
+/** simulation results
+ */
+typedef struct {
+  unsigned long       rxChunks;   /* completed RX transfers */
+  unsigned long       txChunks;   /* completed TX transfers */
+  unsigned long long  rxStalled;  /* sample periods RX waited for the ISR */
+  unsigned long long  txStalled;  /* sample periods TX waited for the ISR */
+  unsigned long long  samples;    /* simulated sample periods */
+  unsigned int        sampleRate; /* rate used */
+  double              wallTime;   /* wall clock seconds spent */
+} audioHalSim_stats_t;
+
+/** set simulation parameters, call before the player is started
+ * @param pConfig  parameters (copied)
+ */
+void audioHalSim_configure(const audioHalSim_config_t *pConfig);
+
+/** sample rate requested by the codec driver, ignored if the rate
+ *  was fixed by audioHalSim_configure
+ * @param rate  samples per second
+ */
+void audioHalSim_setRate(unsigned int rate);
+
+/** override the execution context of the calling thread, used by
+ *  benchmarks; interrupt handlers always run as AUDIOHAL_CTX_ISR
+ * @param context  AUDIOHAL_CTX_NONE, AUDIOHAL_CTX_MAIN or AUDIOHAL_CTX_ISR
+ */
+void audioHalSim_setContext(int context);
+
+/** block until the configured duration has been simulated
+ * @param pStats  filled with the results
+ * @return Zero on success
+ */
+int audioHalSim_wait(audioHalSim_stats_t *pStats);
+
+#endif
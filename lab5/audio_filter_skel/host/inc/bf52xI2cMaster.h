@@ -0,0 +1,24 @@
+/**
+ *@file bf52xI2cMaster.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the TWI/I2C master driver
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _BF52X_I2C_MASTER_H_
+#define _BF52X_I2C_MASTER_H_
+
+/** initialize the I2C master, no-op on the host
+ * @param index  TWI controller
+ * @param clock  bus clock in Hz
+ * @return Zero on success
+ */
+int bf52xI2cMaster_init(int index, unsigned int clock);
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ *@file extio.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the external IO (switches, buttons)
+ *  - events are injected by the host driver instead of the FPGA
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _EXTIO_H_
+#define _EXTIO_H_
+
+#include <isrDisp.h>
+
+/** external input events
+ */
+typedef enum {
+    EXTIO_SW0_HIGH,
+    EXTIO_SW1_HIGH,
+    EXTIO_SW2_HIGH,
+    EXTIO_SW3_HIGH,
+    EXTIO_PB0_HIGH,
+    EXTIO_PB1_HIGH,
+    EXTIO_PB2_HIGH,
+    EXTIO_PB3_HIGH,
+    EXTIO_SW0_LOW,
+    EXTIO_SW1_LOW,
+    EXTIO_SW2_LOW,
+    EXTIO_SW3_LOW,
+    EXTIO_PB0_LOW,
+    EXTIO_PB1_LOW,
+    EXTIO_PB2_LOW,
+    EXTIO_PB3_LOW,
+    EXTIO_INPUT_NUM
+} extio_input;
+
+/** offset between a HIGH event and its LOW counterpart */
+#define EXTIO_INPUT_FIRST   (EXTIO_SW0_LOW)
+
+/** initialize extio
+ * @param pIsrDisp  interrupt dispatcher
+ * @return Zero on success
+ */
+int extio_init(isrDisp_t *pIsrDisp);
+
+/** subscribe to an event, it will be returned by extio_eventGet
+ * @return Zero on success
+ */
+int extio_eventSubscribe(extio_input event);
+
+/** get next subscribed event (non blocking)
+ * @param pEvent  where to store the event
+ * @return Zero if an event was returned, FAIL otherwise
+ */
+int extio_eventGet(extio_input *pEvent);
+
+/** register a callback for an event
+ * @return Zero on success
+ */
+int extio_callbackRegister(extio_input event, void (*callback)(void *), void *pArg);
+
+/** inject an event as if the input had changed (host only)
+ * @return Zero on success
+ */
+int extio_inject(extio_input event);
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ *@file filter.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the VisualDSP++ libbfdsp filter API
+ *  - fir_fr16 is a C reference with the same semantics
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _FILTER_H
+#define _FILTER_H
+
+/** 1.15 fractional */
+typedef short fract16;
+
+/** FIR filter state
+ */
+typedef struct {
+    int     k;   /* number of coefficients */
+    fract16 *h;  /* filter coefficients */
+    fract16 *d;  /* start of delay line */
+    fract16 *p;  /* read/write pointer into the delay line */
+    int     l;   /* interpolation/decimation index */
+} fir_state_fr16;
+
+/** initialize FIR state (note: takes the struct, not a pointer) */
+#define fir_init(state, coeffs, delay, ncoeffs, index) \
+    (state).h = (coeffs);  \
+    (state).d = (delay);   \
+    (state).p = (delay);   \
+    (state).k = (ncoeffs); \
+    (state).l = (index)
+
+/** FIR filter, 1.15 in and out, circular delay line
+ * @param input   input samples
+ * @param output  output samples (may not alias input)
+ * @param length  number of samples
+ * @param s       filter state
+ */
+void fir_fr16(const fract16 input[], fract16 output[], int length, fir_state_fr16 *s);
+
+#endif
@@ -0,0 +1,177 @@
+/**
+ *@file hostBench.h
+ *
+ *@brief
+ *  - host (x86 Linux) stress tests and micro benchmarks of the
+ *    pipeline building blocks, selected by audio_filter_host options
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _HOST_BENCH_H_
+#define _HOST_BENCH_H_
+
+/** stress spscRing with a producer and a consumer thread
+ *   - producer pushes a sequence number stream in random batch sizes,
+ *     consumer pops in random batch sizes and checks the order
+ *   - repeated for several ring sizes
+ *
+ * @param count  number of elements per ring size
+ *
+ * @return Zero if every element arrived once and in order, FAIL otherwise
+ */
+int hostBench_spscRing(unsigned long count);
+
+/** measure bufferPool acquire/release ns/op
+ *   - one thread through its magazine and through the free list only
+ *   - threads contending on the free list, and a main loop plus an
+ *     ISR context thread as in the audio pipeline
+ *   - checks at the end that every chunk is back exactly once
+ *
+ * @param count  acquire/release pairs per thread
+ *
+ * @return Zero if no chunk was lost or duplicated, FAIL otherwise
+ */
+int hostBench_bufferPool(unsigned long count);
+
+/** measure resampler ns per output for the player rate pairs
+ *   - streams random input in random block sizes and output limits and
+ *     compares every output with the polyphase equation evaluated
+ *     directly (history, phase carry and SIMD dot product)
+ *   - reports the gain of a tone at a tenth of the lower rate
+ *
+ * @param count  input samples per rate pair
+ *
+ * @return Zero if the streamed output equals the reference, FAIL otherwise
+ */
+int hostBench_resampler(unsigned long count);
+
+/** check the q15 library and measure its block operations
+ *   - scalar, packed 2x16 and 40 bit accumulator operations (all
+ *     rounding modes) against 64 bit reference arithmetic, random
+ *     operands mixed with the range edges
+ *   - block operations (SSE2 / SSSE3 / AVX2 as compiled) against the
+ *     scalar loops, ns/sample of both
+ *
+ * @param count  operands per operation
+ *
+ * @return Zero if every result is bit-exact, FAIL otherwise
+ */
+int hostBench_q15(unsigned long count);
+
+/** check the FIR designer and measure the coefficient cache
+ *   - filter 1..3 of audioFilter designed at 8k..48k, narrow bands
+ *     widened as in audioFilter_setRate: pass band gain, -6 dB cut-offs
+ *     and stop band attenuation, cached sets against fresh designs
+ *   - us per design, ns per cached lookup, misses over rate switches
+ *
+ * @param count  cache lookups timed
+ *
+ * @return Zero if every design meets its spec, FAIL otherwise
+ */
+int hostBench_firDesign(unsigned long count);
+
+/** check and measure the multirate decimators and interpolators
+ *   - factors 2, 4, 8 in half-band and polyphase mode, both directions,
+ *     streamed in random block sizes against the direct form
+ *   - ns and MACs per input sample, decimator alias rejection
+ *
+ * @param count  input samples timed per configuration
+ *
+ * @return Zero if every output equals the reference, FAIL otherwise
+ */
+int hostBench_multirate(unsigned long count);
+
+/** check and measure the equalizer
+ *   - every band boosted and cut alone at 16 and 48 kHz, gain at the
+ *     band frequency within 0.5 dB; plain Q15 and Q31 sections compared
+ *   - cycles and ns per chunk with 1 .. EQ_BANDS active bands, cost of
+ *     a redesign
+ *
+ * @param count  chunks timed per band count
+ *
+ * @return Zero if every band meets its gain, FAIL otherwise
+ */
+int hostBench_eq(unsigned long count);
+
+/** check and measure the look-ahead limiter
+ *   - quiet input: output is the input delayed by LIMITER_LOOKAHEAD
+ *     within the trimmed LSBs, bit-exact without headroom
+ *   - bursts 12 dB over full scale: no sample above LIMITER_CEILING,
+ *     metered reduction; 4:1 compression of a steady tone
+ *   - overlapping EQ bands at +12 dB, with and without the echo: the
+ *     headroom of the summed boost keeps every stage out of saturation
+ *   - cycles and ns per chunk at 16 and 48 kHz against the chunk period
+ *
+ * @param count  chunks timed per rate
+ *
+ * @return Zero if every check holds, FAIL otherwise
+ */
+int hostBench_limiter(unsigned long count);
+
+/** check the DTMF decoder and measure Goertzel detector banks
+ *   - 16 keys with twist, frequency offset and noise in random chunk
+ *     sizes at 16 and 48 kHz, talk-off on noise and random chords
+ *   - banks fed in random pieces equal banks fed whole blocks
+ *   - ns per 1024 sample chunk of 8, 16 and 64 detectors against a 1024
+ *     point fixed point FFT
+ *
+ * @param count  chunks timed per bank size
+ *
+ * @return Zero if every check holds, FAIL otherwise
+ */
+int hostBench_goertzel(unsigned long count);
+
+/** check and measure the echo
+ *   - impulse through a 4 s delay line across its wrap point, fed in
+ *     random chunk sizes, against the echo equations sample by sample
+ *   - tap positions and gains, feedback decay, no stray samples
+ *   - ns per 1024 sample chunk
+ *
+ * @param count  chunks timed
+ *
+ * @return Zero if every check holds, FAIL otherwise
+ */
+int hostBench_echo(unsigned long count);
+
+/** check and measure the folded FIR kernels
+ *   - firBlock_fr16 built with FIRBLOCK_FOLD=1 against fir_fr16, odd and
+ *     even tap counts, symmetric and not, at the coefficient sum bound,
+ *     fed in random chunk sizes; scaled variant against the unfolded one
+ *   - ns per sample of fir_fr16, the host default and the folded kernel
+ *
+ * @param count  1024 sample chunks timed per kernel
+ *
+ * @return Zero if every output equals the reference, FAIL otherwise
+ */
+int hostBench_firFold(unsigned long count);
+
+/** check and measure the overlap-save convolution
+ *   - windowed sinc low-pass of 256 .. 2048 taps, fixed and float FFT
+ *     against firBlock_fr16, rms and largest error in LSB
+ *   - ns per sample of the direct form and both FFT modes at 1024 taps
+ *   - FFTCONV_AUTO at 32 .. 1024 taps picks the faster mode as measured
+ *
+ * @param count  1024 sample calls timed per mode
+ *
+ * @return Zero if every error stays within its bound, FAIL otherwise
+ */
+int hostBench_fftConv(unsigned long count);
+
+/** check the filterCascade across mask changes
+ *   - filter 1..3 in random masks per chunk against the stages run
+ *     without interruption: separate mode bit-exact, combined mode
+ *     within a few LSB right after a change too
+ *   - ns per mask change
+ *
+ * @param count  mask changes timed
+ *
+ * @return Zero if every output matches its reference, FAIL otherwise
+ */
+int hostBench_filterCascade(unsigned long count);
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ *@file isrDisp.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the interrupt dispatcher
+ *  - callbacks are invoked by the simulated DMA engine
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _ISR_DISP_H_
+#define _ISR_DISP_H_
+
+/** interrupt sources known to the dispatcher
+ */
+typedef enum {
+    ISR_DMA3_SPORT0_RX,
+    ISR_DMA4_SPORT0_TX,
+    ISR_PORTF_INTA,
+    ISR_NUM
+} isrDisp_isr_t;
+
+/** callback signature */
+typedef void (*isrDisp_callback_t)(void *pArg);
+
+/** dispatcher object
+ */
+typedef struct {
+  isrDisp_callback_t  callback[ISR_NUM]; /* registered handlers */
+  void                *pArg[ISR_NUM];    /* argument passed to handler */
+} isrDisp_t;
+
+/** initialize dispatcher
+ * @param pThis  pointer to own object
+ * @return Zero on success
+ */
+int isrDisp_init(isrDisp_t *pThis);
+
+/** register a callback for an interrupt source
+ * @param pThis     pointer to own object
+ * @param isr       interrupt source
+ * @param callback  handler
+ * @param pArg      argument handed to the handler
+ * @return Zero on success
+ */
+int isrDisp_registerCallback(isrDisp_t *pThis, isrDisp_isr_t isr,
+                             isrDisp_callback_t callback, void *pArg);
+
+/** raise an interrupt (host only)
+ *   - runs the registered handler atomically with respect to
+ *     other interrupts and to queue operations
+ * @param isr  interrupt source
+ */
+void isrDisp_raise(isrDisp_isr_t isr);
+
+/** wait until an interrupt was raised (host only, models "idle") */
+void isrDisp_waitIrq(void);
+
+/** @return non-zero while the calling thread executes an interrupt handler */
+int isrDisp_inIsr(void);
+
+/** enter/leave a section that may not be interrupted (host only) */
+void isrDisp_lock(void);
+void isrDisp_unlock(void);
+
+#endif
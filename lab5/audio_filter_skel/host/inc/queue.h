@@ -0,0 +1,65 @@
+/**
+ *@file queue.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the TLL6527 pointer queue
+ *  - operations are atomic with respect to the simulated interrupts
+ *  - keeps occupancy statistics for the simulation report
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+/**
+ * @def QUEUE_SIZE_MAX
+ * @brief maximum number of elements in a queue
+ */
+#define QUEUE_SIZE_MAX  (64)
+
+/** queue object
+ */
+typedef struct {
+  void          *data[QUEUE_SIZE_MAX]; /* stored pointers */
+  int           size;       /* configured depth */
+  int           head;       /* read position */
+  int           tail;       /* write position */
+  int           count;      /* current fill level */
+  int           levelMax;   /* highest fill level seen */
+  unsigned long levelSum;   /* sum of fill levels sampled on every put */
+  unsigned long nPut;       /* number of successful puts */
+} queue_t;
+
+/** initialize queue
+ * @param pThis  pointer to own object
+ * @param size   queue depth (at most QUEUE_SIZE_MAX)
+ * @return Zero on success, FAIL otherwise
+ */
+int queue_init(queue_t *pThis, int size);
+
+/** append pointer at the tail
+ * @param pThis  pointer to own object
+ * @param pData  pointer to store
+ * @return Zero on success, FAIL if full
+ */
+int queue_put(queue_t *pThis, void *pData);
+
+/** remove pointer from the head
+ * @param pThis  pointer to own object
+ * @param ppData where to store the removed pointer
+ * @return Zero on success, FAIL if empty
+ */
+int queue_get(queue_t *pThis, void **ppData);
+
+/** @return non-zero if the queue is empty */
+int queue_is_empty(queue_t *pThis);
+
+/** @return non-zero if the queue is full */
+int queue_is_full(queue_t *pThis);
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ *@file ssm2602.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the SSM2602 codec driver
+ *  - the configured sample rate is forwarded to the simulated DMA engine
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _SSM2602_H_
+#define _SSM2602_H_
+
+#include <isrDisp.h>
+
+/** codec sample rates
+ */
+typedef enum {
+    SSM2602_SR_8000,
+    SSM2602_SR_16000,
+    SSM2602_SR_22050,
+    SSM2602_SR_32000,
+    SSM2602_SR_44100,
+    SSM2602_SR_48000,
+    SSM2602_SR_88200,
+    SSM2602_SR_96000
+} eSsm2602SampleFreq;
+
+/** codec directions */
+#define SSM2602_RX          (0x1)
+#define SSM2602_TX          (0x2)
+
+/** volume targets */
+#define SSM2602_MAIN_OUT    (0)
+
+/** initialize the codec
+ * @return Zero on success
+ */
+int ssm2602_init(isrDisp_t *pIsrDisp, int volume, eSsm2602SampleFreq freq, int mode);
+
+/** set output volume
+ * @return Zero on success
+ */
+int ssm2602_setVolume(int target, int left, int right);
+
+/** set sampling frequency
+ * @return Zero on success
+ */
+int ssm2602_setSamplingFeq(int target, eSsm2602SampleFreq freq);
+
+/** sample rate in Hz for a codec setting (host only) */
+unsigned int ssm2602_rateHz(eSsm2602SampleFreq freq);
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ *@file startup.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the processor and FPGA setup
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _STARTUP_H_
+#define _STARTUP_H_
+
+/** processor setup, nothing to do on the host
+ * @return 0 on success
+ */
+int blackfin_setup(void);
+
+/** FPGA setup, nothing to do on the host
+ * @return 0 on success
+ */
+int fpga_setup(void);
+
+#endif
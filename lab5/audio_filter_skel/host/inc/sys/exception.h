@@ -0,0 +1,17 @@
+/**
+ *@file sys/exception.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the Blackfin exception header
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _SYS_EXCEPTION_H_
+#define _SYS_EXCEPTION_H_
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ *@file tll6527_core_timer.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the core timer
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _TLL6527_CORE_TIMER_H_
+#define _TLL6527_CORE_TIMER_H_
+
+/** initialize the core timer, no-op on the host
+ * @return Zero on success
+ */
+int coreTimer_init(void);
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ *@file tll_common.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the TLL6527 common definitions
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _TLL_COMMON_H_
+#define _TLL_COMMON_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** return value for success */
+#define PASS    (0)
+/** return value for failure */
+#define FAIL    (-1)
+
+/** frequency helpers */
+#define _1KHZ   (1000)
+#define _1MHZ   (1000*_1KHZ)
+
+#endif
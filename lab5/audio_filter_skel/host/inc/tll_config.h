@@ -0,0 +1,21 @@
+/**
+ *@file tll_config.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the TLL6527 board configuration
+ *    nothing is memory mapped on the host, the simulated DMA is reached
+ *    through audioHal.h
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _TLL_CONFIG_H_
+#define _TLL_CONFIG_H_
+
+#include <tll_common.h>
+
+#endif
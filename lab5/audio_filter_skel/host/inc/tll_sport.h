@@ -0,0 +1,23 @@
+/**
+ *@file tll_sport.h
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the SPORT helpers
+ *    SPORT0 is started by the simulated DMA engine (see audioHalSim.c)
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _TLL_SPORT_H_
+#define _TLL_SPORT_H_
+
+#include <audioHal.h>
+
+#define ENABLE_SPORT0_RX()  audioHal_rxEnable()
+#define ENABLE_SPORT0_TX()  audioHal_txEnable()
+
+#endif
@@ -0,0 +1,523 @@
+/**
+ *@file audioHalSim.c
+ *
+ *@brief
+ *  - host (x86 Linux) implementation of the audio hardware abstraction
+ *  - a clock thread advances simulated time at sampleRate * speedup,
+ *    completes the configured RX/TX transfers and raises the DMA
+ *    interrupts through the dispatcher, exactly like DMA3/DMA4 would
+ *  - RX data comes from a raw file or a two tone test signal, TX data
+ *    goes to a raw file or is discarded
+ *  - in descriptor mode a channel follows the pNext links of the ring
+ *    it was started on and loads the next transfer right away; in
+ *    register mode it stands still until the ISR reprograms it, those
+ *    sample periods are counted as stalled
+ *  - in autobuffer mode RX writes its buffer sample by sample as time
+ *    advances and wraps around without an interrupt
+ *  - an interrupt latency (config.irqDelay) delays the ISR after the
+ *    transfer completes, completions in between share one interrupt
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <math.h>
+#include "tll_common.h"
+#include "isrDisp.h"
+#include "audioHalSim.h"
+
+/**
+ * @def AUDIOHALSIM_TICK_NS
+ * @brief longest wall clock sleep of the clock thread
+ */
+#define AUDIOHALSIM_TICK_NS     (1000*1000)
+
+/**
+ * @def AUDIOHALSIM_RATE_DEFAULT
+ * @brief rate used if neither the codec nor the configuration set one
+ */
+#define AUDIOHALSIM_RATE_DEFAULT (16000)
+
+/** one simulated DMA channel
+ */
+typedef struct {
+  unsigned short    *pBuff;     /* current transfer buffer */
+  int               nSamples;   /* transfer length */
+  int               remaining;  /* samples left in current transfer */
+  int               running;    /* transfer configured and not finished */
+  int               enabled;    /* SPORT side started */
+  int               irq;        /* completion interrupt latched */
+  unsigned long long irqAt;     /* sample time the ISR runs, valid while irqDue */
+  int               irqDue;     /* ISR not yet run for the latched interrupt */
+  unsigned long     nChunks;    /* completed transfers */
+  unsigned long long stalled;   /* sample periods enabled but without transfer */
+  audioHal_desc_t   *pDesc;     /* descriptor worked on, NULL = register mode */
+  int               autoBuf;    /* autobuffer: wraps around, no interrupt */
+} audioHalSim_dma_t;
+
+/** simulation state
+ */
+typedef struct {
+  audioHalSim_config_t  config;     /* parameters */
+  unsigned int          rate;       /* rate requested by the codec */
+  audioHalSim_dma_t     rx;         /* DMA3 */
+  audioHalSim_dma_t     tx;         /* DMA4 */
+  int                   started;    /* clock thread running */
+  pthread_t             thread;     /* clock thread */
+  pthread_mutex_t       doneLock;   /* protects done */
+  pthread_cond_t        doneCond;   /* signalled when done */
+  int                   done;       /* duration simulated */
+  audioHalSim_stats_t   stats;      /* results */
+  unsigned long long    tonePos;    /* test tone sample index */
+} audioHalSim_t;
+
+static audioHalSim_t audioHalSim = {
+    .config   = { 0, 1.0, 10.0, NULL, NULL, 0 },
+    .rate     = AUDIOHALSIM_RATE_DEFAULT,
+    .doneLock = PTHREAD_MUTEX_INITIALIZER,
+    .doneCond = PTHREAD_COND_INITIALIZER,
+};
+
+/** context override of the calling thread, see audioHalSim_setContext */
+static __thread int audioHalSim_context = AUDIOHAL_CTX_MAIN;
+
+/** @return monotonic wall clock in seconds */
+static double audioHalSim_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** fill a finished RX transfer with input data
+ *   - raw file (looped, a RIFF header is skipped) or 500Hz + 5kHz tones
+ */
+static void audioHalSim_source(unsigned short *pBuff, int nSamples, unsigned int rate)
+{
+    FILE    *pIn = audioHalSim.config.pIn;
+    size_t  count = 0;
+    int     i;
+
+    if ( NULL != pIn ) {
+        while ( count < (size_t)nSamples ) {
+            size_t n = fread(&pBuff[count], sizeof(short), nSamples - count, pIn);
+            if ( 0 == n ) {
+                char riff[4] = { 0 };
+                rewind(pIn);
+                if ( 4 == fread(riff, 1, 4, pIn) && 0 == memcmp(riff, "RIFF", 4) ) {
+                    fseek(pIn, 44, SEEK_SET);
+                } else {
+                    rewind(pIn);
+                }
+                if ( feof(pIn) || ferror(pIn) ) {
+                    break;
+                }
+            }
+            count += n;
+        }
+        return;
+    }
+
+    for ( i = 0; i < nSamples; i++ ) {
+        double t = (double)(audioHalSim.tonePos++) / rate;
+        pBuff[i] = (unsigned short)(short)(8000.0 * sin(2 * M_PI * 500.0 * t)
+                                         + 8000.0 * sin(2 * M_PI * 5000.0 * t));
+    }
+}
+
+/** a channel finished its transfer
+ *   - latch the interrupt, the ISR runs irqDelay samples later
+ *   - descriptor mode: load the next descriptor of the ring
+ * @param pDma  channel
+ * @param now   sample time
+ */
+static void audioHalSim_complete(audioHalSim_dma_t *pDma, unsigned long long now)
+{
+    pDma->irq = 1;
+    pDma->nChunks++;
+    if ( 0 == pDma->irqDue ) {
+        pDma->irqDue = 1;
+        pDma->irqAt  = now + audioHalSim.config.irqDelay;
+    }
+    if ( NULL != pDma->pDesc ) {
+        pDma->pDesc     = pDma->pDesc->pNext;
+        pDma->pBuff     = pDma->pDesc->pStart;
+        pDma->nSamples  = pDma->pDesc->yCount;
+        pDma->remaining = pDma->nSamples;
+    } else {
+        pDma->running   = 0;
+    }
+}
+
+/** @return non-zero if the ISR of a channel is due, clears it
+ * @param pDma  channel
+ * @param now   sample time
+ */
+static int audioHalSim_irqDue(audioHalSim_dma_t *pDma, unsigned long long now)
+{
+    if ( pDma->irqDue && pDma->irqAt <= now ) {
+        pDma->irqDue = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/** clock thread, advances simulated time and completes transfers
+ * @param pArg  not used
+ */
+static void *audioHalSim_clock(void *pArg)
+{
+    audioHalSim_t       *pThis   = &audioHalSim;
+    unsigned int        rate     = pThis->config.sampleRate ? pThis->config.sampleRate : pThis->rate;
+    double              speed    = rate * pThis->config.speedup;
+    unsigned long long  limit    = (unsigned long long)(pThis->config.duration * rate);
+    unsigned long long  samples  = 0;
+    double              t0       = audioHalSim_now();
+
+    while ( samples < limit ) {
+        unsigned long long target = (unsigned long long)((audioHalSim_now() - t0) * speed);
+        unsigned long long next   = AUDIOHALSIM_TICK_NS;
+        struct timespec    sleep  = { 0, 0 };
+
+        if ( target > limit ) {
+            target = limit;
+        }
+
+        while ( samples < target ) {
+            unsigned long long  step   = target - samples;
+            int                 rxDone = 0;
+            int                 txDone = 0;
+
+            isrDisp_lock();
+            if ( pThis->rx.running && pThis->rx.enabled && (unsigned)pThis->rx.remaining < step ) {
+                step = pThis->rx.remaining;
+            }
+            if ( pThis->tx.running && pThis->tx.enabled && (unsigned)pThis->tx.remaining < step ) {
+                step = pThis->tx.remaining;
+            }
+            if ( pThis->rx.irqDue && pThis->rx.irqAt - samples < step ) {
+                step = pThis->rx.irqAt - samples;
+            }
+            if ( pThis->tx.irqDue && pThis->tx.irqAt - samples < step ) {
+                step = pThis->tx.irqAt - samples;
+            }
+            samples += step;
+
+            if ( pThis->rx.running && pThis->rx.enabled && pThis->rx.autoBuf ) {
+                audioHalSim_source(&pThis->rx.pBuff[pThis->rx.nSamples - pThis->rx.remaining], step, rate);
+                pThis->rx.remaining -= step;
+                if ( 0 == pThis->rx.remaining ) {
+                    pThis->rx.remaining = pThis->rx.nSamples;
+                    pThis->rx.nChunks++;
+                }
+            } else if ( pThis->rx.running && pThis->rx.enabled ) {
+                pThis->rx.remaining -= step;
+                if ( 0 == pThis->rx.remaining ) {
+                    audioHalSim_source(pThis->rx.pBuff, pThis->rx.nSamples, rate);
+                    audioHalSim_complete(&pThis->rx, samples);
+                }
+            } else if ( pThis->rx.enabled ) {
+                pThis->rx.stalled += step;
+            }
+            if ( pThis->tx.running && pThis->tx.enabled ) {
+                pThis->tx.remaining -= step;
+                if ( 0 == pThis->tx.remaining ) {
+                    if ( NULL != pThis->config.pOut ) {
+                        fwrite(pThis->tx.pBuff, sizeof(short), pThis->tx.nSamples, pThis->config.pOut);
+                    }
+                    audioHalSim_complete(&pThis->tx, samples);
+                }
+            } else if ( pThis->tx.enabled ) {
+                pThis->tx.stalled += step;
+            }
+            rxDone = audioHalSim_irqDue(&pThis->rx, samples);
+            txDone = audioHalSim_irqDue(&pThis->tx, samples);
+            isrDisp_unlock();
+
+            if ( rxDone ) {
+                isrDisp_raise(ISR_DMA3_SPORT0_RX);
+            }
+            if ( txDone ) {
+                isrDisp_raise(ISR_DMA4_SPORT0_TX);
+            }
+        }
+
+        /* sleep until the next transfer completes or ISR is due, at most one tick */
+        isrDisp_lock();
+        if ( pThis->rx.running && pThis->rx.enabled ) {
+            unsigned long long ns = (unsigned long long)(pThis->rx.remaining * 1e9 / speed);
+            next = ns < next ? ns : next;
+        }
+        if ( pThis->tx.running && pThis->tx.enabled ) {
+            unsigned long long ns = (unsigned long long)(pThis->tx.remaining * 1e9 / speed);
+            next = ns < next ? ns : next;
+        }
+        if ( pThis->rx.irqDue ) {
+            unsigned long long ns = (unsigned long long)((pThis->rx.irqAt - samples) * 1e9 / speed);
+            next = ns < next ? ns : next;
+        }
+        if ( pThis->tx.irqDue ) {
+            unsigned long long ns = (unsigned long long)((pThis->tx.irqAt - samples) * 1e9 / speed);
+            next = ns < next ? ns : next;
+        }
+        isrDisp_unlock();
+        if ( 0 < next ) {
+            sleep.tv_nsec = next;
+            nanosleep(&sleep, NULL);
+        }
+    }
+
+    /* stop both channels, the player blocks in its idle loop afterwards */
+    isrDisp_lock();
+    pThis->rx.enabled = 0;
+    pThis->tx.enabled = 0;
+    isrDisp_unlock();
+
+    pthread_mutex_lock(&pThis->doneLock);
+    pThis->stats.rxChunks   = pThis->rx.nChunks;
+    pThis->stats.txChunks   = pThis->tx.nChunks;
+    pThis->stats.rxStalled  = pThis->rx.stalled;
+    pThis->stats.txStalled  = pThis->tx.stalled;
+    pThis->stats.samples    = samples;
+    pThis->stats.sampleRate = rate;
+    pThis->stats.wallTime   = audioHalSim_now() - t0;
+    pThis->done = 1;
+    pthread_cond_broadcast(&pThis->doneCond);
+    pthread_mutex_unlock(&pThis->doneLock);
+
+    return NULL;
+}
+
+/** start the clock thread on the first SPORT enable */
+static void audioHalSim_start(void)
+{
+    if ( audioHalSim.started ) {
+        return;
+    }
+    audioHalSim.started = 1;
+    if ( 0 != pthread_create(&audioHalSim.thread, NULL, audioHalSim_clock, NULL) ) {
+        printf("[SIM]: failed to start DMA clock\n");
+        exit(1);
+    }
+}
+
+/** configure a channel for a new transfer */
+static void audioHalSim_dmaConfig(audioHalSim_dma_t *pDma, unsigned short *pBuff, int nSamples)
+{
+    isrDisp_lock();
+    pDma->pBuff     = pBuff;
+    pDma->nSamples  = nSamples;
+    pDma->remaining = nSamples;
+    pDma->running   = (0 < nSamples);
+    pDma->pDesc     = NULL;
+    pDma->autoBuf   = 0;
+    isrDisp_unlock();
+}
+
+/** start a channel on a descriptor ring */
+static void audioHalSim_descStart(audioHalSim_dma_t *pDma, audioHal_desc_t *pFirst)
+{
+    isrDisp_lock();
+    pDma->pDesc     = pFirst;
+    pDma->pBuff     = pFirst->pStart;
+    pDma->nSamples  = pFirst->yCount;
+    pDma->remaining = pDma->nSamples;
+    pDma->running   = (0 < pDma->nSamples);
+    isrDisp_unlock();
+}
+
+/** link a descriptor ring, same transfer layout as the Blackfin */
+static void audioHalSim_descRing(audioHal_desc_t *pRing, int nDesc)
+{
+    int         i;
+
+    for ( i = 0; i < nDesc; i++ ) {
+        pRing[i].pNext   = &pRing[(i + 1) % nDesc];
+        pRing[i].pStart  = NULL;
+        pRing[i].config  = 0;
+        pRing[i].xCount  = 2;
+        pRing[i].xModify = 0;
+        pRing[i].yCount  = 0;
+        pRing[i].yModify = 2;
+    }
+}
+
+/** set simulation parameters
+ * @param pConfig  parameters (copied)
+ */
+void audioHalSim_configure(const audioHalSim_config_t *pConfig)
+{
+    audioHalSim.config = *pConfig;
+}
+
+/** sample rate requested by the codec driver
+ * @param rate  samples per second
+ */
+void audioHalSim_setRate(unsigned int rate)
+{
+    audioHalSim.rate = rate;
+}
+
+/** override the execution context of the calling thread
+ * @param context  AUDIOHAL_CTX_NONE, AUDIOHAL_CTX_MAIN or AUDIOHAL_CTX_ISR
+ */
+void audioHalSim_setContext(int context)
+{
+    audioHalSim_context = context;
+}
+
+/** block until the configured duration has been simulated
+ * @param pStats  filled with the results
+ * @return Zero on success
+ */
+int audioHalSim_wait(audioHalSim_stats_t *pStats)
+{
+    pthread_mutex_lock(&audioHalSim.doneLock);
+    while ( 0 == audioHalSim.done ) {
+        pthread_cond_wait(&audioHalSim.doneCond, &audioHalSim.doneLock);
+    }
+    *pStats = audioHalSim.stats;
+    pthread_mutex_unlock(&audioHalSim.doneLock);
+    return PASS;
+}
+
+/***************************************************
+            audioHal.h implementation
+***************************************************/
+
+void audioHal_rxInit(void)
+{
+    memset(&audioHalSim.rx, 0, sizeof(audioHalSim.rx));
+}
+
+void audioHal_rxDmaConfig(unsigned short *pBuff, int nSamples)
+{
+    audioHalSim_dmaConfig(&audioHalSim.rx, pBuff, nSamples);
+}
+
+void audioHal_rxEnable(void)
+{
+    isrDisp_lock();
+    audioHalSim.rx.enabled = 1;
+    isrDisp_unlock();
+    audioHalSim_start();
+}
+
+int audioHal_rxIrqPending(void)
+{
+    return audioHalSim.rx.irq;
+}
+
+void audioHal_rxIrqClear(void)
+{
+    audioHalSim.rx.irq = 0;
+}
+
+void audioHal_txInit(void)
+{
+    memset(&audioHalSim.tx, 0, sizeof(audioHalSim.tx));
+}
+
+void audioHal_txDmaConfig(unsigned short *pBuff, int nSamples)
+{
+    audioHalSim_dmaConfig(&audioHalSim.tx, pBuff, nSamples);
+}
+
+void audioHal_txEnable(void)
+{
+    isrDisp_lock();
+    audioHalSim.tx.enabled = 1;
+    isrDisp_unlock();
+    audioHalSim_start();
+}
+
+int audioHal_txIrqPending(void)
+{
+    return audioHalSim.tx.irq;
+}
+
+void audioHal_txIrqClear(void)
+{
+    audioHalSim.tx.irq = 0;
+}
+
+void audioHal_rxAutoStart(unsigned short *pBuff, int nSamples)
+{
+    audioHalSim_dmaConfig(&audioHalSim.rx, pBuff, nSamples);
+    isrDisp_lock();
+    audioHalSim.rx.autoBuf = 1;
+    isrDisp_unlock();
+}
+
+int audioHal_rxAutoPos(void)
+{
+    int         pos;
+
+    isrDisp_lock();
+    pos = audioHalSim.rx.nSamples - audioHalSim.rx.remaining;
+    isrDisp_unlock();
+    return pos;
+}
+
+void audioHal_poll(void)
+{
+    sched_yield();
+}
+
+void audioHal_rxDescInit(audioHal_desc_t *pRing, int nDesc)
+{
+    audioHalSim_descRing(pRing, nDesc);
+}
+
+void audioHal_rxDescStart(audioHal_desc_t *pFirst)
+{
+    audioHalSim_descStart(&audioHalSim.rx, pFirst);
+}
+
+audioHal_desc_t *audioHal_rxDescNext(void)
+{
+    return NULL != audioHalSim.rx.pDesc ? audioHalSim.rx.pDesc->pNext : NULL;
+}
+
+void audioHal_txDescInit(audioHal_desc_t *pRing, int nDesc)
+{
+    audioHalSim_descRing(pRing, nDesc);
+}
+
+void audioHal_txDescStart(audioHal_desc_t *pFirst)
+{
+    audioHalSim_descStart(&audioHalSim.tx, pFirst);
+}
+
+audioHal_desc_t *audioHal_txDescNext(void)
+{
+    return NULL != audioHalSim.tx.pDesc ? audioHalSim.tx.pDesc->pNext : NULL;
+}
+
+void audioHal_descSet(audioHal_desc_t *pDesc, unsigned short *pBuff, int nSamples)
+{
+    pDesc->pStart = pBuff;
+    pDesc->yCount = nSamples;
+}
+
+void audioHal_idle(void)
+{
+    isrDisp_waitIrq();
+}
+
+void audioHal_active(void)
+{
+}
+
+int audioHal_context(void)
+{
+    return isrDisp_inIsr() ? AUDIOHAL_CTX_ISR : audioHalSim_context;
+}
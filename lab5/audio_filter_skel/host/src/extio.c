@@ -0,0 +1,97 @@
+/**
+ *@file extio.c
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the external IO
+ *  - injected events are queued for extio_eventGet if subscribed and
+ *    run the registered callback otherwise
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "extio.h"
+#include "queue.h"
+
+/** event queue depth */
+#define EXTIO_QUEUE_DEPTH   (16)
+
+/** extio state
+ */
+typedef struct {
+  queue_t   events;                         /* pending subscribed events */
+  int       subscribed[EXTIO_INPUT_NUM];    /* subscription flags */
+  void      (*callback[EXTIO_INPUT_NUM])(void *); /* registered callbacks */
+  void      *pArg[EXTIO_INPUT_NUM];         /* callback arguments */
+} extio_t;
+
+static extio_t extio;
+
+/** initialize extio
+ * @return Zero on success
+ */
+int extio_init(isrDisp_t *pIsrDisp)
+{
+    memset(&extio, 0, sizeof(extio));
+    return queue_init(&extio.events, EXTIO_QUEUE_DEPTH);
+}
+
+/** subscribe to an event
+ * @return Zero on success
+ */
+int extio_eventSubscribe(extio_input event)
+{
+    if ( EXTIO_INPUT_NUM <= event ) {
+        return FAIL;
+    }
+    extio.subscribed[event] = 1;
+    return PASS;
+}
+
+/** get next subscribed event (non blocking)
+ * @return Zero if an event was returned, FAIL otherwise
+ */
+int extio_eventGet(extio_input *pEvent)
+{
+    void *pData = NULL;
+
+    if ( PASS != queue_get(&extio.events, &pData) ) {
+        return FAIL;
+    }
+    *pEvent = (extio_input)(long)pData;
+    return PASS;
+}
+
+/** register a callback for an event
+ * @return Zero on success
+ */
+int extio_callbackRegister(extio_input event, void (*callback)(void *), void *pArg)
+{
+    if ( EXTIO_INPUT_NUM <= event ) {
+        return FAIL;
+    }
+    extio.callback[event] = callback;
+    extio.pArg[event]     = pArg;
+    return PASS;
+}
+
+/** inject an event as if the input had changed
+ * @return Zero on success
+ */
+int extio_inject(extio_input event)
+{
+    if ( EXTIO_INPUT_NUM <= event ) {
+        return FAIL;
+    }
+    if ( NULL != extio.callback[event] ) {
+        extio.callback[event](extio.pArg[event]);
+    }
+    if ( extio.subscribed[event] ) {
+        return queue_put(&extio.events, (void *)(long)event);
+    }
+    return PASS;
+}
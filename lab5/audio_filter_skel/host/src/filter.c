@@ -0,0 +1,46 @@
+/**
+ *@file filter.c
+ *
+ *@brief
+ *  - host (x86 Linux) C reference of the libbfdsp fir_fr16 routine
+ *  - 1.15 multiply, wide accumulation, rounding and saturation on output
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "filter.h"
+
+/** FIR filter, 1.15 in and out, circular delay line
+ * @param input   input samples
+ * @param output  output samples
+ * @param length  number of samples
+ * @param s       filter state
+ */
+void fir_fr16(const fract16 input[], fract16 output[], int length, fir_state_fr16 *s)
+{
+    int         i, j;
+    int         pos = s->p - s->d;   // index of the next write
+    long long   acc;
+
+    for ( i = 0; i < length; i++ ) {
+        s->d[pos] = input[i];
+        acc = 0;
+        // h[0] applies to the newest sample
+        for ( j = 0; j < s->k; j++ ) {
+            acc += (long long)s->h[j] * s->d[(pos - j + s->k) % s->k];
+        }
+        acc = (acc + 0x4000) >> 15;
+        if ( acc > 0x7fff ) {
+            acc = 0x7fff;
+        } else if ( acc < -0x8000 ) {
+            acc = -0x8000;
+        }
+        output[i] = (fract16)acc;
+        pos = (pos + 1) % s->k;
+    }
+    s->p = s->d + pos;
+}
@@ -0,0 +1,2109 @@
+/**
+ *@file hostBench.c
+ *
+ *@brief
+ *  - host (x86 Linux) stress tests and micro benchmarks of the
+ *    pipeline building blocks
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <pthread.h>
+#include <time.h>
+#include <math.h>
+#include "tll_common.h"
+#include "hostBench.h"
+#include "spscRing.h"
+#include "bufferPool.h"
+#include "audioHal.h"
+#include "audioHalSim.h"
+#include "resampler.h"
+#include "q15.h"
+#include "firDesign.h"
+#include "audioFilter.h"
+#include "multirate.h"
+#include "eq.h"
+#include "limiter.h"
+#include "audioPlayer.h"
+#include "goertzel.h"
+#include "dtmf.h"
+#include "fftConv.h"
+#include "echo.h"
+#include "firBlock.h"
+
+/**
+ * @def HOSTBENCH_BATCH_MAX
+ * @brief largest batch used by the ring stress test
+ */
+#define HOSTBENCH_BATCH_MAX (8)
+
+/**
+ * @def HOSTBENCH_THREADS_MAX
+ * @brief largest number of contending threads in the pool benchmark
+ */
+#define HOSTBENCH_THREADS_MAX (4)
+
+/**
+ * @def HOSTBENCH_RESAMPLE_LEN
+ * @brief input samples of the resampler reference check
+ */
+#define HOSTBENCH_RESAMPLE_LEN (20000)
+
+/**
+ * @def HOSTBENCH_Q15_LEN
+ * @brief samples per block of the q15 benchmark (odd, so the scalar tail runs)
+ */
+#define HOSTBENCH_Q15_LEN (1021)
+
+/**
+ * @def HOSTBENCH_MULTIRATE_LEN
+ * @brief input samples of the multirate reference check
+ */
+#define HOSTBENCH_MULTIRATE_LEN (8192)
+
+/** state shared by the ring stress threads */
+typedef struct {
+  spscRing_t    ring;
+  unsigned long count;      /* elements to transfer */
+  unsigned long nErrors;    /* out of order or corrupted elements */
+  unsigned long nFull;      /* producer found the ring full */
+  unsigned long nEmpty;     /* consumer found the ring empty */
+} hostBench_ring_t;
+
+/** bufferPool benchmark thread */
+typedef struct {
+  bufferPool_t  *pPool;
+  int           context;    /* AUDIOHAL_CTX_* the thread runs as */
+  unsigned long count;      /* acquire/release pairs */
+  unsigned long nFail;      /* acquire found no chunk */
+} hostBench_pool_t;
+
+/** @return monotonic time in seconds */
+static double hostBench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** wait a little for the other side, it may share the only CPU */
+static void hostBench_backoff(void)
+{
+    struct timespec ts = { 0, 1000 };
+
+    nanosleep(&ts, NULL);
+}
+
+/** small private PRNG, rand() is not thread safe */
+static unsigned int hostBench_rand(unsigned int *pSeed)
+{
+    *pSeed = *pSeed * 1103515245u + 12345u;
+    return *pSeed >> 16;
+}
+
+/** ring producer: pushes 1..count, element value is its sequence number */
+static void *hostBench_ringProducer(void *pArg)
+{
+    hostBench_ring_t   *pThis = (hostBench_ring_t *)pArg;
+    void               *batch[HOSTBENCH_BATCH_MAX];
+    unsigned long       next  = 1;
+    unsigned int        seed  = 1;
+    int                 n;
+    int                 i;
+
+    while ( next <= pThis->count ) {
+        n = 1 + hostBench_rand(&seed) % HOSTBENCH_BATCH_MAX;
+        if ( (unsigned long)n > pThis->count - next + 1 ) {
+            n = pThis->count - next + 1;
+        }
+        for ( i = 0; i < n; i++ ) {
+            batch[i] = (void *)(next + i);
+        }
+        if ( 1 == n ) {
+            n = PASS == spscRing_push(&pThis->ring, batch[0]) ? 1 : 0;
+        } else {
+            n = spscRing_pushBatch(&pThis->ring, batch, n);
+        }
+        if ( 0 == n ) {
+            pThis->nFull++;
+            hostBench_backoff();
+        }
+        next += n;
+    }
+    return NULL;
+}
+
+/** ring consumer: pops until count elements arrived, checks order */
+static void *hostBench_ringConsumer(void *pArg)
+{
+    hostBench_ring_t   *pThis = (hostBench_ring_t *)pArg;
+    void               *batch[HOSTBENCH_BATCH_MAX];
+    unsigned long       expect = 1;
+    unsigned int        seed   = 2;
+    int                 n;
+    int                 i;
+
+    while ( expect <= pThis->count ) {
+        n = 1 + hostBench_rand(&seed) % HOSTBENCH_BATCH_MAX;
+        if ( 1 == n ) {
+            n = PASS == spscRing_pop(&pThis->ring, &batch[0]) ? 1 : 0;
+        } else {
+            n = spscRing_popBatch(&pThis->ring, batch, n);
+        }
+        if ( 0 == n ) {
+            pThis->nEmpty++;
+            hostBench_backoff();
+        }
+        for ( i = 0; i < n; i++, expect++ ) {
+            if ( (void *)expect != batch[i] ) {
+                pThis->nErrors++;
+                expect = (unsigned long)batch[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+/** stress spscRing with a producer and a consumer thread
+ *   - producer pushes a sequence number stream in random batch sizes,
+ *     consumer pops in random batch sizes and checks the order
+ *   - repeated for several ring sizes
+ *
+ * @param count  number of elements per ring size
+ *
+ * @return Zero if every element arrived once and in order, FAIL otherwise
+ */
+int hostBench_spscRing(unsigned long count)
+{
+    static hostBench_ring_t bench;
+    static const unsigned int sizes[] = { 1, 2, 8, SPSCRING_SIZE_MAX };
+    pthread_t           producer;
+    pthread_t           consumer;
+    unsigned int        s;
+    double              t;
+    int                 status = PASS;
+
+    for ( s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++ ) {
+        memset(&bench, 0, sizeof(bench));
+        spscRing_init(&bench.ring, sizes[s]);
+        bench.count = count;
+
+        t = hostBench_now();
+        pthread_create(&consumer, NULL, hostBench_ringConsumer, &bench);
+        pthread_create(&producer, NULL, hostBench_ringProducer, &bench);
+        pthread_join(producer, NULL);
+        pthread_join(consumer, NULL);
+        t = hostBench_now() - t;
+
+        if ( 0 != bench.nErrors || 0 != spscRing_count(&bench.ring) ) {
+            status = FAIL;
+        }
+        printf("[BENCH]: spscRing size %2u: %lu elements, %lu errors, %.1f ns/element,"
+               " full %lu, empty %lu, level avg %.2f max %u\n",
+               sizes[s], count, bench.nErrors, t * 1e9 / count, bench.nFull, bench.nEmpty,
+               bench.ring.nPut ? (double)bench.ring.levelSum / bench.ring.nPut : 0.0,
+               bench.ring.levelMax);
+    }
+    printf("[BENCH]: spscRing stress %s\n", PASS == status ? "passed" : "FAILED");
+    return status;
+}
+
+/** pool thread: acquires 1..4 chunks, touches and releases them */
+static void *hostBench_poolWorker(void *pArg)
+{
+    hostBench_pool_t   *pThis = (hostBench_pool_t *)pArg;
+    chunk_t            *pChunk[4];
+    unsigned int        seed  = pThis->context + 3;
+    unsigned long       done  = 0;
+    int                 n;
+    int                 i;
+
+    audioHalSim_setContext(pThis->context);
+    while ( done < pThis->count ) {
+        n = 1 + hostBench_rand(&seed) % 4;
+        for ( i = 0; i < n; i++ ) {
+            if ( PASS != bufferPool_acquire(pThis->pPool, &pChunk[i]) ) {
+                pThis->nFail++;
+                break;
+            }
+            pChunk[i]->len = i;
+        }
+        n = i;
+        for ( i = 0; i < n; i++ ) {
+            bufferPool_release(pThis->pPool, pChunk[i]);
+        }
+        done += n ? n : 1;
+    }
+    return NULL;
+}
+
+/** run pool threads and report ns per acquire/release pair
+ * @return Zero if all chunks are back exactly once
+ */
+static int hostBench_poolRun(bufferPool_t *pPool, const char *pName,
+                             const int context[], int nThreads, unsigned long count)
+{
+    hostBench_pool_t    worker[HOSTBENCH_THREADS_MAX];
+    pthread_t           thread[HOSTBENCH_THREADS_MAX];
+    unsigned char       seen[CHUNK_NUM_MAX];
+    unsigned long       nFail = 0;
+    chunk_t             *pChunk;
+    double              t;
+    int                 nFree = 0;
+    int                 c;
+    int                 i;
+
+    static unsigned char arena[BUFFERPOOL_ARENA_SIZE(SAMPLE_SIZE, 32)];
+
+    bufferPool_init(pPool, SAMPLE_SIZE, 32, arena, sizeof(arena));
+    t = hostBench_now();
+    for ( i = 0; i < nThreads; i++ ) {
+        worker[i].pPool   = pPool;
+        worker[i].context = context[i];
+        worker[i].count   = count;
+        worker[i].nFail   = 0;
+        pthread_create(&thread[i], NULL, hostBench_poolWorker, &worker[i]);
+    }
+    for ( i = 0; i < nThreads; i++ ) {
+        pthread_join(thread[i], NULL);
+        nFail += worker[i].nFail;
+    }
+    t = hostBench_now() - t;
+
+    // drain magazines and free list, every chunk must show up once
+    memset(seen, 0, sizeof(seen));
+    for ( c = AUDIOHAL_CTX_NONE; c < AUDIOHAL_CTX_NUM; c++ ) {
+        audioHalSim_setContext(c);
+        while ( PASS == bufferPool_acquire(pPool, &pChunk) ) {
+            seen[pChunk - pPool->buffer]++;
+            nFree++;
+        }
+    }
+    audioHalSim_setContext(AUDIOHAL_CTX_MAIN);
+    for ( i = 0; i < pPool->count; i++ ) {
+        if ( 1 != seen[i] ) {
+            nFree = -1;
+        }
+    }
+
+    printf("[BENCH]: bufferPool %-22s %d thread(s): %6.1f ns/op, empty %lu, magazine hit %lu miss %lu, %s\n",
+           pName, nThreads, t * 1e9 / (2.0 * count * nThreads), nFail,
+           pPool->mag[AUDIOHAL_CTX_MAIN].nHit + pPool->mag[AUDIOHAL_CTX_ISR].nHit,
+           pPool->mag[AUDIOHAL_CTX_MAIN].nMiss + pPool->mag[AUDIOHAL_CTX_ISR].nMiss,
+           pPool->count == nFree ? "ok" : "CHUNKS LOST");
+    return pPool->count == nFree ? PASS : FAIL;
+}
+
+/** measure bufferPool acquire/release ns/op
+ *   - one thread through its magazine and through the free list only
+ *   - threads contending on the free list, and a main loop plus an
+ *     ISR context thread as in the audio pipeline
+ *   - checks at the end that every chunk is back exactly once
+ *
+ * @param count  acquire/release pairs per thread
+ *
+ * @return Zero if no chunk was lost or duplicated, FAIL otherwise
+ */
+int hostBench_bufferPool(unsigned long count)
+{
+    static bufferPool_t pool;
+    static const int    magazine[]  = { AUDIOHAL_CTX_MAIN };
+    static const int    freeList[]  = { AUDIOHAL_CTX_NONE, AUDIOHAL_CTX_NONE,
+                                        AUDIOHAL_CTX_NONE, AUDIOHAL_CTX_NONE };
+    static const int    pipeline[]  = { AUDIOHAL_CTX_MAIN, AUDIOHAL_CTX_ISR };
+    int                 status      = PASS;
+
+    status |= hostBench_poolRun(&pool, "magazine",            magazine, 1, count);
+    status |= hostBench_poolRun(&pool, "free list",           freeList, 1, count);
+    status |= hostBench_poolRun(&pool, "free list contended", freeList, 2, count);
+    status |= hostBench_poolRun(&pool, "free list contended", freeList, 4, count);
+    status |= hostBench_poolRun(&pool, "main + ISR magazines", pipeline, 2, count);
+
+    printf("[BENCH]: bufferPool %s\n", PASS == status ? "passed" : "FAILED");
+    return PASS == status ? PASS : FAIL;
+}
+
+/** reference output n of a resampler with cleared history, straight from
+ *  the polyphase equation over the whole input
+ */
+static fract16 hostBench_resampleRef(const resampler_t *pRs, const fract16 *pIn, long n)
+{
+    long long   pos     = (long long)n * pRs->down;
+    long        newest  = (long)(pos / pRs->up);
+    int         phase   = (int)(pos % pRs->up);
+    int         acc     = 0;
+    int         t;
+
+    for ( t = 0; t < pRs->taps && newest - t >= 0; t++ ) {
+        acc += pRs->coeff[phase * pRs->taps + pRs->taps - 1 - t] * pIn[newest - t];
+    }
+    acc = (acc + (1 << 14)) >> 15;
+    return acc > 0x7fff ? 0x7fff : acc < -0x8000 ? -0x8000 : acc;
+}
+
+/** one rate pair of the resampler benchmark */
+static int hostBench_resampleRun(unsigned int inRate, unsigned int outRate, unsigned long count)
+{
+    static resampler_t  rs;
+    static fract16      in[HOSTBENCH_RESAMPLE_LEN];
+    static fract16      out[HOSTBENCH_RESAMPLE_LEN * 8];
+    static fract16      block[RESAMPLER_BLOCK * 8];
+    unsigned int        seed    = inRate ^ outRate;
+    long                nOut    = 0;
+    long                nErr    = 0;
+    long                i;
+    int                 done    = 0;
+    double              t0, sec, peak = 0.0;
+    unsigned long       n;
+
+    if ( PASS != resampler_init(&rs, inRate, outRate, RESAMPLER_TAPS) ) {
+        return FAIL;
+    }
+
+    // streaming in random input blocks and output limits against the reference
+    for ( i = 0; i < HOSTBENCH_RESAMPLE_LEN; i++ ) {
+        in[i] = (fract16)(hostBench_rand(&seed) - 0x8000);
+    }
+    while ( done < HOSTBENCH_RESAMPLE_LEN ) {
+        int length = 1 + hostBench_rand(&seed) % 700;
+        int room   = 1 + hostBench_rand(&seed) % 900;
+
+        if ( length > HOSTBENCH_RESAMPLE_LEN - done ) {
+            length = HOSTBENCH_RESAMPLE_LEN - done;
+        }
+        nOut += resampler_process(&rs, &in[done], &length, &out[nOut], room);
+        done += length;
+    }
+    for ( i = 0; i < nOut; i++ ) {
+        if ( out[i] != hostBench_resampleRef(&rs, in, i) ) {
+            nErr++;
+        }
+    }
+
+    // throughput and gain of a full scale tone at a tenth of the lower rate
+    resampler_init(&rs, inRate, outRate, RESAMPLER_TAPS);
+    for ( i = 0; i < RESAMPLER_BLOCK; i++ ) {
+        in[i] = (fract16)(16384.0 * sin(2.0 * M_PI * 0.1 * (inRate < outRate ? inRate : outRate)
+                                        / inRate * i));
+    }
+    t0 = hostBench_now();
+    for ( n = 0, i = 0; n < count; n += RESAMPLER_BLOCK ) {
+        int length = RESAMPLER_BLOCK;
+        int m      = resampler_process(&rs, in, &length, block, RESAMPLER_BLOCK * 8);
+
+        i += m;
+        if ( n + RESAMPLER_BLOCK >= count ) {
+            int j;
+            for ( j = m / 2; j < m; j++ ) {
+                peak = abs(block[j]) > peak ? abs(block[j]) : peak;
+            }
+        }
+    }
+    sec = hostBench_now() - t0;
+
+    printf("[BENCH]: resample %5u -> %5u (%3d/%3d): %6.2f ns/output %7.1f Ms/s,"
+           " tone %+5.2f dB, %ld of %ld differ\n",
+           inRate, outRate, rs.up, rs.down, sec * 1e9 / i, i / sec * 1e-6,
+           20.0 * log10(peak / 16384.0), nErr, nOut);
+    return 0 == nErr ? PASS : FAIL;
+}
+
+/** measure resampler ns per output and check it against the reference
+ *   - rate pairs of the player (8k/16k content to 44.1k/48k codec)
+ *
+ * @param count  input samples per rate pair
+ *
+ * @return Zero if streaming output equals the reference, FAIL otherwise
+ */
+int hostBench_resampler(unsigned long count)
+{
+    static const unsigned int rates[][2] = {
+        {  8000, 16000 }, { 16000, 44100 }, {  8000, 48000 }, { 44100, 48000 },
+        { 48000, 44100 }, { 48000,  8000 }, { 16000, 16000 },
+    };
+    int                 status  = PASS;
+    unsigned int        i;
+
+    for ( i = 0; i < sizeof(rates) / sizeof(rates[0]); i++ ) {
+        status |= hostBench_resampleRun(rates[i][0], rates[i][1], count);
+    }
+    printf("[BENCH]: resampler %s\n", PASS == status ? "passed" : "FAILED");
+    return PASS == status ? PASS : FAIL;
+}
+
+/** 1.15 reference: saturate a 64 bit value */
+static fract16 hostBench_q15Sat(long long v)
+{
+    return v > Q15_MAX ? Q15_MAX : v < Q15_MIN ? Q15_MIN : (fract16)v;
+}
+
+/** random 1.15 value, every 16th one a range edge */
+static fract16 hostBench_q15Rand(unsigned int *pSeed)
+{
+    static const fract16 edge[] = { Q15_MIN, Q15_MIN + 1, -1, 0, 1, Q15_MAX };
+    unsigned int r = hostBench_rand(pSeed);
+
+    if ( 0 == (r & 0xf0000) ) {
+        return edge[r % (sizeof(edge) / sizeof(edge[0]))];
+    }
+    return (fract16)r;
+}
+
+/** check the scalar, packed and accumulator operations against 64 bit
+ *  reference arithmetic, returns the number of mismatches
+ */
+static long hostBench_q15Scalar(unsigned long count)
+{
+    unsigned int    seed    = 15;
+    long            nErr    = 0;
+    unsigned long   i;
+
+    for ( i = 0; i < count; i++ ) {
+        fract16     a = hostBench_q15Rand(&seed);
+        fract16     b = hostBench_q15Rand(&seed);
+        fract16     c = hostBench_q15Rand(&seed);
+        fract16     d = hostBench_q15Rand(&seed);
+        long long   p = (long long)a * b;
+        q15x2_t     x = q15x2_compose(a, b);
+        q15x2_t     y = q15x2_compose(c, d);
+        q15_acc_t   acc;
+        long long   ref;
+        int         k;
+
+        nErr += q15_add(a, b)  != hostBench_q15Sat((long long)a + b);
+        nErr += q15_sub(a, b)  != hostBench_q15Sat((long long)a - b);
+        nErr += q15_neg(a)     != hostBench_q15Sat(-(long long)a);
+        nErr += q15_abs(a)     != hostBench_q15Sat(a < 0 ? -(long long)a : a);
+        nErr += q15_mul(a, b)  != hostBench_q15Sat(p >> 15);
+        nErr += q15_mulr(a, b) != hostBench_q15Sat((p + 0x4000) >> 15);
+
+        nErr += q15x2_hi(x) != a || q15x2_lo(x) != b;
+        nErr += q15x2_add(x, y)  != q15x2_compose(q15_add(a, c), q15_add(b, d));
+        nErr += q15x2_sub(x, y)  != q15x2_compose(q15_sub(a, c), q15_sub(b, d));
+        nErr += q15x2_mul(x, y)  != q15x2_compose(q15_mul(a, c), q15_mul(b, d));
+        nErr += q15x2_mulr(x, y) != q15x2_compose(q15_mulr(a, c), q15_mulr(b, d));
+
+        // a run of MACs saturates at 40 bits, an MSU comes back from there
+        acc = 0;
+        ref = 0;
+        for ( k = 0; k < 8; k++ ) {
+            long long pk = (Q15_MIN == a && Q15_MIN == c) ? 0x7fffffffLL : 2LL * a * c;
+
+            acc = q15_mac(acc, a, c);
+            ref += pk;
+            ref = ref > Q15_ACC_MAX ? Q15_ACC_MAX : ref < Q15_ACC_MIN ? Q15_ACC_MIN : ref;
+        }
+        acc = q15_msu(acc, b, d);
+        ref -= (Q15_MIN == b && Q15_MIN == d) ? 0x7fffffffLL : 2LL * b * d;
+        nErr += acc != q15_accSat(ref);
+
+        // rounding modes on a 1.31 value with a random fraction and exact ties
+        acc = ((long long)a << 16) | (0 == (i & 3) ? 0x8000 : (unsigned short)d);
+        ref = acc >> 16;
+        nErr += q15_accExtract(acc, Q15_ROUND_TRUNC) != hostBench_q15Sat(ref);
+        nErr += q15_accExtract(acc, Q15_ROUND_BIASED)
+                != hostBench_q15Sat(ref + ((acc & 0xffff) >= 0x8000));
+        nErr += q15_accExtract(acc, Q15_ROUND_CONVERGENT)
+                != hostBench_q15Sat(ref + ((acc & 0xffff) > 0x8000
+                                           || ((acc & 0xffff) == 0x8000 && (ref & 1))));
+    }
+    return nErr;
+}
+
+/** check q15 scalar and packed operations against 64 bit references and
+ *  the block operations against their scalar loops, measure ns/sample
+ *   - the block operations use SSE2 / SSSE3 / AVX2 as compiled
+ *     (HOST_ARCH), the scalar loops are what the target tail runs
+ *
+ * @param count  samples per operation
+ *
+ * @return Zero if every result is bit-exact, FAIL otherwise
+ */
+int hostBench_q15(unsigned long count)
+{
+    static fract16  a[HOSTBENCH_Q15_LEN];
+    static fract16  b[HOSTBENCH_Q15_LEN];
+    static fract16  ref[HOSTBENCH_Q15_LEN];
+    static fract16  out[HOSTBENCH_Q15_LEN];
+    static const char *names[] = { "vecAdd", "vecMulr", "vecScaleAdd" };
+    unsigned int    seed    = 1;
+    unsigned long   nBlocks = (count + HOSTBENCH_Q15_LEN - 1) / HOSTBENCH_Q15_LEN;
+    long            nErr;
+    unsigned long   n;
+    int             op, i;
+
+    nErr = hostBench_q15Scalar(count);
+    printf("[BENCH]: q15 scalar/packed/accumulator: %ld of %lu differ\n", nErr, count);
+
+    for ( op = 0; op < 3; op++ ) {
+        double      tScalar, tBlock;
+        long        nDiff   = 0;
+        fract16     gain    = 0;
+
+        // correctness on fresh random data, odd lengths for the tails
+        for ( n = 0; n < nBlocks; n++ ) {
+            int len = 1 + hostBench_rand(&seed) % HOSTBENCH_Q15_LEN;
+
+            for ( i = 0; i < len; i++ ) {
+                a[i] = hostBench_q15Rand(&seed);
+                b[i] = hostBench_q15Rand(&seed);
+                ref[i] = out[i] = a[i];
+            }
+            gain = hostBench_q15Rand(&seed);
+            switch ( op ) {
+            case 0:
+                q15_vecAdd(out, a, b, len);
+                for ( i = 0; i < len; i++ ) ref[i] = hostBench_q15Sat((long long)a[i] + b[i]);
+                break;
+            case 1:
+                q15_vecMulr(out, a, b, len);
+                for ( i = 0; i < len; i++ ) ref[i] = q15_mulr(a[i], b[i]);
+                break;
+            default:
+                q15_vecScaleAdd(out, b, gain, len);
+                for ( i = 0; i < len; i++ ) ref[i] = q15_add(ref[i], q15_mulr(b[i], gain));
+                break;
+            }
+            for ( i = 0; i < len; i++ ) {
+                nDiff += out[i] != ref[i];
+            }
+        }
+        nErr += nDiff;
+
+        // timing on full blocks, scalar loops first
+        tScalar = hostBench_now();
+        for ( n = 0; n < nBlocks; n++ ) {
+            for ( i = 0; i < HOSTBENCH_Q15_LEN; i++ ) {
+                switch ( op ) {
+                case 0:  out[i] = q15_add(a[i], b[i]); break;
+                case 1:  out[i] = q15_mulr(a[i], b[i]); break;
+                default: out[i] = q15_add(out[i], q15_mulr(b[i], gain)); break;
+                }
+            }
+            a[n % HOSTBENCH_Q15_LEN] ^= out[0];     // keep the loop live
+        }
+        tScalar = hostBench_now() - tScalar;
+        tBlock = hostBench_now();
+        for ( n = 0; n < nBlocks; n++ ) {
+            switch ( op ) {
+            case 0:  q15_vecAdd(out, a, b, HOSTBENCH_Q15_LEN); break;
+            case 1:  q15_vecMulr(out, a, b, HOSTBENCH_Q15_LEN); break;
+            default: q15_vecScaleAdd(out, b, gain, HOSTBENCH_Q15_LEN); break;
+            }
+            a[n % HOSTBENCH_Q15_LEN] ^= out[0];
+        }
+        tBlock = hostBench_now() - tBlock;
+
+        n = nBlocks * HOSTBENCH_Q15_LEN;
+        printf("[BENCH]: q15 %-12s scalar %6.3f ns/sample, block %6.3f ns/sample (x%.1f),"
+               " %ld differ\n", names[op], tScalar * 1e9 / n, tBlock * 1e9 / n,
+               tBlock > 0 ? tScalar / tBlock : 0.0, nDiff);
+    }
+    printf("[BENCH]: q15 %s\n", 0 == nErr ? "passed" : "FAILED");
+    return 0 == nErr ? PASS : FAIL;
+}
+
+/** gain in dB of a 1.15 filter at a normalized frequency */
+static double hostBench_firGain(const fract16 *pH, int taps, double f)
+{
+    double  re = 0.0;
+    double  im = 0.0;
+    int     n;
+
+    for ( n = 0; n < taps; n++ ) {
+        re += pH[n] * cos(2.0 * M_PI * f * n);
+        im -= pH[n] * sin(2.0 * M_PI * f * n);
+    }
+    return 20.0 * log10(sqrt(re * re + im * im) / 32768.0 + 1e-9);
+}
+
+/** check the designer on the audioFilter specs at several rates, measure
+ *  design and cache lookup cost
+ *   - pass band gain (0 dB at the reference frequency), level at the
+ *     cut-offs (-6 dB within 1 dB), worst stop band level beyond the
+ *     Kaiser transition width, a band-pass narrower than that width is
+ *     widened first (firDesign_fitBand) as audioFilter_setRate does
+ *   - cached sets equal fresh designs, rate switches only miss once
+ *
+ * @param count  cache lookups timed
+ *
+ * @return Zero if every design meets its attenuation, FAIL otherwise
+ */
+int hostBench_firDesign(unsigned long count)
+{
+    static const unsigned int rates[] = { 8000, 16000, 22050, 44100, 48000 };
+    static const char *names[] = { "lowpass", "highpass", "bandpass", "bandstop" };
+    firDesign_spec_t    spec[3] = {
+        { FIRDESIGN_HIGHPASS, 0, AUDIOFILTER_HIGHPASS_HZ, 0, FILTER_COEFFICIENTS, AUDIOFILTER_ATTEN },
+        { FIRDESIGN_LOWPASS,  0, AUDIOFILTER_LOWPASS_HZ,  0, FILTER_COEFFICIENTS, AUDIOFILTER_ATTEN },
+        { FIRDESIGN_BANDPASS, 0, AUDIOFILTER_BANDLOW_HZ, AUDIOFILTER_BANDHIGH_HZ,
+          FILTER_COEFFICIENTS, AUDIOFILTER_ATTEN },
+    };
+    static firDesign_cache_t cache;
+    fract16             h[FIRDESIGN_TAPS_MAX];
+    int                 status  = PASS;
+    unsigned long       n;
+    double              t, tDesign, tLookup;
+    unsigned int        r;
+    int                 i, k;
+
+    firDesign_cacheInit(&cache);
+    for ( r = 0; r < sizeof(rates) / sizeof(rates[0]); r++ ) {
+        for ( i = 0; i < 3; i++ ) {
+            firDesign_spec_t sp;
+            firDesign_spec_t *pS    = &sp;
+            const fract16   *pC;
+            double          rate    = rates[r];
+            double          stop    = -200.0;
+            int             widened;
+            double          width, f1, f2, f0, f;
+
+            // as audioFilter_setRate: a narrow band is widened to the transition
+            spec[i].rate = rates[r];
+            sp           = spec[i];
+            widened      = firDesign_fitBand(pS);
+            width = (pS->atten - 7.95) / (14.36 * (pS->taps - 1));
+            f1    = pS->f1 / rate;
+            f2    = pS->f2 / rate;
+            f0    = FIRDESIGN_HIGHPASS == pS->shape ? 0.5
+                  : FIRDESIGN_BANDPASS == pS->shape ? (f1 + f2) / 2 : 0.0;
+            pC = firDesign_get(&cache, pS);
+            if ( NULL == pC || PASS != firDesign_design(pS, h)
+              || 0 != memcmp(pC, h, pS->taps * sizeof(fract16)) ) {
+                printf("[BENCH]: design %s at %u Hz failed\n", names[pS->shape], pS->rate);
+                status = FAIL;
+                continue;
+            }
+            for ( f = 0.0; f <= 0.5; f += 0.0005 ) {
+                int inStop = FIRDESIGN_LOWPASS == pS->shape  ? f > f1 + width
+                           : FIRDESIGN_HIGHPASS == pS->shape ? f < f1 - width
+                           : f < f1 - width || f > f2 + width;
+                double g = hostBench_firGain(pC, pS->taps, f);
+
+                if ( inStop && g > stop ) {
+                    stop = g;
+                }
+            }
+            printf("[BENCH]: design %-8s %5u Hz: pass %+5.2f dB, cut-off %+6.2f dB",
+                   names[pS->shape], pS->rate, hostBench_firGain(pC, pS->taps, f0),
+                   hostBench_firGain(pC, pS->taps, f1));
+            if ( FIRDESIGN_BANDPASS == pS->shape ) {
+                printf(" / %+6.2f dB", hostBench_firGain(pC, pS->taps, f2));
+            }
+            printf(", stop %6.1f dB", stop);
+            if ( widened ) {
+                printf(" (band widened to %u .. %u Hz)", pS->f1, pS->f2);
+            }
+            printf("\n");
+            if ( stop > -(pS->atten - 3) || fabs(hostBench_firGain(pC, pS->taps, f0)) > 0.2
+              || fabs(hostBench_firGain(pC, pS->taps, f1) + 6.0) > 1.0
+              || (FIRDESIGN_BANDPASS == pS->shape
+                  && fabs(hostBench_firGain(pC, pS->taps, f2) + 6.0) > 1.0) ) {
+                status = FAIL;
+            }
+        }
+    }
+
+    // cost: fresh design vs lookup of a cached set
+    t = hostBench_now();
+    for ( k = 0; k < 100; k++ ) {
+        firDesign_design(&spec[k % 3], h);
+    }
+    tDesign = (hostBench_now() - t) / 100;
+    t = hostBench_now();
+    for ( n = 0; n < count; n++ ) {
+        if ( NULL == firDesign_get(&cache, &spec[n % 3]) ) {
+            status = FAIL;
+        }
+    }
+    tLookup = count ? (hostBench_now() - t) / count : 0.0;
+
+    // rate switches between two rates: three misses per new rate only
+    firDesign_cacheInit(&cache);
+    for ( k = 0; k < 10; k++ ) {
+        for ( i = 0; i < 3; i++ ) {
+            spec[i].rate = k & 1 ? 48000 : 16000;
+            firDesign_get(&cache, &spec[i]);
+        }
+    }
+    printf("[BENCH]: design %.1f us per %d tap set, cached lookup %.1f ns;"
+           " 10 rate switches: %lu hits, %lu misses\n",
+           tDesign * 1e6, FILTER_COEFFICIENTS, tLookup * 1e9, cache.hits, cache.misses);
+    if ( 6 != cache.misses ) {
+        status = FAIL;
+    }
+    printf("[BENCH]: firDesign %s\n", PASS == status ? "passed" : "FAILED");
+    return status;
+}
+
+/** direct form reference of one multirate object on a whole signal from
+ *  silence, stage by stage; returns the number of outputs
+ */
+static int hostBench_multirateRef(const multirate_t *pMr, const fract16 *pIn, int length,
+                                  fract16 *pOut)
+{
+    static fract16  buf[2][HOSTBENCH_MULTIRATE_LEN * MULTIRATE_FACTOR_MAX];
+    int             hb[MULTIRATE_HB_TAPS] = { 0 };
+    const fract16   *pX = pIn;
+    int             n = length;
+    int             st, i, k, t;
+
+    if ( !pMr->halfband ) {
+        int T = pMr->taps;
+        int P = MULTIRATE_POLY_TAPS;
+
+        n = 0;
+        for ( i = 0; i < length; i++ ) {
+            if ( MULTIRATE_DECIMATE == pMr->dir ) {
+                long long acc = 0;
+
+                if ( (i + 1) % pMr->factor ) {
+                    continue;
+                }
+                for ( t = 0; t < T; t++ ) {
+                    acc += i - T + 1 + t >= 0 ? pMr->coeff[t] * pIn[i - T + 1 + t] : 0;
+                }
+                pOut[n++] = hostBench_q15Sat((acc + (1 << 14)) >> 15);
+                continue;
+            }
+            for ( k = 0; k < pMr->factor; k++ ) {
+                long long acc = 0;
+
+                for ( t = 0; t < P && t <= i; t++ ) {
+                    acc += pMr->coeff[k * P + P - 1 - t] * pIn[i - t];
+                }
+                pOut[n++] = hostBench_q15Sat((acc + (1 << 14)) >> 15);
+            }
+        }
+        return n;
+    }
+
+    // full half-band filter including its zeros
+    hb[(MULTIRATE_HB_TAPS - 1) / 2] = 1 << 14;
+    for ( k = 0; k < MULTIRATE_HB_SIDE; k++ ) {
+        hb[(MULTIRATE_HB_TAPS - 1) / 2 - 1 - 2*k] = pMr->side[k];
+        hb[(MULTIRATE_HB_TAPS - 1) / 2 + 1 + 2*k] = pMr->side[k];
+    }
+    for ( st = 0; st < pMr->nStages; st++ ) {
+        fract16 *pY = st == pMr->nStages - 1 ? pOut : buf[st & 1];
+        int     m = 0;
+
+        if ( MULTIRATE_DECIMATE == pMr->dir ) {
+            for ( i = 1; i < n; i += 2 ) {
+                long long acc = 0;
+
+                for ( t = 0; t < MULTIRATE_HB_TAPS && t <= i; t++ ) {
+                    acc += hb[t] * pX[i - t];
+                }
+                pY[m++] = hostBench_q15Sat((acc + (1 << 14)) >> 15);
+            }
+        } else {
+            // zero stuffed input, gain 2
+            for ( i = 0; i < 2 * n; i++ ) {
+                long long acc = 0;
+
+                for ( t = 0; t < MULTIRATE_HB_TAPS && t <= i; t++ ) {
+                    acc += 0 == ((i - t) & 1) ? hb[t] * pX[(i - t) / 2] : 0;
+                }
+                pY[m++] = hostBench_q15Sat((acc + (1 << 13)) >> 14);
+            }
+        }
+        pX = pY;
+        n  = m;
+    }
+    return n;
+}
+
+/** check one multirate configuration and measure it */
+static int hostBench_multirateRun(multirate_dir_t dir, int factor, int halfband,
+                                  unsigned long count)
+{
+    static fract16  in[HOSTBENCH_MULTIRATE_LEN];
+    static fract16  out[HOSTBENCH_MULTIRATE_LEN * MULTIRATE_FACTOR_MAX];
+    static fract16  ref[HOSTBENCH_MULTIRATE_LEN * MULTIRATE_FACTOR_MAX];
+    multirate_t     mr;
+    unsigned int    seed    = 17;
+    int             nOut    = 0;
+    int             nRef, done, i;
+    long            nErr    = 0;
+    double          t, macs, inRms = 0.0, outRms = 0.0, fTone;
+    unsigned long   n;
+
+    if ( PASS != multirate_init(&mr, dir, factor, halfband) ) {
+        return FAIL;
+    }
+
+    // random blocks against the reference
+    for ( i = 0; i < HOSTBENCH_MULTIRATE_LEN; i++ ) {
+        in[i] = (fract16)(hostBench_rand(&seed) - 0x8000);
+    }
+    for ( done = 0; done < HOSTBENCH_MULTIRATE_LEN; ) {
+        int blk = 1 + hostBench_rand(&seed) % 700;
+
+        if ( blk > HOSTBENCH_MULTIRATE_LEN - done ) {
+            blk = HOSTBENCH_MULTIRATE_LEN - done;
+        }
+        if ( multirate_outMax(&mr, blk) + nOut > (int)(sizeof(out) / sizeof(out[0])) ) {
+            break;
+        }
+        nOut += multirate_process(&mr, &in[done], blk, &out[nOut]);
+        done += blk;
+    }
+    nRef = hostBench_multirateRef(&mr, in, HOSTBENCH_MULTIRATE_LEN, ref);
+    for ( i = 0; i < nOut && i < nRef; i++ ) {
+        nErr += out[i] != ref[i];
+    }
+    nErr += nOut != nRef;
+
+    // decimator: a tone 3/4 of the way from the low rate Nyquist
+    // frequency to the high one must not alias into the band
+    if ( MULTIRATE_DECIMATE == dir ) {
+        fTone = 0.5 / factor + 0.75 * (0.5 - 0.5 / factor);
+        multirate_init(&mr, dir, factor, halfband);
+        for ( i = 0; i < HOSTBENCH_MULTIRATE_LEN; i++ ) {
+            in[i] = (fract16)(16384.0 * sin(2.0 * M_PI * fTone * i));
+            inRms += (double)in[i] * in[i];
+        }
+        nOut = multirate_process(&mr, in, HOSTBENCH_MULTIRATE_LEN, out);
+        for ( i = nOut / 2; i < nOut; i++ ) {
+            outRms += (double)out[i] * out[i];
+        }
+        inRms  /= HOSTBENCH_MULTIRATE_LEN;
+        outRms /= nOut - nOut / 2;
+    }
+
+    // cost on the whole input, repeated up to count samples
+    multirate_init(&mr, dir, factor, halfband);
+    t = hostBench_now();
+    for ( n = 0; n < count; n += HOSTBENCH_MULTIRATE_LEN / MULTIRATE_FACTOR_MAX ) {
+        multirate_process(&mr, in, HOSTBENCH_MULTIRATE_LEN / MULTIRATE_FACTOR_MAX, out);
+    }
+    t = hostBench_now() - t;
+
+    if ( halfband ) {
+        // stage s runs at 1/2^s (decimate) or 2^s (interpolate) of the input rate
+        int s;
+
+        macs = 0.0;
+        for ( s = 0; s < mr.nStages; s++ ) {
+            macs += MULTIRATE_DECIMATE == dir ? (MULTIRATE_HB_SIDE + 1) / (double)(2 << s)
+                                              : MULTIRATE_HB_SIDE * (double)(1 << s);
+        }
+    } else {
+        macs = MULTIRATE_DECIMATE == dir ? (double)mr.taps / factor : (double)mr.taps;
+    }
+    printf("[BENCH]: multirate %-11s by %d %-9s: %5.2f ns/input, %5.2f MACs/input,",
+           MULTIRATE_DECIMATE == dir ? "decimate" : "interpolate", factor,
+           halfband ? "half-band" : "polyphase", count ? t * 1e9 / count : 0.0, macs);
+    if ( MULTIRATE_DECIMATE == dir ) {
+        printf(" alias %6.1f dB,", 10.0 * log10(outRms / inRms + 1e-12));
+    }
+    printf(" %ld of %d differ\n", nErr, nRef);
+    return 0 == nErr ? PASS : FAIL;
+}
+
+/** check and measure the multirate stages
+ *   - every factor and mode in both directions, streamed in random block
+ *     sizes against the direct form (zero stuffed input, every output
+ *     computed, half-band zeros multiplied)
+ *   - decimator alias rejection of a tone above the low rate band
+ *
+ * @param count  input samples timed per configuration
+ *
+ * @return Zero if every output equals the reference, FAIL otherwise
+ */
+int hostBench_multirate(unsigned long count)
+{
+    static const int factors[] = { 2, 4, 8 };
+    int             status = PASS;
+    int             dir, hb;
+    unsigned int    i;
+
+    for ( dir = 0; dir < 2; dir++ ) {
+        for ( i = 0; i < sizeof(factors) / sizeof(factors[0]); i++ ) {
+            for ( hb = 1; hb >= 0; hb-- ) {
+                status |= hostBench_multirateRun(0 == dir ? MULTIRATE_DECIMATE : MULTIRATE_INTERPOLATE,
+                                                 factors[i], hb, count);
+            }
+        }
+    }
+    printf("[BENCH]: multirate %s\n", PASS == status ? "passed" : "FAILED");
+    return PASS == status ? PASS : FAIL;
+}
+
+/**
+ * @def HOSTBENCH_EQ_RATE
+ * @brief sample rate of the EQ timing
+ */
+#define HOSTBENCH_EQ_RATE   (16000)
+
+/** tone at freq into buf, 2 s at rate (buf holds 2 * 48000) */
+static void hostBench_eqToneGen(fract16 *pBuf, int len, double freq, unsigned int rate)
+{
+    int         i;
+
+    for ( i = 0; i < len; i++ ) {
+        pBuf[i] = (fract16)floor(6000.0 * sin(2.0 * M_PI * freq * i / rate) + 0.5);
+    }
+}
+
+/** gain in dB from the tone to pBuf, rms over the second half */
+static double hostBench_eqToneGain(const fract16 *pBuf, int len, double freq, unsigned int rate)
+{
+    double      in = 0.0, out = 0.0;
+    int         i;
+
+    for ( i = len / 2; i < len; i++ ) {
+        double  x = floor(6000.0 * sin(2.0 * M_PI * freq * i / rate) + 0.5);
+
+        in  += x * x;
+        out += (double)pBuf[i] * pBuf[i];
+    }
+    return 10.0 * log10(out / in);
+}
+
+/** check and measure the equalizer
+ *   - every band at +12 and -12 dB alone through eq_process at 16 and
+ *     48 kHz: gain at the band frequency (shelves: half the gain at
+ *     mid-slope) within 0.5 dB; at 16 kHz also the error of a plain
+ *     Q15 and Q31 section, the base of EQ_Q31_BELOW
+ *   - cycles and ns per chunk and per sample with 1 .. EQ_BANDS bands
+ *     active, cost of a redesign
+ *
+ * @param count  chunks timed per band count
+ *
+ * @return Zero if every band meets its gain, FAIL otherwise
+ */
+int hostBench_eq(unsigned long count)
+{
+    static const unsigned int rates[] = { 16000, 48000 };
+    static fract16  tone[2 * 48000];
+    static fract16  buf[SAMPLE_SIZE / 2];
+    eq_t            eq;
+    chunk_t         chunk;
+    biquad_t        bq;
+    biquad_coeff_t  coeff;
+    unsigned int    seed   = 1;
+    int             status = PASS;
+    int             band, g, fmt, n, i;
+    unsigned int    r;
+    double          t;
+
+    for ( r = 0; r < sizeof(rates) / sizeof(rates[0]); r++ ) {
+        int     len = 2 * rates[r];
+
+        for ( band = 0; band < EQ_BANDS; band++ ) {
+            for ( g = -EQ_GAIN_MAX; g <= EQ_GAIN_MAX; g += 2 * EQ_GAIN_MAX ) {
+                const eq_band_t *pBand;
+                double          want, err;
+
+                eq_init(&eq, rates[r]);
+                eq_setGain(&eq, band, g);
+                pBand = &eq.band[band];
+                want  = BIQUAD_PEAKING == pBand->shape ? g : g / 2.0;
+                hostBench_eqToneGen(tone, len, pBand->freq, rates[r]);
+                chunk.s16_buff = tone;
+                chunk.size     = len * sizeof(fract16);
+                chunk.len      = chunk.size;
+                eq_process(&eq, &chunk);
+                err = hostBench_eqToneGain(tone, len, pBand->freq, rates[r]) - want;
+                printf("[BENCH]: eq %5u Hz band %d %5.0f Hz %+3d dB: error %+6.2f dB (%s, shift %d)",
+                       rates[r], band, pBand->freq, g, err,
+                       BIQUAD_Q31 == pBand->bq.format ? "Q31" : "Q15", pBand->shift);
+                if ( fabs(err) > 0.5 || 0 == pBand->active ) {
+                    status = FAIL;
+                }
+                if ( 0 != r ) {
+                    printf("\n");
+                    continue;
+                }
+                biquad_designGain(&coeff, pBand->shape, pBand->freq / rates[r], pBand->q, (float)g);
+                printf(", plain section");
+                for ( fmt = 0; fmt < 2; fmt++ ) {
+                    biquad_init(&bq, 0 == fmt ? BIQUAD_Q15 : BIQUAD_Q31);
+                    if ( PASS != biquad_addSection(&bq, &coeff) ) {
+                        continue;
+                    }
+                    hostBench_eqToneGen(tone, len, pBand->freq, rates[r]);
+                    biquad_filter(&bq, tone, tone, len);
+                    printf(" %s %+6.2f dB", 0 == fmt ? "Q15" : "Q31",
+                           hostBench_eqToneGain(tone, len, pBand->freq, rates[r]) - want);
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    // noise at -12 dBFS, a fresh chunk of it per call (in place filtering
+    // of one buffer would boost it into saturation)
+    for ( i = 0; i < (int)(sizeof(tone) / sizeof(tone[0])); i++ ) {
+        tone[i] = (fract16)((hostBench_rand(&seed) & 0x3fff) - 0x2000);
+    }
+    chunk.s16_buff = buf;
+    chunk.size     = sizeof(buf);
+    chunk.len      = sizeof(buf);
+    for ( n = 1; n <= EQ_BANDS; n++ ) {
+        eq_init(&eq, HOSTBENCH_EQ_RATE);
+        for ( band = 0; band < n; band++ ) {
+            eq_setGain(&eq, band, band & 1 ? -6 : 6);
+        }
+        eq_process(&eq, &chunk);    // designs
+        eq.calls[n]  = 0;
+        eq.cycles[n] = 0;
+        t = 0.0;
+        for ( i = 0; i < (int)count; i++ ) {
+            double t0;
+
+            memcpy(buf, &tone[(i % 64) * (SAMPLE_SIZE / 2)], sizeof(buf));
+            t0 = hostBench_now();
+            eq_process(&eq, &chunk);
+            t += hostBench_now() - t0;
+        }
+        printf("[BENCH]: eq %2d bands: %7.0f cycles/chunk %5.1f cycles/sample, %7.0f ns/chunk\n",
+               n, count ? (double)eq.cycles[n] / count : 0.0,
+               count ? (double)eq.cycles[n] / count / (SAMPLE_SIZE / 2) : 0.0,
+               count ? t * 1e9 / count : 0.0);
+    }
+
+    // parameter change: one band redesigned on the next chunk
+    t = 0.0;
+    for ( i = 0; i < (int)count; i++ ) {
+        double t0;
+
+        memcpy(buf, &tone[(i % 64) * (SAMPLE_SIZE / 2)], sizeof(buf));
+        t0 = hostBench_now();
+        eq_setGain(&eq, i % EQ_BANDS, i & 1 ? 3 : -3);
+        eq_process(&eq, &chunk);
+        t += hostBench_now() - t0;
+    }
+    printf("[BENCH]: eq 10 bands with one redesign: %7.0f ns/chunk, %lu designs\n",
+           count ? t * 1e9 / count : 0.0, eq.designs);
+
+    printf("[BENCH]: eq %s\n", PASS == status ? "passed" : "FAILED");
+    return PASS == status ? PASS : FAIL;
+}
+
+/**
+ * @def HOSTBENCH_LIMITER_CHUNK
+ * @brief samples per chunk of the limiter check
+ */
+#define HOSTBENCH_LIMITER_CHUNK (SAMPLE_SIZE / 2)
+
+/**
+ * @def HOSTBENCH_LIMITER_BOOST
+ * @brief boost in dB of the x4 stage of the limiter checks
+ */
+#define HOSTBENCH_LIMITER_BOOST (12)
+
+/** largest magnitude of n samples */
+static int hostBench_peak(const fract16 x[], int n)
+{
+    int         m = 0;
+    int         i;
+
+    for ( i = 0; i < n; i++ ) {
+        m = abs(x[i]) > m ? abs(x[i]) : m;
+    }
+    return m;
+}
+
+/** run one chunk of src through trim, an optional x4 boost and the limiter */
+static void hostBench_limiterChunk(limiter_t *pLim, fract16 buf[], const fract16 src[], int boost)
+{
+    chunk_t     chunk;
+    int         i;
+
+    chunk.s16_buff = buf;
+    chunk.size     = HOSTBENCH_LIMITER_CHUNK * sizeof(fract16);
+    chunk.len      = chunk.size;
+    memcpy(buf, src, chunk.size);
+    limiter_trim(pLim, &chunk);
+    if ( boost ) {
+        for ( i = 0; i < HOSTBENCH_LIMITER_CHUNK; i++ ) {
+            buf[i] = q15_sat(4 * buf[i]);
+        }
+    }
+    limiter_process(pLim, &chunk);
+}
+
+/** EQ with nBands overlapping bands at +12 dB from 1.2 kHz, echo set up
+ *  like the player's on a short line */
+static void hostBench_limiterStages(eq_t *pEq, echo_t *pEcho, fract16 line[], int lineLen, int nBands)
+{
+    int         i;
+
+    eq_init(pEq, 16000);
+    for ( i = 0; i < nBands; i++ ) {
+        eq_setGain(pEq, 6 + i, EQ_GAIN_MAX);
+    }
+    echo_init(pEcho, line, lineLen);
+    echo_setTap(pEcho, 0, 1000, 0x4000);
+    echo_setTap(pEcho, 1, 2300, 0x2666);
+    echo_setMix(pEcho, 0x6666, 0x2ccc);
+}
+
+/** run a tone through trim, echo, EQ and the limiter like the player,
+ *  count the samples saturated inside the chain */
+static int hostBench_limiterChain(eq_t *pEq, echo_t *pEcho, int headroom, int *pMaxOut)
+{
+    static fract16  buf[HOSTBENCH_LIMITER_CHUNK];
+    static const double freq[] = { 1200.0, 1600.0, 2100.0 };
+    limiter_t       lim;
+    chunk_t         chunk;
+    int             nSat = 0;
+    int             c, i, k;
+
+    chunk.s16_buff = buf;
+    chunk.size     = HOSTBENCH_LIMITER_CHUNK * sizeof(fract16);
+    chunk.len      = chunk.size;
+    limiter_init(&lim, 16000, headroom);
+    *pMaxOut = 0;
+    for ( c = 0; c < 32; c++ ) {
+        for ( i = 0; i < HOSTBENCH_LIMITER_CHUNK; i++ ) {
+            double  x = 0.0;
+
+            for ( k = 0; k < 3; k++ ) {
+                x += sin(2.0 * M_PI * freq[k] * (c * HOSTBENCH_LIMITER_CHUNK + i) / 16000);
+            }
+            buf[i] = (fract16)floor(32767.0 / 3 * x + 0.5);
+        }
+        limiter_trim(&lim, &chunk);
+        if ( NULL != pEcho ) {
+            echo_process(pEcho, &chunk);
+            nSat += 32767 <= hostBench_peak(buf, HOSTBENCH_LIMITER_CHUNK);
+        }
+        eq_process(pEq, &chunk);
+        nSat += 32767 <= hostBench_peak(buf, HOSTBENCH_LIMITER_CHUNK);
+        limiter_process(&lim, &chunk);
+        k        = hostBench_peak(buf, HOSTBENCH_LIMITER_CHUNK);
+        *pMaxOut = k > *pMaxOut ? k : *pMaxOut;
+    }
+    return nSat;
+}
+
+/** check and measure the look-ahead limiter
+ *   - quiet input: output is the input delayed by LIMITER_LOOKAHEAD
+ *     within the trimmed LSBs, bit-exact without headroom, also after
+ *     the headroom was switched on and off
+ *   - 1 kHz bursts boosted 12 dB over full scale: no sample above
+ *     LIMITER_CEILING, about 12 dB metered, the limited level close to
+ *     the ceiling; 4:1 compression of a steady tone above -20 dBFS
+ *   - two and three overlapping EQ bands at +12 dB, alone and with the
+ *     echo: with the headroom of the summed boost no stage saturates
+ *     and the output stays below LIMITER_CEILING
+ *   - cycles and ns per chunk at 16 and 48 kHz against the chunk period
+ *
+ * @param count  chunks timed per rate
+ *
+ * @return Zero if every check holds, FAIL otherwise
+ */
+int hostBench_limiter(unsigned long count)
+{
+    static const unsigned int rates[] = { 16000, 48000 };
+    static fract16  src[16 * HOSTBENCH_LIMITER_CHUNK];
+    static fract16  buf[HOSTBENCH_LIMITER_CHUNK];
+    const int       L      = LIMITER_LOOKAHEAD;
+    limiter_t       lim;
+    unsigned int    seed   = 1;
+    int             status = PASS;
+    int             nChunks = sizeof(src) / sizeof(src[0]) / HOSTBENCH_LIMITER_CHUNK;
+    int             headroom = limiter_boostHeadroom(HOSTBENCH_LIMITER_BOOST);
+    int             maxErr, maxOut, lateOut, now, peak, nExact;
+    int             c, i, r;
+    double          t, cycles, dB;
+
+    // quiet noise: a plain delay
+    limiter_init(&lim, 16000, headroom);
+    for ( i = 0; i < (int)(sizeof(src) / sizeof(src[0])); i++ ) {
+        src[i] = (fract16)((hostBench_rand(&seed) & 0x1fff) - 0x1000);
+    }
+    maxErr = 0;
+    for ( c = 0; c < nChunks; c++ ) {
+        hostBench_limiterChunk(&lim, buf, &src[c * HOSTBENCH_LIMITER_CHUNK], 0);
+        for ( i = 0; i < HOSTBENCH_LIMITER_CHUNK; i++ ) {
+            int n   = c * HOSTBENCH_LIMITER_CHUNK + i - L;
+            int err = abs(buf[i] - (0 > n ? 0 : src[n]));
+
+            maxErr = err > maxErr ? err : maxErr;
+        }
+    }
+    now = limiter_meter(&lim, &peak);
+    printf("[BENCH]: limiter -18 dBFS noise: delay %d samples, max error %d LSB, reduction %d (peak %d) 0.1 dB\n",
+           L, maxErr, now, peak);
+    if ( maxErr > 1 << (headroom - 1) || 0 != peak ) {
+        status = FAIL;
+    }
+
+    // no boosting stage: headroom 0 is a bit-exact delay; the headroom
+    // switched on and off again keeps the line within the trimmed LSBs
+    for ( i = 0; i < (int)(sizeof(src) / sizeof(src[0])); i++ ) {
+        src[i] = (fract16)((hostBench_rand(&seed) & 0xdfff) - 0x7000);
+    }
+    limiter_init(&lim, 16000, 0);
+    maxErr = 0;
+    nExact = 0;
+    for ( c = 0; c < nChunks; c++ ) {
+        if ( nChunks / 3 == c || 2 * nChunks / 3 == c ) {
+            limiter_setHeadroom(&lim, nChunks / 3 == c ? headroom : 0);
+        }
+        hostBench_limiterChunk(&lim, buf, &src[c * HOSTBENCH_LIMITER_CHUNK], 0);
+        for ( i = 0; i < HOSTBENCH_LIMITER_CHUNK; i++ ) {
+            int n   = c * HOSTBENCH_LIMITER_CHUNK + i - L;
+            int err = abs(buf[i] - (0 > n ? 0 : src[n]));
+
+            maxErr  = err > maxErr ? err : maxErr;
+            nExact += (nChunks / 3 > c || 2 * nChunks / 3 < c) && 0 != err;
+        }
+    }
+    now = limiter_meter(&lim, &peak);
+    printf("[BENCH]: limiter -1 dBFS noise, headroom 0 / %d / 0: %d samples differ without"
+           " headroom, max error %d LSB, reduction peak %d 0.1 dB\n",
+           6 * headroom, nExact, maxErr, peak);
+    if ( 0 != nExact || maxErr > 1 << (headroom - 1) || 0 != peak ) {
+        status = FAIL;
+    }
+
+    // full scale 1 kHz bursts, 4 chunks on / 4 off, boosted 12 dB
+    for ( i = 0; i < (int)(sizeof(src) / sizeof(src[0])); i++ ) {
+        src[i] = (i / HOSTBENCH_LIMITER_CHUNK) & 4 ? 0
+               : (fract16)floor(32767.0 * sin(2.0 * M_PI * 1000.0 * i / 16000) + 0.5);
+    }
+    limiter_init(&lim, 16000, headroom);
+    maxOut  = 0;
+    lateOut = 0;
+    for ( c = 0; c < nChunks; c++ ) {
+        hostBench_limiterChunk(&lim, buf, &src[c * HOSTBENCH_LIMITER_CHUNK], 1);
+        peak   = hostBench_peak(buf, HOSTBENCH_LIMITER_CHUNK);
+        maxOut = peak > maxOut ? peak : maxOut;
+        if ( 3 == (c & 7) ) {
+            lateOut = peak;     // settled, end of a burst
+        }
+    }
+    now = limiter_meter(&lim, &peak);
+    printf("[BENCH]: limiter bursts +12 dB over: max output %d (ceiling %d), settled %d,"
+           " reduction peak %d.%d dB\n", maxOut, LIMITER_CEILING, lateOut, peak / 10, peak % 10);
+    if ( maxOut > LIMITER_CEILING || lateOut < LIMITER_CEILING * 9 / 10
+      || peak < 115 || peak > 130 ) {
+        status = FAIL;
+    }
+
+    // 4:1 above -20 dBFS: a -8 dBFS tone comes out at -17 dBFS
+    for ( i = 0; i < (int)(sizeof(src) / sizeof(src[0])); i++ ) {
+        src[i] = (fract16)floor(32768.0 * pow(10.0, -8.0 / 20.0)
+                                * sin(2.0 * M_PI * 1000.0 * i / 16000) + 0.5);
+    }
+    limiter_init(&lim, 16000, headroom);
+    limiter_setCurve(&lim, -20, 4);
+    for ( c = 0; c < nChunks; c++ ) {
+        hostBench_limiterChunk(&lim, buf, &src[c * HOSTBENCH_LIMITER_CHUNK], 0);
+    }
+    dB = 20.0 * log10(hostBench_peak(buf, HOSTBENCH_LIMITER_CHUNK) / 32768.0);
+    printf("[BENCH]: limiter 4:1 at -20 dBFS, -8 dBFS tone: %.2f dBFS out (-17 expected)\n", dB);
+    if ( fabs(dB + 17.0) > 0.3 ) {
+        status = FAIL;
+    }
+
+    // overlapping bands at +12 dB and the echo on top: the trim follows
+    // the summed boost, nothing saturates before the limiter; the fixed
+    // 12 dB trim, enough for a single band, saturates with two
+    {
+        static fract16  line[4096];
+        static const struct { int nBands; int echo; } cases[] = { { 2, 0 }, { 3, 0 }, { 1, 1 }, { 2, 1 } };
+        eq_t            eq;
+        echo_t          echo;
+        int             boost, nSat, nSatFixed, n;
+
+        for ( n = 0; n < (int)(sizeof(cases) / sizeof(cases[0])); n++ ) {
+            hostBench_limiterStages(&eq, &echo, line, sizeof(line) / sizeof(line[0]), cases[n].nBands);
+            boost     = eq_boost(&eq) + (cases[n].echo ? echo_boost(&echo) : 0);
+            nSat      = hostBench_limiterChain(&eq, cases[n].echo ? &echo : NULL,
+                                               limiter_boostHeadroom(boost), &maxOut);
+            hostBench_limiterStages(&eq, &echo, line, sizeof(line) / sizeof(line[0]), cases[n].nBands);
+            nSatFixed = hostBench_limiterChain(&eq, cases[n].echo ? &echo : NULL, headroom, &peak);
+            printf("[BENCH]: limiter %d band%s +%d dB%s: boost %d dB, headroom %d, %d chunks"
+                   " saturated in the chain (%d with %d dB), max output %d\n",
+                   cases[n].nBands, 1 < cases[n].nBands ? "s" : "", EQ_GAIN_MAX, cases[n].echo ? " and echo" : "", boost,
+                   limiter_boostHeadroom(boost), nSat, nSatFixed, 6 * headroom, maxOut);
+            if ( 0 != nSat || (1 < cases[n].nBands && 0 == nSatFixed) || maxOut > LIMITER_CEILING ) {
+                status = FAIL;
+            }
+        }
+    }
+
+    // timing on noise with loud bursts, the gain computer busy
+    for ( i = 0; i < (int)(sizeof(src) / sizeof(src[0])); i++ ) {
+        int loud = (i >> 9) & 1;    // 512 samples loud, 512 quiet
+
+        src[i] = (fract16)(loud ? (hostBench_rand(&seed) & 0xffff) - 0x8000
+                                : (hostBench_rand(&seed) & 0x0fff) - 0x800);
+    }
+    for ( r = 0; r < (int)(sizeof(rates) / sizeof(rates[0])); r++ ) {
+        limiter_init(&lim, rates[r], headroom);
+        t = 0.0;
+        for ( c = 0; c < (int)count; c++ ) {
+            double t0 = hostBench_now();
+
+            hostBench_limiterChunk(&lim, buf, &src[(c % nChunks) * HOSTBENCH_LIMITER_CHUNK], 1);
+            t += hostBench_now() - t0;
+        }
+        cycles = count ? (double)lim.cycles / count : 0.0;
+        printf("[BENCH]: limiter %5u Hz: %7.0f cycles/chunk %5.1f cycles/sample, %7.0f ns/chunk"
+               " (trim included) = %.3f%% of the %.1f ms chunk period, %lu of %lu blocks limited\n",
+               rates[r], cycles, cycles / HOSTBENCH_LIMITER_CHUNK, count ? t * 1e9 / count : 0.0,
+               count ? t / count * rates[r] / HOSTBENCH_LIMITER_CHUNK * 100.0 : 0.0,
+               1000.0 * HOSTBENCH_LIMITER_CHUNK / rates[r], lim.limited, lim.blocks);
+    }
+
+    printf("[BENCH]: limiter %s\n", PASS == status ? "passed" : "FAILED");
+    return PASS == status ? PASS : FAIL;
+}
+
+/**
+ * @def HOSTBENCH_DTMF_MS
+ * @brief tone and pause length of the DTMF check
+ */
+#define HOSTBENCH_DTMF_MS   (80)
+
+/** DTMF row / column frequencies of a key, 0 for an invalid key */
+static int hostBench_dtmfFreq(char key, double *pRow, double *pCol)
+{
+    static const char   keys[] = "123A456B789C*0#D";
+    static const double row[]  = { 697.0, 770.0, 852.0, 941.0 };
+    static const double col[]  = { 1209.0, 1336.0, 1477.0, 1633.0 };
+    const char          *pPos  = strchr(keys, key);
+
+    if ( NULL == pPos ) {
+        return FAIL;
+    }
+    *pRow = row[(pPos - keys) / 4];
+    *pCol = col[(pPos - keys) % 4];
+    return PASS;
+}
+
+/** feed a signal to a decoder in random chunks, collect the keys */
+static void hostBench_dtmfRun(dtmf_t *pDtmf, const fract16 *pSig, int len, unsigned int *pSeed,
+                              char *pKeys, int keysMax)
+{
+    chunk_t     chunk;
+    int         nKeys = 0;
+    int         o, b;
+    char        key;
+
+    for ( o = 0; o < len; o += b ) {
+        b = 1 + hostBench_rand(pSeed) % 1500;
+        b = b < len - o ? b : len - o;
+        chunk.s16_buff = (short *)&pSig[o];
+        chunk.len      = 2 * b;
+        chunk.size     = chunk.len;
+        dtmf_process(pDtmf, &chunk);
+        while ( PASS == dtmf_keyGet(pDtmf, &key) ) {
+            if ( nKeys < keysMax - 1 ) {
+                pKeys[nKeys++] = key;
+            }
+        }
+    }
+    pKeys[nKeys] = '\0';
+}
+
+/** check the DTMF decoder and measure Goertzel banks
+ *   - all 16 keys (80 ms on / off, -10 dBFS, 4 dB twist, +-1.5 % off the
+ *     nominal frequencies, noise at -30 dBFS) fed in random chunk sizes
+ *     at 16 and 48 kHz decode to the sent sequence
+ *   - noise and random chords (talk-off) give no key
+ *   - a bank fed in random pieces gives the same powers as one fed whole
+ *   - ns per chunk of 8, 16 and 64 detectors against a 1024 point fixed
+ *     point FFT (half an fftConv pass)
+ *
+ * @param count  chunks timed per bank size
+ *
+ * @return Zero if every check holds, FAIL otherwise
+ */
+int hostBench_goertzel(unsigned long count)
+{
+    static const unsigned int rates[] = { 16000, 48000 };
+    static const int    sizes[]  = { 8, 16, 64 };
+    static const char   sent[]   = "123A456B789C*0#D";
+    static fract16      sig[48000 * 3];
+    static fftConv_t    conv;
+    static fract16      chunkBuf[1024];
+    static fract16      fftCoeff[1] = { 0x4000 };
+    goertzel_t          *pBank   = malloc(2 * sizeof(goertzel_t));
+    dtmf_t              dtmf;
+    char                keys[64];
+    float               freq[GOERTZEL_MAX];
+    unsigned int        seed     = 1;
+    int                 status   = PASS;
+    int                 len, o, b, i, k, r;
+    int                 same;
+    double              t, tFft;
+
+    if ( NULL == pBank ) {
+        return FAIL;
+    }
+
+    // all keys, each 80 ms on and 80 ms off
+    for ( r = 0; r < (int)(sizeof(rates) / sizeof(rates[0])); r++ ) {
+        unsigned int    rate = rates[r];
+        int             seg  = rate * HOSTBENCH_DTMF_MS / 1000;
+
+        len = 0;
+        for ( k = 0; sent[k]; k++ ) {
+            double  fr  = 0.0, fc = 0.0;
+            double  dev = 0 == (k & 1) ? 1.015 : 0.985;
+
+            if ( PASS != hostBench_dtmfFreq(sent[k], &fr, &fc) ) {
+                free(pBank);
+                return FAIL;
+            }
+            for ( i = 0; i < 2 * seg; i++, len++ ) {
+                double  v = (int)(hostBench_rand(&seed) & 0x7ff) - 0x400;   // -30 dBFS
+
+                if ( i < seg ) {
+                    v += 10362.0 * 0.63 * sin(2.0 * M_PI * fr * dev * i / rate)
+                       + 10362.0 * sin(2.0 * M_PI * fc * dev * i / rate);
+                }
+                sig[len] = (fract16)floor(v + 0.5);
+            }
+        }
+        dtmf_init(&dtmf, rate);
+        hostBench_dtmfRun(&dtmf, sig, len, &seed, keys, sizeof(keys));
+        printf("[BENCH]: dtmf %5u Hz: sent %s, decoded %s (%lu blocks of %d)\n",
+               rate, sent, keys, dtmf.bank.blocks, dtmf.bank.blockLen);
+        if ( 0 != strcmp(sent, keys) ) {
+            status = FAIL;
+        }
+    }
+
+    // talk-off: white noise, then chords of 5 random tones changing every 100 ms
+    len = 16000 * 3;
+    for ( i = 0; i < len; i++ ) {
+        sig[i] = (fract16)((hostBench_rand(&seed) & 0x3fff) - 0x2000);
+    }
+    dtmf_init(&dtmf, 16000);
+    hostBench_dtmfRun(&dtmf, sig, len, &seed, keys, sizeof(keys));
+    printf("[BENCH]: dtmf noise: %d keys", (int)strlen(keys));
+    status |= 0 != keys[0] ? FAIL : PASS;
+    for ( o = 0; o < len; o += 1600 ) {
+        double  f[5];
+
+        for ( k = 0; k < 5; k++ ) {
+            f[k] = 300.0 + hostBench_rand(&seed) % 2700;
+        }
+        for ( i = o; i < o + 1600; i++ ) {
+            double v = 0.0;
+
+            for ( k = 0; k < 5; k++ ) {
+                v += 4000.0 * sin(2.0 * M_PI * f[k] * i / 16000);
+            }
+            sig[i] = (fract16)floor(v + 0.5);
+        }
+    }
+    dtmf_init(&dtmf, 16000);
+    hostBench_dtmfRun(&dtmf, sig, len, &seed, keys, sizeof(keys));
+    printf(", chords: %d keys %s\n", (int)strlen(keys), keys);
+    status |= 0 != keys[0] ? FAIL : PASS;
+
+    // incremental: random pieces against whole blocks, bit-exact
+    same = 1;
+    for ( k = 0; k < GOERTZEL_MAX; k++ ) {
+        freq[k] = 200.0f + 110.0f * k;
+    }
+    goertzel_init(&pBank[0], 16000, freq, GOERTZEL_MAX, 0);
+    goertzel_init(&pBank[1], 16000, freq, GOERTZEL_MAX, 0);
+    for ( o = 0; o + pBank[0].blockLen <= len; o += pBank[0].blockLen ) {
+        int at = o;
+
+        goertzel_feed(&pBank[0], &sig[o], pBank[0].blockLen);
+        while ( !pBank[1].ready || at == o ) {
+            b   = 1 + hostBench_rand(&seed) % 100;
+            at += goertzel_feed(&pBank[1], &sig[at], b);
+        }
+        same &= 0 == memcmp(pBank[0].power, pBank[1].power, sizeof(pBank[0].power));
+    }
+    printf("[BENCH]: goertzel %lu blocks in random pieces %s whole blocks\n",
+           pBank[1].blocks, same ? "equal to" : "DIFFER from");
+    status |= same ? PASS : FAIL;
+
+    // timing: 1024 sample chunks against a 1024 point FFT
+    for ( i = 0; i < 1024; i++ ) {
+        chunkBuf[i] = sig[i];
+    }
+    fftConv_init(&conv, fftCoeff, NULL, 1, 1024, FFTCONV_FFT_FIXED);
+    t = hostBench_now();
+    for ( i = 0; i < (int)count; i++ ) {
+        fftConv_process(&conv, chunkBuf, chunkBuf, 1024);
+    }
+    tFft = count ? (hostBench_now() - t) / count / 2.0 : 0.0;
+    printf("[BENCH]: fft 1024 points fixed point: %7.0f ns, %d real multiplies\n",
+           tFft * 1e9, 512 * 10 * 4);
+    for ( r = 0; r < (int)(sizeof(sizes) / sizeof(sizes[0])); r++ ) {
+        goertzel_init(&pBank[0], 16000, freq, sizes[r], 0);
+        t = hostBench_now();
+        for ( i = 0; i < (int)count; i++ ) {
+            for ( o = 0; o < 1024; ) {
+                o += goertzel_feed(&pBank[0], &sig[o], 1024 - o);
+            }
+        }
+        t = count ? (hostBench_now() - t) / count : 0.0;
+        printf("[BENCH]: goertzel %2d detectors: %7.0f ns/chunk of 1024, %.2f ns per sample"
+               " and detector, %d multiplies (%.2f x the FFT time)\n",
+               sizes[r], t * 1e9, t * 1e9 / 1024 / sizes[r], 2 * 1024 * sizes[r],
+               0.0 < tFft ? t / tFft : 0.0);
+    }
+
+    free(pBank);
+    printf("[BENCH]: goertzel %s\n", PASS == status ? "passed" : "FAILED");
+    return PASS == status ? PASS : FAIL;
+}
+
+/**
+ * @def HOSTBENCH_ECHO_RATE
+ * @brief sample rate of the echo check, the line holds 4 s
+ */
+#define HOSTBENCH_ECHO_RATE (16000)
+
+/** check the echo and measure it
+ *   - an impulse just before the end of a 4 s delay line, taps at 0.3 s
+ *     (with feedback) and 3.875 s (no multiple of 0.3 s), so the echoes
+ *     are read across the wrap; fed in random chunk sizes
+ *   - every output sample against the echo equations evaluated sample
+ *     by sample on a plain history (bit-exact)
+ *   - the response is zero except at dry, k * delay0 and delay1 +
+ *     k * delay0, with gains dry, gain0 * fb^(k-1), gain1 * fb^k
+ *   - ns per 1024 sample chunk
+ *
+ * @param count  chunks timed
+ *
+ * @return Zero if every check holds, FAIL otherwise
+ */
+int hostBench_echo(unsigned long count)
+{
+    enum { LINE = 4 * HOSTBENCH_ECHO_RATE, D0 = 3 * HOSTBENCH_ECHO_RATE / 10,
+           D1 = 31 * HOSTBENCH_ECHO_RATE / 8, N0 = LINE - 300, LEN = N0 + 2 * LINE };
+    static fract16      line[LINE];
+    static fract16      in[LEN], out[LEN], w[LEN];
+    static fract16      chunkBuf[1024];
+    const fract16       amp = 0x4000, dry = 0x6666, fb = 0x2ccc, g0 = 0x4000, g1 = 0x2666;
+    echo_t              echo;
+    unsigned int        seed     = 1;
+    int                 status   = PASS;
+    long                nDiff    = 0, nEcho = 0, nStray = 0;
+    int                 maxErr   = 0;
+    int                 n, o, b, k;
+    double              t;
+
+    echo_init(&echo, line, LINE);
+    echo_setTap(&echo, 0, D0, g0);
+    echo_setTap(&echo, 1, D1, g1);
+    echo_setMix(&echo, dry, fb);
+
+    memset(in, 0, sizeof(in));
+    in[N0] = amp;
+    for ( o = 0; o < LEN; o += b ) {
+        b = 1 + hostBench_rand(&seed) % 1500;
+        if ( o + b > LEN ) {
+            b = LEN - o;
+        }
+        echo_filter(&echo, &in[o], &out[o], b);
+    }
+
+    // reference: the equations of echo.h, one sample at a time
+    for ( n = 0; n < LEN; n++ ) {
+        int acc = in[n] + (n >= D0 ? (fb * w[n - D0]) >> 15 : 0);
+        int y;
+
+        w[n] = q15_sat(acc);
+        y    = (dry * in[n]) >> 15;
+        y   += n >= D0 ? (g0 * w[n - D0]) >> 15 : 0;
+        y   += n >= D1 ? (g1 * w[n - D1]) >> 15 : 0;
+        nDiff += out[n] != q15_sat(y);
+    }
+
+    // response: expected taps, anything else is a stray sample
+    for ( n = 0; n < LEN; n++ ) {
+        int     d   = n - N0;
+        double  exp = 0.0;
+        int     hit = 0;
+
+        if ( 0 == d ) {
+            exp = (double)dry / 32768.0;
+            hit = 1;
+        } else if ( 0 < d && 0 == d % D0 ) {
+            exp = (double)g0 / 32768.0 * pow((double)fb / 32768.0, d / D0 - 1);
+            hit = 1;
+        } else if ( D1 <= d && 0 == (d - D1) % D0 ) {
+            exp = (double)g1 / 32768.0 * pow((double)fb / 32768.0, (d - D1) / D0);
+            hit = 1;
+        }
+        if ( hit ) {
+            int err = abs(out[n] - (int)floor(exp * amp + 0.5));
+
+            maxErr = err > maxErr ? err : maxErr;
+            nEcho += 0 != out[n];
+            if ( 0 == d || D0 == d || 2 * D0 == d || D1 == d || D1 + D0 == d ) {
+                printf("[BENCH]: echo at %6.3f s: %6d (%+6.2f dB, expected %+6.2f dB)\n",
+                       (double)d / HOSTBENCH_ECHO_RATE, out[n],
+                       20.0 * log10(abs(out[n]) / (double)amp), 20.0 * log10(exp));
+            }
+        } else {
+            nStray += 0 != out[n];
+        }
+    }
+    printf("[BENCH]: echo impulse %d samples before the wrap of a %d sample line: %ld of %d"
+           " samples differ from the reference, %ld echoes, max gain error %d LSB,"
+           " %ld stray samples\n", LINE - N0, LINE, nDiff, LEN, nEcho, maxErr, nStray);
+    // truncation: one LSB per multiply along the feedback path
+    if ( 0 != nDiff || 0 != nStray || LEN / D0 < maxErr || 3 > nEcho ) {
+        status = FAIL;
+    }
+
+    // timing: 2 taps and feedback on noise
+    for ( k = 0; k < 1024; k++ ) {
+        chunkBuf[k] = (fract16)((hostBench_rand(&seed) & 0x3fff) - 0x2000);
+    }
+    t = hostBench_now();
+    for ( n = 0; n < (int)count; n++ ) {
+        echo_filter(&echo, chunkBuf, chunkBuf, 1024);
+    }
+    t = count ? (hostBench_now() - t) / count : 0.0;
+    printf("[BENCH]: echo 2 taps + feedback: %7.0f ns/chunk of 1024, %.2f ns/sample\n",
+           t * 1e9, t * 1e9 / 1024);
+
+    printf("[BENCH]: echo %s\n", PASS == status ? "passed" : "FAILED");
+    return status;
+}
+
+/**
+ * @def HOSTBENCH_FOLD_LEN
+ * @brief input samples streamed through each folded FIR configuration
+ */
+#define HOSTBENCH_FOLD_LEN  (4000)
+
+/**
+ * @def HOSTBENCH_FOLD_TAPS
+ * @brief longest filter of the folded FIR check, one above FIRBLOCK_TAPS_MAX
+ */
+#define HOSTBENCH_FOLD_TAPS (FIRBLOCK_TAPS_MAX + 1)
+
+/* firBlock.c built a second time with -DFIRBLOCK_FOLD=1 (see Makefile),
+   the host default is the unfolded kernel */
+void firBlockFold_fr16(const fract16 input[], fract16 output[], int length, fir_state_fr16 *s);
+void firBlockFold_fr16Scaled(const fract16 input[], fract16 output[], int length,
+                             fir_state_fr16 *s, int shift);
+
+/** random taps, symmetric unless asym, sum of |h| at most 65535 */
+static void hostBench_foldTaps(fract16 h[], int k, int asym, unsigned int *pSeed)
+{
+    long        sum = 0;
+    int         j;
+
+    for ( j = 0; j < (k + 1) / 2; j++ ) {
+        h[j] = h[k - 1 - j] = (fract16)hostBench_rand(pSeed);
+    }
+    for ( j = 0; j < k; j++ ) {
+        sum += abs(h[j]);
+    }
+    // truncation toward zero keeps the mirrored taps equal
+    if ( sum > 65535 ) {
+        for ( j = 0; j < k; j++ ) {
+            h[j] = (fract16)((long long)h[j] * 65535 / sum);
+        }
+    }
+    if ( asym && k > 1 ) {
+        h[k - 1] /= 2;
+    }
+}
+
+/** check the folded FIR kernels against fir_fr16 and measure them
+ *   - firBlock_fr16 with FIRBLOCK_FOLD=1 (symEven / symOdd) and the host
+ *     default against fir_fr16 for odd and even k from 1 to one above
+ *     FIRBLOCK_TAPS_MAX, symmetric and not, sum of |h| at the 65535 bound,
+ *     full scale noise with runs of -32768 (17 bit pre-add extremes), fed
+ *     in random chunk sizes (bit-exact)
+ *   - the folded and unfolded firBlock_fr16Scaled with shift 20 on the
+ *     halved taps
+ *   - ns per sample of fir_fr16, the unfolded and the folded kernel
+ *
+ * @param count  1024 sample chunks timed per kernel
+ *
+ * @return Zero if every output equals the reference, FAIL otherwise
+ */
+int hostBench_firFold(unsigned long count)
+{
+    static const int    taps[] = { 1, 2, 3, 4, 7, 16, 17, 32, 33, 63, 64, 65,
+                                   127, 128, HOSTBENCH_FOLD_TAPS };
+    static fract16      in[HOSTBENCH_FOLD_LEN];
+    static fract16      out[4][HOSTBENCH_FOLD_LEN];
+    static fract16      chunkBuf[1024];
+    fract16             h[HOSTBENCH_FOLD_TAPS];
+    fract16             hs[HOSTBENCH_FOLD_TAPS];
+    fract16             d[4][HOSTBENCH_FOLD_TAPS];
+    fir_state_fr16      s[4];
+    unsigned int        seed    = 1;
+    long                nDiff   = 0;
+    long                nScaled = 0;
+    int                 t, asym, n, o, b, k;
+    double              tm[3];
+
+    for ( n = 0; n < HOSTBENCH_FOLD_LEN; n++ ) {
+        in[n] = (fract16)hostBench_rand(&seed);
+        if ( 0 == hostBench_rand(&seed) % 8 ) {
+            in[n] = -0x8000;
+        }
+    }
+
+    for ( t = 0; t < (int)(sizeof(taps) / sizeof(taps[0])); t++ ) {
+        for ( asym = 0; asym < 2; asym++ ) {
+            long diff = 0;
+
+            k = taps[t];
+            hostBench_foldTaps(h, k, asym, &seed);
+            // half the taps leave room for the rounding constant of shift 20
+            for ( n = 0; n < k; n++ ) {
+                hs[n] = h[n] / 2;
+            }
+            memset(d, 0, sizeof(d));
+            for ( n = 0; n < 3; n++ ) {
+                fir_init(s[n], h, d[n], k, 0);
+            }
+            fir_init(s[3], hs, d[3], k, 0);
+            for ( o = 0; o < HOSTBENCH_FOLD_LEN; o += b ) {
+                b = 1 + hostBench_rand(&seed) % 300;
+                if ( o + b > HOSTBENCH_FOLD_LEN ) {
+                    b = HOSTBENCH_FOLD_LEN - o;
+                }
+                fir_fr16(&in[o], &out[0][o], b, &s[0]);
+                firBlock_fr16(&in[o], &out[1][o], b, &s[1]);
+                firBlockFold_fr16(&in[o], &out[2][o], b, &s[2]);
+                firBlockFold_fr16Scaled(&in[o], &out[3][o], b, &s[3], 20);
+            }
+            for ( n = 0; n < HOSTBENCH_FOLD_LEN; n++ ) {
+                diff += out[1][n] != out[0][n];
+                diff += out[2][n] != out[0][n];
+            }
+
+            // scaled reference: the unfolded kernel on the same taps
+            memset(d[1], 0, sizeof(d[1]));
+            fir_init(s[1], hs, d[1], k, 0);
+            firBlock_fr16Scaled(in, out[1], HOSTBENCH_FOLD_LEN, &s[1], 20);
+            for ( n = 0; n < HOSTBENCH_FOLD_LEN; n++ ) {
+                nScaled += out[3][n] != out[1][n];
+            }
+            if ( 0 != diff ) {
+                printf("[BENCH]: firFold %3d taps %s: %ld samples differ\n",
+                       k, asym ? "asymmetric" : "symmetric", diff);
+            }
+            nDiff += diff;
+        }
+    }
+    printf("[BENCH]: firFold %d tap counts (1..%d), symmetric and not, %d samples each:"
+           " %ld differ from fir_fr16, %ld scaled differ\n",
+           (int)(sizeof(taps) / sizeof(taps[0])), HOSTBENCH_FOLD_TAPS, HOSTBENCH_FOLD_LEN,
+           nDiff, nScaled);
+
+    // timing: the 33 tap audioFilter length, symmetric
+    for ( n = 0; n < 1024; n++ ) {
+        chunkBuf[n] = (fract16)((hostBench_rand(&seed) & 0x3fff) - 0x2000);
+    }
+    for ( k = 32; k <= 33; k++ ) {
+        hostBench_foldTaps(h, k, 0, &seed);
+        for ( t = 0; t < 3; t++ ) {
+            memset(d[t], 0, sizeof(d[t]));
+            fir_init(s[t], h, d[t], k, 0);
+            tm[t] = hostBench_now();
+            for ( n = 0; n < (int)count; n++ ) {
+                if ( 0 == t ) {
+                    fir_fr16(chunkBuf, out[0], 1024, &s[t]);
+                } else if ( 1 == t ) {
+                    firBlock_fr16(chunkBuf, out[0], 1024, &s[t]);
+                } else {
+                    firBlockFold_fr16(chunkBuf, out[0], 1024, &s[t]);
+                }
+            }
+            tm[t] = count ? (hostBench_now() - tm[t]) / count / 1024 : 0.0;
+        }
+        printf("[BENCH]: firFold %d taps: fir_fr16 %.2f ns/sample, firBlock %.2f ns/sample"
+               " (FIRBLOCK_FOLD=%d), folded %.2f ns/sample\n",
+               k, tm[0] * 1e9, tm[1] * 1e9, FIRBLOCK_FOLD, tm[2] * 1e9);
+    }
+
+    printf("[BENCH]: firFold %s\n", 0 == nDiff && 0 == nScaled ? "passed" : "FAILED");
+    return 0 == nDiff && 0 == nScaled ? PASS : FAIL;
+}
+
+/**
+ * @def HOSTBENCH_CONV_BLOCK
+ * @brief samples per fftConv_process call of the overlap-save check
+ */
+#define HOSTBENCH_CONV_BLOCK (1024)
+
+/**
+ * @def HOSTBENCH_CONV_LEN
+ * @brief input samples streamed through each overlap-save configuration
+ */
+#define HOSTBENCH_CONV_LEN  (16 * HOSTBENCH_CONV_BLOCK)
+
+/**
+ * @def HOSTBENCH_CONV_AUTO_SLACK
+ * @brief the mode FFTCONV_AUTO picks may be this much slower than the
+ *        faster one (close to the crossover)
+ */
+#define HOSTBENCH_CONV_AUTO_SLACK (1.5)
+
+/** check overlap-save against the direct form and measure it
+ *   - Blackman windowed sinc low-pass of 256 .. 2048 taps (1.15, sum of
+ *     |h| below the firBlock bound), noise at -6 dBFS plus a full scale
+ *     tone in the pass band, fed in calls of 1 .. HOSTBENCH_CONV_BLOCK
+ *   - fixed and float FFT against firBlock_fr16 (exact integer sums):
+ *     rms and largest error in LSB
+ *   - ns per sample of the direct form and both FFT modes
+ *   - FFTCONV_AUTO at 32 .. 1024 taps: the mode it picks is within
+ *     HOSTBENCH_CONV_AUTO_SLACK of the faster of direct form and the
+ *     native FFT as measured
+ *
+ * @param count  HOSTBENCH_CONV_BLOCK sample calls timed per mode
+ *
+ * @return Zero if every error stays within its bound, FAIL otherwise
+ */
+int hostBench_fftConv(unsigned long count)
+{
+    static const int    taps[] = { 256, 512, 1024, 2048 };
+    static const int    autoTaps[] = { 32, 64, 128, 256, 1024 };
+    static const fftConv_mode_t modes[] = { FFTCONV_FFT_FIXED, FFTCONV_FFT_FLOAT };
+    static fftConv_t    conv;
+    static fract16      h[2048];
+    static fract16      d[2048];
+    static fract16      in[HOSTBENCH_CONV_LEN];
+    static fract16      ref[HOSTBENCH_CONV_LEN];
+    static fract16      out[HOSTBENCH_CONV_LEN];
+    fir_state_fr16      fir;
+    unsigned int        seed   = 1;
+    int                 status = PASS;
+    int                 t, m, n, o, b, k;
+    double              tm[3];
+
+    for ( n = 0; n < HOSTBENCH_CONV_LEN; n++ ) {
+        int v = ((int)(hostBench_rand(&seed) & 0x7fff) - 0x4000)
+              + (int)(0x3fff * sin(2.0 * M_PI * 0.01 * n));
+        in[n] = q15_sat(v);
+    }
+
+    for ( t = 0; t < (int)(sizeof(taps) / sizeof(taps[0])); t++ ) {
+        k = taps[t];
+        // cut-off 0.1 fs, Blackman window
+        for ( n = 0; n < k; n++ ) {
+            double x = n - (k - 1) / 2.0;
+            double s = 0.0 == x ? 0.2 : sin(2.0 * M_PI * 0.1 * x) / (M_PI * x);
+            double w = 0.42 - 0.5 * cos(2.0 * M_PI * n / (k - 1))
+                     + 0.08 * cos(4.0 * M_PI * n / (k - 1));
+            h[n] = q15_sat((int)floor(s * w * 32768.0 + 0.5));
+        }
+        memset(d, 0, sizeof(d));
+        fir_init(fir, h, d, k, 0);
+        firBlock_fr16(in, ref, HOSTBENCH_CONV_LEN, &fir);
+
+        for ( m = 0; m < 2; m++ ) {
+            double  sq     = 0.0;
+            int     maxErr = 0;
+
+            if ( PASS != fftConv_init(&conv, h, NULL, k, HOSTBENCH_CONV_BLOCK, modes[m]) ) {
+                status = FAIL;
+                continue;
+            }
+            for ( o = 0; o < HOSTBENCH_CONV_LEN; o += b ) {
+                b = 1 + hostBench_rand(&seed) % HOSTBENCH_CONV_BLOCK;
+                if ( o + b > HOSTBENCH_CONV_LEN ) {
+                    b = HOSTBENCH_CONV_LEN - o;
+                }
+                fftConv_process(&conv, &in[o], &out[o], b);
+            }
+            for ( n = 0; n < HOSTBENCH_CONV_LEN; n++ ) {
+                int err = abs(out[n] - ref[n]);
+
+                sq    += (double)err * err;
+                maxErr = err > maxErr ? err : maxErr;
+            }
+            sq = sqrt(sq / HOSTBENCH_CONV_LEN);
+            printf("[BENCH]: fftConv %4d taps %s FFT (N = %d): rms error %.3f LSB, max %d LSB\n",
+                   k, FFTCONV_FFT_FIXED == modes[m] ? "fixed" : "float", 1 << conv.log2n,
+                   sq, maxErr);
+            // float: rounding of the float sum only; fixed: 1.15 twiddles
+            // and spectrum, see fftConv.c
+            if ( FFTCONV_FFT_FLOAT == modes[m] ? 1 < maxErr : 2.0 < sq || 16 < maxErr ) {
+                status = FAIL;
+            }
+        }
+    }
+
+    // timing: 1024 sample calls, 1024 taps
+    k = 1024;
+    memset(d, 0, sizeof(d));
+    fir_init(fir, h, d, k, 0);
+    for ( m = 0; m < 3; m++ ) {
+        if ( 0 < m ) {
+            fftConv_init(&conv, h, NULL, k, HOSTBENCH_CONV_BLOCK, modes[m - 1]);
+        }
+        tm[m] = hostBench_now();
+        for ( n = 0; n < (int)count; n++ ) {
+            if ( 0 == m ) {
+                firBlock_fr16(in, out, HOSTBENCH_CONV_BLOCK, &fir);
+            } else {
+                fftConv_process(&conv, in, out, HOSTBENCH_CONV_BLOCK);
+            }
+        }
+        tm[m] = count ? (hostBench_now() - tm[m]) / count / HOSTBENCH_CONV_BLOCK : 0.0;
+    }
+    printf("[BENCH]: fftConv %d taps, %d sample calls: direct %.1f ns/sample,"
+           " fixed FFT %.1f ns/sample, float FFT %.1f ns/sample\n",
+           k, HOSTBENCH_CONV_BLOCK, tm[0] * 1e9, tm[1] * 1e9, tm[2] * 1e9);
+
+    // FFTCONV_AUTO against the measured direct form and native FFT
+    for ( t = 0; t < (int)(sizeof(autoTaps) / sizeof(autoTaps[0])); t++ ) {
+        fftConv_mode_t  pick;
+
+        k = autoTaps[t];
+        fftConv_init(&conv, h, d, k, HOSTBENCH_CONV_BLOCK, FFTCONV_AUTO);
+        pick = conv.mode;
+        for ( m = 0; m < 2; m++ ) {
+            fftConv_init(&conv, h, d, k, HOSTBENCH_CONV_BLOCK,
+                         0 == m ? FFTCONV_DIRECT : FFTCONV_FFT_NATIVE);
+            tm[m] = hostBench_now();
+            for ( n = 0; n < (int)count; n++ ) {
+                fftConv_process(&conv, in, out, HOSTBENCH_CONV_BLOCK);
+            }
+            tm[m] = count ? (hostBench_now() - tm[m]) / count / HOSTBENCH_CONV_BLOCK : 0.0;
+        }
+        printf("[BENCH]: fftConv %4d taps auto: cost direct %d FFT %d, picks %s;"
+               " direct %.1f ns/sample, FFT %.1f ns/sample\n",
+               k, fftConv_cost(k, HOSTBENCH_CONV_BLOCK, FFTCONV_DIRECT),
+               fftConv_cost(k, HOSTBENCH_CONV_BLOCK, FFTCONV_FFT_NATIVE),
+               FFTCONV_DIRECT == pick ? "direct" : "FFT", tm[0] * 1e9, tm[1] * 1e9);
+        // near the crossover either is fine, a wrong side costs more
+        if ( tm[FFTCONV_DIRECT == pick ? 0 : 1] > HOSTBENCH_CONV_AUTO_SLACK * (tm[0] < tm[1] ? tm[0] : tm[1]) ) {
+            status = FAIL;
+        }
+    }
+
+    printf("[BENCH]: fftConv %s\n", PASS == status ? "passed" : "FAILED");
+    return status;
+}
+
+/**
+ * @def HOSTBENCH_CASCADE_LEN
+ * @brief input samples of the filterCascade continuity check
+ */
+#define HOSTBENCH_CASCADE_LEN (64 * 1024)
+
+/**
+ * @def HOSTBENCH_CASCADE_LSB
+ * @brief largest error of the combined kernel against the separate
+ *        stages, which round after every stage
+ */
+#define HOSTBENCH_CASCADE_LSB (4)
+
+/** check that the filterCascade output continues across mask changes
+ *   - filter 1..3 of audioFilter at 48 kHz as stages, noise at -6 dBFS
+ *     in chunks of 1 .. 600 samples, a random mask for every chunk
+ *   - reference: each mask's stages run over the whole input without
+ *     ever stopping; separate mode bit-exact, combined mode within
+ *     HOSTBENCH_CASCADE_LSB, also in the first samples after a change
+ *   - ns per mask change (combined kernel build and priming)
+ *
+ * @param count  mask changes timed
+ *
+ * @return Zero if every output matches its reference, FAIL otherwise
+ */
+int hostBench_filterCascade(unsigned long count)
+{
+    static audioFilter_t    af;
+    static filterCascade_t  cas;
+    static fract16          in[HOSTBENCH_CASCADE_LEN];
+    static fract16          out[HOSTBENCH_CASCADE_LEN];
+    static fract16          ref[8][HOSTBENCH_CASCADE_LEN];
+    static unsigned char    maskOf[HOSTBENCH_CASCADE_LEN];
+    fract16                 *pCoeff[3];
+    fract16                 d[3][FILTER_COEFFICIENTS];
+    fir_state_fr16          s[3];
+    chunk_t                 chunk;
+    unsigned int            seed    = 1;
+    int                     status  = PASS;
+    int                     combine, m, st, n, o, b, err, maxErr, nDiff;
+    double                  t;
+
+    if ( PASS != audioFilter_init(&af, 48000) ) {
+        return FAIL;
+    }
+    pCoeff[0] = af.filter1_coeff;
+    pCoeff[1] = af.filter2_coeff;
+    pCoeff[2] = af.filter3_coeff;
+    for ( n = 0; n < HOSTBENCH_CASCADE_LEN; n++ ) {
+        in[n] = (fract16)((hostBench_rand(&seed) & 0x7fff) - 0x4000);
+    }
+
+    // uninterrupted reference of every mask
+    for ( m = 0; m < 8; m++ ) {
+        memcpy(ref[m], in, sizeof(in));
+        for ( st = 0; st < 3; st++ ) {
+            if ( m & (0x1 << st) ) {
+                memset(d[st], 0, sizeof(d[st]));
+                fir_init(s[st], pCoeff[st], d[st], FILTER_COEFFICIENTS, 1);
+                firBlock_fr16(ref[m], ref[m], HOSTBENCH_CASCADE_LEN, &s[st]);
+            }
+        }
+    }
+
+    for ( combine = 0; combine < 2; combine++ ) {
+        memset(d, 0, sizeof(d));
+        filterCascade_init(&cas, combine);
+        for ( st = 0; st < 3; st++ ) {
+            fir_init(s[st], pCoeff[st], d[st], FILTER_COEFFICIENTS, 1);
+            filterCascade_addStage(&cas, &s[st]);
+        }
+        memcpy(out, in, sizeof(in));
+        for ( o = 0; o < HOSTBENCH_CASCADE_LEN; o += b ) {
+            b = 1 + hostBench_rand(&seed) % 600;
+            if ( o + b > HOSTBENCH_CASCADE_LEN ) {
+                b = HOSTBENCH_CASCADE_LEN - o;
+            }
+            m              = hostBench_rand(&seed) % 8;
+            chunk.s16_buff = &out[o];
+            chunk.size     = b * sizeof(fract16);
+            chunk.len      = chunk.size;
+            filterCascade_setMask(&cas, m);
+            filterCascade_process(&cas, &chunk);
+            memset(&maskOf[o], m, b);
+        }
+        // the history needs FILTERCASCADE_TAPS_MAX samples of input
+        maxErr = 0;
+        nDiff  = 0;
+        for ( n = FILTERCASCADE_TAPS_MAX; n < HOSTBENCH_CASCADE_LEN; n++ ) {
+            err    = abs(out[n] - ref[maskOf[n]][n]);
+            maxErr = err > maxErr ? err : maxErr;
+            nDiff += 0 != err;
+        }
+        printf("[BENCH]: filterCascade %s: mask changed every 1..600 samples, %d of %d samples"
+               " differ from the uninterrupted stages, max error %d LSB\n",
+               combine ? "combined" : "separate", nDiff,
+               HOSTBENCH_CASCADE_LEN - FILTERCASCADE_TAPS_MAX, maxErr);
+        if ( combine ? maxErr > HOSTBENCH_CASCADE_LSB : 0 != nDiff ) {
+            status = FAIL;
+        }
+
+        // rebuild and priming cost
+        t = hostBench_now();
+        for ( n = 0; n < (int)count; n++ ) {
+            filterCascade_setMask(&cas, 0 == (n & 1) ? 0x7 : 0x3);
+        }
+        t = count ? (hostBench_now() - t) / count : 0.0;
+        printf("[BENCH]: filterCascade %s: %.0f ns per mask change\n",
+               combine ? "combined" : "separate", t * 1e9);
+    }
+
+    printf("[BENCH]: filterCascade %s\n", PASS == status ? "passed" : "FAILED");
+    return status;
+}
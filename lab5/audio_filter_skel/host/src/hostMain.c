@@ -0,0 +1,221 @@
+/**
+ *@file hostMain.c
+ *
+ *@brief
+ *  - host (x86 Linux) driver for the audio filter pipeline
+ *  - runs audioPlayer on top of the simulated DMA engine for a given
+ *    amount of simulated time and reports throughput, queue occupancy
+ *    and drop counts
+ *
+ * usage: audio_filter_host [-r rate] [-x speedup] [-t seconds]
+ *                          [-m switchmask] [-i in.raw] [-o out.raw]
+ *                          [-c chunksamples] [-q] [-e eqcommand]
+ *                          [-d ringchunks] [-l isrdelay] [-p]
+ *                          (-q: biquad filters, -e: see eq_command,
+ *                           -d: chunks per DMA descriptor ring, 1 = register
+ *                           mode, -l: ISR latency in sample periods,
+ *                           -p: RX polled without interrupts)
+ *        audio_filter_host -S count   (spscRing stress test, see hostBench.h)
+ *        audio_filter_host -P count   (bufferPool benchmark)
+ *        audio_filter_host -R count   (resampler benchmark)
+ *        audio_filter_host -Q count   (q15 library check and benchmark)
+ *        audio_filter_host -D count   (FIR designer and cache benchmark)
+ *        audio_filter_host -M count   (multirate benchmark)
+ *        audio_filter_host -G count   (equalizer check and benchmark)
+ *        audio_filter_host -L count   (limiter check and benchmark)
+ *        audio_filter_host -T count   (DTMF / Goertzel check and benchmark)
+ *        audio_filter_host -E count   (echo check and benchmark)
+ *        audio_filter_host -F count   (folded FIR check and benchmark)
+ *        audio_filter_host -C count   (overlap-save check and benchmark)
+ *        audio_filter_host -K count   (filter cascade continuity check)
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <pthread.h>
+#include <unistd.h>
+#include "tll_common.h"
+#include "audioPlayer.h"
+#include "audioHalSim.h"
+#include "extio.h"
+#include "hostBench.h"
+
+/**
+ * @var audioPlayer
+ * @brief  global audio player object
+ */
+audioPlayer_t            audioPlayer;
+
+/** player thread, audioPlayer_run does not return */
+static void *hostMain_player(void *pArg)
+{
+    audioPlayer_run(&audioPlayer);
+    return NULL;
+}
+
+/** print occupancy statistics of one queue */
+static void hostMain_queueReport(const char *pName, spscRing_t *pQueue)
+{
+    printf("[SIM]: %s queue occupancy avg %.2f max %d of %d\n", pName,
+           pQueue->nPut ? (double)pQueue->levelSum / pQueue->nPut : 0.0,
+           pQueue->levelMax, pQueue->size);
+}
+
+/** print usage */
+static void hostMain_usage(const char *pName)
+{
+    printf("usage: %s [-r rate] [-x speedup] [-t seconds] [-m switchmask]"
+           " [-i in.raw] [-o out.raw] [-c chunksamples] [-q] [-e eqcommand]"
+           " [-d ringchunks] [-l isrdelay] [-p]\n", pName);
+    printf("       %s -S count   (spscRing stress test)\n", pName);
+    printf("       %s -P count   (bufferPool benchmark)\n", pName);
+    printf("       %s -R count   (resampler benchmark)\n", pName);
+    printf("       %s -Q count   (q15 library check and benchmark)\n", pName);
+    printf("       %s -D count   (FIR designer and cache benchmark)\n", pName);
+    printf("       %s -M count   (multirate benchmark)\n", pName);
+    printf("       %s -G count   (equalizer check and benchmark)\n", pName);
+    printf("       %s -L count   (limiter check and benchmark)\n", pName);
+    printf("       %s -T count   (DTMF / Goertzel check and benchmark)\n", pName);
+    printf("       %s -E count   (echo check and benchmark)\n", pName);
+    printf("       %s -F count   (folded FIR check and benchmark)\n", pName);
+    printf("       %s -C count   (overlap-save check and benchmark)\n", pName);
+    printf("       %s -K count   (filter cascade continuity check)\n", pName);
+}
+
+/** 
+ * Main function for the host simulation
+ *
+ * @return int
+ */
+int main(int argc, char *argv[])
+{
+    audioHalSim_config_t    config      = { 0, 1.0, 10.0, NULL, NULL, 0 };
+    audioHalSim_stats_t     stats;
+    pthread_t               player;
+    unsigned int            mask        = 0;
+    int                     biquad      = 0;
+    const char              *pEq        = NULL;
+    int                     opt;
+    int                     sw;
+
+    while ( -1 != (opt = getopt(argc, argv, "r:x:t:m:i:o:c:qe:d:l:pS:P:R:Q:D:M:G:L:T:E:F:C:K:h")) ) {
+        switch ( opt ) {
+        case 'r': config.sampleRate = strtoul(optarg, NULL, 0); break;
+        case 'x': config.speedup    = strtod(optarg, NULL);     break;
+        case 't': config.duration   = strtod(optarg, NULL);     break;
+        case 'm': mask              = strtoul(optarg, NULL, 0); break;
+        case 'c': audioPlayer.chunkSize = 2 * strtoul(optarg, NULL, 0); break;
+        case 'q': biquad                = 1;                        break;
+        case 'e': pEq                   = optarg;                   break;
+        case 'd': audioPlayer.ringSize  = strtoul(optarg, NULL, 0); break;
+        case 'l': config.irqDelay       = strtoul(optarg, NULL, 0); break;
+        case 'p': audioPlayer.rxPolled  = 1;                        break;
+        case 'S': return hostBench_spscRing(strtoul(optarg, NULL, 0));
+        case 'P': return hostBench_bufferPool(strtoul(optarg, NULL, 0));
+        case 'R': return hostBench_resampler(strtoul(optarg, NULL, 0));
+        case 'Q': return hostBench_q15(strtoul(optarg, NULL, 0));
+        case 'D': return hostBench_firDesign(strtoul(optarg, NULL, 0));
+        case 'M': return hostBench_multirate(strtoul(optarg, NULL, 0));
+        case 'G': return hostBench_eq(strtoul(optarg, NULL, 0));
+        case 'L': return hostBench_limiter(strtoul(optarg, NULL, 0));
+        case 'T': return hostBench_goertzel(strtoul(optarg, NULL, 0));
+        case 'E': return hostBench_echo(strtoul(optarg, NULL, 0));
+        case 'F': return hostBench_firFold(strtoul(optarg, NULL, 0));
+        case 'C': return hostBench_fftConv(strtoul(optarg, NULL, 0));
+        case 'K': return hostBench_filterCascade(strtoul(optarg, NULL, 0));
+        case 'i':
+            config.pIn = fopen(optarg, "rb");
+            if ( NULL == config.pIn ) {
+                perror(optarg);
+                return -1;
+            }
+            break;
+        case 'o':
+            config.pOut = fopen(optarg, "wb");
+            if ( NULL == config.pOut ) {
+                perror(optarg);
+                return -1;
+            }
+            break;
+        default:
+            hostMain_usage(argv[0]);
+            return -1;
+        }
+    }
+    if ( 0 >= config.speedup || 0 >= config.duration ) {
+        hostMain_usage(argv[0]);
+        return -1;
+    }
+
+    audioHalSim_configure(&config);
+
+    printf("[MAIN]: Starting Audio Player (host simulation)\n");
+
+    if ( PASS != audioPlayer_init(&audioPlayer) ) {
+        return -1;
+    }
+    /* a simulated rate other than the codec setting gets its own filters */
+    if ( 0 != config.sampleRate && AUDIOPLAYER_RATE != config.sampleRate
+      && PASS != audioFilter_setRate(&audioPlayer.filter, config.sampleRate) ) {
+        return -1;
+    }
+    eq_setRate(&audioPlayer.eq, 0 != config.sampleRate ? config.sampleRate : AUDIOPLAYER_RATE);
+    limiter_setRate(&audioPlayer.limiter, 0 != config.sampleRate ? config.sampleRate : AUDIOPLAYER_RATE);
+    if ( 0 != config.sampleRate && AUDIOPLAYER_RATE != config.sampleRate
+      && PASS != dtmf_init(&audioPlayer.dtmf, config.sampleRate) ) {
+        return -1;
+    }
+    if ( NULL != pEq && PASS != eq_command(&audioPlayer.eq, pEq) ) {
+        return -1;
+    }
+    if ( biquad ) {
+        audioFilter_setType(&audioPlayer.filter, AUDIOFILTER_BIQUAD);
+    }
+    /* switches set on the command line, as if flipped before start */
+    for ( sw = 0; sw < 4; sw++ ) {
+        if ( mask & (0x1 << sw) ) {
+            extio_inject((extio_input)(EXTIO_SW0_HIGH + sw));
+        }
+    }
+    if ( PASS != audioPlayer_start(&audioPlayer) ) {
+        return -1;
+    }
+    pthread_create(&player, NULL, hostMain_player, NULL);
+
+    audioHalSim_wait(&stats);
+
+    printf("[SIM]: %.2f s at %u Hz simulated in %.3f s wall (%.1fx real-time)\n",
+           (double)stats.samples / stats.sampleRate, stats.sampleRate,
+           stats.wallTime, (double)stats.samples / stats.sampleRate / stats.wallTime);
+    printf("[SIM]: RX chunks %lu, TX chunks %lu (%.1f chunks/s wall)\n",
+           stats.rxChunks, stats.txChunks, stats.txChunks / stats.wallTime);
+    printf("[SIM]: RX dropped %u, TX dropped %u, TX underrun %u\n",
+           audioPlayer.rx.nDropped, audioPlayer.tx.nDropped, audioPlayer.tx.nUnderrun);
+    printf("[SIM]: DMA ring %d chunks, ISR delay %u, stalled RX %llu TX %llu samples,"
+           " coalesced IRQs RX %u TX %u\n",
+           audioPlayer.ringSize, config.irqDelay, stats.rxStalled, stats.txStalled,
+           audioPlayer.rx.nCoalesced, audioPlayer.tx.nCoalesced);
+    if ( audioPlayer.rxPolled ) {
+        printf("[SIM]: RX polled, %d sample DMA buffer, overruns %u\n",
+               AUDIORX_POLL_SAMPLES, audioPlayer.rx.nOverrun);
+    }
+    hostMain_queueReport("RX", &audioPlayer.rx.queue);
+    hostMain_queueReport("TX", &audioPlayer.tx.queue);
+    latency_dump(&audioPlayer.latency);
+    echo_report(&audioPlayer.echo, audioPlayer.bp.chunkSize, audioPlayer.bp.count);
+    audioPlayer_analysisReport(&audioPlayer);
+    eq_report(&audioPlayer.eq, audioPlayer.bp.chunkSize / 2);
+    limiter_report(&audioPlayer.limiter, audioPlayer.bp.chunkSize / 2);
+    dtmf_report(&audioPlayer.dtmf, audioPlayer.bp.chunkSize / 2);
+
+    if ( NULL != config.pOut ) {
+        fclose(config.pOut);
+    }
+    fflush(stdout);
+    /* the player thread never returns */
+    _exit(0);
+}
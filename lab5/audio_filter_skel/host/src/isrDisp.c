@@ -0,0 +1,128 @@
+/**
+ *@file isrDisp.c
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the interrupt dispatcher
+ *  - one recursive lock models "interrupts disabled": handlers run with
+ *    it held, so they are atomic with respect to each other and to the
+ *    queue operations of the main loop
+ *  - a latched pending flag models the wake up of the "idle" instruction
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <time.h>
+#include "tll_common.h"
+#include "isrDisp.h"
+
+/** dispatcher the interrupts are delivered to */
+static isrDisp_t        *isrDisp_pActive = NULL;
+
+/** interrupt lock */
+static pthread_mutex_t  isrDisp_irqLock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+/** wake up of the idle instruction */
+static pthread_mutex_t  isrDisp_wakeLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   isrDisp_wakeCond = PTHREAD_COND_INITIALIZER;
+static int              isrDisp_irqLatched = 0;
+
+/** handler nesting depth of the calling thread */
+static __thread int     isrDisp_depth = 0;
+
+/** initialize dispatcher
+ * @param pThis  pointer to own object
+ * @return Zero on success
+ */
+int isrDisp_init(isrDisp_t *pThis)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    isrDisp_pActive = pThis;
+    return PASS;
+}
+
+/** register a callback for an interrupt source
+ * @return Zero on success
+ */
+int isrDisp_registerCallback(isrDisp_t *pThis, isrDisp_isr_t isr,
+                             isrDisp_callback_t callback, void *pArg)
+{
+    if ( NULL == pThis || ISR_NUM <= isr ) {
+        return FAIL;
+    }
+    isrDisp_lock();
+    pThis->callback[isr] = callback;
+    pThis->pArg[isr]     = pArg;
+    isrDisp_unlock();
+    return PASS;
+}
+
+/** raise an interrupt, runs the handler with interrupts locked
+ * @param isr  interrupt source
+ */
+void isrDisp_raise(isrDisp_isr_t isr)
+{
+    isrDisp_lock();
+    if ( NULL != isrDisp_pActive && NULL != isrDisp_pActive->callback[isr] ) {
+        isrDisp_depth++;
+        isrDisp_pActive->callback[isr](isrDisp_pActive->pArg[isr]);
+        isrDisp_depth--;
+    }
+    isrDisp_unlock();
+
+    pthread_mutex_lock(&isrDisp_wakeLock);
+    isrDisp_irqLatched = 1;
+    pthread_cond_broadcast(&isrDisp_wakeCond);
+    pthread_mutex_unlock(&isrDisp_wakeLock);
+}
+
+/** wait until an interrupt was raised since the last call
+ *   - returns after 10ms at the latest so a stopped simulation
+ *     does not hang a caller forever
+ */
+void isrDisp_waitIrq(void)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += 10 * 1000 * 1000;
+    if ( deadline.tv_nsec >= 1000000000L ) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&isrDisp_wakeLock);
+    while ( 0 == isrDisp_irqLatched ) {
+        if ( 0 != pthread_cond_timedwait(&isrDisp_wakeCond, &isrDisp_wakeLock, &deadline) ) {
+            break;
+        }
+    }
+    isrDisp_irqLatched = 0;
+    pthread_mutex_unlock(&isrDisp_wakeLock);
+}
+
+/** enter a section that may not be interrupted */
+/** @return non-zero while the calling thread executes an interrupt handler */
+int isrDisp_inIsr(void)
+{
+    return 0 != isrDisp_depth;
+}
+
+void isrDisp_lock(void)
+{
+    pthread_mutex_lock(&isrDisp_irqLock);
+}
+
+/** leave a section that may not be interrupted */
+void isrDisp_unlock(void)
+{
+    pthread_mutex_unlock(&isrDisp_irqLock);
+}
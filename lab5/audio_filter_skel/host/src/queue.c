@@ -0,0 +1,88 @@
+/**
+ *@file queue.c
+ *
+ *@brief
+ *  - host (x86 Linux) replacement for the TLL6527 pointer queue
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "queue.h"
+#include "isrDisp.h"
+
+/** initialize queue
+ * @param pThis  pointer to own object
+ * @param size   queue depth (at most QUEUE_SIZE_MAX)
+ * @return Zero on success, FAIL otherwise
+ */
+int queue_init(queue_t *pThis, int size)
+{
+    if ( NULL == pThis || 0 >= size || QUEUE_SIZE_MAX < size ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->size = size;
+    return PASS;
+}
+
+/** append pointer at the tail
+ * @param pThis  pointer to own object
+ * @param pData  pointer to store
+ * @return Zero on success, FAIL if full
+ */
+int queue_put(queue_t *pThis, void *pData)
+{
+    int status = FAIL;
+
+    isrDisp_lock();
+    if ( pThis->count < pThis->size ) {
+        pThis->data[pThis->tail] = pData;
+        pThis->tail = (pThis->tail + 1) % pThis->size;
+        pThis->count++;
+        if ( pThis->count > pThis->levelMax ) {
+            pThis->levelMax = pThis->count;
+        }
+        pThis->levelSum += pThis->count;
+        pThis->nPut++;
+        status = PASS;
+    }
+    isrDisp_unlock();
+    return status;
+}
+
+/** remove pointer from the head
+ * @param pThis  pointer to own object
+ * @param ppData where to store the removed pointer
+ * @return Zero on success, FAIL if empty
+ */
+int queue_get(queue_t *pThis, void **ppData)
+{
+    int status = FAIL;
+
+    isrDisp_lock();
+    if ( 0 < pThis->count ) {
+        *ppData = pThis->data[pThis->head];
+        pThis->head = (pThis->head + 1) % pThis->size;
+        pThis->count--;
+        status = PASS;
+    }
+    isrDisp_unlock();
+    return status;
+}
+
+/** @return non-zero if the queue is empty */
+int queue_is_empty(queue_t *pThis)
+{
+    return 0 == pThis->count;
+}
+
+/** @return non-zero if the queue is full */
+int queue_is_full(queue_t *pThis)
+{
+    return pThis->size == pThis->count;
+}
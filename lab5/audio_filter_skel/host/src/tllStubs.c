@@ -0,0 +1,78 @@
+/**
+ *@file tllStubs.c
+ *
+ *@brief
+ *  - host (x86 Linux) stand-ins for the board support functions that
+ *    have no meaning in the simulation (processor/FPGA setup, core timer,
+ *    I2C, codec)
+ *
+ * Target:   x86 Linux host simulation
+ * Compiler: gcc
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "startup.h"
+#include "bf52xI2cMaster.h"
+#include "tll6527_core_timer.h"
+#include "ssm2602.h"
+#include "audioHalSim.h"
+
+/** processor setup, nothing to do */
+int blackfin_setup(void)
+{
+    return 0;
+}
+
+/** FPGA setup, nothing to do */
+int fpga_setup(void)
+{
+    return 0;
+}
+
+/** I2C master, nothing to do */
+int bf52xI2cMaster_init(int index, unsigned int clock)
+{
+    return PASS;
+}
+
+/** core timer, nothing to do */
+int coreTimer_init(void)
+{
+    return PASS;
+}
+
+/** sample rate in Hz for a codec setting */
+unsigned int ssm2602_rateHz(eSsm2602SampleFreq freq)
+{
+    static const unsigned int rates[] = {
+        8000, 16000, 22050, 32000, 44100, 48000, 88200, 96000
+    };
+
+    if ( freq > SSM2602_SR_96000 ) {
+        freq = SSM2602_SR_96000;
+    }
+    return rates[freq];
+}
+
+/** codec init, forwards the sample rate to the simulated DMA */
+int ssm2602_init(isrDisp_t *pIsrDisp, int volume, eSsm2602SampleFreq freq, int mode)
+{
+    audioHalSim_setRate(ssm2602_rateHz(freq));
+    return PASS;
+}
+
+/** codec volume, nothing to do */
+int ssm2602_setVolume(int target, int left, int right)
+{
+    return PASS;
+}
+
+/** codec sample rate, forwards the sample rate to the simulated DMA */
+int ssm2602_setSamplingFeq(int target, eSsm2602SampleFreq freq)
+{
+    audioHalSim_setRate(ssm2602_rateHz(freq));
+    return PASS;
+}
@@ -26,9 +26,41 @@
 #define FILTER_HIGHPASS     (0x01<<2)
 #define FILTER_COEFFICIENTS	33
 
+/** corners of filter 1..3 in Hz, designed for the running sample rate:
+ *  high-pass, low-pass and band-pass (-6 dB points of the Matlab designs
+ *  at 16 kHz); a band-pass narrower than the transition of 33 taps is
+ *  widened around its center (firDesign_fitBand) */
+#define AUDIOFILTER_HIGHPASS_HZ     (3500)
+#define AUDIOFILTER_LOWPASS_HZ      (2500)
+#define AUDIOFILTER_BANDLOW_HZ      (2550)
+#define AUDIOFILTER_BANDHIGH_HZ     (3450)
+
+/** rate of the Matlab coefficient sets, used instead of designs there */
+#define AUDIOFILTER_MATLAB_RATE     (16000)
+
+/** stop band attenuation of the FIR designs in dB (see firDesign.h) */
+#define AUDIOFILTER_ATTEN           (40)
+
+/** convolve the enabled filters into one kernel (see filterCascade.h) */
+#define AUDIOFILTER_CASCADE_COMBINE (1)
+
+/** arithmetic of the IIR versions of filter 1..3 (see biquad.h) */
+#define AUDIOFILTER_BIQUAD_FORMAT   BIQUAD_Q15
+
+/** implementation of filter 1..3
+ */
+typedef enum {
+	AUDIOFILTER_FIR,	/* 33 tap FIR, 33 MACs per sample and filter */
+	AUDIOFILTER_BIQUAD	/* 6th order IIR, 3 biquads, 15 MACs per sample and filter */
+} audioFilter_type_t;
+
 #include <filter.h>
 #include <string.h>
 #include <chunk.h>
+#include <filterCascade.h>
+#include <fftConv.h>
+#include <biquad.h>
+#include <firDesign.h>
 
 /** audioFilter attributes
  */
@@ -41,18 +73,42 @@ typedef struct {
 	fract16			filter2_delay[FILTER_COEFFICIENTS]; /* delay line for filter 2 calculations */
 	fract16			filter3_delay[FILTER_COEFFICIENTS]; /* delay line for filter 3 calculations */
 	
+	fract16			filter1_coeff[FILTER_COEFFICIENTS]; /* coefficients of filter 1 at rate */
+	fract16			filter2_coeff[FILTER_COEFFICIENTS]; /* coefficients of filter 2 at rate */
+	fract16			filter3_coeff[FILTER_COEFFICIENTS]; /* coefficients of filter 3 at rate */
+	unsigned int	rate;		/* sample rate the filters are designed for */
+	firDesign_cache_t	design;	/* designed coefficient sets by rate */
+	
+	filterCascade_t	cascade;	/* filter 1..3 as stages 0..2, applied in one pass */
+	
+	audioFilter_type_t	type;		/* FIR or biquad versions of filter 1..3 */
+	biquad_t		biquad[3];	/* biquad versions of filter 1..3 */
 } audioFilter_t;
 
 
 /** Initialization for audioFilter
  *
  * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
  *
  * @return Zero on success, negative otherwise 
  */
-int audioFilter_init(audioFilter_t *pThis);
+int audioFilter_init(audioFilter_t *pThis, unsigned int rate);
+
+/** Design filter 1..3 (FIR and biquad versions) for a sample rate
+ *   - FIR sets come from the design cache, a rate used before costs a
+ *     lookup; the active FIR delay lines are primed from the cascade
+ *     input history, the biquad states restart from silence
+ *
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return Zero on success, negative otherwise (old rate stays active)
+ */
+int audioFilter_setRate(audioFilter_t *pThis, unsigned int rate);
 
 /** The optimized filter process of audioFilter
+ *   - block FIR engine (firBlock_fr16), filters the chunk in place
  *
  * @param pData  pointer to a chunk of audio data - the filtered data is returned in this variable
  * @param pState pointer to a state variable for filter coefficients and delay line
@@ -70,5 +126,35 @@ void audioFilter_optimized(chunk_t *pData, fir_state_fr16 *pState);
  */
 void audioFilter_filter(chunk_t *pData, fir_state_fr16 *pState);
 
+/** Long filter process of audioFilter
+ *   - overlap-save FFT or direct form, as chosen by fftConv_init
+ *
+ * @param pData  pointer to a chunk of audio data - filtered in place
+ * @param pConv  convolution object, block at least the chunk samples
+ *
+ * @return no return
+ */
+void audioFilter_convolve(chunk_t *pData, fftConv_t *pConv);
+
+/** Select FIR or biquad implementation of filter 1..3
+ *   - the biquad states start from silence on every switch
+ *
+ * @param pThis  pointer to own object
+ * @param type   implementation
+ *
+ * @return no return
+ */
+void audioFilter_setType(audioFilter_t *pThis, audioFilter_type_t type);
+
+/** Apply all enabled filters in one pass
+ *
+ * @param pThis  pointer to own object
+ * @param pData  pointer to a chunk of audio data - filtered in place
+ * @param mask   bit 0..2 enable filter 1..3
+ *
+ * @return no return
+ */
+void audioFilter_cascade(audioFilter_t *pThis, chunk_t *pData, unsigned int mask);
+
 
 #endif /* _FILTER_H_ */
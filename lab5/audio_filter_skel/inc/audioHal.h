@@ -0,0 +1,150 @@
+/**
+ *@file audioHal.h
+ *
+ *@brief
+ *  - hardware abstraction for the audio DMA channels (DMA3 RX, DMA4 TX)
+ *  - src/audioHal.c drives the Blackfin DMA/SPORT registers
+ *  - host/src/audioHalSim.c provides a simulated DMA engine on x86 Linux
+ *  - two ways to run a channel: register mode (one transfer per
+ *    *DmaConfig, the ISR restarts the DMA) or a ring of large model
+ *    descriptors the DMA walks on its own (*DescInit / *DescStart);
+ *    RX also runs without interrupts over one circular buffer, the
+ *    caller follows its position (audioHal_rxAutoStart / _rxAutoPos)
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+
+#ifndef _AUDIO_HAL_H_
+#define _AUDIO_HAL_H_
+
+/***************************************************
+            DEFINES
+***************************************************/   
+
+/** execution contexts, e.g. one bufferPool magazine each */
+#define AUDIOHAL_CTX_NONE   (-1)    /* any thread, no private state (host only) */
+#define AUDIOHAL_CTX_MAIN   (0)     /* main loop */
+#define AUDIOHAL_CTX_ISR    (1)     /* DMA interrupt handlers (same level, do not nest) */
+#define AUDIOHAL_CTX_NUM    (2)
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** large model DMA descriptor (NDSIZE 9)
+ *   on the Blackfin the members map onto NDPL/NDPH, SAL/SAH, DMACFG,
+ *   XCNT, XMOD, YCNT, YMOD in the order the DMA fetches them
+ */
+typedef struct audioHal_desc_s {
+  struct audioHal_desc_s *pNext;  /* descriptor loaded after this one */
+  unsigned short    *pStart;      /* transfer buffer */
+  unsigned short    config;       /* DMA configuration for this transfer */
+  unsigned short    xCount;       /* inner loop: both slots of a frame ... */
+  short             xModify;      /* ... go to the same sample */
+  unsigned short    yCount;       /* outer loop: number of 16 bit samples */
+  short             yModify;
+} audioHal_desc_t;
+
+/***************************************************
+            Access Methods 
+***************************************************/
+
+/** Configure RX DMA (memory write, 16 bit, interrupt on completion) */
+void audioHal_rxInit(void);
+
+/** Point the RX DMA at a buffer and (re)start it
+ * @param pBuff     start of the receive buffer
+ * @param nSamples  number of 16 bit samples to receive
+ */
+void audioHal_rxDmaConfig(unsigned short *pBuff, int nSamples);
+
+/** start the receive side of SPORT0 */
+void audioHal_rxEnable(void);
+
+/** @return non-zero if the RX DMA completion interrupt is pending */
+int audioHal_rxIrqPending(void);
+
+/** acknowledge the RX DMA completion interrupt */
+void audioHal_rxIrqClear(void);
+
+/** Configure TX DMA (memory read, 16 bit, interrupt on completion) */
+void audioHal_txInit(void);
+
+/** Point the TX DMA at a buffer and (re)start it
+ * @param pBuff     start of the transmit buffer
+ * @param nSamples  number of 16 bit samples to transmit
+ */
+void audioHal_txDmaConfig(unsigned short *pBuff, int nSamples);
+
+/** start the transmit side of SPORT0 */
+void audioHal_txEnable(void);
+
+/** @return non-zero if the TX DMA completion interrupt is pending */
+int audioHal_txIrqPending(void);
+
+/** acknowledge the TX DMA completion interrupt */
+void audioHal_txIrqClear(void);
+
+/** Link descriptors into a ring for the RX DMA, pRing[i] is followed
+ *  by pRing[i+1], the last one by pRing[0]; buffers via audioHal_descSet
+ * @param pRing  descriptors
+ * @param nDesc  number of descriptors
+ */
+void audioHal_rxDescInit(audioHal_desc_t *pRing, int nDesc);
+
+/** Start the RX DMA on a descriptor ring, it then runs from descriptor
+ *  to descriptor and raises the completion interrupt after each one
+ * @param pFirst  first descriptor to work on
+ */
+void audioHal_rxDescStart(audioHal_desc_t *pFirst);
+
+/** @return descriptor the RX DMA loads once the current transfer is
+ *   done, i.e. the successor of the one it works on */
+audioHal_desc_t *audioHal_rxDescNext(void);
+
+/** Start the RX DMA in autobuffer mode without interrupts, it fills
+ *  pBuff over and over
+ * @param pBuff     start of the circular buffer
+ * @param nSamples  number of 16 bit samples in the buffer
+ */
+void audioHal_rxAutoStart(unsigned short *pBuff, int nSamples);
+
+/** @return index of the sample the autobuffer RX DMA writes next,
+ *   all samples before it are complete */
+int audioHal_rxAutoPos(void);
+
+/** called between two polls of a DMA position (host: let the simulated
+ *  DMA run, Blackfin: nothing) */
+void audioHal_poll(void);
+
+/** Link descriptors into a ring for the TX DMA, see audioHal_rxDescInit */
+void audioHal_txDescInit(audioHal_desc_t *pRing, int nDesc);
+
+/** Start the TX DMA on a descriptor ring, see audioHal_rxDescStart */
+void audioHal_txDescStart(audioHal_desc_t *pFirst);
+
+/** @return descriptor the TX DMA loads once the current transfer is done */
+audioHal_desc_t *audioHal_txDescNext(void);
+
+/** Set the buffer of a descriptor, only while the DMA does not work on it
+ * @param pDesc     descriptor
+ * @param pBuff     start of the buffer
+ * @param nSamples  number of 16 bit samples
+ */
+void audioHal_descSet(audioHal_desc_t *pDesc, unsigned short *pBuff, int nSamples);
+
+/** wait for the next interrupt in low power mode */
+void audioHal_idle(void);
+
+/** return to full power after waiting in audioHal_idle */
+void audioHal_active(void);
+
+/** @return execution context of the caller (AUDIOHAL_CTX_*) */
+int audioHal_context(void);
+
+#endif
@@ -23,6 +23,58 @@
 #include <audioRx.h>
 #include <audioTx.h>
 #include <audioFilter.h>
+#include <latency.h>
+#include <echo.h>
+#include <multirate.h>
+#include <eq.h>
+#include <limiter.h>
+#include <dtmf.h>
+
+/**
+ * @def AUDIOPLAYER_ARENA_SIZE
+ * @brief chunk memory of the player, 32 chunks of the default SAMPLE_SIZE;
+ * smaller chunks give more chunks (up to CHUNK_NUM_MAX), larger fewer
+ */
+#define AUDIOPLAYER_ARENA_SIZE  BUFFERPOOL_ARENA_SIZE(SAMPLE_SIZE, 32)
+
+/**
+ * @def AUDIOPLAYER_RATE
+ * @brief codec sample rate in Hz (SSM2602_SR_16000)
+ */
+#define AUDIOPLAYER_RATE        (16000)
+
+/**
+ * @def AUDIOPLAYER_ECHO_SAMPLES
+ * @brief echo delay line, 4.1 s at 16 kHz (128 KB = 64 default chunks)
+ */
+#define AUDIOPLAYER_ECHO_SAMPLES (64*1024)
+
+/**
+ * @def AUDIOPLAYER_ANALYSIS_FACTOR
+ * @brief decimation of the input for the analysis side path (half-band)
+ */
+#define AUDIOPLAYER_ANALYSIS_FACTOR (4)
+
+/**
+ * @def AUDIOPLAYER_ANALYSIS_ARENA_SIZE
+ * @brief chunk memory of the analysis pool, 8 decimated default chunks;
+ * larger chunks give fewer
+ */
+#define AUDIOPLAYER_ANALYSIS_ARENA_SIZE \
+    BUFFERPOOL_ARENA_SIZE(SAMPLE_SIZE / AUDIOPLAYER_ANALYSIS_FACTOR, 8)
+
+/**
+ * @def AUDIOPLAYER_FILTER_BOOST
+ * @brief boost of an enabled filter in dB, its pass band ripple rounded up
+ */
+#define AUDIOPLAYER_FILTER_BOOST (1)
+
+/**
+ * @def AUDIOPLAYER_RING_SIZE
+ * @brief chunks per DMA descriptor ring of RX and TX, the RX/TX ISRs
+ *        may run up to this many minus one chunks late
+ */
+#define AUDIOPLAYER_RING_SIZE   (3)
 
 
 /** audioPlayer object
@@ -32,7 +84,25 @@ typedef struct {
   audioTx_t      tx;  /* transmit object */
   audioFilter_t	 filter; /* filter object */
   bufferPool_t   bp;  /* buffer pool */
+  int            chunkSize; /* bytes per chunk, 0 = SAMPLE_SIZE, set before init */
+  int            ringSize;  /* chunks per DMA descriptor ring, 0 = AUDIOPLAYER_RING_SIZE,
+                               1 = register mode, set before init */
+  int            rxPolled;  /* RX without interrupts (audioRx_setPolled), set before init */
+  unsigned char  arena[AUDIOPLAYER_ARENA_SIZE]; /* chunk memory of bp */
   isrDisp_t      isrDisp; /* dispatcher for Rx Tx ISR */
+  latency_t      latency; /* RX to TX latency per stage, PB0 dumps it */
+  echo_t         echo;    /* FILTER_ECHO on SW0 */
+  fract16        echoLine[AUDIOPLAYER_ECHO_SAMPLES]; /* echo delay line */
+  multirate_t    analysis;     /* input decimator of the analysis path */
+  bufferPool_t   analysisPool; /* decimated chunks, separate from bp */
+  unsigned char  analysisArena[AUDIOPLAYER_ANALYSIS_ARENA_SIZE]; /* chunk memory of analysisPool */
+  int            levelPeak;    /* input level meter at the analysis rate: peak */
+  unsigned long long levelEnergy; /* sum of squares */
+  unsigned long  levelSamples; /* samples in levelEnergy */
+  unsigned long  analysisDrops; /* chunks not analyzed, analysisPool empty */
+  eq_t           eq;           /* 10 band EQ, PB2 selects a band, PB3 steps its gain */
+  limiter_t      limiter;      /* trims the chain input, limits its output */
+  dtmf_t         dtmf;         /* control tones on the input, keys act as SW / PB events */
 } audioPlayer_t;
 
 /** initialize audio player 
@@ -56,6 +126,13 @@ int audioPlayer_start(audioPlayer_t *pThis);
  **/
 void audioPlayer_run(audioPlayer_t *pThis);
 
+/** print the input level and the cost of the analysis path, restart the meter
+ *@param pThis  pointer to own object 
+ *
+ *@return None
+ **/
+void audioPlayer_analysisReport(audioPlayer_t *pThis);
+
 #endif
 
 
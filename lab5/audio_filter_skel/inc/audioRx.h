@@ -18,15 +18,35 @@
 #ifndef _AUDIO_RX_H_
 #define _AUDIO_RX_H_
 
-#include "queue.h"
+#include "spscRing.h"
 #include "bufferPool.h"
 #include "isrDisp.h"
+#include "audioHal.h"
 
 /***************************************************
             DEFINES
 ***************************************************/   
-/** queue depth */
-#define AUDIORX_QUEUE_DEPTH 7
+/** queue depth (power of two, see spscRing.h) */
+#define AUDIORX_QUEUE_DEPTH 8
+
+/**
+ * @def AUDIORX_RING_MAX
+ * @brief most chunks in the DMA descriptor ring (see audioRx_setRing)
+ */
+#define AUDIORX_RING_MAX    (8)
+
+/**
+ * @def AUDIORX_POLL_SAMPLES
+ * @brief samples in the circular DMA buffer of the polled mode, the main
+ *        loop has to poll at least once per round of the DMA
+ */
+#define AUDIORX_POLL_SAMPLES (4096)
+
+/**
+ * @def AUDIORX_POLL_MIN
+ * @brief smallest block handed out in polled mode, in samples
+ */
+#define AUDIORX_POLL_MIN    (16)
 
 
 /***************************************************
@@ -36,10 +56,20 @@
 /** audio RX object
  */
 typedef struct {
-  queue_t        queue;  /* queue for received buffers */
+  spscRing_t     queue;  /* queue for received buffers, ISR -> main loop */
   chunk_t        *pPending; /* pointer to pending chunk just in receiving */
   bufferPool_t   *pBuffP; /* pointer to buffer pool */
   FILE              *audioRx_pFile;  /* Audio File */
+  unsigned int   nDropped; /* chunks overwritten because the queue was full */
+  int            ringSize; /* chunks in the descriptor ring, 1 = register mode (pPending) */
+  int            ringHead; /* oldest descriptor not yet handed to the queue */
+  audioHal_desc_t ring[AUDIORX_RING_MAX];       /* DMA descriptors */
+  chunk_t        *pRingChunk[AUDIORX_RING_MAX]; /* chunk each descriptor fills */
+  unsigned int   nCoalesced; /* interrupts that found more than one chunk done */
+  int            polled;   /* no RX interrupts, the main loop follows the DMA position */
+  int            pollRead; /* next sample of pollBuff to hand out */
+  unsigned int   nOverrun; /* polled mode: DMA almost caught up with the reader, backlog skipped */
+  unsigned short pollBuff[AUDIORX_POLL_SAMPLES]; /* circular DMA buffer of the polled mode */
 } audioRx_t;
 
 
@@ -65,6 +95,37 @@ typedef struct {
 int audioRx_init(audioRx_t *pThis, bufferPool_t *pBuffP, 
                  isrDisp_t *pIsrDisp);
 
+/** Select the DMA mode, call between audioRx_init and audioRx_start
+ *    - 1: register mode, the ISR reprograms the DMA for every chunk
+ *      and has to run before the next sample arrives
+ *    - 2 .. AUDIORX_RING_MAX: the DMA runs through a ring of that many
+ *      chunk descriptors without stopping, the ISR only swaps the
+ *      filled chunks for fresh ones and has nSize - 1 chunks of time
+
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param nSize  chunks in the ring
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioRx_setRing(audioRx_t *pThis, int nSize);
+
+/** Select polled mode, call between audioRx_init and audioRx_start
+ *    - the DMA runs in autobuffer mode over pollBuff and raises no
+ *      interrupts, audioRx_getView/audioRx_getChunk compare its current
+ *      address with what was handed out so far
+ *    - the ring size (audioRx_setRing) does not apply
+
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param polled  non-zero for polled mode
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioRx_setPolled(audioRx_t *pThis, int polled);
+
 /** start audio rx
  *    - start receiving first chunk from DMA
  *      - acqurie chunk from pool 
@@ -103,5 +164,39 @@ void audioRx_isr(void *pThisArg);
  */
 int audioRx_get(audioRx_t *pThis, chunk_t *pChunk);
 
+/** audioRx_getChunk
+ *   hands a filled chunk over to the caller without copying
+ *   blocking call, blocks if queue is empty 
+ *     - get from queue 
+ *     - caller owns the chunk and has to pass it on (audioTx_putChunk)
+ *       or release it to the buffer pool
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param ppChunk pointer to chunk pointer, set to the filled chunk
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioRx_getChunk(audioRx_t *pThis, chunk_t **ppChunk);
+
+
+/** audioRx_getView
+ *   polled mode: view of the next received samples, without copying
+ *   and without blocking
+ *     - pView points into the DMA buffer, read only; it stays valid
+ *       until the DMA comes round again, i.e. for less than
+ *       AUDIORX_POLL_SAMPLES - nSamples samples
+ *     - a view stops at the end of the DMA buffer, pView->len may be
+ *       shorter than asked for, the next view continues at the start
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param pView     chunk object, set to the view
+ * @param nSamples  samples wanted, AUDIORX_POLL_MIN .. AUDIORX_POLL_SAMPLES/2
+ *
+ * @return Zero on success.
+ * Negative value if fewer samples are ready or on failure.
+ */
+int audioRx_getView(audioRx_t *pThis, chunk_t *pView, int nSamples);
+
 
 #endif
@@ -18,9 +18,11 @@
 #ifndef _AUDIO_TX_H_
 #define _AUDIO_TX_H_
 
-#include "queue.h"
+#include "spscRing.h"
 #include "bufferPool.h"
 #include "isrDisp.h"
+#include "latency.h"
+#include "audioHal.h"
 
 /***************************************************
             DEFINES
@@ -28,9 +30,15 @@
 
 /**
  * @def AUDIOTX_QUEUE_DEPTH
- * @brief tx queue depth
+ * @brief tx queue depth (power of two, see spscRing.h)
  */
-#define AUDIOTX_QUEUE_DEPTH  (7)
+#define AUDIOTX_QUEUE_DEPTH  (8)
+
+/**
+ * @def AUDIOTX_RING_MAX
+ * @brief most chunks in the DMA descriptor ring (see audioTx_setRing)
+ */
+#define AUDIOTX_RING_MAX     (8)
 
 /***************************************************
             DATA TYPES
@@ -39,10 +47,20 @@
 /** audio RX object
  */
 typedef struct {
-  queue_t       queue;  /* queue for received buffers */
+  spscRing_t    queue;  /* queue for buffers to send, main loop -> ISR */
   chunk_t       *pPending; /* pointer to pending chunk just in receiving */
   bufferPool_t  *pBuffP; /* pointer to buffer pool */
   int              running; /* DMA is Running */
+  unsigned int  nDropped;  /* chunks dropped because queue or pool was full */
+  unsigned int  nUnderrun; /* chunks replayed because the queue was empty */
+  latency_t     *pLatency; /* statistics fed at TX DMA start, NULL = off */
+  int           ringSize;  /* chunks in the descriptor ring, 1 = register mode (pPending) */
+  int           ringHead;  /* oldest descriptor not yet refilled */
+  int           ringFill;  /* descriptors filled before the DMA starts */
+  unsigned int  ringFresh; /* bit per descriptor: chunk not yet time stamped */
+  audioHal_desc_t ring[AUDIOTX_RING_MAX];       /* DMA descriptors */
+  chunk_t       *pRingChunk[AUDIOTX_RING_MAX]; /* chunk each descriptor plays */
+  unsigned int  nCoalesced; /* interrupts that found more than one chunk done */
 } audioTx_t;
 
 
@@ -66,6 +84,23 @@ typedef struct {
 int audioTx_init(audioTx_t *pThis, bufferPool_t *pBuffP, 
                  isrDisp_t *pIsrDisp);
 
+/** Select the DMA mode, call between audioTx_init and the first put
+ *    - 1: register mode, the ISR reprograms the DMA for every chunk
+ *      and has to run before the next sample is due
+ *    - 2 .. AUDIOTX_RING_MAX: the DMA runs through a ring of that many
+ *      chunk descriptors without stopping, the ISR only swaps played
+ *      chunks for queued ones and has nSize - 1 chunks of time; the
+ *      DMA starts once the first nSize chunks are put
+
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param nSize  chunks in the ring
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioTx_setRing(audioTx_t *pThis, int nSize);
+
 /** start audio tx
  *   - empthy for now
  * Parameters:
@@ -100,5 +135,19 @@ void audioTx_isr(void *pThis);
  */
 int audioTx_put(audioTx_t *pThis, chunk_t *pChunk);
 
+/** audio tx put chunk
+ *   hands pChunk over to the TX queue for transmission without copying
+ *    - ownership passes to audioTx, the chunk is released to the
+ *      buffer pool once it has been transmitted
+ *    - if queue is full, then chunk is dropped (released)
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pChunk Pointer to chunk acquired from the buffer pool
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioTx_putChunk(audioTx_t *pThis, chunk_t *pChunk);
+
 
 #endif
@@ -0,0 +1,200 @@
+/**
+ *@file biquad.h
+ *
+ *@brief
+ *  - cascade of second order IIR sections (biquads) in direct form II
+ *    transposed, a low cost alternative to the 33 tap FIR filters
+ *  - fixed point Q15 (16 bit data, Q2.14 coefficients, states in the
+ *    40 bit accumulator model of q15.h as on the Blackfin A0/A1), fixed point Q31
+ *    (32 bit data between sections, Q2.30 coefficients, 64 bit states)
+ *    and float arithmetic
+ *  - block processing: each section runs over a block of samples before
+ *    the next section, its coefficients stay in registers
+ *  - cookbook designs (low-, high-, band-pass, peaking and shelving EQ)
+ *    at init time, sections can be redesigned in a running cascade
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _BIQUAD_H_
+#define _BIQUAD_H_
+
+#include <filter.h>
+#include <chunk.h>
+
+/***************************************************
+            DEFINES
+***************************************************/   
+
+/**
+ * @def BIQUAD_SECTIONS_MAX
+ * @brief longest cascade (order 2 * BIQUAD_SECTIONS_MAX)
+ */
+#define BIQUAD_SECTIONS_MAX (4)
+
+/**
+ * @def BIQUAD_BLOCK
+ * @brief samples per section pass (Q31 / float scratch size)
+ */
+#define BIQUAD_BLOCK        (64)
+
+/** arithmetic of a cascade
+ */
+typedef enum {
+    BIQUAD_Q15,     /* 16 bit data, Q2.14 coefficients, 40 bit states */
+    BIQUAD_Q31,     /* 32 bit data, Q2.30 coefficients, 64 bit states */
+    BIQUAD_FLOAT    /* float data, coefficients and states */
+} biquad_format_t;
+
+/** cookbook section shapes
+ */
+typedef enum {
+    BIQUAD_LOWPASS,
+    BIQUAD_HIGHPASS,
+    BIQUAD_BANDPASS,    /* 0 dB peak gain */
+    BIQUAD_PEAKING,     /* gain around freq, 0 dB elsewhere */
+    BIQUAD_LOWSHELF,    /* gain below freq */
+    BIQUAD_HIGHSHELF    /* gain above freq */
+} biquad_shape_t;
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** section coefficients, a0 normalized to 1:
+ *  y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+ */
+typedef struct {
+  float b0, b1, b2, a1, a2;
+} biquad_coeff_t;
+
+/** biquad cascade object
+ */
+typedef struct {
+  biquad_format_t   format;     /* arithmetic */
+  int               nSections;  /* sections in use */
+  biquad_coeff_t    coeff[BIQUAD_SECTIONS_MAX];    /* design values */
+  short             q15[BIQUAD_SECTIONS_MAX][5];   /* b0 b1 b2 a1 a2 in Q2.14 */
+  int               q31[BIQUAD_SECTIONS_MAX][5];   /* b0 b1 b2 a1 a2 in Q2.30 */
+  long long         state[BIQUAD_SECTIONS_MAX][2]; /* fixed point s1, s2 */
+  float             stateF[BIQUAD_SECTIONS_MAX][2];/* float s1, s2 */
+} biquad_t;
+
+
+/***************************************************
+            Access Methods 
+***************************************************/
+
+/** Design one section (bilinear transform, pre-warped at freq)
+ *
+ * Parameters:
+ * @param pCoeff  filled with the section coefficients
+ * @param shape   response
+ * @param freq    corner / center frequency as fraction of the sample rate
+ * @param q       quality factor (0.7071 for a Butterworth pair)
+ *
+ * @return None 
+ */
+void biquad_design(biquad_coeff_t *pCoeff, biquad_shape_t shape, float freq, float q);
+
+/** Design one section with a gain (peaking and shelving shapes)
+ *
+ * Parameters:
+ * @param pCoeff  filled with the section coefficients
+ * @param shape   response, the pass shapes ignore gain
+ * @param freq    center (peaking) or mid-slope (shelf) frequency as
+ *                fraction of the sample rate
+ * @param q       quality factor (shelf: 0.7071 for the steepest slope
+ *                without overshoot)
+ * @param gain    gain in dB
+ *
+ * @return None 
+ */
+void biquad_designGain(biquad_coeff_t *pCoeff, biquad_shape_t shape, float freq, float q,
+                       float gain);
+
+/** Initialize an empty cascade
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param format  arithmetic
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int biquad_init(biquad_t *pThis, biquad_format_t format);
+
+/** Append a section, quantized to the cascade format
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pCoeff  section coefficients, |b|, |a| < 2
+ *
+ * @return Zero on success.
+ * Negative value on failure (cascade full or coefficient out of range).
+ */
+int biquad_addSection(biquad_t *pThis, const biquad_coeff_t *pCoeff);
+
+/** Replace the coefficients of a section, keeps its state
+ *   - parameter changes of a running filter without a restart
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param sec     section index, below nSections
+ * @param pCoeff  section coefficients, |b|, |a| < 2
+ *
+ * @return Zero on success.
+ * Negative value on failure (no such section or coefficient out of range).
+ */
+int biquad_setSection(biquad_t *pThis, int sec, const biquad_coeff_t *pCoeff);
+
+/** Append the sections of a Butterworth low- or high-pass
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param shape   BIQUAD_LOWPASS or BIQUAD_HIGHPASS
+ * @param freq    -3 dB frequency as fraction of the sample rate
+ * @param order   even filter order
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int biquad_addButterworth(biquad_t *pThis, biquad_shape_t shape, float freq, int order);
+
+/** Clear the filter states
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ *
+ * @return None 
+ */
+void biquad_reset(biquad_t *pThis);
+
+/** Filter samples, 1.15 in and out
+ *   - input and output may be the same buffer (in place)
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param output  output samples
+ * @param length  number of samples
+ *
+ * @return None 
+ */
+void biquad_filter(biquad_t *pThis, const fract16 input[], fract16 output[], int length);
+
+/** Filter a chunk in place
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None 
+ */
+void biquad_process(biquad_t *pThis, chunk_t *pChunk);
+
+#endif
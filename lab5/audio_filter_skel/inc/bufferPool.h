@@ -3,6 +3,8 @@
  *
  *@brief
  *  - manages a fixed size buffer pool for chunks
+ *  - lock-free free list shared by all contexts, plus one small
+ *    magazine per context (main loop, ISRs) for the common case
  *
  * Target:   TLL6537v1-1      
  * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
@@ -17,8 +19,8 @@
 #ifndef _BUFFER_POOL_H_
 #define _BUFFER_POOL_H_
 
-#include "queue.h"
 #include "isrDisp.h"
+#include "audioHal.h"
 #include <chunk.h>
 
 /***************************************************
@@ -27,18 +29,66 @@
 /**
  * @def CHUNK_NUM_MAX
  * @brief maximum number of chunks managed in this bufffer pool
- * since we use static allocation, one number for all
+ * (chunk descriptors are static, the data lives in the arena)
  */
-#define CHUNK_NUM_MAX (32)
+#define CHUNK_NUM_MAX (64)
+
+/**
+ * @def BUFFERPOOL_ALIGN
+ * @brief alignment of every chunk in the arena: a cache line, which
+ * also satisfies the 32 bit DMA word alignment
+ */
+#ifdef __bfin__
+#define BUFFERPOOL_ALIGN    (32)
+#else
+#define BUFFERPOOL_ALIGN    (64)
+#endif
+
+/**
+ * @def BUFFERPOOL_CHUNK_STRIDE
+ * @brief bytes a chunk of chunkSize bytes occupies in the arena
+ */
+#define BUFFERPOOL_CHUNK_STRIDE(chunkSize) \
+    (((chunkSize) + BUFFERPOOL_ALIGN - 1) & ~(BUFFERPOOL_ALIGN - 1))
+
+/**
+ * @def BUFFERPOOL_ARENA_SIZE
+ * @brief arena bytes needed for count chunks, including start alignment
+ */
+#define BUFFERPOOL_ARENA_SIZE(chunkSize, count) \
+    (BUFFERPOOL_CHUNK_STRIDE(chunkSize) * (count) + BUFFERPOOL_ALIGN)
+
+/**
+ * @def BUFFERPOOL_MAG_SIZE
+ * @brief chunks cached per execution context (magazine), refilled from
+ * and flushed to the shared free list in halves
+ */
+#define BUFFERPOOL_MAG_SIZE (4)
 
 /***************************************************
             DATA TYPESt
 ***************************************************/
 
+/** per context chunk cache, only touched by its own context
+ */
+typedef struct {
+  chunk_t       *pChunk[BUFFERPOOL_MAG_SIZE] __attribute__((aligned(32))); /* cached chunks */
+  int           count;  /* number of cached chunks */
+  unsigned long nHit;   /* acquire/release served by the magazine */
+  unsigned long nMiss;  /* acquire/release that went to the free list */
+} bufferPool_mag_t;
+
 /** bufferPool object
+ *   the free list is a lock-free stack of chunk indices; the top word
+ *   holds a tag in the upper half against ABA and index + 1 in the
+ *   lower half (0 = empty)
  */
 typedef struct {
-  queue_t    freeList;  /* List of free chunks */
+  unsigned int      freeTop;  /* tagged top of the free list */
+  unsigned short    freeNext[CHUNK_NUM_MAX]; /* index + 1 of the next free chunk */
+  bufferPool_mag_t  mag[AUDIOHAL_CTX_NUM]; /* magazines of main loop and ISRs */
+  int        chunkSize; /* bytes per chunk */
+  int        count;     /* number of chunks */
   chunk_t    buffer[CHUNK_NUM_MAX];
   isrDisp_t  isrDisp; /* dispatcher for Rx Tx ISR */
 } bufferPool_t;
@@ -49,15 +99,22 @@ typedef struct {
 ***************************************************/
 
 /** Initialize buffer pool 
+ *    - carve count chunks of chunkSize bytes from the arena, each
+ *      aligned to BUFFERPOOL_ALIGN
  *    - initialize freeList, populate with chunks
   *
  * Parameters:
- * @param pThis  pointer to buffer pool
+ * @param pThis      pointer to buffer pool
+ * @param chunkSize  bytes per chunk, multiple of 4
+ * @param count      number of chunks, at most CHUNK_NUM_MAX
+ * @param pArena     memory for the chunk data, see BUFFERPOOL_ARENA_SIZE
+ * @param arenaSize  size of the arena in bytes
  *
  * @return Zero on success.
  * Negative value on failure.
  */
-int bufferPool_init(bufferPool_t *pThis);
+int bufferPool_init(bufferPool_t *pThis, int chunkSize, int count,
+                    void *pArena, int arenaSize);
 
 
 /** Get a chunk from the  buffer pool 
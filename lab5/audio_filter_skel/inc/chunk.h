@@ -22,10 +22,16 @@
 
 /**
  * @def SAMPLE_SIZE
- * @brief Size of one chunk
+ * @brief default size of one chunk in bytes
  */
 #define SAMPLE_SIZE                 (1024*2)
 
+/**
+ * @def CHUNK_SIZE_MAX
+ * @brief largest chunk in bytes, for scratch buffers that hold a chunk
+ */
+#define CHUNK_SIZE_MAX              (4096*2)
+
 /**
  * Chunk status enumeration 
  */ 
@@ -36,38 +42,56 @@ typedef enum {
 	FREE       /** free */
 } e_buff_status_t;
 
+/**
+ * Time stamp points along the audio path (see latency.h)
+ */
+typedef enum {
+	CHUNK_STAMP_RX_DONE,      /** RX DMA completed */
+	CHUNK_STAMP_DEQUEUE,      /** taken from the RX queue by the main loop */
+	CHUNK_STAMP_FILTER_START, /** processing started */
+	CHUNK_STAMP_FILTER_END,   /** processing finished */
+	CHUNK_STAMP_TX_ENQUEUE,   /** handed to audioTx */
+	CHUNK_STAMP_TX_START,     /** TX DMA started on the chunk */
+	CHUNK_STAMP_NUM
+} e_chunk_stamp_t;
+
 
 
 /** Chunk Object
+ *   describes a data buffer owned elsewhere (e.g. the buffer pool arena)
  */
 typedef struct {
   /* define a union to have different acess to same data in chunk */
   union {
-    unsigned char       u08_buff[SAMPLE_SIZE];  /** Unsigned Data Chunk */
-    unsigned short      u16_buff[SAMPLE_SIZE/2];
-    unsigned int        u32_buff[SAMPLE_SIZE/4];
-    signed char         s08_buff[SAMPLE_SIZE];  /** Signed Data Chunk */
-    signed short        s16_buff[SAMPLE_SIZE/2];
-    signed int          s32_buff[SAMPLE_SIZE/4];
+    unsigned char       *u08_buff;  /** Unsigned Data Chunk */
+    unsigned short      *u16_buff;
+    unsigned int        *u32_buff;
+    signed char         *s08_buff;  /** Signed Data Chunk */
+    signed short        *s16_buff;
+    signed int          *s32_buff;
   };
   int                 size;         /** total number bytes in chunk */ 
   int                 len;          /**  used bytes in chunk (fill level) */ 
   e_buff_status_t     e_status;     /** status */ 
+  unsigned long long  stamp[CHUNK_STAMP_NUM]; /** cycle counter at each stamp point */
   
 } chunk_t;
 
 /** initialize chunk 
- *  - reset size of chunk to maximum 
+ *  - attach data buffer, set size of chunk to its size
  *  - does NOT zero the buffer !
  *@param pThis  pointer to own object 
+ *@param pBuff  data buffer, 32 bit aligned
+ *@param size   size of the data buffer in bytes
  *
  *@return 0 success, non-zero otherwise
  **/
-int chunk_init(chunk_t *pThis); 
+int chunk_init(chunk_t *pThis, void *pBuff, int size); 
 
 
 
 /** copy on chunk into nother 
+ *  - fails if the destination is smaller than the data
  *@param pSrc  pointer to source object (will not be modified)
  *@param pDst  pointer to destination object (will get the data of the src object)
  *
@@ -0,0 +1,122 @@
+/**
+ *@file dtmf.h
+ *
+ *@brief
+ *  - DTMF key decoder on a Goertzel bank of the 4 row and 4 column tones
+ *  - runs incrementally on chunks of any size, one decision per block
+ *    (GOERTZEL_BLOCK_MS): strongest row and column tone, both strong
+ *    enough, together most of the block energy, twist and the runner-up
+ *    in each group within limits
+ *  - a key is reported once when it was seen in DTMF_HITS blocks in a row,
+ *    again only after a block without it; keys queue for dtmf_keyGet
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _DTMF_H_
+#define _DTMF_H_
+
+#include <filter.h>
+#include <chunk.h>
+#include <goertzel.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def DTMF_HITS
+ * @brief blocks in a row that must show the same key (2 = 51 ms)
+ */
+#define DTMF_HITS           (2)
+
+/**
+ * @def DTMF_KEYS_MAX
+ * @brief keys queued for dtmf_keyGet
+ */
+#define DTMF_KEYS_MAX       (8)
+
+/**
+ * @def DTMF_LEVEL_MIN_DB
+ * @brief quietest block (mean square) considered, dBFS
+ */
+#define DTMF_LEVEL_MIN_DB   (-45)
+
+/**
+ * @def DTMF_TWIST_DB
+ * @brief largest level difference of the row and the column tone
+ */
+#define DTMF_TWIST_DB       (8)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** DTMF decoder object
+ */
+typedef struct {
+  goertzel_t        bank;       /* rows 697..941 Hz, columns 1209..1633 Hz */
+  char              candidate;  /* key of the last block, 0 = none */
+  int               hits;       /* blocks in a row with candidate */
+  int               reported;   /* candidate was queued */
+  char              keys[DTMF_KEYS_MAX]; /* detected keys, ring */
+  int               keyIn;
+  int               keyOut;
+  unsigned long     detected;   /* keys reported */
+  unsigned long     dropped;    /* keys lost, queue full */
+  unsigned long     calls;      /* processed chunks */
+  unsigned long long cycles;    /* cycles spent in them */
+} dtmf_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize a decoder
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int dtmf_init(dtmf_t *pThis, unsigned int rate);
+
+/** Decode a chunk, counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples (not modified)
+ *
+ * @return None
+ */
+void dtmf_process(dtmf_t *pThis, const chunk_t *pChunk);
+
+/** Get the next detected key (non blocking)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pKey   where to store the key, '0'..'9', 'A'..'D', '*', '#'
+ *
+ * @return Zero if a key was returned, FAIL otherwise
+ */
+int dtmf_keyGet(dtmf_t *pThis, char *pKey);
+
+/** Print keys and cycles per chunk
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param samples   samples per chunk, for cycles per sample
+ *
+ * @return None
+ */
+void dtmf_report(const dtmf_t *pThis, int samples);
+
+#endif
@@ -0,0 +1,149 @@
+/**
+ *@file echo.h
+ *
+ *@brief
+ *  - multi-tap echo / delay with feedback (FILTER_ECHO, SW0)
+ *      w[n] = x[n] + feedback * w[n - delay0]       (written to the line)
+ *      y[n] = dry * x[n] + sum_i gain_i * w[n - delay_i]
+ *  - the delay line is caller memory (several seconds, in SDRAM), used
+ *    as a ring; every tap reads ECHO_BLOCK contiguous samples per pass,
+ *    split into at most two segments where it wraps, so there is no
+ *    modulo per sample and the gain loops vectorize
+ *  - keeps cycles per call for the cost report
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _ECHO_H_
+#define _ECHO_H_
+
+#include <filter.h>
+#include <chunk.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def ECHO_TAPS_MAX
+ * @brief largest number of output taps
+ */
+#define ECHO_TAPS_MAX       (4)
+
+/**
+ * @def ECHO_BLOCK
+ * @brief samples per pass, also the shortest delay (a pass only reads
+ *        line samples written by earlier passes)
+ */
+#define ECHO_BLOCK          (64)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** echo object
+ */
+typedef struct {
+  fract16               *pLine;     /* delay line, lineLen samples */
+  int                   lineLen;    /* samples in the line */
+  int                   pos;        /* next line sample written */
+  int                   nTaps;      /* output taps in use */
+  int                   delay[ECHO_TAPS_MAX]; /* tap delays in samples */
+  fract16               gain[ECHO_TAPS_MAX];  /* tap gains, 1.15 */
+  fract16               feedback;   /* gain of tap 0 back into the line */
+  fract16               dry;        /* gain of the input */
+  unsigned long         calls;      /* processed chunks */
+  unsigned long long    cycles;     /* cycles spent in all calls */
+  unsigned long long    cyclesMax;  /* slowest call */
+} echo_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize an echo on a delay line, no taps, dry signal only
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param pLine    delay line memory
+ * @param lineLen  samples in pLine, at least 2 * ECHO_BLOCK
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int echo_init(echo_t *pThis, fract16 *pLine, int lineLen);
+
+/** Set (or add) an output tap
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param tap    tap index, 0..ECHO_TAPS_MAX-1, taps in between become silent
+ * @param delay  delay in samples, ECHO_BLOCK .. lineLen - ECHO_BLOCK
+ * @param gain   tap gain
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int echo_setTap(echo_t *pThis, int tap, int delay, fract16 gain);
+
+/** Set the dry and feedback gains
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param dry       gain of the input
+ * @param feedback  gain of tap 0 back into the line, < 1 to decay
+ *
+ * @return None
+ */
+void echo_setMix(echo_t *pThis, fract16 dry, fract16 feedback);
+
+/** Bound of the boost of the echo: the line holds at most
+ *  |x| / (1 - |feedback|), the output the dry input plus every tap of it
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return worst case gain in dB rounded up, 0 if it does not boost
+ */
+int echo_boost(const echo_t *pThis);
+
+/** Echo a block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param output  output samples (may equal input)
+ * @param length  number of samples
+ *
+ * @return None
+ */
+void echo_filter(echo_t *pThis, const fract16 input[], fract16 output[], int length);
+
+/** Echo a chunk in place, counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void echo_process(echo_t *pThis, chunk_t *pChunk);
+
+/** Print delay line memory (in chunks of the pool) and cycles per chunk
+ *
+ * Parameters:
+ * @param pThis      pointer to own object
+ * @param chunkSize  bytes per pool chunk
+ * @param nChunks    chunks in the pool
+ *
+ * @return None
+ */
+void echo_report(const echo_t *pThis, int chunkSize, int nChunks);
+
+#endif
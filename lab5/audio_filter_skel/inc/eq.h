@@ -0,0 +1,196 @@
+/**
+ *@file eq.h
+ *
+ *@brief
+ *  - 10 band graphic / parametric equalizer: one biquad section per
+ *    band (low shelf, 8 peaking bands, high shelf by default; shape,
+ *    frequency and q of every band can be changed)
+ *  - block processed: each active band runs over the whole chunk
+ *  - coefficients are only redesigned for bands whose parameters
+ *    changed, on the next chunk; a running band keeps its state
+ *  - bands at 0 dB are skipped (no cycles at all for a flat EQ)
+ *  - low bands run in Q31 (Q2.30 coefficients), where Q2.14 cannot
+ *    place the poles close enough to the unit circle
+ *  - cycles per chunk kept per number of active bands
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _EQ_H_
+#define _EQ_H_
+
+#include <filter.h>
+#include <chunk.h>
+#include <biquad.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def EQ_BANDS
+ * @brief number of bands
+ */
+#define EQ_BANDS            (10)
+
+/**
+ * @def EQ_GAIN_MAX
+ * @brief largest boost / cut in dB
+ */
+#define EQ_GAIN_MAX         (12)
+
+/**
+ * @def EQ_GAIN_STEP
+ * @brief gain step of the push button control in dB
+ */
+#define EQ_GAIN_STEP        (3)
+
+/**
+ * @def EQ_Q31_BELOW
+ * @brief bands below rate / EQ_Q31_BELOW use Q31 arithmetic
+ */
+#define EQ_Q31_BELOW        (32)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** one band */
+typedef struct {
+  biquad_shape_t    shape;      /* BIQUAD_PEAKING / LOWSHELF / HIGHSHELF */
+  float             freq;       /* center / mid-slope frequency in Hz */
+  float             q;          /* quality factor */
+  int               gain;       /* gain in dB, 0 = band skipped */
+  int               changed;    /* parameters changed since the last design */
+  int               active;     /* designed and running */
+  int               shift;      /* output shift, b scaled by 2^-shift to fit */
+  biquad_t          bq;         /* the section and its state */
+} eq_band_t;
+
+/** equalizer object
+ */
+typedef struct {
+  unsigned int      rate;       /* sample rate in Hz */
+  int               changed;    /* some band changed */
+  int               selected;   /* band of the push button control */
+  int               nActive;    /* running bands */
+  eq_band_t         band[EQ_BANDS];
+  unsigned long     designs;    /* section (re)designs */
+  unsigned long     calls[EQ_BANDS + 1];  /* chunks by active bands */
+  unsigned long long cycles[EQ_BANDS + 1]; /* their cycles */
+} eq_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize a flat equalizer
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int eq_init(eq_t *pThis, unsigned int rate);
+
+/** Set the gain of a band, applied with the next chunk
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param band   0 .. EQ_BANDS-1
+ * @param gain   dB, clipped to +-EQ_GAIN_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure (no such band).
+ */
+int eq_setGain(eq_t *pThis, int band, int gain);
+
+/** Bound of the boost of the bands: overlapping bands multiply, so the
+ *  boost of the chain is at most the sum of the positive band gains
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return sum of the positive band gains in dB, 0 if no band boosts
+ */
+int eq_boost(const eq_t *pThis);
+
+/** Set shape, frequency and q of a band (parametric use)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param band   0 .. EQ_BANDS-1
+ * @param shape  BIQUAD_PEAKING, BIQUAD_LOWSHELF or BIQUAD_HIGHSHELF
+ * @param freq   frequency in Hz, below half the rate
+ * @param q      quality factor
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int eq_setBand(eq_t *pThis, int band, biquad_shape_t shape, float freq, float q);
+
+/** Change the sample rate, every active band is redesigned
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return None
+ */
+void eq_setRate(eq_t *pThis, unsigned int rate);
+
+/** Push button control: step the selected band or the gain of it
+ *   - next band: selects the next band
+ *   - otherwise: gain + EQ_GAIN_STEP, after +EQ_GAIN_MAX back to -EQ_GAIN_MAX
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param nextBand non-zero to select the next band
+ *
+ * @return None
+ */
+void eq_step(eq_t *pThis, int nextBand);
+
+/** Command interface
+ *   - "flat": all bands 0 dB
+ *   - "band:gain[,band:gain..]", e.g. "0:6,4:-3,9:4"
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pCmd   command string
+ *
+ * @return Zero on success.
+ * Negative value on failure (nothing after the error is applied).
+ */
+int eq_command(eq_t *pThis, const char *pCmd);
+
+/** Equalize a chunk in place, counts the cycles of the call
+ *   - redesigns changed bands first
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void eq_process(eq_t *pThis, chunk_t *pChunk);
+
+/** Print the band settings and the cycles per chunk by active bands
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param samples   samples per chunk, for cycles per sample
+ *
+ * @return None
+ */
+void eq_report(const eq_t *pThis, int samples);
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ *@file fftConv.h
+ *
+ *@brief
+ *  - FIR filtering by overlap-save FFT convolution for long filters
+ *    (hundreds to thousands of taps) on the chunk stream
+ *  - radix-2 FFT in float (host) and in 32 bit fixed point with block
+ *    floating point scaling (Blackfin, no FPU)
+ *  - picks direct form (firBlock) or FFT from tap count and block size
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+
+#ifndef _FFT_CONV_H_
+#define _FFT_CONV_H_
+
+#include <filter.h>
+
+/***************************************************
+            DEFINES
+***************************************************/   
+
+/**
+ * @def FFTCONV_LOG2_MAX
+ * @brief largest FFT is 2^FFTCONV_LOG2_MAX points
+ */
+#define FFTCONV_LOG2_MAX    (12)
+
+/**
+ * @def FFTCONV_N_MAX
+ * @brief largest FFT size, taps + block - 1 must not exceed it
+ */
+#define FFTCONV_N_MAX       (1 << FFTCONV_LOG2_MAX)
+
+/** processing modes
+ */
+typedef enum {
+    FFTCONV_AUTO,       /* cheapest of direct and FFT, FFT in native arithmetic */
+    FFTCONV_DIRECT,     /* direct form FIR (firBlock) */
+    FFTCONV_FFT_FIXED,  /* overlap-save, fixed point FFT */
+    FFTCONV_FFT_FLOAT   /* overlap-save, float FFT */
+} fftConv_mode_t;
+
+/**
+ * @def FFTCONV_FFT_NATIVE
+ * @brief FFT arithmetic chosen by FFTCONV_AUTO, fixed point on Blackfin
+ */
+#ifdef __bfin__
+#define FFTCONV_FFT_NATIVE  FFTCONV_FFT_FIXED
+#else
+#define FFTCONV_FFT_NATIVE  FFTCONV_FFT_FLOAT
+#endif
+
+/**
+ * @def FFTCONV_MUL_DIRECT
+ * @brief cost of a tap of the direct form beyond FIRBLOCK_TAPS_MAX (per
+ *        sample fallback of firBlock), in MACs of the block kernel (dual
+ *        MAC on Blackfin, SIMD dot products on the host)
+ */
+#ifdef __bfin__
+#define FFTCONV_MUL_DIRECT  (2)
+#else
+#define FFTCONV_MUL_DIRECT  (12)
+#endif
+
+/**
+ * @def FFTCONV_MUL_FIXED
+ * @brief cost of a fixed point FFT multiply in MACs of the block kernel:
+ *        on Blackfin the 32 bit by 1.15 (or 32 bit) product into 64 bit
+ *        is built from several 16 bit multiplies, adds and a 64 bit
+ *        shift; on the host it is a scalar multiply against SIMD lanes
+ */
+#define FFTCONV_MUL_FIXED   (12)
+
+/**
+ * @def FFTCONV_MUL_FLOAT
+ * @brief cost of a float FFT multiply in MACs of the block kernel,
+ *        emulated on Blackfin
+ */
+#ifdef __bfin__
+#define FFTCONV_MUL_FLOAT   (60)
+#else
+#define FFTCONV_MUL_FLOAT   (12)
+#endif
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** fftConv object (large, allocate statically)
+ */
+typedef struct {
+  fftConv_mode_t  mode;       /* resolved mode, never FFTCONV_AUTO */
+  int             taps;       /* filter length */
+  int             block;      /* largest number of samples per call */
+  int             log2n;      /* FFT size is 1 << log2n */
+  fir_state_fr16  direct;     /* direct form state (FFTCONV_DIRECT) */
+  fract16         history[FFTCONV_N_MAX]; /* last taps-1 input samples */
+  int             hShift;     /* fixed point spectrum scale 2^hShift */
+  int             hRe[FFTCONV_N_MAX];    /* fixed point filter spectrum */
+  int             hIm[FFTCONV_N_MAX];
+  int             xRe[FFTCONV_N_MAX];    /* fixed point work buffer */
+  int             xIm[FFTCONV_N_MAX];
+  fract16         cosQ15[FFTCONV_N_MAX/2]; /* fixed point twiddles */
+  fract16         sinQ15[FFTCONV_N_MAX/2];
+  float           hReF[FFTCONV_N_MAX];   /* float filter spectrum */
+  float           hImF[FFTCONV_N_MAX];
+  float           xReF[FFTCONV_N_MAX];   /* float work buffer */
+  float           xImF[FFTCONV_N_MAX];
+  float           cosF[FFTCONV_N_MAX/2]; /* float twiddles */
+  float           sinF[FFTCONV_N_MAX/2];
+} fftConv_t;
+
+
+/***************************************************
+            Access Methods 
+***************************************************/
+
+/** Initialize convolution
+ *   - FFTCONV_AUTO picks direct form when it costs less (fftConv_cost)
+ *   - the FFT size is the next power of two >= taps + block - 1
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pCoeff  filter coefficients (1.15), must stay valid
+ * @param pDelay  delay line of taps samples for direct form, must stay valid
+ * @param taps    number of coefficients
+ * @param block   largest number of samples passed to fftConv_process
+ * @param mode    processing mode
+ *
+ * @return Zero on success.
+ * Negative value on failure (filter + block too long for FFTCONV_N_MAX).
+ */
+int fftConv_init(fftConv_t *pThis, fract16 *pCoeff, fract16 *pDelay,
+                 int taps, int block, fftConv_mode_t mode);
+
+/** Filter samples
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param output  output samples (may equal input)
+ * @param length  number of samples, at most block
+ *
+ * @return None 
+ */
+void fftConv_process(fftConv_t *pThis, const fract16 input[], fract16 output[], int length);
+
+/** Cost per sample of a mode, used for the automatic choice
+ *
+ * Parameters:
+ * @param taps   number of coefficients
+ * @param block  samples per call
+ * @param mode   FFTCONV_DIRECT or an FFT mode
+ *
+ * @return estimated cost per output sample in MACs of the firBlock
+ *         kernel, see FFTCONV_MUL_DIRECT .. FFTCONV_MUL_FLOAT
+ */
+int fftConv_cost(int taps, int block, fftConv_mode_t mode);
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ *@file filterCascade.h
+ *
+ *@brief
+ *  - applies all enabled FIR stages to a chunk in one pass
+ *  - separate mode: the chunk is walked in FILTERCASCADE_BLOCK sized
+ *    pieces and each piece runs through every active stage while it
+ *    is still in L1, instead of one full chunk pass per stage
+ *  - combined mode: the active stages are convolved into one kernel,
+ *    rebuilt only when the stage mask changes
+ *  - the last FILTERCASCADE_TAPS_MAX input samples are kept; on a mask
+ *    change the delay lines of the new configuration are primed from
+ *    them, the output continues as if it had run all along
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+
+#ifndef _FILTER_CASCADE_H_
+#define _FILTER_CASCADE_H_
+
+#include <filter.h>
+#include <chunk.h>
+#include <firBlock.h>
+
+/***************************************************
+            DEFINES
+***************************************************/   
+
+/**
+ * @def FILTERCASCADE_STAGES_MAX
+ * @brief maximum number of stages in a cascade
+ */
+#define FILTERCASCADE_STAGES_MAX    (4)
+
+/**
+ * @def FILTERCASCADE_BLOCK
+ * @brief samples carried through all stages at once (separate mode)
+ */
+#define FILTERCASCADE_BLOCK         (64)
+
+/**
+ * @def FILTERCASCADE_TAPS_MAX
+ * @brief longest combined kernel, longer combinations use separate mode
+ */
+#define FILTERCASCADE_TAPS_MAX      (FIRBLOCK_TAPS_MAX)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** filterCascade object
+ */
+typedef struct {
+  fir_state_fr16  *pStage[FILTERCASCADE_STAGES_MAX]; /* stages in processing order */
+  int             nStages;        /* number of registered stages */
+  unsigned int    mask;           /* active stages, bit i = stage i */
+  int             combine;        /* build a combined kernel if possible */
+  int             combined;       /* combined kernel is valid for mask */
+  int             combinedShift;  /* fractional bits of the combined kernel */
+  fract16         combinedCoeff[FILTERCASCADE_TAPS_MAX]; /* combined kernel */
+  fract16         combinedDelay[FILTERCASCADE_TAPS_MAX]; /* its delay line */
+  fir_state_fr16  combinedState;  /* its filter state */
+  fract16         history[FILTERCASCADE_TAPS_MAX]; /* last input samples */
+} filterCascade_t;
+
+
+/***************************************************
+            Access Methods 
+***************************************************/
+
+/** Initialize cascade with no stages and no stage active
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param combine  non-zero to convolve active FIR stages into one kernel
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int filterCascade_init(filterCascade_t *pThis, int combine);
+
+/** Append a FIR stage (initialized with fir_init)
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pStage  stage state, the stage index is the order of adding
+ *
+ * @return stage index on success.
+ * Negative value on failure.
+ */
+int filterCascade_addStage(filterCascade_t *pThis, fir_state_fr16 *pStage);
+
+/** Select the active stages
+ *   - rebuilds the combined kernel only if the mask changed
+ *   - primes the delay lines of the active stages (or of the combined
+ *     kernel) from the input history
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param mask   bit i enables stage i
+ *
+ * @return None 
+ */
+void filterCascade_setMask(filterCascade_t *pThis, unsigned int mask);
+
+/** Rebuild after the coefficients of stages changed (same mask)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return None 
+ */
+void filterCascade_update(filterCascade_t *pThis);
+
+/** Filter a chunk in place through all active stages
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None 
+ */
+void filterCascade_process(filterCascade_t *pThis, chunk_t *pChunk);
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ *@file firBlock.h
+ *
+ *@brief
+ *  - block based FIR engine, drop-in replacement for fir_fr16
+ *  - works on the same fir_state_fr16 (fir_init) as the library routine
+ *  - the circular delay line is linearized once per call into a scratch
+ *    buffer, so the inner loops run over contiguous memory with no
+ *    modulo addressing and compute two outputs per pass (dual MAC on
+ *    Blackfin, auto-vectorized SSE2/AVX2 dot products on the host)
+ *  - linear phase (symmetric) coefficient sets are detected per call and
+ *    folded: mirrored taps are pre-added, half the multiplies
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+
+#ifndef _FIR_BLOCK_H_
+#define _FIR_BLOCK_H_
+
+#include <filter.h>
+
+/***************************************************
+            DEFINES
+***************************************************/   
+
+/**
+ * @def FIRBLOCK_SIZE
+ * @brief samples processed per pass over the scratch buffer
+ */
+#define FIRBLOCK_SIZE       (64)
+
+/**
+ * @def FIRBLOCK_TAPS_MAX
+ * @brief longest filter handled by the block kernel, longer filters
+ *        fall back to a per-sample loop
+ */
+#define FIRBLOCK_TAPS_MAX   (128)
+
+/**
+ * @def FIRBLOCK_FOLD
+ * @brief 1: use the folded kernel for symmetric coefficients
+ *   The pre-added taps need 17 bits, so the folded products run in 32 bit
+ *   lanes. That wins where the multiplies are scalar (Blackfin MAC, plain
+ *   C), but loses against pmaddwd on SSE2 which packs eight 16x16
+ *   products per instruction, so the host keeps the unfolded kernel.
+ *   Override with -DFIRBLOCK_FOLD=1 to use the folded path on the host,
+ *   the host -F check builds a folded copy of firBlock.c that way.
+ */
+#ifndef FIRBLOCK_FOLD
+#ifdef __SSE2__
+#define FIRBLOCK_FOLD       (0)
+#else
+#define FIRBLOCK_FOLD       (1)
+#endif
+#endif
+
+
+/***************************************************
+            Access Methods 
+***************************************************/
+
+/** Block FIR filter, 1.15 in and out
+ *   - same interface and state as fir_fr16
+ *   - input and output may be the same buffer (in place)
+ *   - products are accumulated in 32 bit, the result is rounded and
+ *     saturated; no overflow as long as the sum of the integer |h| is
+ *     below 65536 (2.0 in 1.15, |acc| < 65536 * 32768 = 2^31). The
+ *     folded kernel pre-adds mirrored samples to 17 bit (|x + x'| <=
+ *     65536) and multiplies each pair once, so the bound is the same
+ *
+ * Parameters:
+ * @param input   input samples
+ * @param output  output samples
+ * @param length  number of samples
+ * @param s       filter state initialized with fir_init
+ *
+ * @return None 
+ */
+void firBlock_fr16(const fract16 input[], fract16 output[], int length, fir_state_fr16 *s);
+
+/** Block FIR filter with coefficients in 1.shift format
+ *   - for kernels whose taps are too small for 1.15 (e.g. convolved
+ *     cascades), the coefficients are scaled up by 2^(shift-15) and the
+ *     accumulator is shifted down by shift instead of 15
+ *   - no overflow as long as the sum of the integer |h| is below
+ *     65536 - 2^(shift-16), the rounding constant 2^(shift-1) takes the
+ *     rest of the 32 bit accumulator (folded or not, see firBlock_fr16)
+ *
+ * Parameters:
+ * @param input   input samples
+ * @param output  output samples
+ * @param length  number of samples
+ * @param s       filter state initialized with fir_init
+ * @param shift   fractional bits of the coefficients (15 for 1.15, max 30)
+ *
+ * @return None 
+ */
+void firBlock_fr16Scaled(const fract16 input[], fract16 output[], int length,
+                         fir_state_fr16 *s, int shift);
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ *@file firDesign.h
+ *
+ *@brief
+ *  - runtime FIR design: Kaiser windowed sinc low-, high-, band-pass and
+ *    band-stop filters for any sample rate, cut-off and tap count,
+ *    quantized to 1.15 coefficients for fir_init / firBlock
+ *  - the window is chosen from the stop band attenuation (Kaiser's
+ *    beta formula), so one spec trades transition width against ripple
+ *    without an iterative (Parks-McClellan) design on the target
+ *  - a small cache of designed sets keyed by the full spec: switching
+ *    back to a rate that was used before is a table lookup, the design
+ *    (a few thousand sin/exp) only runs on a miss
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _FIR_DESIGN_H_
+#define _FIR_DESIGN_H_
+
+#include <filter.h>
+#include <firBlock.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def FIRDESIGN_TAPS_MAX
+ * @brief longest designed filter
+ */
+#define FIRDESIGN_TAPS_MAX      (FIRBLOCK_TAPS_MAX)
+
+/**
+ * @def FIRDESIGN_CACHE_SETS
+ * @brief designed sets kept, least recently used is replaced
+ *        (three filters at two rates fit without a redesign)
+ */
+#define FIRDESIGN_CACHE_SETS    (8)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** filter shapes
+ */
+typedef enum {
+    FIRDESIGN_LOWPASS,      /* pass 0 .. f1 */
+    FIRDESIGN_HIGHPASS,     /* pass f1 .. rate/2, odd taps */
+    FIRDESIGN_BANDPASS,     /* pass f1 .. f2 */
+    FIRDESIGN_BANDSTOP      /* stop f1 .. f2, odd taps */
+} firDesign_shape_t;
+
+/** design spec, also the cache key
+ */
+typedef struct {
+  firDesign_shape_t shape;
+  unsigned int      rate;   /* sample rate in Hz */
+  unsigned int      f1;     /* cut-off (-6 dB) in Hz, lower edge of a band */
+  unsigned int      f2;     /* upper band edge in Hz, unused for low/high-pass */
+  int               taps;   /* filter length */
+  int               atten;  /* stop band attenuation in dB, sets the window */
+} firDesign_spec_t;
+
+/** one cached set */
+typedef struct {
+  firDesign_spec_t  spec;
+  unsigned long     used;   /* cache clock at the last lookup, 0 = empty */
+  fract16           coeff[FIRDESIGN_TAPS_MAX];
+} firDesign_entry_t;
+
+/** coefficient cache object
+ */
+typedef struct {
+  unsigned long     clock;  /* lookups so far */
+  unsigned long     hits;   /* lookups served from the cache */
+  unsigned long     misses; /* lookups that designed */
+  firDesign_entry_t entry[FIRDESIGN_CACHE_SETS];
+} firDesign_cache_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Design a filter
+ *   - unity gain in the pass band: at DC (low-pass, band-stop), at
+ *     rate/2 (high-pass) or at the band center (band-pass)
+ *
+ * Parameters:
+ * @param pSpec  filter spec
+ * @param coeff  filled with pSpec->taps 1.15 coefficients
+ *
+ * @return Zero on success.
+ * Negative value on failure (invalid spec).
+ */
+int firDesign_design(const firDesign_spec_t *pSpec, fract16 coeff[]);
+
+/** Widen a band narrower than the transition width
+ *   - the Kaiser transition width of taps and atten is
+ *     rate * (atten - 7.95) / (14.36 * (taps - 1)); a band-pass or
+ *     band-stop narrower than that reaches neither the attenuation nor
+ *     its -6 dB edges, so f1 .. f2 is widened to it around the center
+ *
+ * Parameters:
+ * @param pSpec  filter spec, f1 and f2 updated
+ *
+ * @return 1 if the band was widened, 0 otherwise
+ */
+int firDesign_fitBand(firDesign_spec_t *pSpec);
+
+/** Initialize an empty cache
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int firDesign_cacheInit(firDesign_cache_t *pThis);
+
+/** Coefficients for a spec, designed on a miss
+ *   - the set stays valid until FIRDESIGN_CACHE_SETS other specs were
+ *     looked up, callers keeping a filter copy it
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pSpec  filter spec
+ *
+ * @return pSpec->taps coefficients, NULL for an invalid spec
+ */
+const fract16 *firDesign_get(firDesign_cache_t *pThis, const firDesign_spec_t *pSpec);
+
+#endif
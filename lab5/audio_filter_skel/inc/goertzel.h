@@ -0,0 +1,102 @@
+/**
+ *@file goertzel.h
+ *
+ *@brief
+ *  - bank of up to GOERTZEL_MAX Goertzel filters: signal power at single
+ *    frequencies over blocks of blockLen samples, much cheaper than an
+ *    FFT of the block when only a few frequencies are of interest
+ *  - incremental: samples are fed in any pieces (chunks), the filter
+ *    states and the block position carry over; goertzel_feed stops at a
+ *    block end so no result is lost when a chunk spans several blocks
+ *  - the detectors are kept as arrays (coefficient, s1, s2 each), the
+ *    per-sample update is one loop over all detectors which the compiler
+ *    vectorizes
+ *  - fixed point: Q14 coefficients, 32 bit states (32 x 16 bit products
+ *    built from two 16 x 16 bit parts), the input pre-shifted so the
+ *    states of the lowest frequency cannot overflow in a block
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _GOERTZEL_H_
+#define _GOERTZEL_H_
+
+#include <filter.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def GOERTZEL_MAX
+ * @brief detectors per bank; up to about 16 detectors a bank is cheaper
+ *        than a 1024 point FFT per block, 64 cost more than a whole one
+ */
+#define GOERTZEL_MAX        (64)
+
+/**
+ * @def GOERTZEL_BLOCK_MS
+ * @brief default block length in ms (205 samples at 8 kHz)
+ */
+#define GOERTZEL_BLOCK_MS   (25.6)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** detector bank object
+ */
+typedef struct {
+  int               n;          /* detectors */
+  int               blockLen;   /* samples per result */
+  int               shift;      /* input pre-shift */
+  int               count;      /* samples of the running block */
+  int               ready;      /* a block ended with the last feed */
+  int               coeff[GOERTZEL_MAX]; /* 2 cos(w) in Q14 */
+  int               s1[GOERTZEL_MAX];    /* filter states */
+  int               s2[GOERTZEL_MAX];
+  long long         energy;     /* sum of x^2 of the running block */
+  float             freq[GOERTZEL_MAX];  /* detector frequencies in Hz */
+  float             power[GOERTZEL_MAX]; /* last block: share of its energy at freq */
+  float             level;      /* last block: mean square re full scale */
+  unsigned long     blocks;     /* completed blocks */
+} goertzel_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize a bank with cleared states
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param rate      sample rate in Hz
+ * @param freq      detector frequencies in Hz, 0 < freq < rate/2
+ * @param n         number of detectors, 1 .. GOERTZEL_MAX
+ * @param blockLen  samples per block, 0 for GOERTZEL_BLOCK_MS
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int goertzel_init(goertzel_t *pThis, unsigned int rate, const float freq[], int n, int blockLen);
+
+/** Feed samples up to the end of the running block
+ *   - at a block end power[] and level are updated, ready is set and the
+ *     next block starts; call again with the rest
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   samples
+ * @param length  number of samples
+ *
+ * @return number of samples consumed
+ */
+int goertzel_feed(goertzel_t *pThis, const fract16 input[], int length);
+
+#endif
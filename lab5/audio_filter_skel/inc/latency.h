@@ -0,0 +1,133 @@
+/**
+ *@file latency.h
+ *
+ *@brief
+ *  - per chunk time stamps along the audio path and per stage latency
+ *    histograms (p50 / p99 / max), dumped on demand
+ *  - time base is the cycle counter (cycle_count_bf.h on the Blackfin,
+ *    rdtsc / clock_gettime on the host)
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+#include <cycle_count.h>
+#include <cycle_count_bf.h>
+#include <chunk.h>
+
+/***************************************************
+            DEFINES
+***************************************************/   
+
+/**
+ * @def LATENCY_ENABLE
+ * @brief set to 0 to compile out all time stamps
+ */
+#ifndef LATENCY_ENABLE
+#define LATENCY_ENABLE      (1)
+#endif
+
+/**
+ * @def LATENCY_BUCKETS
+ * @brief histogram buckets per stage: exact below 16 cycles, then four
+ * buckets per power of two (< 19% bucket width)
+ */
+#define LATENCY_BUCKETS     (256)
+
+/**
+ * @def LATENCY_CCLK_MHZ
+ * @brief core clock of the target, cycles per microsecond
+ */
+#define LATENCY_CCLK_MHZ    (600)
+
+/**
+ * @def LATENCY_STAMP
+ * @brief time stamp a chunk at one point of the audio path
+ */
+#if LATENCY_ENABLE
+#define LATENCY_STAMP(pChunk, point)    _GET_CYCLE_COUNT((pChunk)->stamp[point])
+#else
+#define LATENCY_STAMP(pChunk, point)
+#endif
+
+/** measured intervals between the chunk time stamps
+ */
+typedef enum {
+    LATENCY_RX_QUEUE,   /* RX complete -> dequeued by main loop */
+    LATENCY_PRE,        /* dequeue -> filter start */
+    LATENCY_FILTER,     /* filter start -> filter end */
+    LATENCY_POST,       /* filter end -> TX enqueue */
+    LATENCY_TX_QUEUE,   /* TX enqueue -> TX DMA start */
+    LATENCY_TOTAL,      /* RX complete -> TX DMA start */
+    LATENCY_STAGE_NUM
+} latency_stage_t;
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** latency object
+ *   written by the TX ISR, read by latency_dump; a dump racing with an
+ *   update may be off by one sample, which is fine for a report
+ */
+typedef struct {
+  unsigned int          hist[LATENCY_STAGE_NUM][LATENCY_BUCKETS]; /* bucket counts */
+  unsigned long         count[LATENCY_STAGE_NUM]; /* samples per stage */
+  unsigned long long    max[LATENCY_STAGE_NUM];   /* largest sample */
+  double                cyclesPerUs;              /* time base */
+} latency_t;
+
+
+/***************************************************
+            Access Methods 
+***************************************************/
+
+/** Initialize latency statistics
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int latency_init(latency_t *pThis);
+
+/** Add the intervals of a chunk that just started TX DMA
+ *   - all stamps up to CHUNK_STAMP_TX_START must be set
+ *   - callable from interrupt context
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  time stamped chunk
+ *
+ * @return None 
+ */
+void latency_record(latency_t *pThis, const chunk_t *pChunk);
+
+/** Percentile of one stage
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param stage     interval
+ * @param percent   percentile 0..100
+ *
+ * @return upper bound of the percentile bucket in cycles
+ */
+unsigned long long latency_percentile(latency_t *pThis, latency_stage_t stage, int percent);
+
+/** Print p50 / p99 / max of every stage
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return None 
+ */
+void latency_dump(latency_t *pThis);
+
+#endif
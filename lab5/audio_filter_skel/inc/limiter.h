@@ -0,0 +1,195 @@
+/**
+ *@file limiter.h
+ *
+ *@brief
+ *  - look-ahead compressor / limiter at the end of the processing chain
+ *  - the chain runs with headroom: limiter_trim takes the input down by
+ *    2^headroom before echo, EQ and filters, limiter_process restores the
+ *    gain and limits the result to LIMITER_CEILING, so boosting stages
+ *    neither clip internally nor at the output; with headroom 0 a quiet
+ *    chain passes bit-exact (delayed by LIMITER_LOOKAHEAD)
+ *  - block based: peak envelope per LIMITER_LOOKAHEAD samples (a max-abs
+ *    reduction that vectorizes), one gain computer call per block, the
+ *    gain ramps linearly over the block; the output is delayed by
+ *    LIMITER_LOOKAHEAD samples so a ramp is complete before a peak leaves
+ *  - fixed point gain computer in the log2 domain (Q16) with small log2 /
+ *    exp2 tables, no transcendental calls while running
+ *  - gain reduction meter: current and largest reduction, read cheaply
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _LIMITER_H_
+#define _LIMITER_H_
+
+#include <filter.h>
+#include <chunk.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def LIMITER_LOOKAHEAD
+ * @brief look-ahead delay and gain block in samples (2 ms at 16 kHz)
+ */
+#define LIMITER_LOOKAHEAD   (32)
+
+/**
+ * @def LIMITER_CEILING
+ * @brief largest output magnitude, -0.1 dBFS
+ */
+#define LIMITER_CEILING     (0x7e8a)
+
+/**
+ * @def LIMITER_HEADROOM_MAX
+ * @brief largest trim shift (24 dB)
+ */
+#define LIMITER_HEADROOM_MAX (4)
+
+/**
+ * @def LIMITER_RELEASE_MS
+ * @brief release time constant in ms
+ */
+#define LIMITER_RELEASE_MS  (100)
+
+/**
+ * @def LIMITER_UNITY
+ * @brief gain 1.0 (Q15 gains are 0 .. LIMITER_UNITY)
+ */
+#define LIMITER_UNITY       (0x8000)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** limiter object
+ */
+typedef struct {
+  unsigned int      rate;       /* sample rate in Hz */
+  int               headroom;   /* trim / makeup shift */
+  int               thresholdDb;/* compressor threshold in dBFS */
+  int               ratio;      /* compressor ratio, 0 = limiter only */
+  int               threshold;  /* threshold as log2 re full scale, Q16 */
+  int               slope;      /* 1 - 1/ratio, Q15 */
+  int               ceiling;    /* LIMITER_CEILING as log2 re full scale, Q16 */
+  int               release;    /* gain step towards unity per block, Q15 */
+  int               gain;       /* gain at the end of the last block, Q15 */
+  int               gainMin;    /* lowest gain since the last meter read */
+  fract16           line[LIMITER_LOOKAHEAD]; /* trimmed samples not yet out */
+  unsigned long     calls;      /* processed chunks */
+  unsigned long     blocks;     /* gain blocks */
+  unsigned long     limited;    /* of those with a gain below unity */
+  unsigned long long cycles;    /* cycles spent in limiter_process */
+  unsigned long long cyclesMax; /* worst chunk */
+} limiter_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize a limiter (no compression, limit at LIMITER_CEILING)
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param rate      sample rate in Hz
+ * @param headroom  trim shift 0 .. LIMITER_HEADROOM_MAX, 6 dB each
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int limiter_init(limiter_t *pThis, unsigned int rate, int headroom);
+
+/** Set the compressor curve, the ceiling always applies
+ *
+ * Parameters:
+ * @param pThis        pointer to own object
+ * @param thresholdDb  threshold in dBFS (output level)
+ * @param ratio        input / output dB above the threshold, 0 = none
+ *
+ * @return None
+ */
+void limiter_setCurve(limiter_t *pThis, int thresholdDb, int ratio);
+
+/** Change the sample rate (release time)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return None
+ */
+void limiter_setRate(limiter_t *pThis, unsigned int rate);
+
+/** Change the headroom, e.g. 0 while no stage of the chain boosts
+ *   - the samples in the look-ahead line are rescaled, the output
+ *     continues without a step
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param headroom  trim shift 0 .. LIMITER_HEADROOM_MAX, 6 dB each
+ *
+ * @return None
+ */
+void limiter_setHeadroom(limiter_t *pThis, int headroom);
+
+/** Trim shift for a chain that boosts by up to boost dB
+ *
+ * Parameters:
+ * @param boost  bound of the boost of the chain in dB
+ *
+ * @return headroom 0 .. LIMITER_HEADROOM_MAX, 6 dB each, the largest if
+ *         the chain can boost by more
+ */
+int limiter_boostHeadroom(int boost);
+
+/** Take a chunk down by the headroom, at the start of the chain
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void limiter_trim(const limiter_t *pThis, chunk_t *pChunk);
+
+/** Restore the gain and limit a chunk in place, at the end of the chain
+ *   - the output is delayed by LIMITER_LOOKAHEAD samples
+ *   - counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void limiter_process(limiter_t *pThis, chunk_t *pChunk);
+
+/** Gain reduction meter
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pPeak   if not NULL: largest reduction since the last read in
+ *                0.1 dB, the peak restarts
+ *
+ * @return current gain reduction in 0.1 dB
+ */
+int limiter_meter(limiter_t *pThis, int *pPeak);
+
+/** Print curve, meter and cycles per chunk, restarts the meter peak
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param samples   samples per chunk, for cycles per sample
+ *
+ * @return None
+ */
+void limiter_report(limiter_t *pThis, int samples);
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ *@file multirate.h
+ *
+ *@brief
+ *  - streaming decimate-by-N and interpolate-by-N stages on chunk_t, for
+ *    analysis side paths (level meters, spectra) at 1/2 .. 1/8 of the
+ *    audio rate
+ *  - half-band mode (N = 2, 4, 8): a cascade of 2:1 stages with one
+ *    MULTIRATE_HB_TAPS long half-band low-pass each. Every second
+ *    coefficient of a half-band filter is zero and the center is 1/2,
+ *    so a 2:1 output costs MULTIRATE_HB_SIDE MACs on pre-added mirrored
+ *    pairs instead of MULTIRATE_HB_TAPS; the interpolator's second
+ *    phase is a plain delay
+ *  - polyphase mode (N = 2 .. MULTIRATE_FACTOR_MAX): one low-pass of
+ *    MULTIRATE_POLY_TAPS taps per phase; the decimator only computes
+ *    every Nth output, the interpolator skips the stuffed zeros
+ *  - 1.15 data and coefficients (firDesign), 32 bit accumulator,
+ *    rounded and saturated outputs
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _MULTIRATE_H_
+#define _MULTIRATE_H_
+
+#include <filter.h>
+#include <chunk.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def MULTIRATE_HB_TAPS
+ * @brief half-band filter length, 4k+3 (non-zero taps at odd offsets)
+ */
+#define MULTIRATE_HB_TAPS       (23)
+
+/**
+ * @def MULTIRATE_HB_SIDE
+ * @brief non-zero coefficients on one side of the half-band center
+ */
+#define MULTIRATE_HB_SIDE       ((MULTIRATE_HB_TAPS + 1) / 4)
+
+/**
+ * @def MULTIRATE_STAGES_MAX
+ * @brief half-band stages, factor 2^MULTIRATE_STAGES_MAX at most
+ */
+#define MULTIRATE_STAGES_MAX    (3)
+
+/**
+ * @def MULTIRATE_FACTOR_MAX
+ * @brief largest factor of the polyphase mode
+ */
+#define MULTIRATE_FACTOR_MAX    (8)
+
+/**
+ * @def MULTIRATE_POLY_TAPS
+ * @brief taps per phase of the polyphase mode (prototype N * taps long)
+ */
+#define MULTIRATE_POLY_TAPS     (8)
+
+/**
+ * @def MULTIRATE_BLOCK
+ * @brief samples linearized per pass (scratch size)
+ */
+#define MULTIRATE_BLOCK         (256)
+
+/**
+ * @def MULTIRATE_ATTEN
+ * @brief stop band attenuation of the designs in dB
+ */
+#define MULTIRATE_ATTEN         (60)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** direction
+ */
+typedef enum {
+    MULTIRATE_DECIMATE,     /* N inputs per output */
+    MULTIRATE_INTERPOLATE   /* N outputs per input */
+} multirate_dir_t;
+
+/** one 2:1 half-band stage */
+typedef struct {
+  int           phase;      /* decimator: input index of the next output */
+  fract16       hist[MULTIRATE_HB_TAPS - 1]; /* newest inputs, oldest first */
+} multirate_hb_t;
+
+/** multirate object
+ */
+typedef struct {
+  multirate_dir_t dir;
+  int           factor;     /* N */
+  int           halfband;   /* cascade of half-band stages, else polyphase */
+  int           nStages;    /* half-band stages, log2 N */
+  fract16       side[MULTIRATE_HB_SIDE]; /* half-band taps at center +-1, +-3, .. */
+  multirate_hb_t hb[MULTIRATE_STAGES_MAX];
+  int           taps;       /* polyphase: prototype length N * MULTIRATE_POLY_TAPS */
+  int           phase;      /* polyphase decimator: input index of the next output */
+  fract16       coeff[MULTIRATE_FACTOR_MAX * MULTIRATE_POLY_TAPS]; /* reversed, per phase */
+  fract16       hist[MULTIRATE_FACTOR_MAX * MULTIRATE_POLY_TAPS - 1];
+  unsigned long calls;      /* processed chunks */
+  unsigned long long samples; /* input samples of those chunks */
+  unsigned long long cycles;  /* cycles spent in them */
+} multirate_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize a decimator or interpolator with cleared history
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param dir       decimate or interpolate
+ * @param factor    N, a power of two up to 2^MULTIRATE_STAGES_MAX in
+ *                  half-band mode, 2 .. MULTIRATE_FACTOR_MAX otherwise
+ * @param halfband  non-zero for the half-band cascade
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int multirate_init(multirate_t *pThis, multirate_dir_t dir, int factor, int halfband);
+
+/** Outputs produced from length inputs at most (to size buffers)
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param length  input samples
+ *
+ * @return number of output samples
+ */
+int multirate_outMax(const multirate_t *pThis, int length);
+
+/** Convert a block
+ *   - a decimator keeps the inputs of a partial output for the next call
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param length  number of input samples
+ * @param output  output samples, room for multirate_outMax()
+ *
+ * @return number of output samples written
+ */
+int multirate_process(multirate_t *pThis, const fract16 input[], int length, fract16 output[]);
+
+/** Convert a chunk, counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pIn    input chunk
+ * @param pOut   output chunk (e.g. of a smaller pool), len is set
+ *
+ * @return Zero on success.
+ * Negative value on failure (pOut too small, nothing converted).
+ */
+int multirate_chunk(multirate_t *pThis, const chunk_t *pIn, chunk_t *pOut);
+
+/** Print the cycles per chunk and per input sample
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pName  label of the stage
+ *
+ * @return None
+ */
+void multirate_report(const multirate_t *pThis, const char *pName);
+
+#endif
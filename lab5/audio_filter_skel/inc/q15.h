@@ -0,0 +1,382 @@
+/**
+ *@file q15.h
+ *
+ *@brief
+ *  - header only 1.15 (fract16) fixed point arithmetic
+ *    - saturating add / sub / negate / abs
+ *    - multiply truncated (q15_mul) and rounded (q15_mulr)
+ *    - 40 bit accumulator (A0/A1 model): MAC / MSU of 1.31 products,
+ *      saturated at 40 bits, extracted with a selectable rounding mode
+ *    - packed 2x16 operations (one 32 bit register, two lanes)
+ *    - block operations over arrays
+ *  - Blackfin: builtins of bfin-elf-gcc (the ALU / MAC instructions);
+ *    host: plain C for the scalar operations, SSE2 / SSSE3 (pmulhrsw) /
+ *    AVX2 (paddsw, pmulhrsw) for the block operations
+ *  - results are bit-exact between target and host. The Blackfin default
+ *    (unbiased) multiply rounding is therefore not used: rounding is
+ *    biased (+0.5 LSB, as pmulhrsw) everywhere, q15_mulr on the target
+ *    rounds the 1.31 product explicitly
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _Q15_H_
+#define _Q15_H_
+
+#include <filter.h>
+
+#if !defined(__bfin__) && defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#endif
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/** largest and smallest 1.15 value */
+#define Q15_MAX         (0x7fff)
+#define Q15_MIN         (-0x8000)
+
+/** range of the 40 bit accumulator (9.31) */
+#define Q15_ACC_MAX     ((1LL << 39) - 1)
+#define Q15_ACC_MIN     (-(1LL << 39))
+
+/** convert a float constant to 1.15 (compile time, no saturation) */
+#define Q15(x)          ((fract16)((x) * 32768.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** 40 bit accumulator, 1.31 products, kept in 64 bit */
+typedef long long q15_acc_t;
+
+/** two 1.15 values in 32 bit, lane 0 in the low half */
+#ifdef __bfin__
+typedef short q15x2_t __attribute__ ((vector_size (4)));
+#else
+typedef int q15x2_t;
+#endif
+
+/** rounding of an accumulator to 1.15
+ */
+typedef enum {
+    Q15_ROUND_BIASED,       /* + 0.5 LSB, ties up (pmulhrsw, Blackfin RND_MOD=1) */
+    Q15_ROUND_CONVERGENT,   /* ties to even (Blackfin RND_MOD=0) */
+    Q15_ROUND_TRUNC         /* towards minus infinity */
+} q15_round_t;
+
+
+/***************************************************
+            Scalar operations
+***************************************************/
+
+/** saturate a 32 bit integer to 1.15 */
+static inline fract16 q15_sat(int v)
+{
+    return v > Q15_MAX ? Q15_MAX : v < Q15_MIN ? Q15_MIN : (fract16)v;
+}
+
+/** saturating a + b */
+static inline fract16 q15_add(fract16 a, fract16 b)
+{
+#ifdef __bfin__
+    return __builtin_bfin_add_fr1x16(a, b);
+#else
+    return q15_sat(a + b);
+#endif
+}
+
+/** saturating a - b */
+static inline fract16 q15_sub(fract16 a, fract16 b)
+{
+#ifdef __bfin__
+    return __builtin_bfin_sub_fr1x16(a, b);
+#else
+    return q15_sat(a - b);
+#endif
+}
+
+/** saturating -a */
+static inline fract16 q15_neg(fract16 a)
+{
+#ifdef __bfin__
+    return __builtin_bfin_negate_fr1x16(a);
+#else
+    return q15_sat(-a);
+#endif
+}
+
+/** saturating |a| */
+static inline fract16 q15_abs(fract16 a)
+{
+#ifdef __bfin__
+    return __builtin_bfin_abs_fr1x16(a);
+#else
+    return q15_sat(a < 0 ? -a : a);
+#endif
+}
+
+/** a * b truncated, -1 * -1 saturates
+ *  (target: top half of the 1.31 product, independent of the MAC rounding mode)
+ */
+static inline fract16 q15_mul(fract16 a, fract16 b)
+{
+#ifdef __bfin__
+    return (fract16)(__builtin_bfin_mult_fr1x32(a, b) >> 16);
+#else
+    return q15_sat((a * b) >> 15);
+#endif
+}
+
+/** a * b rounded (biased), -1 * -1 saturates */
+static inline fract16 q15_mulr(fract16 a, fract16 b)
+{
+#ifdef __bfin__
+    return (fract16)(__builtin_bfin_add_fr1x32(__builtin_bfin_mult_fr1x32(a, b), 0x8000) >> 16);
+#else
+    return q15_sat((a * b + 0x4000) >> 15);
+#endif
+}
+
+/** saturate to the 40 bit accumulator range */
+static inline q15_acc_t q15_accSat(q15_acc_t acc)
+{
+    return acc > Q15_ACC_MAX ? Q15_ACC_MAX : acc < Q15_ACC_MIN ? Q15_ACC_MIN : acc;
+}
+
+/** acc + a * b, 1.31 product (-1 * -1 saturates to 0x7fffffff) */
+static inline q15_acc_t q15_mac(q15_acc_t acc, fract16 a, fract16 b)
+{
+    int p = (Q15_MIN == a && Q15_MIN == b) ? 0x7fffffff : (a * b) << 1;
+
+    return q15_accSat(acc + p);
+}
+
+/** acc - a * b, 1.31 product */
+static inline q15_acc_t q15_msu(q15_acc_t acc, fract16 a, fract16 b)
+{
+    int p = (Q15_MIN == a && Q15_MIN == b) ? 0x7fffffff : (a * b) << 1;
+
+    return q15_accSat(acc - p);
+}
+
+/** accumulator to 1.15: round at bit 16, then saturate */
+static inline fract16 q15_accExtract(q15_acc_t acc, q15_round_t mode)
+{
+    q15_acc_t r;
+
+    switch ( mode ) {
+    case Q15_ROUND_CONVERGENT:
+        r = (acc + 0x8000) >> 16;
+        if ( 0x8000 == (acc & 0xffff) ) {
+            r &= ~1LL;      // exact tie: to even
+        }
+        break;
+    case Q15_ROUND_TRUNC:
+        r = acc >> 16;
+        break;
+    default:
+        r = (acc + 0x8000) >> 16;
+        break;
+    }
+    return r > Q15_MAX ? Q15_MAX : r < Q15_MIN ? Q15_MIN : (fract16)r;
+}
+
+
+/***************************************************
+            Packed 2x16 operations
+***************************************************/
+
+/** pack two values, lo in lane 0 */
+static inline q15x2_t q15x2_compose(fract16 hi, fract16 lo)
+{
+#ifdef __bfin__
+    return __builtin_bfin_compose_2x16(hi, lo);
+#else
+    return (int)(((unsigned int)(unsigned short)hi << 16) | (unsigned short)lo);
+#endif
+}
+
+/** lane 1 */
+static inline fract16 q15x2_hi(q15x2_t v)
+{
+#ifdef __bfin__
+    return __builtin_bfin_extract_hi(v);
+#else
+    return (fract16)(v >> 16);
+#endif
+}
+
+/** lane 0 */
+static inline fract16 q15x2_lo(q15x2_t v)
+{
+#ifdef __bfin__
+    return __builtin_bfin_extract_lo(v);
+#else
+    return (fract16)v;
+#endif
+}
+
+/** saturating a + b per lane */
+static inline q15x2_t q15x2_add(q15x2_t a, q15x2_t b)
+{
+#ifdef __bfin__
+    return __builtin_bfin_add_fr2x16(a, b);
+#else
+    return q15x2_compose(q15_add(q15x2_hi(a), q15x2_hi(b)), q15_add(q15x2_lo(a), q15x2_lo(b)));
+#endif
+}
+
+/** saturating a - b per lane */
+static inline q15x2_t q15x2_sub(q15x2_t a, q15x2_t b)
+{
+#ifdef __bfin__
+    return __builtin_bfin_sub_fr2x16(a, b);
+#else
+    return q15x2_compose(q15_sub(q15x2_hi(a), q15x2_hi(b)), q15_sub(q15x2_lo(a), q15x2_lo(b)));
+#endif
+}
+
+/** a * b truncated per lane */
+static inline q15x2_t q15x2_mul(q15x2_t a, q15x2_t b)
+{
+    return q15x2_compose(q15_mul(q15x2_hi(a), q15x2_hi(b)), q15_mul(q15x2_lo(a), q15x2_lo(b)));
+}
+
+/** a * b rounded (biased) per lane */
+static inline q15x2_t q15x2_mulr(q15x2_t a, q15x2_t b)
+{
+    return q15x2_compose(q15_mulr(q15x2_hi(a), q15x2_hi(b)), q15_mulr(q15x2_lo(a), q15x2_lo(b)));
+}
+
+
+/***************************************************
+            Block operations
+***************************************************/
+
+#if !defined(__bfin__) && defined(__SSE2__)
+/** eight rounded products, pmulhrsw where available */
+static inline __m128i q15_mulr8(__m128i a, __m128i b)
+{
+#if defined(__SSSE3__)
+    __m128i r = _mm_mulhrs_epi16(a, b);
+
+    // only -1 * -1 gives 0x8000, it has to saturate
+    return _mm_xor_si128(r, _mm_cmpeq_epi16(r, _mm_set1_epi16(Q15_MIN)));
+#else
+    __m128i lo = _mm_mullo_epi16(a, b);
+    __m128i hi = _mm_mulhi_epi16(a, b);
+    __m128i rnd = _mm_set1_epi32(0x4000);
+    __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), rnd), 15);
+    __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), rnd), 15);
+
+    return _mm_packs_epi32(p0, p1);
+#endif
+}
+#endif
+
+#if !defined(__bfin__) && defined(__AVX2__)
+/** sixteen rounded products */
+static inline __m256i q15_mulr16(__m256i a, __m256i b)
+{
+    __m256i r = _mm256_mulhrs_epi16(a, b);
+
+    return _mm256_xor_si256(r, _mm256_cmpeq_epi16(r, _mm256_set1_epi16(Q15_MIN)));
+}
+#endif
+
+/** dst[i] = a[i] + b[i], saturating */
+static inline void q15_vecAdd(fract16 dst[], const fract16 a[], const fract16 b[], int n)
+{
+    int i = 0;
+
+#if !defined(__bfin__) && defined(__AVX2__)
+    for ( ; i + 16 <= n; i += 16 ) {
+        _mm256_storeu_si256((__m256i *)&dst[i],
+            _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)&a[i]),
+                              _mm256_loadu_si256((const __m256i *)&b[i])));
+    }
+#endif
+#if !defined(__bfin__) && defined(__SSE2__)
+    for ( ; i + 8 <= n; i += 8 ) {
+        _mm_storeu_si128((__m128i *)&dst[i],
+            _mm_adds_epi16(_mm_loadu_si128((const __m128i *)&a[i]),
+                           _mm_loadu_si128((const __m128i *)&b[i])));
+    }
+#endif
+    for ( ; i < n; i++ ) {
+        dst[i] = q15_add(a[i], b[i]);
+    }
+}
+
+/** dst[i] = a[i] * b[i], rounded */
+static inline void q15_vecMulr(fract16 dst[], const fract16 a[], const fract16 b[], int n)
+{
+    int i = 0;
+
+#if !defined(__bfin__) && defined(__AVX2__)
+    for ( ; i + 16 <= n; i += 16 ) {
+        _mm256_storeu_si256((__m256i *)&dst[i],
+            q15_mulr16(_mm256_loadu_si256((const __m256i *)&a[i]),
+                       _mm256_loadu_si256((const __m256i *)&b[i])));
+    }
+#endif
+#if !defined(__bfin__) && defined(__SSE2__)
+    for ( ; i + 8 <= n; i += 8 ) {
+        _mm_storeu_si128((__m128i *)&dst[i],
+            q15_mulr8(_mm_loadu_si128((const __m128i *)&a[i]),
+                      _mm_loadu_si128((const __m128i *)&b[i])));
+    }
+#endif
+    for ( ; i < n; i++ ) {
+        dst[i] = q15_mulr(a[i], b[i]);
+    }
+}
+
+/** dst[i] = dst[i] + gain * src[i], product rounded, sum saturating
+ *  (mix and feedback gains)
+ */
+static inline void q15_vecScaleAdd(fract16 dst[], const fract16 src[], fract16 gain, int n)
+{
+    int i = 0;
+
+#if !defined(__bfin__) && defined(__AVX2__)
+    {
+        __m256i g = _mm256_set1_epi16(gain);
+
+        for ( ; i + 16 <= n; i += 16 ) {
+            __m256i d = _mm256_loadu_si256((const __m256i *)&dst[i]);
+            __m256i p = q15_mulr16(_mm256_loadu_si256((const __m256i *)&src[i]), g);
+            _mm256_storeu_si256((__m256i *)&dst[i], _mm256_adds_epi16(d, p));
+        }
+    }
+#endif
+#if !defined(__bfin__) && defined(__SSE2__)
+    {
+        __m128i g = _mm_set1_epi16(gain);
+
+        for ( ; i + 8 <= n; i += 8 ) {
+            __m128i d = _mm_loadu_si128((const __m128i *)&dst[i]);
+            __m128i p = q15_mulr8(_mm_loadu_si128((const __m128i *)&src[i]), g);
+            _mm_storeu_si128((__m128i *)&dst[i], _mm_adds_epi16(d, p));
+        }
+    }
+#endif
+    for ( ; i < n; i++ ) {
+        dst[i] = q15_add(dst[i], q15_mulr(src[i], gain));
+    }
+}
+
+#endif
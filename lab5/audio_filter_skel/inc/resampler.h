@@ -0,0 +1,155 @@
+/**
+ *@file resampler.h
+ *
+ *@brief
+ *  - streaming polyphase sample rate converter for rational ratios
+ *    L/M = outRate/inRate (reduced), e.g. 8k->16k (2/1),
+ *    16k->44.1k (441/160), 44.1k->48k (160/147)
+ *  - one windowed-sinc low-pass prototype of L * taps coefficients is
+ *    split into L phases at init time; every output is a taps long dot
+ *    product of one phase with the newest input samples
+ *  - fixed point: 1.15 data and coefficients, 32 bit accumulator,
+ *    rounded and saturated output; SSE2 (pmaddwd) dot product on the
+ *    host, bit-exact with the plain C loop used on the Blackfin
+ *  - per stream state (history, phase), input and output in any block
+ *    size, so a player can fill fixed size DMA buffers at any codec rate
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _RESAMPLER_H_
+#define _RESAMPLER_H_
+
+#include <filter.h>
+#include <chunk.h>
+
+/***************************************************
+            DEFINES
+***************************************************/
+
+/**
+ * @def RESAMPLER_TAPS
+ * @brief default taps per phase (multiple of 8 for the SIMD path)
+ */
+#define RESAMPLER_TAPS          (16)
+
+/**
+ * @def RESAMPLER_TAPS_MAX
+ * @brief longest phase
+ */
+#define RESAMPLER_TAPS_MAX      (32)
+
+/**
+ * @def RESAMPLER_COEFF_MAX
+ * @brief coefficient table size, L * taps must fit
+ *        (441 phases of 16 taps for 16k/8k -> 44.1k)
+ */
+#define RESAMPLER_COEFF_MAX     (8192)
+
+/**
+ * @def RESAMPLER_BLOCK
+ * @brief input samples linearized per pass
+ */
+#define RESAMPLER_BLOCK         (256)
+
+/**
+ * @def RESAMPLER_ROLLOFF
+ * @brief cutoff as fraction of the lower Nyquist frequency
+ */
+#define RESAMPLER_ROLLOFF       (0.9)
+
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** resampler object
+ */
+typedef struct {
+  unsigned int  inRate;     /* input samples per second */
+  unsigned int  outRate;    /* output samples per second */
+  int           up;         /* L, phases */
+  int           down;       /* M, phase advance per output */
+  int           taps;       /* taps per phase */
+  int           phase;      /* phase of the next output, 0..L-1 */
+  int           index;      /* input (relative to the next call) of the next output */
+  fract16       hist[RESAMPLER_TAPS_MAX - 1];  /* newest taps-1 inputs, oldest first */
+  fract16       coeff[RESAMPLER_COEFF_MAX];    /* [phase][tap], taps reversed */
+} resampler_t;
+
+
+/***************************************************
+            Access Methods
+***************************************************/
+
+/** Initialize a resampler with cleared history
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param inRate   input sample rate
+ * @param outRate  output sample rate
+ * @param taps     taps per phase, multiple of 8, max RESAMPLER_TAPS_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure (ratio needs too many phases).
+ */
+int resampler_init(resampler_t *pThis, unsigned int inRate, unsigned int outRate, int taps);
+
+/** Change the ratio of a running stream
+ *   - designs the new phases, the history is kept so the stream
+ *     continues without a gap
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param inRate   input sample rate
+ * @param outRate  output sample rate
+ *
+ * @return Zero on success.
+ * Negative value on failure, the old ratio stays active.
+ */
+int resampler_setRate(resampler_t *pThis, unsigned int inRate, unsigned int outRate);
+
+/** Outputs produced from length inputs at most (to size buffers)
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param length   input samples
+ *
+ * @return number of output samples
+ */
+int resampler_outMax(const resampler_t *pThis, int length);
+
+/** Convert a block
+ *   - stops when either all input is consumed or nOut outputs are
+ *     written; unconsumed input has to be passed again on the next call
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param input    input samples
+ * @param pLength  in: input samples available, out: input samples consumed
+ * @param output   output samples
+ * @param nOut     room in output
+ *
+ * @return number of output samples written
+ */
+int resampler_process(resampler_t *pThis, const fract16 input[], int *pLength,
+                      fract16 output[], int nOut);
+
+/** Convert a chunk
+ *   - consumes all of pIn, pOut must hold resampler_outMax() samples
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param pIn      input chunk
+ * @param pOut     output chunk, len is set
+ *
+ * @return Zero on success.
+ * Negative value on failure (pOut too small, input only partly converted).
+ */
+int resampler_chunk(resampler_t *pThis, const chunk_t *pIn, chunk_t *pOut);
+
+#endif
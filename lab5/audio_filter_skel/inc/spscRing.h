@@ -0,0 +1,132 @@
+/**
+ *@file spscRing.h
+ *
+ *@brief
+ *  - wait-free single producer / single consumer pointer ring
+ *  - one side may run in interrupt context, the other in the main loop;
+ *    no interrupt masking is needed
+ *  - power of two capacity, free running head and tail counters,
+ *    head (consumer) and tail (producer) on separate cache lines
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#ifndef _SPSC_RING_H_
+#define _SPSC_RING_H_
+
+/***************************************************
+            DEFINES
+***************************************************/   
+
+/**
+ * @def SPSCRING_SIZE_MAX
+ * @brief maximum capacity of a ring (power of two)
+ */
+#define SPSCRING_SIZE_MAX   (64)
+
+/**
+ * @def SPSCRING_CACHE_LINE
+ * @brief separation of the producer and consumer fields in bytes
+ */
+#ifdef __bfin__
+#define SPSCRING_CACHE_LINE (32)
+#else
+#define SPSCRING_CACHE_LINE (64)
+#endif
+
+/***************************************************
+            DATA TYPES
+***************************************************/
+
+/** spscRing object
+ *   tail and the statistics are written by the producer only,
+ *   head by the consumer only
+ */
+typedef struct {
+  /* producer side */
+  unsigned int  tail __attribute__((aligned(SPSCRING_CACHE_LINE))); /* write counter */
+  unsigned int  levelMax;   /* highest fill level seen by the producer */
+  unsigned long levelSum;   /* sum of fill levels sampled on every push */
+  unsigned long nPut;       /* number of pushed elements */
+  /* consumer side */
+  unsigned int  head __attribute__((aligned(SPSCRING_CACHE_LINE))); /* read counter */
+  /* read only after init */
+  unsigned int  size __attribute__((aligned(SPSCRING_CACHE_LINE))); /* capacity */
+  unsigned int  mask;       /* size - 1 */
+  void          *data[SPSCRING_SIZE_MAX]; /* stored pointers */
+} spscRing_t;
+
+
+/***************************************************
+            Access Methods 
+***************************************************/
+
+/** Initialize ring
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param size   capacity, power of two, at most SPSCRING_SIZE_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int spscRing_init(spscRing_t *pThis, unsigned int size);
+
+/** Append one pointer (producer only)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pData  pointer to store
+ *
+ * @return Zero on success.
+ * Negative value if the ring is full.
+ */
+int spscRing_push(spscRing_t *pThis, void *pData);
+
+/** Remove one pointer (consumer only)
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param ppData  where to store the removed pointer
+ *
+ * @return Zero on success.
+ * Negative value if the ring is empty.
+ */
+int spscRing_pop(spscRing_t *pThis, void **ppData);
+
+/** Append up to n pointers with one index update (producer only)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pData  pointers to store
+ * @param n      number of pointers
+ *
+ * @return number of pointers appended
+ */
+int spscRing_pushBatch(spscRing_t *pThis, void * const pData[], int n);
+
+/** Remove up to n pointers with one index update (consumer only)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pData  where to store the removed pointers
+ * @param n      maximum number of pointers
+ *
+ * @return number of pointers removed
+ */
+int spscRing_popBatch(spscRing_t *pThis, void *pData[], int n);
+
+/** @return number of stored pointers (exact for the calling side) */
+int spscRing_count(spscRing_t *pThis);
+
+/** @return non-zero if the ring is empty */
+int spscRing_isEmpty(spscRing_t *pThis);
+
+/** @return non-zero if the ring is full */
+int spscRing_isFull(spscRing_t *pThis);
+
+#endif
@@ -18,25 +18,92 @@
 
 #include <tll_common.h>
 #include "audioFilter.h"
+#include "firBlock.h"
 
-/* Declare filter coefficients - Generated by Matlab filterbuilder */
+/* Declare filter coefficients - Generated by Matlab filterbuilder,
+   used as they are at AUDIOFILTER_MATLAB_RATE */
 fract16 audioFilter_filter1_coeff[] = {22, -296, -107, 275, 295, -286, -589, 151, 959, 231, -1355, -1032, 1711, 2774, -1958, -10183, 18431, -10183, -1958, 2774, 1711, -1032, -1355, 231, 959, 151, -589, -286, 295, 275, -107, -296, 22};
 fract16 audioFilter_filter2_coeff[] = {-67, 253, 260, 71, -291, -506, -246, 431, 957, 658, -558, -1819, -1714, 647, 4728, 8635, 10244, 8635, 4728, 647, -1714, -1819, -558, 658, 957, 431, -246, -506, -291, 71, 260, 253, -67};
 fract16 audioFilter_filter3_coeff[] = {166, 99, -299, -570, -19, 993, 979, -639, -2028, -920, 1888, 2769, 9, -3226, -2596, 1437, 3801, 1437, -2596, -3226, 9, 2769, 1888, -920, -2028, -639, 979, 993, -19, -570, -299, 99, 166};
 
+/* Butterworth corners (-3 dB) and band center of the biquad versions in
+   Hz, placed so the responses cross the FIR -6 dB points */
+#define AUDIOFILTER_BIQUAD_HIGHPASS_HZ	(3648)
+#define AUDIOFILTER_BIQUAD_LOWPASS_HZ	(2368)
+#define AUDIOFILTER_BIQUAD_CENTER_HZ	(3040)
+
 /* Declare 2 arrays for filter input and output */
-fract16 audioFilter_output[SAMPLE_SIZE/2];
-fract16 audioFilter_input[SAMPLE_SIZE/2];
+fract16 audioFilter_output[CHUNK_SIZE_MAX/2];
+fract16 audioFilter_input[CHUNK_SIZE_MAX/2];
 
 /** Initialization for audioFilter
  *
  * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
  *
  * @return Zero on success, negative otherwise 
  */
-int audioFilter_init(audioFilter_t *pThis)
+int audioFilter_init(audioFilter_t *pThis, unsigned int rate)
+{
+	firDesign_cacheInit(&pThis->design);
+	pThis->rate = 0;
+
+	filterCascade_init(&pThis->cascade, AUDIOFILTER_CASCADE_COMBINE);
+	filterCascade_addStage(&pThis->cascade, &pThis->filter1State);
+	filterCascade_addStage(&pThis->cascade, &pThis->filter2State);
+	filterCascade_addStage(&pThis->cascade, &pThis->filter3State);
+
+	pThis->type = AUDIOFILTER_FIR;
+
+	return audioFilter_setRate(pThis, rate);
+}
+
+/** Design filter 1..3 (FIR and biquad versions) for a sample rate
+ *
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return Zero on success, negative otherwise (old rate stays active)
+ */
+int audioFilter_setRate(audioFilter_t *pThis, unsigned int rate)
 {
+	firDesign_spec_t spec[3] = {
+		{ FIRDESIGN_HIGHPASS, rate, AUDIOFILTER_HIGHPASS_HZ, 0, FILTER_COEFFICIENTS, AUDIOFILTER_ATTEN },
+		{ FIRDESIGN_LOWPASS,  rate, AUDIOFILTER_LOWPASS_HZ,  0, FILTER_COEFFICIENTS, AUDIOFILTER_ATTEN },
+		{ FIRDESIGN_BANDPASS, rate, AUDIOFILTER_BANDLOW_HZ, AUDIOFILTER_BANDHIGH_HZ,
+		  FILTER_COEFFICIENTS, AUDIOFILTER_ATTEN },
+	};
+	const fract16 *pMatlab[3] = { audioFilter_filter1_coeff, audioFilter_filter2_coeff, audioFilter_filter3_coeff };
+	const fract16 *pCoeff[3];
+	fract16 *pDest[3] = { pThis->filter1_coeff, pThis->filter2_coeff, pThis->filter3_coeff };
+	biquad_coeff_t bandpass;
 	int i;
+
+	for(i = 0; i < 3; i++)
+	{
+		if (AUDIOFILTER_MATLAB_RATE == rate)
+		{
+			pCoeff[i] = pMatlab[i];
+			continue;
+		}
+		/* 33 taps cannot resolve the 900 Hz band above ~13 kHz, the
+		   designed band grows to the transition width instead */
+		if (firDesign_fitBand(&spec[i]))
+		{
+			printf("[AF]: Band-pass widened to %u .. %u Hz at %u Hz\n",
+			       spec[i].f1, spec[i].f2, rate);
+		}
+		pCoeff[i] = firDesign_get(&pThis->design, &spec[i]);
+		if (NULL == pCoeff[i])
+		{
+			printf("[AF]: No filters for %u Hz\n", rate);
+			return FAIL;
+		}
+	}
+	for(i = 0; i < 3; i++)
+	{
+		memcpy(pDest[i], pCoeff[i], FILTER_COEFFICIENTS * sizeof(fract16));
+	}
 	for(i = 0; i < FILTER_COEFFICIENTS; i++)
 	{
 		pThis->filter1_delay[i] = 0;
@@ -44,14 +111,35 @@ int audioFilter_init(audioFilter_t *pThis)
 		pThis->filter3_delay[i] = 0;
 	}
 	
-	fir_init(pThis->filter1State, audioFilter_filter1_coeff, pThis->filter1_delay, FILTER_COEFFICIENTS, 1);
-	fir_init(pThis->filter2State, audioFilter_filter2_coeff, pThis->filter2_delay, FILTER_COEFFICIENTS, 1);
-	fir_init(pThis->filter3State, audioFilter_filter3_coeff, pThis->filter3_delay, FILTER_COEFFICIENTS, 1);
+	fir_init(pThis->filter1State, pThis->filter1_coeff, pThis->filter1_delay, FILTER_COEFFICIENTS, 1);
+	fir_init(pThis->filter2State, pThis->filter2_coeff, pThis->filter2_delay, FILTER_COEFFICIENTS, 1);
+	fir_init(pThis->filter3State, pThis->filter3_coeff, pThis->filter3_delay, FILTER_COEFFICIENTS, 1);
+
+	// the combined kernel of the active filters is built from the new sets
+	filterCascade_update(&pThis->cascade);
+
+	/* IIR versions with the same corners: Butterworth high-pass and
+	   low-pass, band-pass of three equal sections */
+	for(i = 0; i < 3; i++)
+	{
+		biquad_init(&pThis->biquad[i], AUDIOFILTER_BIQUAD_FORMAT);
+	}
+	biquad_addButterworth(&pThis->biquad[0], BIQUAD_HIGHPASS, (float)AUDIOFILTER_BIQUAD_HIGHPASS_HZ / rate, 6);
+	biquad_addButterworth(&pThis->biquad[1], BIQUAD_LOWPASS, (float)AUDIOFILTER_BIQUAD_LOWPASS_HZ / rate, 6);
+	biquad_design(&bandpass, BIQUAD_BANDPASS, (float)AUDIOFILTER_BIQUAD_CENTER_HZ / rate, 2.0f);
+	for(i = 0; i < 3; i++)
+	{
+		biquad_addSection(&pThis->biquad[2], &bandpass);
+	}
 
+	pThis->rate = rate;
+	printf("[AF]: Filters for %u Hz (design cache %lu hits, %lu misses)\n",
+	       rate, pThis->design.hits, pThis->design.misses);
 	return PASS;
 }
 
 /** The optimized filter process of audioFilter
+ *   - block FIR engine (firBlock_fr16), filters the chunk in place
  *
  * @param pData  pointer to a chunk of audio data - the filtered data is returned in this variable
  * @param pState pointer to a state variable for filter coefficients and delay line
@@ -60,14 +148,21 @@ int audioFilter_init(audioFilter_t *pThis)
  */
 void audioFilter_optimized(chunk_t *pData, fir_state_fr16 *pState)
 {
-	chunk_t			temp_chunk;
-
-	chunk_init(&temp_chunk);
-	
+	// block engine works in place, no temporary chunk needed
+	firBlock_fr16(pData->s16_buff, pData->s16_buff, pData->len/2, pState);
+}
 
-	temp_chunk.len = pData->len;
-	
-	chunk_copy(&temp_chunk, pData);
+/** Long filter process of audioFilter
+ *   - overlap-save FFT or direct form, as chosen by fftConv_init
+ *
+ * @param pData  pointer to a chunk of audio data - filtered in place
+ * @param pConv  convolution object, block at least the chunk samples
+ *
+ * @return no return
+ */
+void audioFilter_convolve(chunk_t *pData, fftConv_t *pConv)
+{
+	fftConv_process(pConv, pData->s16_buff, pData->s16_buff, pData->len/2);
 }
 
 /** The non-optimized filter process of audioFilter
@@ -84,7 +179,7 @@ void audioFilter_filter(chunk_t *pData, fir_state_fr16 *pState)
 	int temp;
 	chunk_t			temp_chunk;
 
-	chunk_init(&temp_chunk);
+	chunk_init(&temp_chunk, audioFilter_output, sizeof(audioFilter_output));
     	
 	//loop through each data point
 	for(i = 0; i < pData->len/2; i++)
@@ -92,15 +187,22 @@ void audioFilter_filter(chunk_t *pData, fir_state_fr16 *pState)
 		temp = 0;
 		
 		//prime the delay line with the new data
+		pState->d[0] = pData->s16_buff[i];
 		
 		//sum the coefficients multiplied by the delay line
 		for(j = 0; j < pState->k; j++)
 		{				
+			temp += pState->h[j] * pState->d[j];
 		}
 		
 		//shift the delay line down 1 to make room for the new data short next cycle
+		for(j = pState->k - 1; j > 0; j--)
+		{
+			pState->d[j] = pState->d[j-1];
+		}
 			
 		//type cast and shift the data for the output
+		temp_chunk.s16_buff[i] = (fract16)(temp >> 15);
 	}
 	
 	temp_chunk.len = pData->len;
@@ -108,3 +210,51 @@ void audioFilter_filter(chunk_t *pData, fir_state_fr16 *pState)
 	chunk_copy(&temp_chunk, pData);
 }
 
+/** Apply all enabled filters in one pass
+ *
+ * @param pThis  pointer to own object
+ * @param pData  pointer to a chunk of audio data - filtered in place
+ * @param mask   bit 0..2 enable filter 1..3
+ *
+ * @return no return
+ */
+void audioFilter_cascade(audioFilter_t *pThis, chunk_t *pData, unsigned int mask)
+{
+	int i;
+
+	if (AUDIOFILTER_BIQUAD == pThis->type)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			if (mask & (0x1 << i))
+			{
+				biquad_process(&pThis->biquad[i], pData);
+			}
+		}
+		return;
+	}
+
+	// only rebuilds the combined kernel if the mask changed
+	filterCascade_setMask(&pThis->cascade, mask);
+	filterCascade_process(&pThis->cascade, pData);
+}
+
+/** Select FIR or biquad implementation of filter 1..3
+ *   - the biquad states start from silence on every switch
+ *
+ * @param pThis  pointer to own object
+ * @param type   implementation
+ *
+ * @return no return
+ */
+void audioFilter_setType(audioFilter_t *pThis, audioFilter_type_t type)
+{
+	int i;
+
+	for(i = 0; i < 3; i++)
+	{
+		biquad_reset(&pThis->biquad[i]);
+	}
+	pThis->type = type;
+	printf("[AF]: %s filters\n", AUDIOFILTER_BIQUAD == type ? "biquad" : "FIR");
+}
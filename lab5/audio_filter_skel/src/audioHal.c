@@ -0,0 +1,239 @@
+/**
+ *@file audioHal.c
+ *
+ *@brief
+ *  - Blackfin implementation of the audio hardware abstraction
+ *  - DMA3 receives from SPORT0, DMA4 transmits to SPORT0
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "audioHal.h"
+#include <tll_config.h>
+#include <tll_sport.h>
+#include <power_mode.h>
+
+
+/** Configure RX DMA
+ *   Read, 1-D, interrupt enabled, Memory write operation, 16 bit transfer
+ */
+void audioHal_rxInit(void)
+{
+    *pDMA3_CONFIG = WNR | WDSIZE_16 | DI_EN | DMA2D;
+}
+
+/** Point the RX DMA at a buffer and (re)start it
+ * @param pBuff     start of the receive buffer
+ * @param nSamples  number of 16 bit samples to receive
+ */
+void audioHal_rxDmaConfig(unsigned short *pBuff, int nSamples)
+{
+    DISABLE_DMA(*pDMA3_CONFIG);
+    *pDMA3_START_ADDR   = pBuff;
+    *pDMA3_Y_COUNT      = nSamples;  // 16 bit data so we change the stride and count
+    *pDMA3_X_COUNT      = 2;
+    *pDMA3_Y_MODIFY     = 2;
+    *pDMA3_X_MODIFY     = 0;
+    ENABLE_DMA(*pDMA3_CONFIG);
+}
+
+/** start the receive side of SPORT0 */
+void audioHal_rxEnable(void)
+{
+    ENABLE_SPORT0_RX();
+}
+
+/** @return non-zero if the RX DMA completion interrupt is pending */
+int audioHal_rxIrqPending(void)
+{
+    return *pDMA3_IRQ_STATUS & 0x1;
+}
+
+/** acknowledge the RX DMA completion interrupt */
+void audioHal_rxIrqClear(void)
+{
+    *pDMA3_IRQ_STATUS  |= 0x0001;
+}
+
+/** Configure TX DMA
+ *   Read, 1-D, interrupt enabled, 16 bit transfer
+ */
+void audioHal_txInit(void)
+{
+    *pDMA4_CONFIG = WDSIZE_16 | DI_EN | DMA2D;
+}
+
+/** Point the TX DMA at a buffer and (re)start it
+ * @param pBuff     start of the transmit buffer
+ * @param nSamples  number of 16 bit samples to transmit
+ */
+void audioHal_txDmaConfig(unsigned short *pBuff, int nSamples)
+{
+    DISABLE_DMA(*pDMA4_CONFIG);
+    *pDMA4_START_ADDR   = pBuff;
+    *pDMA4_Y_COUNT      = nSamples;  // 16 bit data so we change the stride and count
+    *pDMA4_X_COUNT      = 2;
+    *pDMA4_Y_MODIFY     = 2;
+    *pDMA4_X_MODIFY     = 0;
+    ENABLE_DMA(*pDMA4_CONFIG);
+}
+
+/** start the transmit side of SPORT0 */
+void audioHal_txEnable(void)
+{
+    ENABLE_SPORT0_TX();
+}
+
+/** @return non-zero if the TX DMA completion interrupt is pending */
+int audioHal_txIrqPending(void)
+{
+    return *pDMA4_IRQ_STATUS & 0x1;
+}
+
+/** acknowledge the TX DMA completion interrupt */
+void audioHal_txIrqClear(void)
+{
+    *pDMA4_IRQ_STATUS  |= 0x0001;
+}
+
+/** Link a descriptor ring, every descriptor is a complete 2-D transfer
+ *  (same counts as audioHal_rxDmaConfig) that raises an interrupt
+ *   and continues with the next descriptor
+ * @param pRing   descriptors
+ * @param nDesc   number of descriptors
+ * @param config  DMA configuration of all descriptors
+ */
+static void audioHal_descRing(audioHal_desc_t *pRing, int nDesc, unsigned short config)
+{
+    int         i;
+
+    for ( i = 0; i < nDesc; i++ ) {
+        pRing[i].pNext   = &pRing[(i + 1) % nDesc];
+        pRing[i].pStart  = NULL;
+        pRing[i].config  = config;
+        pRing[i].xCount  = 2;
+        pRing[i].xModify = 0;
+        pRing[i].yCount  = 0;
+        pRing[i].yModify = 2;
+    }
+}
+
+/** Link descriptors into a ring for the RX DMA
+ *   Large descriptor list, memory write, 16 bit, interrupt per descriptor
+ * @param pRing  descriptors
+ * @param nDesc  number of descriptors
+ */
+void audioHal_rxDescInit(audioHal_desc_t *pRing, int nDesc)
+{
+    audioHal_descRing(pRing, nDesc, FLOW_LARGE | NDSIZE_9 | WNR | WDSIZE_16 | DI_EN | DMA2D | DMAEN);
+}
+
+/** Start the RX DMA on a descriptor ring
+ *   writing CONFIG with FLOW_LARGE fetches the descriptor at NEXT_DESC_PTR
+ * @param pFirst  first descriptor to work on
+ */
+void audioHal_rxDescStart(audioHal_desc_t *pFirst)
+{
+    DISABLE_DMA(*pDMA3_CONFIG);
+    *pDMA3_NEXT_DESC_PTR = pFirst;
+    *pDMA3_CONFIG        = pFirst->config;
+}
+
+/** @return descriptor the RX DMA loads once the current transfer is done */
+audioHal_desc_t *audioHal_rxDescNext(void)
+{
+    return (audioHal_desc_t *)*pDMA3_NEXT_DESC_PTR;
+}
+
+/** Start the RX DMA in autobuffer mode without interrupts
+ *   Autobuffer, memory write, 16 bit, same 2-D layout as audioHal_rxDmaConfig
+ * @param pBuff     start of the circular buffer
+ * @param nSamples  number of 16 bit samples in the buffer
+ */
+void audioHal_rxAutoStart(unsigned short *pBuff, int nSamples)
+{
+    DISABLE_DMA(*pDMA3_CONFIG);
+    *pDMA3_START_ADDR   = pBuff;
+    *pDMA3_Y_COUNT      = nSamples;
+    *pDMA3_X_COUNT      = 2;
+    *pDMA3_Y_MODIFY     = 2;
+    *pDMA3_X_MODIFY     = 0;
+    *pDMA3_CONFIG       = FLOW_AUTO | WNR | WDSIZE_16 | DMA2D | DMAEN;
+}
+
+/** @return index of the sample the autobuffer RX DMA writes next
+ *   CURR_ADDR stays on a sample until both slots of its frame are in
+ */
+int audioHal_rxAutoPos(void)
+{
+    return (unsigned short *)*pDMA3_CURR_ADDR - (unsigned short *)*pDMA3_START_ADDR;
+}
+
+/** between two polls of a DMA position, nothing to do on the Blackfin */
+void audioHal_poll(void)
+{
+}
+
+/** Link descriptors into a ring for the TX DMA
+ *   Large descriptor list, memory read, 16 bit, interrupt per descriptor
+ * @param pRing  descriptors
+ * @param nDesc  number of descriptors
+ */
+void audioHal_txDescInit(audioHal_desc_t *pRing, int nDesc)
+{
+    audioHal_descRing(pRing, nDesc, FLOW_LARGE | NDSIZE_9 | WDSIZE_16 | DI_EN | DMA2D | DMAEN);
+}
+
+/** Start the TX DMA on a descriptor ring
+ * @param pFirst  first descriptor to work on
+ */
+void audioHal_txDescStart(audioHal_desc_t *pFirst)
+{
+    DISABLE_DMA(*pDMA4_CONFIG);
+    *pDMA4_NEXT_DESC_PTR = pFirst;
+    *pDMA4_CONFIG        = pFirst->config;
+}
+
+/** @return descriptor the TX DMA loads once the current transfer is done */
+audioHal_desc_t *audioHal_txDescNext(void)
+{
+    return (audioHal_desc_t *)*pDMA4_NEXT_DESC_PTR;
+}
+
+/** Set the buffer of a descriptor
+ * @param pDesc     descriptor, not the one the DMA works on
+ * @param pBuff     start of the buffer
+ * @param nSamples  number of 16 bit samples
+ */
+void audioHal_descSet(audioHal_desc_t *pDesc, unsigned short *pBuff, int nSamples)
+{
+    pDesc->pStart = pBuff;
+    pDesc->yCount = nSamples;
+}
+
+/** wait for the next interrupt in low power mode */
+void audioHal_idle(void)
+{
+    powerMode_change(PWR_ACTIVE);
+    asm("idle;");
+}
+
+/** return to full power after waiting in audioHal_idle */
+void audioHal_active(void)
+{
+    powerMode_change(PWR_FULL_ON);
+}
+
+/** @return execution context of the caller (AUDIOHAL_CTX_*)
+ *   any of IVHW .. IVG14 active in IPEND means interrupt level,
+ *   the main loop runs at IVG15
+ */
+int audioHal_context(void)
+{
+    return (*pIPEND & 0x7FE0) ? AUDIOHAL_CTX_ISR : AUDIOHAL_CTX_MAIN;
+}
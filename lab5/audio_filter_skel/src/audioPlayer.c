@@ -27,6 +27,8 @@
 //#include <cycles.h>
 #include <cycle_count.h>
 #include <cycle_count_bf.h>
+#include <math.h>
+#include <string.h>
 
 /**
  * @def I2C_CLK
@@ -42,6 +44,8 @@
 int audioPlayer_init(audioPlayer_t *pThis)
 {
     int                         status                  = 0;
+    int                         count;
+    int                         size;
     
     printf("[AP]: Init start\n");
     
@@ -69,9 +73,17 @@ int audioPlayer_init(audioPlayer_t *pThis)
     }
     
     /**
-     * Initialize the buffer Pool
+     * Initialize the buffer Pool, as many chunks as fit the arena
      */
-    status = bufferPool_init(&pThis->bp);
+    if ( 0 == pThis->chunkSize ) {
+        pThis->chunkSize = SAMPLE_SIZE;
+    }
+    count = (AUDIOPLAYER_ARENA_SIZE - BUFFERPOOL_ALIGN) / BUFFERPOOL_CHUNK_STRIDE(pThis->chunkSize);
+    if ( CHUNK_NUM_MAX < count ) {
+        count = CHUNK_NUM_MAX;
+    }
+    status = bufferPool_init(&pThis->bp, pThis->chunkSize, count,
+                             pThis->arena, sizeof(pThis->arena));
     if ( PASS != status ) {
         return FAIL;
     }
@@ -99,6 +111,18 @@ int audioPlayer_init(audioPlayer_t *pThis)
         return FAIL;
     }   
 
+    /**
+     * DMA descriptor rings of RX and TX, or RX polled
+     */
+    if ( 0 == pThis->ringSize ) {
+        pThis->ringSize = AUDIOPLAYER_RING_SIZE;
+    }
+    if ( PASS != audioRx_setRing(&pThis->rx, pThis->ringSize)
+      || PASS != audioTx_setRing(&pThis->tx, pThis->ringSize)
+      || PASS != audioRx_setPolled(&pThis->rx, pThis->rxPolled) ) {
+        return FAIL;
+    }
+
     /**
      * Subscribe to the extio module for switch 0 high event. The event will be
      * parsed in get event
@@ -163,11 +187,115 @@ int audioPlayer_init(audioPlayer_t *pThis)
     if ( PASS != status) {
         return FAIL;
     }
+    /**
+     * Subscribe to the extio module for pushbutton 0 press, dumps the
+     * latency statistics
+     */
+    status = extio_eventSubscribe(EXTIO_PB0_HIGH);
+    if ( PASS != status) {
+        return FAIL;
+    }
+    /**
+     * Subscribe to the extio module for pushbutton 1 press, toggles
+     * between FIR and biquad filters
+     */
+    status = extio_eventSubscribe(EXTIO_PB1_HIGH);
+    if ( PASS != status) {
+        return FAIL;
+    }
+    /**
+     * Subscribe to the extio module for pushbutton 2 and 3 press, select
+     * an EQ band and step its gain
+     */
+    status = extio_eventSubscribe(EXTIO_PB2_HIGH);
+    if ( PASS != status) {
+        return FAIL;
+    }
+    status = extio_eventSubscribe(EXTIO_PB3_HIGH);
+    if ( PASS != status) {
+        return FAIL;
+    }
     
     /**
      * Initialize the audio filter module
      */
- 
+    status = audioFilter_init(&pThis->filter, AUDIOPLAYER_RATE);
+    if ( PASS != status ) {
+        return FAIL;
+    }
+    
+    /**
+     * Initialize the latency statistics, fed by TX at DMA start
+     */
+    status = latency_init(&pThis->latency);
+    if ( PASS != status ) {
+        return FAIL;
+    }
+    pThis->tx.pLatency = &pThis->latency;
+
+    /**
+     * Initialize the echo (SW0): taps at 300 and 700 ms, tap 0 fed back
+     */
+    status = echo_init(&pThis->echo, pThis->echoLine, AUDIOPLAYER_ECHO_SAMPLES);
+    if ( PASS != status ) {
+        return FAIL;
+    }
+    status  = echo_setTap(&pThis->echo, 0, AUDIOPLAYER_RATE * 3 / 10, 0x4000);
+    status |= echo_setTap(&pThis->echo, 1, AUDIOPLAYER_RATE * 7 / 10, 0x2666);
+    if ( PASS != status ) {
+        return FAIL;
+    }
+    echo_setMix(&pThis->echo, 0x6666, 0x2ccc);
+
+    /**
+     * Initialize the analysis side path: input decimated into chunks of
+     * a separate pool, 1/AUDIOPLAYER_ANALYSIS_FACTOR of the main chunk
+     */
+    status = multirate_init(&pThis->analysis, MULTIRATE_DECIMATE,
+                            AUDIOPLAYER_ANALYSIS_FACTOR, 1);
+    if ( PASS != status ) {
+        return FAIL;
+    }
+    size  = (pThis->chunkSize / AUDIOPLAYER_ANALYSIS_FACTOR + 3) & ~3;
+    count = (AUDIOPLAYER_ANALYSIS_ARENA_SIZE - BUFFERPOOL_ALIGN) / BUFFERPOOL_CHUNK_STRIDE(size);
+    if ( CHUNK_NUM_MAX < count ) {
+        count = CHUNK_NUM_MAX;
+    }
+    status = bufferPool_init(&pThis->analysisPool, size, count,
+                             pThis->analysisArena, sizeof(pThis->analysisArena));
+    if ( PASS != status ) {
+        return FAIL;
+    }
+    pThis->levelPeak     = 0;
+    pThis->levelEnergy   = 0;
+    pThis->levelSamples  = 0;
+    pThis->analysisDrops = 0;
+
+    /**
+     * Initialize the equalizer flat, all bands skipped
+     */
+    status = eq_init(&pThis->eq, AUDIOPLAYER_RATE);
+    if ( PASS != status ) {
+        return FAIL;
+    }
+
+    /**
+     * Initialize the limiter: while stages can boost the chain runs
+     * their summed boost below the input and is limited back up at its
+     * end, without one it runs at full resolution
+     */
+    status = limiter_init(&pThis->limiter, AUDIOPLAYER_RATE, 0);
+    if ( PASS != status ) {
+        return FAIL;
+    }
+
+    /**
+     * Initialize the DTMF decoder on the input (control tones)
+     */
+    status = dtmf_init(&pThis->dtmf, AUDIOPLAYER_RATE);
+    if ( PASS != status ) {
+        return FAIL;
+    }
     
     printf("[AP]: Init complete\n");
 
@@ -203,6 +331,139 @@ int audioPlayer_start(audioPlayer_t *pThis)
 
 
 
+/** analysis side path: decimate the input chunk into a chunk of the
+ *  analysis pool and run the level meter on it
+ *@param pThis   pointer to own object 
+ *@param pChunk  input chunk, not modified
+ *
+ *@return None
+ **/
+static void audioPlayer_analyze(audioPlayer_t *pThis, const chunk_t *pChunk)
+{
+    chunk_t                     *pSmall                 = NULL;
+    int                         i;
+
+    if ( PASS != bufferPool_acquire(&pThis->analysisPool, &pSmall) ) {
+        pThis->analysisDrops++;
+        return;
+    }
+    if ( PASS == multirate_chunk(&pThis->analysis, pChunk, pSmall) ) {
+        for ( i = 0; i < pSmall->len/2; i++ ) {
+            int x = pSmall->s16_buff[i];
+
+            if ( x < 0 ) {
+                x = -x;
+            }
+            if ( x > pThis->levelPeak ) {
+                pThis->levelPeak = x;
+            }
+            pThis->levelEnergy += x * x;
+        }
+        pThis->levelSamples += pSmall->len/2;
+    }
+    bufferPool_release(&pThis->analysisPool, pSmall);
+}
+
+/** print the input level and the cost of the analysis path, restart the meter
+ *@param pThis  pointer to own object 
+ *
+ *@return None
+ **/
+void audioPlayer_analysisReport(audioPlayer_t *pThis)
+{
+    double                      rms;
+
+    rms = pThis->levelSamples ? sqrt((double)pThis->levelEnergy / pThis->levelSamples) : 0.0;
+    printf("[AP]: input level peak %.1f dBFS, rms %.1f dBFS at %d Hz (%d x %d byte analysis chunks, %lu not analyzed)\n",
+           20.0 * log10(pThis->levelPeak / 32768.0 + 1e-9), 20.0 * log10(rms / 32768.0 + 1e-9),
+           AUDIOPLAYER_RATE / AUDIOPLAYER_ANALYSIS_FACTOR, pThis->analysisPool.count,
+           pThis->analysisPool.chunkSize, pThis->analysisDrops);
+    multirate_report(&pThis->analysis, "analysis");
+    pThis->levelPeak    = 0;
+    pThis->levelEnergy  = 0;
+    pThis->levelSamples = 0;
+}
+
+/** handle one control event, of extio or of a DTMF key
+ *@param pThis        pointer to own object 
+ *@param event        switch / button event
+ *@param pFilterMask  switches that are on, updated
+ *
+ *@return None
+ **/
+static void audioPlayer_event(audioPlayer_t *pThis, extio_input event, int *pFilterMask)
+{
+    printf("event: 0x%x\n", event);
+    if (event == EXTIO_SW0_HIGH || event == EXTIO_SW1_HIGH || event == EXTIO_SW2_HIGH || event == EXTIO_SW3_HIGH) {
+        *pFilterMask |= (0x1<<event);               
+    } else if (event == EXTIO_SW0_LOW || event == EXTIO_SW1_LOW || event == EXTIO_SW2_LOW || event == EXTIO_SW3_LOW) {
+        *pFilterMask &= ~(0x1<<(event-EXTIO_INPUT_FIRST));
+    } else if (event == EXTIO_PB0_HIGH) {
+        latency_dump(&pThis->latency);
+        echo_report(&pThis->echo, pThis->bp.chunkSize, pThis->bp.count);
+        audioPlayer_analysisReport(pThis);
+        eq_report(&pThis->eq, pThis->bp.chunkSize / 2);
+        limiter_report(&pThis->limiter, pThis->bp.chunkSize / 2);
+        dtmf_report(&pThis->dtmf, pThis->bp.chunkSize / 2);
+    } else if (event == EXTIO_PB1_HIGH) {
+        audioFilter_setType(&pThis->filter, AUDIOFILTER_FIR == pThis->filter.type ?
+                            AUDIOFILTER_BIQUAD : AUDIOFILTER_FIR);
+    } else if (event == EXTIO_PB2_HIGH) {
+        eq_step(&pThis->eq, 1);
+    } else if (event == EXTIO_PB3_HIGH) {
+        eq_step(&pThis->eq, 0);
+    }
+}
+
+/** event of a DTMF key: 1 2 3 A switch SW0..SW3 on, 4 5 6 B off,
+ *  7 8 9 C press PB0..PB3
+ *@param key     DTMF key
+ *@param pEvent  where to store the event
+ *
+ *@return Zero if the key has an event, FAIL otherwise
+ **/
+static int audioPlayer_keyEvent(char key, extio_input *pEvent)
+{
+    static const char           keys[]                  = "123A456B789C";
+    static const extio_input    events[]                = {
+        EXTIO_SW0_HIGH, EXTIO_SW1_HIGH, EXTIO_SW2_HIGH, EXTIO_SW3_HIGH,
+        EXTIO_SW0_LOW,  EXTIO_SW1_LOW,  EXTIO_SW2_LOW,  EXTIO_SW3_LOW,
+        EXTIO_PB0_HIGH, EXTIO_PB1_HIGH, EXTIO_PB2_HIGH, EXTIO_PB3_HIGH
+    };
+    const char                  *pPos                   = strchr(keys, key);
+
+    if ( 0 == key || NULL == pPos ) {
+        return FAIL;
+    }
+    *pEvent = events[pPos - keys];
+    return PASS;
+}
+
+/** Bound of the boost of the enabled stages, EQ bands and echo stack
+ *@param pThis       pointer to own object 
+ *@param filterMask  switches of the enabled stages
+ *
+ *@return boost in dB, 0 if no stage boosts
+ **/
+static int audioPlayer_boost(const audioPlayer_t *pThis, int filterMask)
+{
+    int                         boost                   = eq_boost(&pThis->eq);
+
+    if (filterMask & (0x1<<EXTIO_SW0_HIGH)) {
+        boost += echo_boost(&pThis->echo);
+    }
+    if (filterMask & (0x1<<EXTIO_SW1_HIGH)) {
+        boost += AUDIOPLAYER_FILTER_BOOST;
+    }
+    if (filterMask & (0x1<<EXTIO_SW2_HIGH)) {
+        boost += AUDIOPLAYER_FILTER_BOOST;
+    }
+    if (filterMask & (0x1<<EXTIO_SW3_HIGH)) {
+        boost += AUDIOPLAYER_FILTER_BOOST;
+    }
+    return boost;
+}
+
 /** main loop of audio player does not terminate
  *@param pThis  pointer to own object 
  *
@@ -210,47 +471,58 @@ int audioPlayer_start(audioPlayer_t *pThis)
  **/
 void audioPlayer_run(audioPlayer_t *pThis)
 {
-    chunk_t                  chunk;
-    int                         start_tx                = 0;    
+    chunk_t                     *pChunk                 = NULL;
     int                         status                  = FAIL;
     int                         filterMask              = 0;
     extio_input                 event;
-//    cycle_stats_t						cycle_stats;
-    cycle_t						cycle_stats;
-    unsigned int				count					= 0;
-    
-    // init local chunk    
-    chunk_init(&chunk);
-    
+    char                        key;
     
     while(1) {
-    	/** get audio chunk */
-        audioRx_get(&pThis->rx, &chunk);
+    	/** get audio chunk, the DMA chunk is processed in place */
+        if ( PASS != audioRx_getChunk(&pThis->rx, &pChunk) ) {
+            continue;
+        }
         
+        /** events of the switches and buttons, then keys of the DTMF decoder */
         status = extio_eventGet(&event);        
         if ( PASS == status ) {
-            printf("event: 0x%x\n", event);
-            if (event == EXTIO_SW0_HIGH | event == EXTIO_SW1_HIGH | event == EXTIO_SW2_HIGH | event == EXTIO_SW3_HIGH) {
-                filterMask |= (0x1<<event);               
-            } else if (event == EXTIO_SW0_LOW | event == EXTIO_SW1_LOW | event == EXTIO_SW2_LOW | event == EXTIO_SW3_LOW) {
-                filterMask &= ~(0x1<<(event-EXTIO_INPUT_FIRST));
+            audioPlayer_event(pThis, event, &filterMask);
+        }
+        while ( PASS == dtmf_keyGet(&pThis->dtmf, &key) ) {
+            if ( PASS == audioPlayer_keyEvent(key, &event) ) {
+                audioPlayer_event(pThis, event, &filterMask);
             }
         }
         
         
         /** Processing on the chunks */
+        LATENCY_STAMP(pChunk, CHUNK_STAMP_FILTER_START);
+        /** analysis side path on the unprocessed input */
+        audioPlayer_analyze(pThis, pChunk);
+        /** control tones, keys are handled with the next chunk */
+        dtmf_process(&pThis->dtmf, pChunk);
+        /** headroom for the summed boost of the enabled stages (echo,
+            filters, EQ bands), taken back by the limiter; bit-exact
+            while none boosts */
+        limiter_setHeadroom(&pThis->limiter,
+                            limiter_boostHeadroom(audioPlayer_boost(pThis, filterMask)));
+        limiter_trim(&pThis->limiter, pChunk);
         if (filterMask & (0x1<<EXTIO_SW0_HIGH)) {
+            echo_process(&pThis->echo, pChunk);
         }        
-        if (filterMask & (0x1<<EXTIO_SW1_HIGH)) {
-        }
-        if (filterMask & (0x1<<EXTIO_SW2_HIGH)) {
-        }
-        if (filterMask & (0x1<<EXTIO_SW3_HIGH)) {
-        }
+        /** EQ, bands at 0 dB cost nothing */
+        eq_process(&pThis->eq, pChunk);
+        /** SW1..SW3 select filter 1..3, all enabled filters run in one pass */
+        audioFilter_cascade(&pThis->filter, pChunk,
+                            ((filterMask & (0x1<<EXTIO_SW1_HIGH)) ? 0x1 : 0) |
+                            ((filterMask & (0x1<<EXTIO_SW2_HIGH)) ? 0x2 : 0) |
+                            ((filterMask & (0x1<<EXTIO_SW3_HIGH)) ? 0x4 : 0));
+        limiter_process(&pThis->limiter, pChunk);
         /** Processing Complete */
+        LATENCY_STAMP(pChunk, CHUNK_STAMP_FILTER_END);
 
-        /** play audio chunk through speakers */
-        audioTx_put(&pThis->tx, &chunk);
+        /** play audio chunk through speakers, TX releases it when done */
+        audioTx_putChunk(&pThis->tx, pChunk);
     }
 }
 
@@ -15,14 +15,14 @@
  * $Id: audioRx.c 512 2011-02-07 22:59:49Z rkangral $
  *
  *******************************************************************************/
+#include <string.h>
 #include "tll_common.h"
 #include "audioRx.h"
 #include "bufferPool.h"
 #include "isrDisp.h"
-#include <tll_config.h>
-#include <tll_sport.h>
-#include <queue.h>
-#include <power_mode.h>
+#include "audioHal.h"
+#include "spscRing.h"
+#include "latency.h"
 
 
 /**
@@ -75,13 +75,7 @@ int audioRx_fileRead(FILE *pFile, chunk_t *pchunk_rx)
  */
 void audioRx_dmaConfig(chunk_t *pchunk)
 {
-    DISABLE_DMA(*pDMA3_CONFIG);
-    *pDMA3_START_ADDR   = &pchunk->u16_buff[0];
-    *pDMA3_Y_COUNT		= pchunk->size/2;  // 16 bit data so we change the stride and count
-    *pDMA3_X_COUNT      = 2;
-    *pDMA3_Y_MODIFY		= 2;
-    *pDMA3_X_MODIFY     = 0;
-    ENABLE_DMA(*pDMA3_CONFIG);
+    audioHal_rxDmaConfig(&pchunk->u16_buff[0], pchunk->size/2);
 }
 
 
@@ -110,15 +104,24 @@ int audioRx_init(audioRx_t *pThis, bufferPool_t *pBuffP,
     
     pThis->pPending     = NULL;
     pThis->pBuffP       = pBuffP;
+    pThis->nDropped     = 0;
+    pThis->ringSize     = 1;
+    pThis->ringHead     = 0;
+    pThis->nCoalesced   = 0;
+    pThis->polled       = 0;
+    pThis->pollRead     = 0;
+    pThis->nOverrun     = 0;
     
-    // init queue with 
-    queue_init(&pThis->queue, AUDIORX_QUEUE_DEPTH);   
+    // init queue, filled by the ISR and emptied by the main loop
+    if ( FAIL == spscRing_init(&pThis->queue, AUDIORX_QUEUE_DEPTH) ) {
+        return FAIL;
+    }   
  
      /* Configure the DMA3 for RX (data receive/memory write) */
      /* Read, 1-D, interrupt enabled, Memory write operation, 16 bit transfer,
       * Auto buffer
       */
-    *pDMA3_CONFIG = WNR | WDSIZE_16 | DI_EN | DMA2D;
+    audioHal_rxInit();
 
     /**
      * Register the interrupt handler
@@ -133,6 +136,78 @@ int audioRx_init(audioRx_t *pThis, bufferPool_t *pBuffP,
 
 
 
+/** Select the DMA mode, call between audioRx_init and audioRx_start
+ *    - 1: register mode, the ISR reprograms the DMA for every chunk
+ *    - 2 .. AUDIORX_RING_MAX: ring of chunk descriptors
+
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param nSize  chunks in the ring
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioRx_setRing(audioRx_t *pThis, int nSize)
+{
+    if ( NULL == pThis || 1 > nSize || AUDIORX_RING_MAX < nSize ) {
+        printf("[ARX]: ring of %d chunks not supported\n", nSize);
+        return FAIL;
+    }
+    pThis->ringSize = nSize;
+    return PASS;
+}
+
+
+
+/** Select polled mode, call between audioRx_init and audioRx_start
+
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param polled  non-zero for polled mode
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioRx_setPolled(audioRx_t *pThis, int polled)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    pThis->polled = polled;
+    return PASS;
+}
+
+
+
+/** start the descriptor ring
+ *    - one chunk from the pool per descriptor
+ *    - link the ring and let the DMA run through it
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+static int audioRx_ringStart(audioRx_t *pThis)
+{
+    int         i;
+
+    audioHal_rxDescInit(pThis->ring, pThis->ringSize);
+    for ( i = 0; i < pThis->ringSize; i++ ) {
+        if ( FAIL == bufferPool_acquire(pThis->pBuffP, &pThis->pRingChunk[i]) ) {
+            printf("[ARX]: Failed to acquire buffer\n");
+            return FAIL;
+        }
+        audioHal_descSet(&pThis->ring[i], &pThis->pRingChunk[i]->u16_buff[0],
+                         pThis->pRingChunk[i]->size/2);
+    }
+    pThis->ringHead = 0;
+    audioHal_rxDescStart(&pThis->ring[0]);
+    return PASS;
+}
+
+
+
 /** start audio rx
  *    - start receiving first chunk from DMA
  *      - acqurie chunk from pool 
@@ -147,6 +222,21 @@ int audioRx_init(audioRx_t *pThis, bufferPool_t *pBuffP,
 int audioRx_start(audioRx_t *pThis)
 {
 #ifndef ENABLE_FILE_STUB
+    if ( pThis->polled ) {
+        pThis->pollRead = 0;
+        audioHal_rxAutoStart(&pThis->pollBuff[0], AUDIORX_POLL_SAMPLES);
+        audioHal_rxEnable();
+        return PASS;
+    }
+
+    if ( 1 < pThis->ringSize ) {
+        if ( FAIL == audioRx_ringStart(pThis) ) {
+            return FAIL;
+        }
+        audioHal_rxEnable();
+        return PASS;
+    }
+
     /* prime the system by getting the first buffer filled */
      if ( FAIL == bufferPool_acquire(pThis->pBuffP, &pThis->pPending ) ) {
          printf("[ARX]: Failed to acquire buffer\n");
@@ -156,7 +246,7 @@ int audioRx_start(audioRx_t *pThis)
      audioRx_dmaConfig(pThis->pPending);    
      
      // enable the audio transfer 
-     ENABLE_SPORT0_RX();
+     audioHal_rxEnable();
 #else
     pThis->audioRx_pFile = fopen(FILE_NAME, "rb");
     if(pThis->audioRx_pFile== NULL) {
@@ -170,6 +260,66 @@ int audioRx_start(audioRx_t *pThis)
 
 
 
+/** hand the chunk of a finished descriptor to the queue
+ *    - a fresh chunk from the pool takes its place in the descriptor
+ *    - without a fresh chunk or space in the queue the descriptor keeps
+ *      its chunk and the DMA overwrites it on the next round (dropped)
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param idx    finished descriptor
+ *
+ * @return None
+ */
+static void audioRx_ringRetire(audioRx_t *pThis, int idx)
+{
+    chunk_t     *pDone  = pThis->pRingChunk[idx];
+    chunk_t     *pFresh = NULL;
+
+    pDone->len = pDone->size;
+    LATENCY_STAMP(pDone, CHUNK_STAMP_RX_DONE);
+
+    if ( FAIL == bufferPool_acquire(pThis->pBuffP, &pFresh) ) {
+        pThis->nDropped++;
+        return;
+    }
+    if ( FAIL == spscRing_push(&pThis->queue, pDone) ) {
+        bufferPool_release(pThis->pBuffP, pFresh);
+        pThis->nDropped++;
+        return;
+    }
+    pThis->pRingChunk[idx] = pFresh;
+    audioHal_descSet(&pThis->ring[idx], &pFresh->u16_buff[0], pFresh->size/2);
+}
+
+/** ISR of the descriptor ring
+ *    - the DMA already works on the descriptor after the finished one,
+ *      every descriptor from ringHead up to that one is done; at least
+ *      the head is, even if the DMA has not fetched its successor yet
+ *    - more than one are done if the ISR ran late and the interrupts
+ *      of several descriptors fell together
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return None
+ */
+static void audioRx_ringIsr(audioRx_t *pThis)
+{
+    int         active  = (audioHal_rxDescNext() - pThis->ring + pThis->ringSize - 1) % pThis->ringSize;
+    int         done    = (active - pThis->ringHead + pThis->ringSize) % pThis->ringSize;
+
+    if ( 0 == done ) {
+        done = 1;
+    } else if ( 1 < done ) {
+        pThis->nCoalesced++;
+    }
+    while ( done-- ) {
+        audioRx_ringRetire(pThis, pThis->ringHead);
+        pThis->ringHead = (pThis->ringHead + 1) % pThis->ringSize;
+    }
+}
+
+
+
 /** audioRx_isr
 
  * Parameters:
@@ -182,18 +332,28 @@ void audioRx_isr(void *pThisArg)
     // local pThis to avoid constant casting 
     audioRx_t *pThis  = (audioRx_t*) pThisArg; 
     
-    if ( *pDMA3_IRQ_STATUS & 0x1 ) {
+    if ( 1 < pThis->ringSize ) {
+        if ( audioHal_rxIrqPending() ) {
+            audioRx_ringIsr(pThis);
+            audioHal_rxIrqClear();  // clear the interrupt, after reading the ring position
+        }
+        return;
+    }
+
+    if ( audioHal_rxIrqPending() ) {
 
         // chunk is now filled update the length
         pThis->pPending->len = pThis->pPending->size;
+        LATENCY_STAMP(pThis->pPending, CHUNK_STAMP_RX_DONE);
         
         /* Insert the chunk previously read by the DMA RX on the
             RX QUEUE and a data is inserted to queue
          */
-        if ( FAIL == queue_put(&pThis->queue, pThis->pPending) ) {
+        if ( FAIL == spscRing_push(&pThis->queue, pThis->pPending) ) {
             
             // reuse the same buffer and overwrite last samples 
             audioRx_dmaConfig(pThis->pPending);
+            pThis->nDropped++;
             
             printf("[INT]: RX packet dropped\n");
         } else {
@@ -205,8 +365,173 @@ void audioRx_isr(void *pThisArg)
             }
         }
         
-        *pDMA3_IRQ_STATUS  |= 0x0001;  // clear the interrupt
+        audioHal_rxIrqClear();  // clear the interrupt
+    }
+}
+
+
+
+/** samples received but not handed out yet (polled mode)
+ *    - the DMA position alone can not tell a full round from none, a
+ *      backlog beyond 3/4 of the buffer counts as overrun: the older
+ *      samples are skipped and the reader continues at the DMA position
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return number of samples ready
+ */
+static int audioRx_pollReady(audioRx_t *pThis)
+{
+    int         pos     = audioHal_rxAutoPos();
+    int         ready   = (pos - pThis->pollRead + AUDIORX_POLL_SAMPLES) % AUDIORX_POLL_SAMPLES;
+
+    if ( AUDIORX_POLL_SAMPLES / 4 * 3 < ready ) {
+        pThis->pollRead = pos;
+        pThis->nOverrun++;
+        ready = 0;
+    }
+    return ready;
+}
+
+
+
+/** view of up to nSamples ready samples, stops at the end of the DMA
+ *  buffer (polled mode)
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param pView     chunk object, set to the view
+ * @param nSamples  samples wanted, no more than are ready
+ *
+ * @return None
+ */
+static void audioRx_pollView(audioRx_t *pThis, chunk_t *pView, int nSamples)
+{
+    int         count   = AUDIORX_POLL_SAMPLES - pThis->pollRead;
+
+    if ( nSamples < count ) {
+        count = nSamples;
+    }
+    chunk_init(pView, &pThis->pollBuff[pThis->pollRead], count * 2);
+    pView->len      = count * 2;
+    pThis->pollRead = (pThis->pollRead + count) % AUDIORX_POLL_SAMPLES;
+}
+
+
+
+/** audioRx_getView
+ *   polled mode: view of the next received samples, without copying
+ *   and without blocking
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param pView     chunk object, set to the view
+ * @param nSamples  samples wanted, AUDIORX_POLL_MIN .. AUDIORX_POLL_SAMPLES/2
+ *
+ * @return Zero on success.
+ * Negative value if fewer samples are ready or on failure.
+ */
+int audioRx_getView(audioRx_t *pThis, chunk_t *pView, int nSamples)
+{
+    if ( NULL == pThis || NULL == pView || 0 == pThis->polled
+      || AUDIORX_POLL_MIN > nSamples || AUDIORX_POLL_SAMPLES / 2 < nSamples ) {
+        printf("[ARX]: Failed to get view\n");
+        return FAIL;
+    }
+    if ( audioRx_pollReady(pThis) < nSamples ) {
+        return FAIL;
     }
+    audioRx_pollView(pThis, pView, nSamples);
+    return PASS;
+}
+
+
+
+/** polled mode of audioRx_getChunk
+ *    - polls until a chunk worth of samples is ready
+ *    - copies them out of the DMA buffer into a chunk of the pool, the
+ *      caller processes it in place and passes it on to audioTx
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param ppChunk pointer to chunk pointer, set to the filled chunk
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+static int audioRx_pollChunk(audioRx_t *pThis, chunk_t **ppChunk)
+{
+    chunk_t     *pChunk;
+    chunk_t     view;
+    int         nSamples;
+    int         done    = 0;
+
+    if ( FAIL == bufferPool_acquire(pThis->pBuffP, &pChunk) ) {
+        return FAIL;
+    }
+    nSamples = pChunk->size / 2;
+    if ( AUDIORX_POLL_SAMPLES / 2 < nSamples ) {
+        printf("[ARX]: chunk too large for polled mode\n");
+        bufferPool_release(pThis->pBuffP, pChunk);
+        return FAIL;
+    }
+
+    while ( audioRx_pollReady(pThis) < nSamples ) {
+        audioHal_poll();
+    }
+    LATENCY_STAMP(pChunk, CHUNK_STAMP_RX_DONE);
+
+    /* at most two views, the second one after the wrap around */
+    while ( done < nSamples ) {
+        audioRx_pollView(pThis, &view, nSamples - done);
+        memcpy(&pChunk->u16_buff[done], view.u16_buff, view.len);
+        done += view.len / 2;
+    }
+    pChunk->len = pChunk->size;
+    LATENCY_STAMP(pChunk, CHUNK_STAMP_DEQUEUE);
+    *ppChunk = pChunk;
+    return PASS;
+}
+
+
+
+/** audio rx get chunk
+ *   hands a filled chunk over to the caller without copying
+ *   blocking call, blocks if queue is empty 
+ *     - get from queue 
+ *     - caller owns the chunk and has to pass it on (audioTx_putChunk)
+ *       or release it to the buffer pool
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param ppChunk pointer to chunk pointer, set to the filled chunk
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioRx_getChunk(audioRx_t *pThis, chunk_t **ppChunk)
+{
+    if ( NULL == pThis || NULL == ppChunk ) {
+        printf("[ARX]: Failed to get\n");
+        return FAIL;
+    }
+    
+#ifdef ENABLE_FILE_STUB 
+    if ( FAIL == bufferPool_acquire(pThis->pBuffP, ppChunk) ) {
+        return FAIL;
+    }
+    audioRx_fileRead(pThis->audioRx_pFile, *ppChunk);
+#else
+    if ( pThis->polled ) {
+        return audioRx_pollChunk(pThis, ppChunk);
+    }
+
+    /* Block till a chunk arrives on the rx queue */
+    while( spscRing_isEmpty(&pThis->queue) ) {
+        audioHal_idle();
+    }
+    audioHal_active();
+    
+    spscRing_pop(&pThis->queue, (void**)ppChunk);
+    LATENCY_STAMP(*ppChunk, CHUNK_STAMP_DEQUEUE);
+#endif
+    return PASS;
 }
 
 
@@ -214,7 +539,7 @@ void audioRx_isr(void *pThisArg)
 /** audio rx get 
  *   copyies a filled chunk into pChunk
  *   blocking call, blocks if queue is empty 
- *     - get from queue 
+ *     - get chunk (audioRx_getChunk)
  *     - copy in to pChunk
  *     - release chunk to buffer pool 
  * Parameters:
@@ -227,20 +552,10 @@ void audioRx_isr(void *pThisArg)
 int audioRx_get(audioRx_t *pThis, chunk_t *pChunk)
 {
     chunk_t                  *chunk_rx;
-    int                         count                   = 0;
-    
     
-#ifdef ENABLE_FILE_STUB 
-    audioRx_fileRead(pThis->audioRx_pFile, pChunk);
-#else
-    /* Block till a chunk arrives on the rx queue */
-    while( queue_is_empty(&pThis->queue) ) {
-        powerMode_change(PWR_ACTIVE);
-        asm("idle;");
+    if ( FAIL == audioRx_getChunk(pThis, &chunk_rx) ) {
+        return FAIL;
     }
-    powerMode_change(PWR_FULL_ON);
-    
-    queue_get(&pThis->queue, (void**)&chunk_rx);
 
     chunk_copy(chunk_rx, pChunk);
     
@@ -248,7 +563,5 @@ int audioRx_get(audioRx_t *pThis, chunk_t *pChunk)
         return FAIL;
     }
     
-#endif
     return PASS;
 }
-
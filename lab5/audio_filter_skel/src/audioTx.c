@@ -19,10 +19,8 @@
 #include "audioTx.h"
 #include "bufferPool.h"
 #include "isrDisp.h"
-#include <tll_config.h>
-#include <tll_sport.h>
-#include <queue.h>
-#include <power_mode.h>
+#include "audioHal.h"
+#include "spscRing.h"
 
 
 /** 
@@ -34,13 +32,29 @@
  */
 void audioTx_dmaConfig(chunk_t *pchunk)
 {
-    DISABLE_DMA(*pDMA4_CONFIG);
-    *pDMA4_START_ADDR   = &pchunk->u16_buff[0];
-    *pDMA4_Y_COUNT		= pchunk->len/2;  // 16 bit data so we change the stride and count
-    *pDMA4_X_COUNT      = 2;
-    *pDMA4_Y_MODIFY		= 2;
-    *pDMA4_X_MODIFY     = 0;
-    ENABLE_DMA(*pDMA4_CONFIG);
+    audioHal_txDmaConfig(&pchunk->u16_buff[0], pchunk->len/2);
+}
+
+
+/** 
+ * Time stamps a chunk at TX DMA start and adds its path latency
+ * to the statistics
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pchunk  chunk the DMA starts on
+ * @return void
+ */
+static void audioTx_stamp(audioTx_t *pThis, chunk_t *pchunk)
+{
+#if LATENCY_ENABLE
+    LATENCY_STAMP(pchunk, CHUNK_STAMP_TX_START);
+    if ( NULL != pThis->pLatency ) {
+        latency_record(pThis->pLatency, pchunk);
+    }
+#else
+    (void)pThis;
+    (void)pchunk;
+#endif
 }
 
 
@@ -71,13 +85,23 @@ int audioTx_init(audioTx_t *pThis, bufferPool_t *pBuffP,
 
     pThis->pPending     = NULL; // nothing pending
     pThis->running      = 0;    // DMA turned off by default
+    pThis->nDropped     = 0;
+    pThis->nUnderrun    = 0;
+    pThis->pLatency     = NULL;
+    pThis->ringSize     = 1;
+    pThis->ringHead     = 0;
+    pThis->ringFill     = 0;
+    pThis->ringFresh    = 0;
+    pThis->nCoalesced   = 0;
     
-    // init queue 
-    queue_init(&pThis->queue, AUDIOTX_QUEUE_DEPTH);   
+    // init queue, filled by the main loop and emptied by the ISR
+    if ( FAIL == spscRing_init(&pThis->queue, AUDIOTX_QUEUE_DEPTH) ) {
+        return FAIL;
+    }   
  
     /* Configure the DMA4 for TX (data transfer/memory read) */
     /* Read, 1-D, interrupt enabled, 16 bit transfer, Auto buffer */
-    *pDMA4_CONFIG = WDSIZE_16 | DI_EN | DMA2D;
+    audioHal_txInit();
     
     // register own ISR to the ISR dispatcher
     isrDisp_registerCallback(pIsrDisp, ISR_DMA4_SPORT0_TX, audioTx_isr, pThis);
@@ -89,6 +113,29 @@ int audioTx_init(audioTx_t *pThis, bufferPool_t *pBuffP,
 
 
 
+/** Select the DMA mode, call between audioTx_init and the first put
+ *    - 1: register mode, the ISR reprograms the DMA for every chunk
+ *    - 2 .. AUDIOTX_RING_MAX: ring of chunk descriptors
+
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param nSize  chunks in the ring
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioTx_setRing(audioTx_t *pThis, int nSize)
+{
+    if ( NULL == pThis || 1 > nSize || AUDIOTX_RING_MAX < nSize ) {
+        printf("[ATX]: ring of %d chunks not supported\n", nSize);
+        return FAIL;
+    }
+    pThis->ringSize = nSize;
+    return PASS;
+}
+
+
+
 /** start audio tx
  *   - empthy for now
  * Parameters:
@@ -108,6 +155,88 @@ int audioTx_start(audioTx_t *pThis)
 
 
 
+/** put one of the first chunks into the descriptor ring
+ *   - the DMA starts on the first descriptor once all are filled
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk to play
+ *
+ * @return None
+ */
+static void audioTx_ringPrime(audioTx_t *pThis, chunk_t *pChunk)
+{
+    if ( 0 == pThis->ringFill ) {
+        audioHal_txDescInit(pThis->ring, pThis->ringSize);
+    }
+    pThis->pRingChunk[pThis->ringFill] = pChunk;
+    audioHal_descSet(&pThis->ring[pThis->ringFill], &pChunk->u16_buff[0], pChunk->len/2);
+    pThis->ringFill++;
+
+    if ( pThis->ringFill == pThis->ringSize ) {
+        pThis->running   = 1;
+        pThis->ringHead  = 0;
+        pThis->ringFresh = ((0x1 << pThis->ringSize) - 1) & ~0x1;
+        audioTx_stamp(pThis, pThis->pRingChunk[0]);
+        audioHal_txDescStart(&pThis->ring[0]);
+        audioHal_txEnable();
+    }
+}
+
+/** refill a played descriptor with the next queued chunk
+ *   - the played chunk goes back to the pool
+ *   - on an empty queue the descriptor keeps its chunk, which is
+ *     played again on the next round
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param idx    played descriptor
+ *
+ * @return None
+ */
+static void audioTx_ringRetire(audioTx_t *pThis, int idx)
+{
+    chunk_t     *pchunk = NULL;
+
+    if ( PASS == spscRing_pop(&pThis->queue, (void **)&pchunk) ) {
+        bufferPool_release(pThis->pBuffP, pThis->pRingChunk[idx]);
+        pThis->pRingChunk[idx] = pchunk;
+        pThis->ringFresh      |= 0x1 << idx;
+        audioHal_descSet(&pThis->ring[idx], &pchunk->u16_buff[0], pchunk->len/2);
+    } else {
+        pThis->nUnderrun++;
+    }
+}
+
+/** ISR of the descriptor ring
+ *    - every descriptor from ringHead up to the one the DMA works on
+ *      has been played, at least the head (see audioRx_ringIsr)
+ *    - the chunk the DMA starts on is time stamped, once
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return None
+ */
+static void audioTx_ringIsr(audioTx_t *pThis)
+{
+    int         active  = (audioHal_txDescNext() - pThis->ring + pThis->ringSize - 1) % pThis->ringSize;
+    int         done    = (active - pThis->ringHead + pThis->ringSize) % pThis->ringSize;
+
+    if ( 0 == done ) {
+        done = 1;
+    } else if ( 1 < done ) {
+        pThis->nCoalesced++;
+    }
+    while ( done-- ) {
+        audioTx_ringRetire(pThis, pThis->ringHead);
+        pThis->ringHead = (pThis->ringHead + 1) % pThis->ringSize;
+    }
+    if ( pThis->ringFresh & (0x1 << pThis->ringHead) ) {
+        pThis->ringFresh &= ~(0x1 << pThis->ringHead);
+        audioTx_stamp(pThis, pThis->pRingChunk[pThis->ringHead]);
+    }
+}
+
+
+
 /** audio rtx isr  (to be called from dispatcher) 
  *   - get chunk from tx queue
  *    - if valid, release old pending chunk to buffer pool 
@@ -125,22 +254,32 @@ void audioTx_isr(void *pThisArg)
 
     chunk_t                  *pchunk              = NULL;
     
+    if ( 1 < pThis->ringSize ) {
+        if ( audioHal_txIrqPending() ) {
+            audioTx_ringIsr(pThis);
+            audioHal_txIrqClear();     // Clear the interrupt, after reading the ring position
+        }
+        return;
+    }
+
     // validate that TX DMA IRQ was triggered 
-    if ( *pDMA4_IRQ_STATUS & 0x1  ) {
+    if ( audioHal_txIrqPending() ) {
         //printf("[TXISR]\n");
         /* Remove the  data from the queue and create space for more data
            The data was read previously by the DMA
          */
          /* fist attempt to get new chunk */
-        if(PASS == queue_get(&pThis->queue, (void **)&pchunk) ) {
+        if(PASS == spscRing_pop(&pThis->queue, (void **)&pchunk) ) {
                 /* release old chunk on success */
                bufferPool_release(pThis->pBuffP, pThis->pPending);
                /* register new chunk as pending */
                pThis->pPending = pchunk;
+               audioTx_stamp(pThis, pchunk);
         } else {
+            pThis->nUnderrun++;
             printf("TX Q Emtpy\n");           
         }
-        *pDMA4_IRQ_STATUS  |= 0x0001;     // Clear the interrupt
+        audioHal_txIrqClear();     // Clear the interrupt
         
         // config DMA either with new chunk (if there was one), or with old chunk on empty Q
         audioTx_dmaConfig(pThis->pPending);        
@@ -150,7 +289,61 @@ void audioTx_isr(void *pThisArg)
 
 
 
-/** audio rx put
+/** audio tx put chunk
+ *   hands pChunk over to the TX queue for transmission without copying
+ *    - ownership passes to audioTx, the chunk is released to the
+ *      buffer pool once it has been transmitted
+ *    - if queue is full, then chunk is dropped (released)
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pChunk Pointer to chunk acquired from the buffer pool
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int audioTx_putChunk(audioTx_t *pThis, chunk_t *pChunk)
+{
+    if ( NULL == pThis || NULL == pChunk ) {
+        printf("[TX]: Failed to put\n");
+        return FAIL;
+    }
+    
+    // block if queue is full
+    while(spscRing_isFull(&pThis->queue) ) {
+        printf("[TX]: Queue Full\n");
+        audioHal_idle();
+    }
+    audioHal_active();
+    
+    LATENCY_STAMP(pChunk, CHUNK_STAMP_TX_ENQUEUE);
+    
+    /* descriptor ring not filled yet ? */
+    if ( 0 == pThis->running && 1 < pThis->ringSize ) {
+        audioTx_ringPrime(pThis, pChunk);
+    } else if ( 0 == pThis->running ) {
+        /* directly put chunk to DMA transfer & enable */
+        pThis->running  = 1;
+        pThis->pPending = pChunk;
+        audioTx_stamp(pThis, pChunk);
+        audioTx_dmaConfig(pThis->pPending);  
+        audioHal_txEnable();  
+    } else { 
+        /* DMA already running add chunk to queue */
+        if ( PASS != spscRing_push(&pThis->queue, pChunk) ) {
+            
+            // return chunk to pool if queue is full, effectivly dropping the chunk 
+            bufferPool_release(pThis->pBuffP, pChunk);
+            pThis->nDropped++;
+            return FAIL;
+        }
+    }
+    
+    return PASS;
+}
+
+
+
+/** audio tx put
  *   copyies filled pChunk into the TX queue for transmission
  *    if queue is full, then chunk is dropped 
  * Parameters:
@@ -163,48 +356,24 @@ void audioTx_isr(void *pThisArg)
 int audioTx_put(audioTx_t *pThis, chunk_t *pChunk)
 {
     chunk_t                  *pchunk_temp         = NULL;
-    int                         count                   = 0;
     
     if ( NULL == pThis || NULL == pChunk ) {
         printf("[TX]: Failed to put\n");
         return FAIL;
     }
     
-    // block if queue is full
-    while(queue_is_full(&pThis->queue) ) {
-        printf("[TX]: Queue Full\n");
-        powerMode_change(PWR_ACTIVE);
-        asm("idle;");
-    }
-    powerMode_change(PWR_FULL_ON);
-    
     // get free chunk from pool 
     if ( PASS == bufferPool_acquire(pThis->pBuffP, &pchunk_temp) ) {
         // copy chunk into free buffer for queue 
         //   (manually since memcpy is not working)
         chunk_copy(pChunk, pchunk_temp);
         
-        /* If DMA not running ? */
-        if ( 0 == pThis->running ) {
-            /* directly put chunk to DMA transfer & enable */
-            pThis->running  = 1;
-            pThis->pPending = pchunk_temp;
-            audioTx_dmaConfig(pThis->pPending);  
-            ENABLE_SPORT0_TX();  
-        } else { 
-            /* DMA already running add chunk to queue */
-            if ( PASS != queue_put(&pThis->queue, pchunk_temp) ) {
-                
-                // return chunk to pool if queue is full, effectivly dropping the chunk 
-                bufferPool_release(pThis->pBuffP, pchunk_temp);
-                return FAIL;
-            }
-        }
-    } else {
-        // drop if we dont get free space 
-        printf("[TX] failed to get buffer\n");
-    }
+        return audioTx_putChunk(pThis, pchunk_temp);
+    } 
+    
+    // drop if we dont get free space 
+    pThis->nDropped++;
+    printf("[TX] failed to get buffer\n");
     
     return PASS;
 }
-
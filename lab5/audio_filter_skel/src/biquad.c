@@ -0,0 +1,412 @@
+/**
+ *@file biquad.c
+ *
+ *@brief
+ *  - cascade of second order IIR sections, direct form II transposed
+ *
+ *  Per section and sample:
+ *    y  = b0 x + s1
+ *    s1 = b1 x - a1 y + s2
+ *    s2 = b2 x - a2 y
+ *  Q15: products of 1.15 data and Q2.14 coefficients are Q3.29, the
+ *  states are 40 bit accumulators (q15_acc_t, saturated with q15_accSat
+ *  as in the Blackfin A0/A1), y is rounded and saturated back to 1.15
+ *  before it feeds the next section. With |coefficients| < 2 and
+ *  saturated y, |s2| < 2^31, |s1| < 2^32 and |b0 x + s1| < 2^33, so the
+ *  range test is a branch that is never taken and stays off the
+ *  feedback path.
+ *  Q31: data between sections is 1.31, products are taken to 64 bit and
+ *  shifted back by 30, which keeps the noise of narrow low frequency
+ *  sections well below the 16 bit output.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include <math.h>
+#include "biquad.h"
+#include "q15.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/** saturate to 32 bit */
+static int biquad_sat32(long long v)
+{
+    return v > 0x7fffffffLL ? 0x7fffffff : v < -0x80000000LL ? (int)-0x80000000LL : (int)v;
+}
+
+/** saturate to 16 bit */
+static fract16 biquad_sat16(long long v)
+{
+    return v > 0x7fff ? 0x7fff : v < -0x8000 ? -0x8000 : (fract16)v;
+}
+
+/** Design one section (bilinear transform, pre-warped at freq)
+ *
+ * Parameters:
+ * @param pCoeff  filled with the section coefficients
+ * @param shape   response
+ * @param freq    corner / center frequency as fraction of the sample rate
+ * @param q       quality factor (0.7071 for a Butterworth pair)
+ *
+ * @return None 
+ */
+void biquad_design(biquad_coeff_t *pCoeff, biquad_shape_t shape, float freq, float q)
+{
+    biquad_designGain(pCoeff, shape, freq, q, 0.0f);
+}
+
+/** Design one section with a gain (peaking and shelving shapes)
+ *
+ * Parameters:
+ * @param pCoeff  filled with the section coefficients
+ * @param shape   response, the pass shapes ignore gain
+ * @param freq    center (peaking) or mid-slope (shelf) frequency as
+ *                fraction of the sample rate
+ * @param q       quality factor
+ * @param gain    gain in dB
+ *
+ * @return None 
+ */
+void biquad_designGain(biquad_coeff_t *pCoeff, biquad_shape_t shape, float freq, float q,
+                       float gain)
+{
+    double w0    = 2.0 * M_PI * freq;
+    double cw    = cos(w0);
+    double alpha = sin(w0) / (2.0 * q);
+    double A     = pow(10.0, gain / 40.0);
+    double sa    = 2.0 * sqrt(A) * alpha;
+    double a0    = 1.0 + alpha;
+    double a1    = -2.0 * cw;
+    double a2    = 1.0 - alpha;
+    double b0, b1, b2;
+
+    switch ( shape ) {
+    case BIQUAD_PEAKING:
+        b0 = 1.0 + alpha * A;
+        b1 = -2.0 * cw;
+        b2 = 1.0 - alpha * A;
+        a0 = 1.0 + alpha / A;
+        a2 = 1.0 - alpha / A;
+        break;
+    case BIQUAD_LOWSHELF:
+        b0 = A * ((A + 1.0) - (A - 1.0) * cw + sa);
+        b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cw);
+        b2 = A * ((A + 1.0) - (A - 1.0) * cw - sa);
+        a0 = (A + 1.0) + (A - 1.0) * cw + sa;
+        a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cw);
+        a2 = (A + 1.0) + (A - 1.0) * cw - sa;
+        break;
+    case BIQUAD_HIGHSHELF:
+        b0 = A * ((A + 1.0) + (A - 1.0) * cw + sa);
+        b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cw);
+        b2 = A * ((A + 1.0) + (A - 1.0) * cw - sa);
+        a0 = (A + 1.0) - (A - 1.0) * cw + sa;
+        a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cw);
+        a2 = (A + 1.0) - (A - 1.0) * cw - sa;
+        break;
+    case BIQUAD_HIGHPASS:
+        b0 = (1.0 + cw) / 2.0;
+        b1 = -(1.0 + cw);
+        b2 = b0;
+        break;
+    case BIQUAD_BANDPASS:
+        b0 = alpha;
+        b1 = 0.0;
+        b2 = -alpha;
+        break;
+    case BIQUAD_LOWPASS:
+    default:
+        b0 = (1.0 - cw) / 2.0;
+        b1 = 1.0 - cw;
+        b2 = b0;
+        break;
+    }
+    pCoeff->b0 = (float)(b0 / a0);
+    pCoeff->b1 = (float)(b1 / a0);
+    pCoeff->b2 = (float)(b2 / a0);
+    pCoeff->a1 = (float)(a1 / a0);
+    pCoeff->a2 = (float)(a2 / a0);
+}
+
+/** Initialize an empty cascade
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param format  arithmetic
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int biquad_init(biquad_t *pThis, biquad_format_t format)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->format = format;
+    return PASS;
+}
+
+/** Append a section, quantized to the cascade format
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pCoeff  section coefficients, |b|, |a| < 2
+ *
+ * @return Zero on success.
+ * Negative value on failure (cascade full or coefficient out of range).
+ */
+int biquad_addSection(biquad_t *pThis, const biquad_coeff_t *pCoeff)
+{
+    int     sec;
+
+    if ( NULL == pThis || NULL == pCoeff || BIQUAD_SECTIONS_MAX <= pThis->nSections ) {
+        printf("[BQ]: Failed to add section\n");
+        return FAIL;
+    }
+    sec = pThis->nSections++;
+    if ( PASS != biquad_setSection(pThis, sec, pCoeff) ) {
+        pThis->nSections--;
+        return FAIL;
+    }
+    pThis->state[sec][0]  = pThis->state[sec][1]  = 0;
+    pThis->stateF[sec][0] = pThis->stateF[sec][1] = 0.0f;
+    return PASS;
+}
+
+/** Replace the coefficients of a section, keeps its state
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param sec     section index, below nSections
+ * @param pCoeff  section coefficients, |b|, |a| < 2
+ *
+ * @return Zero on success.
+ * Negative value on failure (no such section or coefficient out of range).
+ */
+int biquad_setSection(biquad_t *pThis, int sec, const biquad_coeff_t *pCoeff)
+{
+    float   c[5];
+    int     i;
+
+    if ( 0 > sec || pThis->nSections <= sec ) {
+        return FAIL;
+    }
+    c[0] = pCoeff->b0; c[1] = pCoeff->b1; c[2] = pCoeff->b2;
+    c[3] = pCoeff->a1; c[4] = pCoeff->a2;
+    for ( i = 0; i < 5; i++ ) {
+        if ( c[i] >= 2.0f || c[i] < -2.0f ) {
+            printf("[BQ]: Coefficient %f out of range\n", c[i]);
+            return FAIL;
+        }
+    }
+
+    pThis->coeff[sec] = *pCoeff;
+    for ( i = 0; i < 5; i++ ) {
+        pThis->q15[sec][i] = biquad_sat16((long long)floor(c[i] * 16384.0 + 0.5));
+        pThis->q31[sec][i] = biquad_sat32((long long)floor(c[i] * 1073741824.0 + 0.5));
+    }
+    return PASS;
+}
+
+/** Append the sections of a Butterworth low- or high-pass
+ *   - pole pair k has q = 1 / (2 cos((2k + 1) pi / (2 order)))
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param shape   BIQUAD_LOWPASS or BIQUAD_HIGHPASS
+ * @param freq    -3 dB frequency as fraction of the sample rate
+ * @param order   even filter order
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int biquad_addButterworth(biquad_t *pThis, biquad_shape_t shape, float freq, int order)
+{
+    biquad_coeff_t  coeff;
+    int             k;
+
+    if ( 0 >= order || 0 != (order & 1) ) {
+        return FAIL;
+    }
+    for ( k = 0; k < order / 2; k++ ) {
+        biquad_design(&coeff, shape, freq,
+                      (float)(1.0 / (2.0 * cos((2 * k + 1) * M_PI / (2.0 * order)))));
+        if ( PASS != biquad_addSection(pThis, &coeff) ) {
+            return FAIL;
+        }
+    }
+    return PASS;
+}
+
+/** Clear the filter states
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ *
+ * @return None 
+ */
+void biquad_reset(biquad_t *pThis)
+{
+    memset(pThis->state, 0, sizeof(pThis->state));
+    memset(pThis->stateF, 0, sizeof(pThis->stateF));
+}
+
+/** saturate to the 40 bit accumulator, one compare in the common case */
+static inline q15_acc_t biquad_acc40(q15_acc_t v)
+{
+    if ( (unsigned long long)v - (unsigned long long)Q15_ACC_MIN
+       > (unsigned long long)(Q15_ACC_MAX - Q15_ACC_MIN) ) {
+        v = q15_accSat(v);
+    }
+    return v;
+}
+
+/** Q15 section over a block of 1.15 data, in place */
+static void biquad_sectionQ15(const short c[5], q15_acc_t s[2], fract16 *data, int length)
+{
+    q15_acc_t   s1 = s[0];
+    q15_acc_t   s2 = s[1];
+    int         b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+    int         i;
+
+    for ( i = 0; i < length; i++ ) {
+        int         x   = data[i];
+        q15_acc_t   acc = biquad_acc40((q15_acc_t)(b0 * x) + s1);
+        q15_acc_t   y   = (acc + (1 << 13)) >> 14;
+
+        // rarely taken, keeps the clipping off the feedback path
+        if ( y != (fract16)y ) {
+            y = biquad_sat16(y);
+        }
+
+        s1      = biquad_acc40((q15_acc_t)(b1 * x) - a1 * y + s2);
+        s2      = biquad_acc40((q15_acc_t)(b2 * x) - a2 * y);
+        data[i] = (fract16)y;
+    }
+    s[0] = s1;
+    s[1] = s2;
+}
+
+/** Q31 section over a block of 1.31 data, in place */
+static void biquad_sectionQ31(const int c[5], long long s[2], int *data, int length)
+{
+    long long   s1 = s[0];
+    long long   s2 = s[1];
+    long long   b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+    int         i;
+
+    for ( i = 0; i < length; i++ ) {
+        long long   x = data[i];
+        int         y = biquad_sat32(((b0 * x) >> 30) + s1);
+
+        s1      = ((b1 * x - a1 * y) >> 30) + s2;
+        s2      = (b2 * x - a2 * y) >> 30;
+        data[i] = y;
+    }
+    s[0] = s1;
+    s[1] = s2;
+}
+
+/** float section over a block, in place */
+static void biquad_sectionFloat(const biquad_coeff_t *c, float s[2], float *data, int length)
+{
+    float   s1 = s[0];
+    float   s2 = s[1];
+    int     i;
+
+    for ( i = 0; i < length; i++ ) {
+        float x = data[i];
+        float y = c->b0 * x + s1;
+
+        s1      = c->b1 * x - c->a1 * y + s2;
+        s2      = c->b2 * x - c->a2 * y;
+        data[i] = y;
+    }
+    s[0] = s1;
+    s[1] = s2;
+}
+
+/** Filter samples, 1.15 in and out
+ *   - input and output may be the same buffer (in place)
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param output  output samples
+ * @param length  number of samples
+ *
+ * @return None 
+ */
+void biquad_filter(biquad_t *pThis, const fract16 input[], fract16 output[], int length)
+{
+    int     done;
+    int     blk;
+    int     sec;
+    int     i;
+
+    if ( 0 == pThis->nSections ) {
+        if ( input != output ) {
+            memcpy(output, input, length * sizeof(fract16));
+        }
+        return;
+    }
+
+    for ( done = 0; done < length; done += blk ) {
+        blk = length - done < BIQUAD_BLOCK ? length - done : BIQUAD_BLOCK;
+
+        if ( BIQUAD_Q15 == pThis->format ) {
+            fract16 scratch[BIQUAD_BLOCK];
+
+            memcpy(scratch, &input[done], blk * sizeof(fract16));
+            for ( sec = 0; sec < pThis->nSections; sec++ ) {
+                biquad_sectionQ15(pThis->q15[sec], pThis->state[sec], scratch, blk);
+            }
+            memcpy(&output[done], scratch, blk * sizeof(fract16));
+        } else if ( BIQUAD_Q31 == pThis->format ) {
+            int scratch[BIQUAD_BLOCK];
+
+            for ( i = 0; i < blk; i++ ) {
+                scratch[i] = (int)input[done + i] * 65536;
+            }
+            for ( sec = 0; sec < pThis->nSections; sec++ ) {
+                biquad_sectionQ31(pThis->q31[sec], pThis->state[sec], scratch, blk);
+            }
+            for ( i = 0; i < blk; i++ ) {
+                output[done + i] = biquad_sat16(((long long)scratch[i] + (1 << 15)) >> 16);
+            }
+        } else {
+            float scratch[BIQUAD_BLOCK];
+
+            for ( i = 0; i < blk; i++ ) {
+                scratch[i] = input[done + i];
+            }
+            for ( sec = 0; sec < pThis->nSections; sec++ ) {
+                biquad_sectionFloat(&pThis->coeff[sec], pThis->stateF[sec], scratch, blk);
+            }
+            for ( i = 0; i < blk; i++ ) {
+                output[done + i] = biquad_sat16((long long)floorf(scratch[i] + 0.5f));
+            }
+        }
+    }
+}
+
+/** Filter a chunk in place
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None 
+ */
+void biquad_process(biquad_t *pThis, chunk_t *pChunk)
+{
+    biquad_filter(pThis, pChunk->s16_buff, pChunk->s16_buff, pChunk->len/2);
+}
@@ -4,6 +4,14 @@
  *@brief
  *  - Global buffer pool divided into chunks and kept on the free list
  *
+ *  The free list is a stack of chunk indices updated by compare and
+ *  swap of a tagged top word, so the RX/TX ISRs and the main loop can
+ *  use it without masking interrupts. Acquire and release first try the
+ *  magazine of the calling context (audioHal_context), which only that
+ *  context touches; it is refilled/flushed half a magazine at a time.
+ *  Chunks cached in one magazine are not visible to the other context,
+ *  at most AUDIOHAL_CTX_NUM * BUFFERPOOL_MAG_SIZE chunks are held back.
+ *
  * Target:   TLL6527v1-0      
  * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
  *
@@ -17,39 +25,137 @@
  *******************************************************************************/
 #include "tll_common.h"
 #include "bufferPool.h"
+#include "audioHal.h"
+
+/** index + 1 of a tagged top word, 0 = empty */
+#define BUFFERPOOL_TOP_INDEX(top)       ((top) & 0xFFFF)
+/** new top word with the next tag */
+#define BUFFERPOOL_TOP_NEXT(top, index) ((((top) & 0xFFFF0000) + 0x10000) | (index))
+
+#ifdef __bfin__
+/** compare and swap; the Blackfin has no CAS instruction, on the single
+ *  core masking interrupts for the three instructions is equivalent */
+static int bufferPool_cas(unsigned int *pWord, unsigned int expect, unsigned int value)
+{
+    unsigned int imask;
+    int          ok;
+
+    __asm__ __volatile__("cli %0;" : "=d"(imask));
+    ok = (*(volatile unsigned int *)pWord == expect);
+    if ( ok ) {
+        *(volatile unsigned int *)pWord = value;
+    }
+    __asm__ __volatile__("sti %0;" : : "d"(imask) : "memory");
+    return ok;
+}
+#define BUFFERPOOL_LOAD(x)          (*(volatile __typeof__(x) *)&(x))
+#define BUFFERPOOL_STORE(x, v)      (*(volatile __typeof__(x) *)&(x) = (v))
+#else
+/** compare and swap */
+static int bufferPool_cas(unsigned int *pWord, unsigned int expect, unsigned int value)
+{
+    return __atomic_compare_exchange_n(pWord, &expect, value, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+#define BUFFERPOOL_LOAD(x)          __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define BUFFERPOOL_STORE(x, v)      __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+#endif
+
+
+/** push a chunk onto the shared free list
+ * @param pThis   pointer to buffer pool
+ * @param index   chunk index
+ */
+static void bufferPool_push(bufferPool_t *pThis, int index)
+{
+    unsigned int top;
+
+    do {
+        top = BUFFERPOOL_LOAD(pThis->freeTop);
+        BUFFERPOOL_STORE(pThis->freeNext[index], BUFFERPOOL_TOP_INDEX(top));
+    } while ( !bufferPool_cas(&pThis->freeTop, top, BUFFERPOOL_TOP_NEXT(top, index + 1)) );
+}
+
+/** pop a chunk from the shared free list
+ * @param pThis   pointer to buffer pool
+ * @return chunk index, negative if the list is empty
+ */
+static int bufferPool_pop(bufferPool_t *pThis)
+{
+    unsigned int top;
+    unsigned int first;
+
+    do {
+        top   = BUFFERPOOL_LOAD(pThis->freeTop);
+        first = BUFFERPOOL_TOP_INDEX(top);
+        if ( 0 == first ) {
+            return -1;
+        }
+        // stale if another context popped meanwhile, then the tag differs
+    } while ( !bufferPool_cas(&pThis->freeTop, top,
+                              BUFFERPOOL_TOP_NEXT(top, BUFFERPOOL_LOAD(pThis->freeNext[first - 1]))) );
+    return first - 1;
+}
+
 
 /** Initialize buffer pool 
+ *    - carve count chunks of chunkSize bytes from the arena, each
+ *      aligned to BUFFERPOOL_ALIGN
  *    - initialize freeList, populate with chunks
   *
  * Parameters:
- * @param pThis  pointer to buffer pool data structure
+ * @param pThis      pointer to buffer pool data structure
+ * @param chunkSize  bytes per chunk, multiple of 4
+ * @param count      number of chunks, at most CHUNK_NUM_MAX
+ * @param pArena     memory for the chunk data, see BUFFERPOOL_ARENA_SIZE
+ * @param arenaSize  size of the arena in bytes
  *
  * @return Zero on success.
  * Negative value on failure.
  */
-int bufferPool_init(bufferPool_t *pThis)
+int bufferPool_init(bufferPool_t *pThis, int chunkSize, int count,
+                    void *pArena, int arenaSize)
 {
-    int                         count                   = 0;
+    unsigned char               *pData;
+    int                         stride;
+    int                         index;
     
-    // init queue
-    if ( FAIL == queue_init(&pThis->freeList, CHUNK_NUM_MAX) ) {
-        printf("[BP]: Failed to initialize free list\n");
+    if ( NULL == pThis || NULL == pArena || 0 >= chunkSize || 0 != (chunkSize & 3) ||
+         0 >= count || CHUNK_NUM_MAX < count ) {
+        printf("[BP]: Invalid pool of %d chunks of %d bytes\n", count, chunkSize);
         return FAIL;
     }
     
+    // first aligned address in the arena
+    stride = BUFFERPOOL_CHUNK_STRIDE(chunkSize);
+    pData  = (unsigned char *)(((unsigned long)pArena + BUFFERPOOL_ALIGN - 1) &
+                               ~(unsigned long)(BUFFERPOOL_ALIGN - 1));
+    if ( pData + (long)stride * count > (unsigned char *)pArena + arenaSize ) {
+        printf("[BP]: Arena of %d bytes too small\n", arenaSize);
+        return FAIL;
+    }
+    pThis->chunkSize = chunkSize;
+    pThis->count     = count;
+    
+    // init free list and magazines
+    pThis->freeTop = 0;
+    memset(pThis->mag, 0, sizeof(pThis->mag));
+    
     /* We put all the chunk on the free list */
-    for(count = 0; CHUNK_NUM_MAX > count; count++){
+    for(index = count - 1; 0 <= index; index--){
         // init chunk 
-        chunk_init(&pThis->buffer[count]);
-        // put initialized chunk into queue 
-        queue_put(&pThis->freeList, (void **)&pThis->buffer[count] );
+        chunk_init(&pThis->buffer[index], pData + (long)stride * index, chunkSize);
+        // put initialized chunk onto the free list, chunk 0 on top
+        bufferPool_push(pThis, index);
     }
     
-    printf("[BP]: Initialised\n");
+    printf("[BP]: Initialised %d chunks of %d bytes\n", count, chunkSize);
     return PASS;
 }
 
 /** Get a chunk from the  buffer pool 
+ *    - from the magazine of the calling context, refilled from the
+ *      free list when empty
  *
  * Parameters:
  * @param pThis    pointer to queue data structure
@@ -60,16 +166,37 @@ int bufferPool_init(bufferPool_t *pThis)
  */
 int bufferPool_acquire(bufferPool_t *pThis, chunk_t **ppChunk)
 {
+    int                 context;
+    int                 index;
+    bufferPool_mag_t    *pMag;
+    
     if ( NULL == pThis || NULL == ppChunk ) {
         printf("[BP]: Acquire failed\n");
         return FAIL;
     }
     
-    if (FAIL == queue_get(&pThis->freeList, (void **)ppChunk) ){
-        *ppChunk = NULL;
+    context = audioHal_context();
+    if ( AUDIOHAL_CTX_NONE == context ) {
+        index = bufferPool_pop(pThis);
+        *ppChunk = 0 <= index ? &pThis->buffer[index] : NULL;
+    } else {
+        pMag = &pThis->mag[context];
+        if ( 0 < pMag->count ) {
+            pMag->nHit++;
+        } else {
+            pMag->nMiss++;
+            while ( pMag->count < BUFFERPOOL_MAG_SIZE / 2 &&
+                    0 <= (index = bufferPool_pop(pThis)) ) {
+                pMag->pChunk[pMag->count++] = &pThis->buffer[index];
+            }
+        }
+        *ppChunk = 0 < pMag->count ? pMag->pChunk[--pMag->count] : NULL;
+    }
+    
+    if ( NULL == *ppChunk ) {
         return FAIL;
     }
-    (*ppChunk)->size = SAMPLE_SIZE;
+    (*ppChunk)->size = pThis->chunkSize;
     (*ppChunk)->len  = 0;
     return PASS;
 }
@@ -79,6 +206,8 @@ int bufferPool_acquire(bufferPool_t *pThis, chunk_t **ppChunk)
 /** Release chunk into the free list 
  *    - non blocking 
  *    - error on null passed 
+ *    - into the magazine of the calling context, half of it is
+ *      flushed to the free list when full
   *
  * Parameters:
  * @param pThis    pointer to queue data structure
@@ -89,15 +218,35 @@ int bufferPool_acquire(bufferPool_t *pThis, chunk_t **ppChunk)
  */
 int bufferPool_release(bufferPool_t *pThis, chunk_t *pChunk)
 {
+    int                 context;
+    bufferPool_mag_t    *pMag;
+    
     if ( NULL == pThis || NULL == pChunk ) {
         printf("[BP]: Acquire failed\n");
         return FAIL;
     }    
     
-    if (FAIL == queue_put(&pThis->freeList, (void **)pChunk) ){
-        pChunk = NULL;
+    if ( pChunk < &pThis->buffer[0] || pChunk >= &pThis->buffer[pThis->count] ) {
+        printf("[BP]: Release of foreign chunk\n");
         return FAIL;
     }
+    
+    context = audioHal_context();
+    if ( AUDIOHAL_CTX_NONE == context ) {
+        bufferPool_push(pThis, pChunk - pThis->buffer);
+        return PASS;
+    }
+    
+    pMag = &pThis->mag[context];
+    if ( BUFFERPOOL_MAG_SIZE > pMag->count ) {
+        pMag->nHit++;
+    } else {
+        pMag->nMiss++;
+        while ( BUFFERPOOL_MAG_SIZE / 2 < pMag->count ) {
+            bufferPool_push(pThis, pMag->pChunk[--pMag->count] - pThis->buffer);
+        }
+    }
+    pMag->pChunk[pMag->count++] = pChunk;
     return PASS;
 }
 
@@ -111,16 +260,19 @@ int bufferPool_release(bufferPool_t *pThis, chunk_t *pChunk)
  */
 int bufferPool_is_empty(bufferPool_t *pThis )
 {
+    int context;
+    
     if ( NULL == pThis ) {
         printf("[BP]: bufferPool_is_empty failed\n");
         return FAIL;
     }   
     
-    if ( FAIL != queue_is_empty(&pThis->freeList) ) {
+    context = audioHal_context();
+    if ( 0 != BUFFERPOOL_TOP_INDEX(BUFFERPOOL_LOAD(pThis->freeTop)) ||
+         ( AUDIOHAL_CTX_NONE != context && 0 < pThis->mag[context].count ) ) {
         printf("[BP]: The buffer has free chunks\n");
         return FAIL;
     }
     
     return PASS;
 }
-
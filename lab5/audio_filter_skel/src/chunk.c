@@ -19,26 +19,30 @@
 #include "chunk.h"
 
 /** Initialize buffer chunk
- *    - set max size of buffer and the current fill level
+ *    - attach data buffer, set max size of buffer and the current fill level
  * Parameters:
  * @param pThis  pointer to own object
+ * @param pBuff  data buffer, 32 bit aligned
+ * @param size   size of the data buffer in bytes
  *
  * @return Zero on success.
  * Negative value on failure.
  */
-int chunk_init(chunk_t *pThis)
+int chunk_init(chunk_t *pThis, void *pBuff, int size)
 {
-    if ( NULL == pThis ) {
+    if ( NULL == pThis || NULL == pBuff ) {
         return FAIL;
     }
     
-    pThis->size = SAMPLE_SIZE;
+    pThis->u08_buff = pBuff;
+    pThis->size = size;
     pThis->len  = 0; // default not filled
     return PASS;
 }
 
 
 /** copy on chunk into nother 
+ *  - fails if the destination is smaller than the data
  *@param pSrc  pointer to source object (will not be modified)
  *@param pDst  pointer to destination object (will get the data of the src object)
  *
@@ -48,6 +52,10 @@ int chunk_copy(chunk_t *pSrc, chunk_t *pDst){
     unsigned int count;
     unsigned int len = pSrc->len/4;
     
+    if ( pSrc->len > pDst->size ) {
+        return FAIL;
+    }
+    
     // copy manuall since memcpy does not work currently 
     // 
     for ( count = 0; len > count; count++ ) {
@@ -55,6 +63,10 @@ int chunk_copy(chunk_t *pSrc, chunk_t *pDst){
     }
     // update length of actual copied data
     pDst->len = pSrc->len;
+    // the copy carries on the time stamps of the source
+    for ( count = 0; CHUNK_STAMP_NUM > count; count++ ) {
+        pDst->stamp[count] = pSrc->stamp[count];
+    }
    
     return PASS;
 }
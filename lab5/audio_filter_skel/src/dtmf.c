@@ -0,0 +1,198 @@
+/**
+ *@file dtmf.c
+ *
+ *@brief
+ *  - DTMF key decoder
+ *
+ *  The bank reports the share of the block energy at each of the 8 tones
+ *  (1 for a pure tone, 1/2 each for a clean key). A block holds a key if
+ *    - its level is above DTMF_LEVEL_MIN_DB,
+ *    - the strongest row and column tone hold DTMF_PAIR_MIN of the energy
+ *      and each at least DTMF_TONE_MIN (speech and noise spread wider),
+ *    - the two differ by at most DTMF_TWIST_DB,
+ *    - the second strongest tone of each group is 6 dB or more below.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "tll_common.h"
+#include "dtmf.h"
+#include <cycle_count.h>
+#include <cycle_count_bf.h>
+
+/**
+ * @def DTMF_PAIR_MIN
+ * @brief share of the block energy in the row and column tone together
+ *        (a key 1.5 % off nominal keeps about 0.35 of it in a 25.6 ms block)
+ */
+#define DTMF_PAIR_MIN       (0.3f)
+
+/**
+ * @def DTMF_TONE_MIN
+ * @brief share of the block energy in each of the two tones
+ */
+#define DTMF_TONE_MIN       (0.1f)
+
+/** row tones, then column tones */
+static const float dtmf_freq[8] = {
+    697.0f, 770.0f, 852.0f, 941.0f, 1209.0f, 1336.0f, 1477.0f, 1633.0f
+};
+
+/** keys by row and column */
+static const char dtmf_key[4][4] = {
+    { '1', '2', '3', 'A' },
+    { '4', '5', '6', 'B' },
+    { '7', '8', '9', 'C' },
+    { '*', '0', '#', 'D' }
+};
+
+/** strongest of 4 powers, the runner-up in pSecond */
+static int dtmf_best(const float power[4], float *pSecond)
+{
+    int         best = 0;
+    int         i;
+
+    for ( i = 1; i < 4; i++ ) {
+        if ( power[i] > power[best] ) {
+            best = i;
+        }
+    }
+    *pSecond = 0.0f;
+    for ( i = 0; i < 4; i++ ) {
+        if ( i != best && power[i] > *pSecond ) {
+            *pSecond = power[i];
+        }
+    }
+    return best;
+}
+
+/** key of the last block, 0 for none */
+static char dtmf_decide(const goertzel_t *pBank)
+{
+    const float *power = pBank->power;
+    float       twist  = powf(10.0f, DTMF_TWIST_DB / 10.0f);
+    float       row2, col2;
+    int         row    = dtmf_best(&power[0], &row2);
+    int         col    = dtmf_best(&power[4], &col2);
+    float       pr     = power[row];
+    float       pc     = power[4 + col];
+
+    if ( pBank->level < powf(10.0f, DTMF_LEVEL_MIN_DB / 10.0f)
+      || pr + pc < DTMF_PAIR_MIN || pr < DTMF_TONE_MIN || pc < DTMF_TONE_MIN
+      || pr > twist * pc || pc > twist * pr
+      || 4.0f * row2 > pr || 4.0f * col2 > pc ) {
+        return 0;
+    }
+    return dtmf_key[row][col];
+}
+
+/** debounce the key of a block, queue a new key */
+static void dtmf_block(dtmf_t *pThis)
+{
+    char        key = dtmf_decide(&pThis->bank);
+
+    if ( key != pThis->candidate ) {
+        pThis->candidate = key;
+        pThis->hits      = 0;
+        pThis->reported  = 0;
+    }
+    if ( 0 == key || pThis->reported || ++pThis->hits < DTMF_HITS ) {
+        return;
+    }
+    pThis->reported = 1;
+    if ( (pThis->keyIn + 1) % DTMF_KEYS_MAX == pThis->keyOut ) {
+        pThis->dropped++;
+        return;
+    }
+    pThis->keys[pThis->keyIn] = key;
+    pThis->keyIn = (pThis->keyIn + 1) % DTMF_KEYS_MAX;
+    pThis->detected++;
+}
+
+/** Initialize a decoder
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int dtmf_init(dtmf_t *pThis, unsigned int rate)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    return goertzel_init(&pThis->bank, rate, dtmf_freq, 8, 0);
+}
+
+/** Decode a chunk, counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples (not modified)
+ *
+ * @return None
+ */
+void dtmf_process(dtmf_t *pThis, const chunk_t *pChunk)
+{
+    const fract16   *x = pChunk->s16_buff;
+    int             n  = pChunk->len / 2;
+    int             o  = 0;
+    cycle_t         c0;
+    cycle_t         c1;
+
+    _GET_CYCLE_COUNT(c0);
+    while ( o < n ) {
+        o += goertzel_feed(&pThis->bank, &x[o], n - o);
+        if ( pThis->bank.ready ) {
+            dtmf_block(pThis);
+        }
+    }
+    _GET_CYCLE_COUNT(c1);
+
+    pThis->calls++;
+    pThis->cycles += c1 - c0;
+}
+
+/** Get the next detected key (non blocking)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pKey   where to store the key
+ *
+ * @return Zero if a key was returned, FAIL otherwise
+ */
+int dtmf_keyGet(dtmf_t *pThis, char *pKey)
+{
+    if ( pThis->keyOut == pThis->keyIn ) {
+        return FAIL;
+    }
+    *pKey = pThis->keys[pThis->keyOut];
+    pThis->keyOut = (pThis->keyOut + 1) % DTMF_KEYS_MAX;
+    return PASS;
+}
+
+/** Print keys and cycles per chunk
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param samples   samples per chunk, for cycles per sample
+ *
+ * @return None
+ */
+void dtmf_report(const dtmf_t *pThis, int samples)
+{
+    printf("[DTMF]: %lu keys (%lu dropped) in %lu blocks of %d samples,"
+           " %lu chunks, %.0f cycles per chunk, %.1f per sample\n",
+           pThis->detected, pThis->dropped, pThis->bank.blocks, pThis->bank.blockLen,
+           pThis->calls, pThis->calls ? (double)pThis->cycles / pThis->calls : 0.0,
+           pThis->calls && 0 < samples ? (double)pThis->cycles / pThis->calls / samples : 0.0);
+}
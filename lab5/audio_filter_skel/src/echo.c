@@ -0,0 +1,263 @@
+/**
+ *@file echo.c
+ *
+ *@brief
+ *  - multi-tap echo / delay with feedback on a ring delay line
+ *
+ *  Per pass of blk <= ECHO_BLOCK samples every tap reads the line at
+ *  pos - delay. The read span is split once into the part up to the end
+ *  of the line and the part from its start, each a plain gain/add loop
+ *  over contiguous memory. Products are taken back to 1.15 and summed in
+ *  32 bit, so any tap count and gain sum is safe; the results are
+ *  saturated once. The pass is written to the line last: delays are at
+ *  least ECHO_BLOCK and at most lineLen - ECHO_BLOCK, so the reads never
+ *  see the samples of their own pass.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "tll_common.h"
+#include "echo.h"
+#include "q15.h"
+#include <cycle_count.h>
+#include <cycle_count_bf.h>
+
+
+/** acc += gain * src over one contiguous segment */
+static inline void echo_macSegment(int acc[], const fract16 src[], int gain, int n)
+{
+    int         j;
+
+    for ( j = 0; j < n; j++ ) {
+        acc[j] += (gain * src[j]) >> 15;
+    }
+}
+
+/** acc += gain * line[pos - delay ..], wrap handled once */
+static void echo_mac(const echo_t *pThis, int acc[], int delay, fract16 gain, int blk)
+{
+    int         start = pThis->pos - delay;
+    int         first;
+
+    if ( start < 0 ) {
+        start += pThis->lineLen;
+    }
+    first = pThis->lineLen - start;
+    if ( first > blk ) {
+        first = blk;
+    }
+    echo_macSegment(acc, &pThis->pLine[start], gain, first);
+    if ( first < blk ) {
+        echo_macSegment(&acc[first], pThis->pLine, gain, blk - first);
+    }
+}
+
+/** Initialize an echo on a delay line, no taps, dry signal only
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param pLine    delay line memory
+ * @param lineLen  samples in pLine, at least 2 * ECHO_BLOCK
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int echo_init(echo_t *pThis, fract16 *pLine, int lineLen)
+{
+    if ( NULL == pThis || NULL == pLine || 2 * ECHO_BLOCK > lineLen ) {
+        printf("[ECHO]: Invalid delay line\n");
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    memset(pLine, 0, lineLen * sizeof(fract16));
+    pThis->pLine   = pLine;
+    pThis->lineLen = lineLen;
+    pThis->dry     = 0x7fff;
+    return PASS;
+}
+
+/** Set (or add) an output tap
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param tap    tap index, 0..ECHO_TAPS_MAX-1, taps in between become silent
+ * @param delay  delay in samples, ECHO_BLOCK .. lineLen - ECHO_BLOCK
+ * @param gain   tap gain
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int echo_setTap(echo_t *pThis, int tap, int delay, fract16 gain)
+{
+    if ( 0 > tap || ECHO_TAPS_MAX <= tap
+      || ECHO_BLOCK > delay || pThis->lineLen - ECHO_BLOCK < delay ) {
+        printf("[ECHO]: Invalid tap %d delay %d (line %d)\n", tap, delay, pThis->lineLen);
+        return FAIL;
+    }
+    while ( pThis->nTaps <= tap ) {
+        pThis->delay[pThis->nTaps] = ECHO_BLOCK;
+        pThis->gain[pThis->nTaps]  = 0;
+        pThis->nTaps++;
+    }
+    pThis->delay[tap] = delay;
+    pThis->gain[tap]  = gain;
+    return PASS;
+}
+
+/** Set the dry and feedback gains
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param dry       gain of the input
+ * @param feedback  gain of tap 0 back into the line, < 1 to decay
+ *
+ * @return None
+ */
+void echo_setMix(echo_t *pThis, fract16 dry, fract16 feedback)
+{
+    pThis->dry      = dry;
+    pThis->feedback = feedback;
+}
+
+/** Bound of the boost of the echo: the line holds at most
+ *  |x| / (1 - |feedback|), the output the dry input plus every tap of it
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return worst case gain in dB rounded up, 0 if it does not boost
+ */
+int echo_boost(const echo_t *pThis)
+{
+    float       taps = 0.0f;
+    float       gain;
+    int         i;
+
+    for ( i = 0; i < pThis->nTaps; i++ ) {
+        taps += abs(pThis->gain[i]);
+    }
+    gain = (abs(pThis->dry) + taps * 32768.0f / (32768 - abs(pThis->feedback))) / 32768.0f;
+    return 1.0f < gain ? (int)ceilf(20.0f * log10f(gain)) : 0;
+}
+
+/** Echo a block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param output  output samples (may equal input)
+ * @param length  number of samples
+ *
+ * @return None
+ */
+void echo_filter(echo_t *pThis, const fract16 input[], fract16 output[], int length)
+{
+    int         acc[ECHO_BLOCK];
+    fract16     w[ECHO_BLOCK];
+    int         done = 0;
+    int         i, j;
+
+    while ( done < length ) {
+        const fract16   *pIn    = &input[done];
+        fract16         *pOut   = &output[done];
+        int             blk     = length - done;
+        int             first;
+
+        if ( blk > ECHO_BLOCK ) {
+            blk = ECHO_BLOCK;
+        }
+
+        // line input: x + feedback * tap 0
+        for ( j = 0; j < blk; j++ ) {
+            acc[j] = pIn[j];
+        }
+        if ( 0 < pThis->nTaps && 0 != pThis->feedback ) {
+            echo_mac(pThis, acc, pThis->delay[0], pThis->feedback, blk);
+        }
+        for ( j = 0; j < blk; j++ ) {
+            w[j] = q15_sat(acc[j]);
+        }
+
+        // output: dry * x + taps, input is read before output is written
+        for ( j = 0; j < blk; j++ ) {
+            acc[j] = (pThis->dry * pIn[j]) >> 15;
+        }
+        for ( i = 0; i < pThis->nTaps; i++ ) {
+            if ( 0 != pThis->gain[i] ) {
+                echo_mac(pThis, acc, pThis->delay[i], pThis->gain[i], blk);
+            }
+        }
+        for ( j = 0; j < blk; j++ ) {
+            pOut[j] = q15_sat(acc[j]);
+        }
+
+        // append the pass to the line, split where it wraps
+        first = pThis->lineLen - pThis->pos;
+        if ( first > blk ) {
+            first = blk;
+        }
+        memcpy(&pThis->pLine[pThis->pos], w, first * sizeof(fract16));
+        memcpy(pThis->pLine, &w[first], (blk - first) * sizeof(fract16));
+        pThis->pos += blk;
+        if ( pThis->pos >= pThis->lineLen ) {
+            pThis->pos -= pThis->lineLen;
+        }
+        done += blk;
+    }
+}
+
+/** Echo a chunk in place, counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void echo_process(echo_t *pThis, chunk_t *pChunk)
+{
+    cycle_t     c0;
+    cycle_t     c1;
+
+    _GET_CYCLE_COUNT(c0);
+    echo_filter(pThis, pChunk->s16_buff, pChunk->s16_buff, pChunk->len/2);
+    _GET_CYCLE_COUNT(c1);
+
+    pThis->calls++;
+    pThis->cycles += c1 - c0;
+    if ( c1 - c0 > pThis->cyclesMax ) {
+        pThis->cyclesMax = c1 - c0;
+    }
+}
+
+/** Print delay line memory (in chunks of the pool) and cycles per chunk
+ *
+ * Parameters:
+ * @param pThis      pointer to own object
+ * @param chunkSize  bytes per pool chunk
+ * @param nChunks    chunks in the pool
+ *
+ * @return None
+ */
+void echo_report(const echo_t *pThis, int chunkSize, int nChunks)
+{
+    int         bytes = pThis->lineLen * sizeof(fract16);
+    int         i;
+
+    printf("[ECHO]: line %d samples, %d bytes = %.1f chunks of %d bytes (pool %d chunks)\n",
+           pThis->lineLen, bytes, (double)bytes / chunkSize, chunkSize, nChunks);
+    for ( i = 0; i < pThis->nTaps; i++ ) {
+        printf("[ECHO]: tap %d delay %d samples gain %d\n", i, pThis->delay[i], pThis->gain[i]);
+    }
+    printf("[ECHO]: %lu chunks, cycles per chunk mean %.0f max %llu, %.1f per sample\n",
+           pThis->calls, pThis->calls ? (double)pThis->cycles / pThis->calls : 0.0,
+           pThis->cyclesMax,
+           pThis->calls ? (double)pThis->cycles / pThis->calls / (chunkSize / 2) : 0.0);
+}
@@ -0,0 +1,384 @@
+/**
+ *@file eq.c
+ *
+ *@brief
+ *  - 10 band equalizer on a bank of single section biquads
+ *
+ *  Every band owns a one section cascade, so bands can be switched on
+ *  and off without touching the others. A gain or parameter change only
+ *  marks the band; the next eq_process redesigns the marked bands
+ *  (biquad_designGain, a handful of sin/cos/pow) and replaces the section
+ *  coefficients in place, a running band keeps its state and changes
+ *  without a click. A band that comes back from 0 dB starts from a
+ *  cleared state. Bands run one after the other over the whole chunk.
+ *  A shelf boosting far from Nyquist has |b| beyond the Q2.14 / Q2.30
+ *  range; its b are halved until they fit and the band output is
+ *  shifted back with saturation.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tll_common.h"
+#include "eq.h"
+#include "q15.h"
+#include <cycle_count.h>
+#include <cycle_count_bf.h>
+
+
+/** default band frequencies in Hz, about 0.8 octaves apart */
+static const float eq_freq[EQ_BANDS] = {
+    40.0f, 70.0f, 125.0f, 220.0f, 380.0f, 670.0f, 1200.0f, 2100.0f, 3700.0f, 6400.0f
+};
+
+/**
+ * @def EQ_PEAK_Q
+ * @brief q of the default peaking bands, -3 dB points about at the
+ *        neighbour bands
+ */
+#define EQ_PEAK_Q           (1.75f)
+
+/**
+ * @def EQ_SHELF_Q
+ * @brief q of the default shelves, steepest slope without overshoot
+ */
+#define EQ_SHELF_Q          (0.7071f)
+
+/**
+ * @def EQ_FREQ_MAX
+ * @brief bands above rate * EQ_FREQ_MAX are not run
+ */
+#define EQ_FREQ_MAX         (0.45f)
+
+
+/** (re)design a changed band */
+static void eq_design(eq_t *pThis, eq_band_t *pBand)
+{
+    biquad_coeff_t  coeff;
+    float           freq = pBand->freq / pThis->rate;
+    float           peak;
+    int             shift = 0;
+
+    pBand->changed = 0;
+    if ( 0 == pBand->gain || freq >= EQ_FREQ_MAX ) {
+        pBand->active = 0;
+        return;
+    }
+
+    biquad_designGain(&coeff, pBand->shape, freq, pBand->q, (float)pBand->gain);
+    pThis->designs++;
+    // boosts far from Nyquist need |b| up to 10^(gain/20): scale b down
+    // by powers of two, the band shifts its output back up
+    peak = fabsf(coeff.b0) > fabsf(coeff.b1) ? fabsf(coeff.b0) : fabsf(coeff.b1);
+    peak = fabsf(coeff.b2) > peak ? fabsf(coeff.b2) : peak;
+    while ( peak >= 2.0f ) {
+        coeff.b0 /= 2.0f;
+        coeff.b1 /= 2.0f;
+        coeff.b2 /= 2.0f;
+        peak     /= 2.0f;
+        shift++;
+    }
+    if ( 0 != pBand->active && shift == pBand->shift
+      && PASS == biquad_setSection(&pBand->bq, 0, &coeff) ) {
+        return;
+    }
+
+    // new band or new scale: cleared state, precision by frequency
+    biquad_init(&pBand->bq, freq < 1.0f / EQ_Q31_BELOW ? BIQUAD_Q31 : BIQUAD_Q15);
+    pBand->shift  = shift;
+    pBand->active = PASS == biquad_addSection(&pBand->bq, &coeff);
+}
+
+/** output shift of a band with scaled down b coefficients */
+static void eq_shift(fract16 data[], int length, int shift)
+{
+    int         i;
+
+    for ( i = 0; i < length; i++ ) {
+        data[i] = q15_sat(data[i] << shift);
+    }
+}
+
+/** Initialize a flat equalizer
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int eq_init(eq_t *pThis, unsigned int rate)
+{
+    int         i;
+
+    if ( NULL == pThis || 0 == rate ) {
+        printf("[EQ]: Failed to init\n");
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->rate = rate;
+    for ( i = 0; i < EQ_BANDS; i++ ) {
+        eq_band_t   *pBand = &pThis->band[i];
+
+        pBand->freq  = eq_freq[i];
+        pBand->shape = 0 == i ? BIQUAD_LOWSHELF
+                     : EQ_BANDS - 1 == i ? BIQUAD_HIGHSHELF : BIQUAD_PEAKING;
+        pBand->q     = BIQUAD_PEAKING == pBand->shape ? EQ_PEAK_Q : EQ_SHELF_Q;
+    }
+    return PASS;
+}
+
+/** Set the gain of a band, applied with the next chunk
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param band   0 .. EQ_BANDS-1
+ * @param gain   dB, clipped to +-EQ_GAIN_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure (no such band).
+ */
+int eq_setGain(eq_t *pThis, int band, int gain)
+{
+    if ( 0 > band || EQ_BANDS <= band ) {
+        printf("[EQ]: No band %d\n", band);
+        return FAIL;
+    }
+    if ( gain > EQ_GAIN_MAX ) {
+        gain = EQ_GAIN_MAX;
+    } else if ( gain < -EQ_GAIN_MAX ) {
+        gain = -EQ_GAIN_MAX;
+    }
+    if ( gain != pThis->band[band].gain ) {
+        pThis->band[band].gain    = gain;
+        pThis->band[band].changed = 1;
+        pThis->changed            = 1;
+    }
+    return PASS;
+}
+
+/** Bound of the boost of the bands: overlapping bands multiply, so the
+ *  boost of the chain is at most the sum of the positive band gains
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return sum of the positive band gains in dB, 0 if no band boosts
+ */
+int eq_boost(const eq_t *pThis)
+{
+    int         boost = 0;
+    int         i;
+
+    for ( i = 0; i < EQ_BANDS; i++ ) {
+        if ( 0 < pThis->band[i].gain ) {
+            boost += pThis->band[i].gain;
+        }
+    }
+    return boost;
+}
+
+/** Set shape, frequency and q of a band (parametric use)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param band   0 .. EQ_BANDS-1
+ * @param shape  BIQUAD_PEAKING, BIQUAD_LOWSHELF or BIQUAD_HIGHSHELF
+ * @param freq   frequency in Hz, below half the rate
+ * @param q      quality factor
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int eq_setBand(eq_t *pThis, int band, biquad_shape_t shape, float freq, float q)
+{
+    eq_band_t   *pBand;
+    float       split;
+
+    if ( 0 > band || EQ_BANDS <= band || BIQUAD_PEAKING > shape
+      || 0.0f >= freq || 0.0f >= q ) {
+        printf("[EQ]: Invalid band %d\n", band);
+        return FAIL;
+    }
+    pBand = &pThis->band[band];
+    split = (float)pThis->rate / EQ_Q31_BELOW;
+    // precision follows the frequency: restart the section
+    if ( (pBand->freq < split) != (freq < split) ) {
+        pBand->active = 0;
+    }
+    pBand->shape   = shape;
+    pBand->freq    = freq;
+    pBand->q       = q;
+    pBand->changed = 1;
+    pThis->changed = 1;
+    return PASS;
+}
+
+/** Change the sample rate, every active band is redesigned
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return None
+ */
+void eq_setRate(eq_t *pThis, unsigned int rate)
+{
+    int         i;
+
+    if ( 0 == rate || rate == pThis->rate ) {
+        return;
+    }
+    pThis->rate = rate;
+    for ( i = 0; i < EQ_BANDS; i++ ) {
+        pThis->band[i].active  = 0;
+        pThis->band[i].changed = 1;
+    }
+    pThis->changed = 1;
+}
+
+/** Push button control: step the selected band or the gain of it
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param nextBand non-zero to select the next band
+ *
+ * @return None
+ */
+void eq_step(eq_t *pThis, int nextBand)
+{
+    int         gain;
+
+    if ( nextBand ) {
+        pThis->selected = (pThis->selected + 1) % EQ_BANDS;
+    } else {
+        gain = pThis->band[pThis->selected].gain + EQ_GAIN_STEP;
+        eq_setGain(pThis, pThis->selected, gain > EQ_GAIN_MAX ? -EQ_GAIN_MAX : gain);
+    }
+    printf("[EQ]: band %d (%.0f Hz) %+d dB\n", pThis->selected,
+           pThis->band[pThis->selected].freq, pThis->band[pThis->selected].gain);
+}
+
+/** Command interface
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pCmd   command string
+ *
+ * @return Zero on success.
+ * Negative value on failure (nothing after the error is applied).
+ */
+int eq_command(eq_t *pThis, const char *pCmd)
+{
+    const char  *p = pCmd;
+    char        *pEnd;
+    long        band;
+    long        gain;
+    int         i;
+
+    if ( 0 == strcmp(pCmd, "flat") ) {
+        for ( i = 0; i < EQ_BANDS; i++ ) {
+            eq_setGain(pThis, i, 0);
+        }
+        return PASS;
+    }
+
+    while ( '\0' != *p ) {
+        band = strtol(p, &pEnd, 10);
+        if ( pEnd == p || ':' != *pEnd ) {
+            break;
+        }
+        p    = pEnd + 1;
+        gain = strtol(p, &pEnd, 10);
+        if ( pEnd == p || PASS != eq_setGain(pThis, (int)band, (int)gain) ) {
+            break;
+        }
+        p = pEnd;
+        if ( ',' == *p ) {
+            p++;
+        } else if ( '\0' != *p ) {
+            break;
+        }
+    }
+    if ( '\0' != *p ) {
+        printf("[EQ]: Bad command at \"%s\"\n", p);
+        return FAIL;
+    }
+    return PASS;
+}
+
+/** Equalize a chunk in place, counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void eq_process(eq_t *pThis, chunk_t *pChunk)
+{
+    cycle_t     c0;
+    cycle_t     c1;
+    int         nActive = 0;
+    int         i;
+
+    _GET_CYCLE_COUNT(c0);
+    if ( pThis->changed ) {
+        pThis->changed = 0;
+        for ( i = 0; i < EQ_BANDS; i++ ) {
+            if ( pThis->band[i].changed ) {
+                eq_design(pThis, &pThis->band[i]);
+            }
+        }
+    }
+    for ( i = 0; i < EQ_BANDS; i++ ) {
+        if ( pThis->band[i].active ) {
+            biquad_process(&pThis->band[i].bq, pChunk);
+            if ( 0 != pThis->band[i].shift ) {
+                eq_shift(pChunk->s16_buff, pChunk->len / 2, pThis->band[i].shift);
+            }
+            nActive++;
+        }
+    }
+    _GET_CYCLE_COUNT(c1);
+
+    pThis->nActive = nActive;
+    pThis->calls[nActive]++;
+    pThis->cycles[nActive] += c1 - c0;
+}
+
+/** Print the band settings and the cycles per chunk by active bands
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param samples   samples per chunk, for cycles per sample
+ *
+ * @return None
+ */
+void eq_report(const eq_t *pThis, int samples)
+{
+    int         i;
+
+    printf("[EQ]:");
+    for ( i = 0; i < EQ_BANDS; i++ ) {
+        printf(" %.0f:%+d%s", pThis->band[i].freq, pThis->band[i].gain,
+               pThis->band[i].active ? (BIQUAD_Q31 == pThis->band[i].bq.format ? "L" : "")
+                                     : "-");
+    }
+    printf(" (L = Q31, - = off), %lu designs\n", pThis->designs);
+    for ( i = 0; i <= EQ_BANDS; i++ ) {
+        if ( 0 == pThis->calls[i] ) {
+            continue;
+        }
+        printf("[EQ]: %2d bands: %lu chunks, %.0f cycles per chunk, %.1f per sample\n",
+               i, pThis->calls[i], (double)pThis->cycles[i] / pThis->calls[i],
+               0 < samples ? (double)pThis->cycles[i] / pThis->calls[i] / samples : 0.0);
+    }
+}
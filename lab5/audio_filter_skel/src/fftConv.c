@@ -0,0 +1,391 @@
+/**
+ *@file fftConv.c
+ *
+ *@brief
+ *  - FIR filtering by overlap-save FFT convolution for long filters
+ *
+ *  Per call the FFT input is [taps-1 history samples, length new samples,
+ *  zeros]. After multiplying with the filter spectrum and transforming
+ *  back, outputs taps-1 .. taps-1+length-1 are free of circular wrap and
+ *  are the filter output for the new samples.
+ *
+ *  Fixed point: samples enter with FFTCONV_HEADROOM bits of headroom in
+ *  32 bit, twiddles are 1.15. Before every butterfly stage the block is
+ *  halved if any value could overflow (block floating point), the
+ *  exponents of both transforms are applied once at the end. The filter
+ *  spectrum is quantized with the scale that uses the 1.15 range best.
+ *  The 1.15 twiddles and spectrum keep the output within about 1 LSB rms
+ *  and 5 LSB peak of the direct form for 256 .. 2048 taps (host -C check).
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include <math.h>
+#include "fftConv.h"
+#include "firBlock.h"
+
+/**
+ * @def FFTCONV_HEADROOM
+ * @brief left shift of 1.15 samples in the fixed point work buffer
+ */
+#define FFTCONV_HEADROOM    (14)
+
+/**
+ * @def FFTCONV_LIMIT
+ * @brief values at or above this are halved before a butterfly stage
+ */
+#define FFTCONV_LIMIT       (1 << 29)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/** bit reversal permutation */
+static void fftConv_reorder(int log2n, int *re, int *im, float *reF, float *imF)
+{
+    int n = 1 << log2n;
+    int i, j, b;
+
+    for ( i = 0; i < n; i++ ) {
+        for ( j = 0, b = 0; b < log2n; b++ ) {
+            j |= ((i >> b) & 1) << (log2n - 1 - b);
+        }
+        if ( j > i ) {
+            if ( NULL != re ) {
+                int t = re[i]; re[i] = re[j]; re[j] = t;
+                t = im[i]; im[i] = im[j]; im[j] = t;
+            } else {
+                float t = reF[i]; reF[i] = reF[j]; reF[j] = t;
+                t = imF[i]; imF[i] = imF[j]; imF[j] = t;
+            }
+        }
+    }
+}
+
+/** radix-2 decimation in time FFT, 32 bit fixed point, block floating point
+ * @param inverse  non-zero for the inverse transform (no 1/N)
+ * @return exponent, the true transform is the result * 2^exponent
+ */
+static int fftConv_fftFixed(fftConv_t *pThis, int *re, int *im, int inverse)
+{
+    int     log2n = pThis->log2n;
+    int     n     = 1 << log2n;
+    int     exp   = 0;
+    int     half, i, j, k;
+
+    fftConv_reorder(log2n, re, im, NULL, NULL);
+
+    for ( half = 1; half < n; half <<= 1 ) {
+        int step    = n / (2 * half);
+        int peak    = 0;
+
+        for ( i = 0; i < n; i++ ) {
+            int a = re[i] < 0 ? -re[i] : re[i];
+            int b = im[i] < 0 ? -im[i] : im[i];
+            peak |= a | b;
+        }
+        if ( peak >= FFTCONV_LIMIT ) {
+            for ( i = 0; i < n; i++ ) {
+                re[i] >>= 1;
+                im[i] >>= 1;
+            }
+            exp++;
+        }
+
+        for ( k = 0; k < half; k++ ) {
+            int wr = pThis->cosQ15[k * step];
+            int wi = inverse ? pThis->sinQ15[k * step] : -pThis->sinQ15[k * step];
+
+            for ( j = k; j < n; j += 2 * half ) {
+                int tr = (int)(((long long)wr * re[j + half] - (long long)wi * im[j + half]) >> 15);
+                int ti = (int)(((long long)wr * im[j + half] + (long long)wi * re[j + half]) >> 15);
+
+                re[j + half] = re[j] - tr;
+                im[j + half] = im[j] - ti;
+                re[j]       += tr;
+                im[j]       += ti;
+            }
+        }
+    }
+    return exp;
+}
+
+/** radix-2 decimation in time FFT, float
+ * @param inverse  non-zero for the inverse transform (no 1/N)
+ */
+static void fftConv_fftFloat(fftConv_t *pThis, float *re, float *im, int inverse)
+{
+    int     log2n = pThis->log2n;
+    int     n     = 1 << log2n;
+    int     half, j, k;
+
+    fftConv_reorder(log2n, NULL, NULL, re, im);
+
+    for ( half = 1; half < n; half <<= 1 ) {
+        int step = n / (2 * half);
+
+        for ( k = 0; k < half; k++ ) {
+            float wr = pThis->cosF[k * step];
+            float wi = inverse ? pThis->sinF[k * step] : -pThis->sinF[k * step];
+
+            for ( j = k; j < n; j += 2 * half ) {
+                float tr = wr * re[j + half] - wi * im[j + half];
+                float ti = wr * im[j + half] + wi * re[j + half];
+
+                re[j + half] = re[j] - tr;
+                im[j + half] = im[j] - ti;
+                re[j]       += tr;
+                im[j]       += ti;
+            }
+        }
+    }
+}
+
+/** saturate to 32 bit */
+static int fftConv_sat32(long long v)
+{
+    if ( v > 0x7fffffffLL ) {
+        return 0x7fffffff;
+    } else if ( v < -0x80000000LL ) {
+        return (int)-0x80000000LL;
+    }
+    return (int)v;
+}
+
+/** saturate to 1.15 */
+static fract16 fftConv_sat(long long v)
+{
+    if ( v > 0x7fff ) {
+        return 0x7fff;
+    } else if ( v < -0x8000 ) {
+        return -0x8000;
+    }
+    return (fract16)v;
+}
+
+/** Cost per sample of a mode
+ *
+ * Parameters:
+ * @param taps   number of coefficients
+ * @param block  samples per call
+ * @param mode   FFTCONV_DIRECT or an FFT mode
+ *
+ * @return estimated cost per output sample in MACs of the firBlock
+ *         kernel, see FFTCONV_MUL_DIRECT .. FFTCONV_MUL_FLOAT
+ */
+int fftConv_cost(int taps, int block, fftConv_mode_t mode)
+{
+    int log2n = 0;
+    int n;
+
+    if ( FFTCONV_DIRECT == mode ) {
+        return FIRBLOCK_TAPS_MAX < taps ? taps * FFTCONV_MUL_DIRECT : taps;
+    }
+    while ( (1 << log2n) < taps + block - 1 ) {
+        log2n++;
+    }
+    n = 1 << log2n;
+    // two complex transforms (4 multiplies per butterfly) + spectrum product
+    return (2 * (n / 2) * log2n * 4 + 4 * n) / block
+         * (FFTCONV_FFT_FIXED == mode ? FFTCONV_MUL_FIXED : FFTCONV_MUL_FLOAT);
+}
+
+/** Initialize convolution
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pCoeff  filter coefficients (1.15)
+ * @param pDelay  delay line of taps samples for direct form
+ * @param taps    number of coefficients
+ * @param block   largest number of samples passed to fftConv_process
+ * @param mode    processing mode
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int fftConv_init(fftConv_t *pThis, fract16 *pCoeff, fract16 *pDelay,
+                 int taps, int block, fftConv_mode_t mode)
+{
+    int     n;
+    int     i;
+    float   peak = 0.0f;
+
+    if ( NULL == pThis || NULL == pCoeff || 0 >= taps || 0 >= block ) {
+        return FAIL;
+    }
+
+    pThis->taps  = taps;
+    pThis->block = block;
+
+    if ( FFTCONV_AUTO == mode ) {
+        mode = fftConv_cost(taps, block, FFTCONV_DIRECT) <= fftConv_cost(taps, block, FFTCONV_FFT_NATIVE)
+             ? FFTCONV_DIRECT : FFTCONV_FFT_NATIVE;
+    }
+    pThis->mode = mode;
+
+    if ( FFTCONV_DIRECT == mode ) {
+        if ( NULL == pDelay ) {
+            return FAIL;
+        }
+        for ( i = 0; i < taps; i++ ) {
+            pDelay[i] = 0;
+        }
+        fir_init(pThis->direct, pCoeff, pDelay, taps, 1);
+        return PASS;
+    }
+
+    for ( pThis->log2n = 0; (1 << pThis->log2n) < taps + block - 1; pThis->log2n++ ) {
+    }
+    if ( pThis->log2n > FFTCONV_LOG2_MAX ) {
+        printf("[FFTCONV]: %d taps + %d block exceed FFT size %d\n", taps, block, FFTCONV_N_MAX);
+        return FAIL;
+    }
+    n = 1 << pThis->log2n;
+
+    for ( i = 0; i < n / 2; i++ ) {
+        double a = 2.0 * M_PI * i / n;
+        pThis->cosF[i]   = (float)cos(a);
+        pThis->sinF[i]   = (float)sin(a);
+        pThis->cosQ15[i] = fftConv_sat((long long)floor(cos(a) * 32768.0 + 0.5));
+        pThis->sinQ15[i] = fftConv_sat((long long)floor(sin(a) * 32768.0 + 0.5));
+    }
+    for ( i = 0; i < n; i++ ) {
+        pThis->history[i] = 0;
+    }
+
+    // filter spectrum, computed in float for both arithmetic modes
+    for ( i = 0; i < n; i++ ) {
+        pThis->hReF[i] = i < taps ? pCoeff[i] / 32768.0f : 0.0f;
+        pThis->hImF[i] = 0.0f;
+    }
+    fftConv_fftFloat(pThis, pThis->hReF, pThis->hImF, 0);
+
+    if ( FFTCONV_FFT_FIXED == mode ) {
+        for ( i = 0; i < n; i++ ) {
+            float a = fabsf(pThis->hReF[i]);
+            float b = fabsf(pThis->hImF[i]);
+            peak = a > peak ? a : peak;
+            peak = b > peak ? b : peak;
+        }
+        // largest 2^hShift with |H| * 2^hShift still below 1.0 in 1.15
+        for ( pThis->hShift = 15; pThis->hShift > -15; pThis->hShift-- ) {
+            if ( ldexpf(peak, pThis->hShift) < 32767.0f ) {
+                break;
+            }
+        }
+        for ( i = 0; i < n; i++ ) {
+            pThis->hRe[i] = (int)floorf(ldexpf(pThis->hReF[i], pThis->hShift) + 0.5f);
+            pThis->hIm[i] = (int)floorf(ldexpf(pThis->hImF[i], pThis->hShift) + 0.5f);
+        }
+    }
+    return PASS;
+}
+
+/** Filter samples
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param output  output samples (may equal input)
+ * @param length  number of samples, at most block
+ *
+ * @return None 
+ */
+void fftConv_process(fftConv_t *pThis, const fract16 input[], fract16 output[], int length)
+{
+    int     n    = 1 << pThis->log2n;
+    int     hist = pThis->taps - 1;
+    int     i;
+
+    if ( FFTCONV_DIRECT == pThis->mode ) {
+        firBlock_fr16(input, output, length, &pThis->direct);
+        return;
+    }
+    if ( length > pThis->block ) {
+        // split calls that are longer than configured
+        fftConv_process(pThis, input, output, pThis->block);
+        fftConv_process(pThis, input + pThis->block, output + pThis->block, length - pThis->block);
+        return;
+    }
+
+    if ( FFTCONV_FFT_FIXED == pThis->mode ) {
+        int     exp;
+        int     shift;
+
+        for ( i = 0; i < hist; i++ ) {
+            pThis->xRe[i] = pThis->history[i] * (1 << FFTCONV_HEADROOM);
+        }
+        for ( i = 0; i < length; i++ ) {
+            pThis->xRe[hist + i] = input[i] * (1 << FFTCONV_HEADROOM);
+        }
+        for ( i = hist + length; i < n; i++ ) {
+            pThis->xRe[i] = 0;
+        }
+        for ( i = 0; i < n; i++ ) {
+            pThis->xIm[i] = 0;
+        }
+        // history for the next call, before output may overwrite input
+        for ( i = 0; i < hist; i++ ) {
+            pThis->history[i] = (fract16)(pThis->xRe[length + i] >> FFTCONV_HEADROOM);
+        }
+
+        exp = fftConv_fftFixed(pThis, pThis->xRe, pThis->xIm, 0);
+        for ( i = 0; i < n; i++ ) {
+            long long re = (long long)pThis->xRe[i] * pThis->hRe[i] - (long long)pThis->xIm[i] * pThis->hIm[i];
+            long long im = (long long)pThis->xRe[i] * pThis->hIm[i] + (long long)pThis->xIm[i] * pThis->hRe[i];
+            // near full scale X and H the complex sums exceed 32 bit after >> 15
+            pThis->xRe[i] = fftConv_sat32(re >> 15);
+            pThis->xIm[i] = fftConv_sat32(im >> 15);
+        }
+        exp += fftConv_fftFixed(pThis, pThis->xRe, pThis->xIm, 1);
+
+        // undo headroom, spectrum scale (less the >> 15 above) and 1/N
+        shift = FFTCONV_HEADROOM + pThis->hShift - 15 + pThis->log2n - exp;
+        for ( i = 0; i < length; i++ ) {
+            long long v = pThis->xRe[hist + i];
+            if ( shift > 0 ) {
+                v = (v + (1LL << (shift - 1))) >> shift;
+            } else {
+                v *= 1LL << -shift;
+            }
+            output[i] = fftConv_sat(v);
+        }
+    } else {
+        float scale = 1.0f / n;
+
+        for ( i = 0; i < hist; i++ ) {
+            pThis->xReF[i] = pThis->history[i];
+        }
+        for ( i = 0; i < length; i++ ) {
+            pThis->xReF[hist + i] = input[i];
+        }
+        for ( i = hist + length; i < n; i++ ) {
+            pThis->xReF[i] = 0.0f;
+        }
+        for ( i = 0; i < n; i++ ) {
+            pThis->xImF[i] = 0.0f;
+        }
+        for ( i = 0; i < hist; i++ ) {
+            pThis->history[i] = (fract16)pThis->xReF[length + i];
+        }
+
+        fftConv_fftFloat(pThis, pThis->xReF, pThis->xImF, 0);
+        for ( i = 0; i < n; i++ ) {
+            float re = pThis->xReF[i] * pThis->hReF[i] - pThis->xImF[i] * pThis->hImF[i];
+            float im = pThis->xReF[i] * pThis->hImF[i] + pThis->xImF[i] * pThis->hReF[i];
+            pThis->xReF[i] = re;
+            pThis->xImF[i] = im;
+        }
+        fftConv_fftFloat(pThis, pThis->xReF, pThis->xImF, 1);
+
+        for ( i = 0; i < length; i++ ) {
+            output[i] = fftConv_sat((long long)floorf(pThis->xReF[hist + i] * scale + 0.5f));
+        }
+    }
+}
@@ -0,0 +1,282 @@
+/**
+ *@file filterCascade.c
+ *
+ *@brief
+ *  - applies all enabled FIR stages to a chunk in one pass
+ *
+ *  The combined kernel is the exact convolution of the active stages
+ *  (64 bit intermediate), quantized to 16 bit with the largest scale
+ *  that keeps sum|c| < 65536 so firBlock's 32 bit accumulator cannot
+ *  overflow. Cascades of high-pass and low-pass sections have very small
+ *  taps, the scale keeps their resolution. The MAC count equals the sum
+ *  of the stage lengths (k1 + k2 - 1 taps), the gain is a single pass
+ *  and delay line. The individual stage states are not updated while it
+ *  runs, and inactive stages not at all; instead the cascade keeps its
+ *  last FILTERCASCADE_TAPS_MAX inputs and on a mask change runs them
+ *  through the new configuration from silence, which leaves every delay
+ *  line as if it had been running. This is exact as long as the summed
+ *  delay of the active stages fits the history, i.e. always for a
+ *  combined kernel (one pass of TAPS_MAX * taps MACs per change).
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "filterCascade.h"
+
+
+/** Build the combined kernel for the current mask
+ *   - leaves pThis->combined cleared if the combination does not fit
+ */
+static void filterCascade_combine(filterCascade_t *pThis)
+{
+    long long   acc[FILTERCASCADE_TAPS_MAX];    // exact kernel
+    long long   tmp[FILTERCASCADE_TAPS_MAX];
+    long long   sum = 0;
+    long long   peak = 0;
+    int         len = 0;
+    int         frac = 0;                       // fractional bits of acc
+    int         shift;
+    int         i, j, st;
+
+    pThis->combined = 0;
+
+    for ( st = 0; st < pThis->nStages; st++ ) {
+        fir_state_fr16 *pStage = pThis->pStage[st];
+
+        if ( 0 == (pThis->mask & (0x1 << st)) ) {
+            continue;
+        }
+        if ( 0 == len ) {
+            for ( i = 0; i < pStage->k; i++ ) {
+                acc[i] = pStage->h[i];
+            }
+            len  = pStage->k;
+            frac = 15;
+            continue;
+        }
+        if ( len + pStage->k - 1 > FILTERCASCADE_TAPS_MAX ) {
+            return;
+        }
+        // keep 15 fractional bits of the intermediate, the exact
+        // product would not fit 64 bit for more than 3 stages
+        for ( i = 0; i < len + pStage->k - 1; i++ ) {
+            tmp[i] = 0;
+        }
+        for ( i = 0; i < len; i++ ) {
+            for ( j = 0; j < pStage->k; j++ ) {
+                tmp[i + j] += acc[i] * pStage->h[j];
+            }
+        }
+        len += pStage->k - 1;
+        for ( i = 0; i < len; i++ ) {
+            acc[i] = tmp[i];
+        }
+        frac += 15;
+        if ( frac > 30 ) {
+            for ( i = 0; i < len; i++ ) {
+                acc[i] = (acc[i] + (1LL << (frac - 31))) >> (frac - 30);
+            }
+            frac = 30;
+        }
+    }
+
+    for ( i = 0; i < len; i++ ) {
+        long long a = acc[i] < 0 ? -acc[i] : acc[i];
+        sum += a;
+        peak = a > peak ? a : peak;
+    }
+    if ( 0 == len || 0 == sum ) {
+        return;
+    }
+
+    // largest shift so that the quantized kernel has sum|c| < 65536
+    for ( shift = 30; shift > 0; shift-- ) {
+        int down = frac - shift;
+        long long s = down >= 0 ? sum >> down : sum << -down;
+        long long p = down >= 0 ? peak >> down : peak << -down;
+        if ( s < 65536 - len && p < 32767 ) {
+            break;
+        }
+    }
+    if ( shift < 1 ) {
+        return;
+    }
+
+    for ( i = 0; i < len; i++ ) {
+        int down = frac - shift;
+        long long c = down > 0 ? (acc[i] + (1LL << (down - 1))) >> down : acc[i] << -down;
+        pThis->combinedCoeff[i] = (fract16)c;
+    }
+    fir_init(pThis->combinedState, pThis->combinedCoeff, pThis->combinedDelay, len, 1);
+    pThis->combinedShift = shift;
+    pThis->combined      = 1;
+}
+
+/** Prime the delay lines of the current configuration from the history
+ */
+static void filterCascade_prime(filterCascade_t *pThis)
+{
+    fract16     buf[FILTERCASCADE_TAPS_MAX];
+    int         st;
+
+    if ( pThis->combined ) {
+        fir_state_fr16 *pState = &pThis->combinedState;
+
+        memset(pState->d, 0, pState->k * sizeof(fract16));
+        pState->p = pState->d;
+        firBlock_fr16Scaled(pThis->history, buf, FILTERCASCADE_TAPS_MAX,
+                            pState, pThis->combinedShift);
+        return;
+    }
+    memcpy(buf, pThis->history, sizeof(buf));
+    for ( st = 0; st < pThis->nStages; st++ ) {
+        fir_state_fr16 *pStage = pThis->pStage[st];
+
+        if ( pThis->mask & (0x1 << st) ) {
+            memset(pStage->d, 0, pStage->k * sizeof(fract16));
+            pStage->p = pStage->d;
+            firBlock_fr16(buf, buf, FILTERCASCADE_TAPS_MAX, pStage);
+        }
+    }
+}
+
+/** Initialize cascade with no stages and no stage active
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param combine  non-zero to convolve active FIR stages into one kernel
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int filterCascade_init(filterCascade_t *pThis, int combine)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    pThis->nStages  = 0;
+    pThis->mask     = 0;
+    pThis->combine  = combine;
+    pThis->combined = 0;
+    memset(pThis->history, 0, sizeof(pThis->history));
+    return PASS;
+}
+
+/** Append a FIR stage
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pStage  stage state, the stage index is the order of adding
+ *
+ * @return stage index on success.
+ * Negative value on failure.
+ */
+int filterCascade_addStage(filterCascade_t *pThis, fir_state_fr16 *pStage)
+{
+    if ( NULL == pThis || NULL == pStage || FILTERCASCADE_STAGES_MAX <= pThis->nStages ) {
+        return FAIL;
+    }
+    pThis->pStage[pThis->nStages] = pStage;
+    return pThis->nStages++;
+}
+
+/** Select the active stages
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param mask   bit i enables stage i
+ *
+ * @return None 
+ */
+void filterCascade_setMask(filterCascade_t *pThis, unsigned int mask)
+{
+    int st;
+    int active = 0;
+
+    mask &= (0x1u << pThis->nStages) - 1;
+    if ( mask == pThis->mask ) {
+        return;
+    }
+    pThis->mask     = mask;
+    pThis->combined = 0;
+
+    for ( st = 0; st < pThis->nStages; st++ ) {
+        if ( mask & (0x1 << st) ) {
+            active++;
+        }
+    }
+    // a single stage runs directly, nothing to combine
+    if ( pThis->combine && 1 < active ) {
+        filterCascade_combine(pThis);
+    }
+    filterCascade_prime(pThis);
+}
+
+/** Rebuild after the coefficients of stages changed (same mask)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return None 
+ */
+void filterCascade_update(filterCascade_t *pThis)
+{
+    unsigned int mask = pThis->mask;
+
+    // no valid mask has bits above nStages, forces the rebuild
+    pThis->mask = ~0u;
+    filterCascade_setMask(pThis, mask);
+}
+
+/** Filter a chunk in place through all active stages
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None 
+ */
+void filterCascade_process(filterCascade_t *pThis, chunk_t *pChunk)
+{
+    int     length  = pChunk->len/2;
+    int     keep    = FILTERCASCADE_TAPS_MAX - length;
+    int     done;
+    int     st;
+
+    // input history for priming on the next mask change
+    if ( 0 < keep ) {
+        memmove(pThis->history, &pThis->history[length], keep * sizeof(fract16));
+        memcpy(&pThis->history[keep], pChunk->s16_buff, length * sizeof(fract16));
+    } else {
+        memcpy(pThis->history, &pChunk->s16_buff[-keep], sizeof(pThis->history));
+    }
+
+    if ( 0 == pThis->mask ) {
+        return;
+    }
+
+    if ( pThis->combined ) {
+        firBlock_fr16Scaled(pChunk->s16_buff, pChunk->s16_buff, length,
+                            &pThis->combinedState, pThis->combinedShift);
+        return;
+    }
+
+    for ( done = 0; done < length; done += FILTERCASCADE_BLOCK ) {
+        fract16 *pBlock = &pChunk->s16_buff[done];
+        int     blk     = length - done;
+
+        if ( blk > FILTERCASCADE_BLOCK ) {
+            blk = FILTERCASCADE_BLOCK;
+        }
+        for ( st = 0; st < pThis->nStages; st++ ) {
+            if ( pThis->mask & (0x1 << st) ) {
+                firBlock_fr16(pBlock, pBlock, blk, pThis->pStage[st]);
+            }
+        }
+    }
+}
@@ -0,0 +1,281 @@
+/**
+ *@file firBlock.c
+ *
+ *@brief
+ *  - block based FIR engine, drop-in replacement for fir_fr16
+ *
+ *  delay line convention (shared with fir_fr16): s->p points to the slot
+ *  written next, the slot before it holds the newest sample; h[0] is
+ *  applied to the newest sample.
+ *
+ *  Per call the k-1 newest delay samples are copied (oldest first) in
+ *  front of the input in a scratch buffer x[]. With reversed coefficients
+ *  hr[j] = h[k-1-j] every output becomes a plain dot product
+ *    y[n] = sum_j hr[j] * x[n+j]
+ *  over contiguous memory. After each block the last k-1 samples move to
+ *  the front, at the end they are written back to the delay line.
+ *
+ *  Linear phase filters (h[j] == h[k-1-j]) are detected per call, which
+ *  costs k/2 compares against k*length MACs. For them the mirrored taps
+ *  are pre-added and only the first half of the coefficients is applied
+ *    y[n] = sum_{j<k/2} h[j] * (x[n+j] + x[n+k-1-j])  (+ h[k/2] * x[n+k/2])
+ *  the middle tap only exists for odd k. The integer sums are the same,
+ *  so the result is bit-exact with the general kernel.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "firBlock.h"
+#include "q15.h"
+
+
+/** round and saturate a 32 bit accumulator to 1.15 */
+static inline fract16 firBlock_sat(int acc, int shift)
+{
+    return q15_sat((acc + (1 << (shift - 1))) >> shift);
+}
+
+/** @return 1 if the coefficients are symmetric (linear phase) */
+static int firBlock_isSymmetric(const fract16 h[], int k)
+{
+    int         j;
+
+    for ( j = 0; j < k / 2; j++ ) {
+        if ( h[j] != h[k - 1 - j] ) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/** general kernel, blk outputs from the scratch buffer */
+static void firBlock_general(const fract16 x[], const fract16 hr[], int k,
+                             fract16 out[], int blk, int shift)
+{
+    int         j, n;
+
+    // two outputs per pass share every coefficient load (dual MAC)
+    for ( n = 0; n + 1 < blk; n += 2 ) {
+        const fract16 *px = &x[n];
+        int           acc0 = 0;
+        int           acc1 = 0;
+
+        for ( j = 0; j < k; j++ ) {
+            acc0 += hr[j] * px[j];
+            acc1 += hr[j] * px[j + 1];
+        }
+        out[n]     = firBlock_sat(acc0, shift);
+        out[n + 1] = firBlock_sat(acc1, shift);
+    }
+    if ( n < blk ) {
+        const fract16 *px = &x[n];
+        int           acc0 = 0;
+
+        for ( j = 0; j < k; j++ ) {
+            acc0 += hr[j] * px[j];
+        }
+        out[n] = firBlock_sat(acc0, shift);
+    }
+}
+
+/** symmetric kernel for even k, k/2 MACs per output
+ *   xr[] is the scratch buffer reversed, so both halves are read forward
+ *   (pLo[j] == x[n+j], pHi[j] == x[n+k-1-j])
+ */
+static void firBlock_symEven(const fract16 x[], const fract16 xr[], const fract16 h[],
+                             int k, fract16 out[], int blk, int shift)
+{
+    int         half = k / 2;
+    int         j, n;
+
+    for ( n = 0; n + 1 < blk; n += 2 ) {
+        const fract16 *pLo = &x[n];
+        const fract16 *pHi = &xr[blk - 1 - n];
+        int           acc0 = 0;
+        int           acc1 = 0;
+
+        for ( j = 0; j < half; j++ ) {
+            acc0 += h[j] * (pLo[j] + pHi[j]);
+            acc1 += h[j] * (pLo[j + 1] + pHi[j - 1]);
+        }
+        out[n]     = firBlock_sat(acc0, shift);
+        out[n + 1] = firBlock_sat(acc1, shift);
+    }
+    if ( n < blk ) {
+        const fract16 *pLo = &x[n];
+        const fract16 *pHi = &xr[blk - 1 - n];
+        int           acc0 = 0;
+
+        for ( j = 0; j < half; j++ ) {
+            acc0 += h[j] * (pLo[j] + pHi[j]);
+        }
+        out[n] = firBlock_sat(acc0, shift);
+    }
+}
+
+/** symmetric kernel for odd k, (k-1)/2 MACs plus the middle tap
+ *   xr[] is the scratch buffer reversed, so both halves are read forward
+ *   (pLo[j] == x[n+j], pHi[j] == x[n+k-1-j])
+ */
+static void firBlock_symOdd(const fract16 x[], const fract16 xr[], const fract16 h[],
+                            int k, fract16 out[], int blk, int shift)
+{
+    int         half = k / 2;
+    int         j, n;
+
+    for ( n = 0; n + 1 < blk; n += 2 ) {
+        const fract16 *pLo = &x[n];
+        const fract16 *pHi = &xr[blk - 1 - n];
+        int           acc0 = h[half] * pLo[half];
+        int           acc1 = h[half] * pLo[half + 1];
+
+        for ( j = 0; j < half; j++ ) {
+            acc0 += h[j] * (pLo[j] + pHi[j]);
+            acc1 += h[j] * (pLo[j + 1] + pHi[j - 1]);
+        }
+        out[n]     = firBlock_sat(acc0, shift);
+        out[n + 1] = firBlock_sat(acc1, shift);
+    }
+    if ( n < blk ) {
+        const fract16 *pLo = &x[n];
+        const fract16 *pHi = &xr[blk - 1 - n];
+        int           acc0 = h[half] * pLo[half];
+
+        for ( j = 0; j < half; j++ ) {
+            acc0 += h[j] * (pLo[j] + pHi[j]);
+        }
+        out[n] = firBlock_sat(acc0, shift);
+    }
+}
+
+/** per-sample fallback for filters longer than FIRBLOCK_TAPS_MAX
+ *   (same arithmetic as the block kernel)
+ */
+static void firBlock_long(const fract16 input[], fract16 output[], int length,
+                          fir_state_fr16 *s, int shift)
+{
+    int         i, j;
+    int         k   = s->k;
+    int         pos = s->p - s->d;
+    int         acc;
+
+    for ( i = 0; i < length; i++ ) {
+        s->d[pos] = input[i];
+        acc = 0;
+        for ( j = 0; j < k; j++ ) {
+            int idx = pos - j;
+            if ( idx < 0 ) {
+                idx += k;
+            }
+            acc += s->h[j] * s->d[idx];
+        }
+        output[i] = firBlock_sat(acc, shift);
+        if ( ++pos == k ) {
+            pos = 0;
+        }
+    }
+    s->p = s->d + pos;
+}
+
+/** Block FIR filter, 1.15 in and out
+ *
+ * Parameters:
+ * @param input   input samples
+ * @param output  output samples (may equal input)
+ * @param length  number of samples
+ * @param s       filter state initialized with fir_init
+ *
+ * @return None 
+ */
+void firBlock_fr16(const fract16 input[], fract16 output[], int length, fir_state_fr16 *s)
+{
+    firBlock_fr16Scaled(input, output, length, s, 15);
+}
+
+/** Block FIR filter with coefficients in 1.shift format
+ *
+ * Parameters:
+ * @param input   input samples
+ * @param output  output samples (may equal input)
+ * @param length  number of samples
+ * @param s       filter state initialized with fir_init
+ * @param shift   fractional bits of the coefficients (15 for 1.15)
+ *
+ * @return None 
+ */
+void firBlock_fr16Scaled(const fract16 input[], fract16 output[], int length,
+                         fir_state_fr16 *s, int shift)
+{
+    fract16     hr[FIRBLOCK_TAPS_MAX];                      // reversed coefficients
+    fract16     x[FIRBLOCK_TAPS_MAX - 1 + FIRBLOCK_SIZE];   // history + block
+    fract16     xr[FIRBLOCK_TAPS_MAX - 1 + FIRBLOCK_SIZE];  // x reversed (symmetric)
+    int         k       = s->k;
+    int         hist    = k - 1;
+    int         pos     = s->p - s->d;
+    int         done    = 0;
+    int         sym;
+    int         i, j, n;
+
+    if ( k > FIRBLOCK_TAPS_MAX ) {
+        firBlock_long(input, output, length, s, shift);
+        return;
+    }
+
+    // symmetric taps are their own reverse
+    sym = FIRBLOCK_FOLD && firBlock_isSymmetric(s->h, k);
+    if ( !sym ) {
+        for ( j = 0; j < k; j++ ) {
+            hr[j] = s->h[k - 1 - j];
+        }
+    }
+
+    // linearize the history, oldest first (the newest k-1 of the k slots)
+    for ( i = 0; i < hist; i++ ) {
+        x[i] = s->d[(pos + 1 + i) % k];
+    }
+
+    while ( done < length ) {
+        int         blk = length - done;
+        const fract16 *pIn  = &input[done];
+        fract16       *pOut = &output[done];
+
+        if ( blk > FIRBLOCK_SIZE ) {
+            blk = FIRBLOCK_SIZE;
+        }
+
+        // input is consumed into the scratch buffer first, so in place is fine
+        for ( n = 0; n < blk; n++ ) {
+            x[hist + n] = pIn[n];
+        }
+
+        if ( !sym ) {
+            firBlock_general(x, hr, k, pOut, blk, shift);
+        } else {
+            for ( n = 0; n < hist + blk; n++ ) {
+                xr[n] = x[hist + blk - 1 - n];
+            }
+            if ( k & 1 ) {
+                firBlock_symOdd(x, xr, s->h, k, pOut, blk, shift);
+            } else {
+                firBlock_symEven(x, xr, s->h, k, pOut, blk, shift);
+            }
+        }
+
+        // keep the newest k-1 samples as history of the next block
+        for ( i = 0; i < hist; i++ ) {
+            x[i] = x[blk + i];
+        }
+        done += blk;
+    }
+
+    // write back the newest k-1 samples, the slot after them is written next
+    for ( i = 0; i < hist; i++ ) {
+        s->d[i] = x[i];
+    }
+    s->p = s->d + hist;
+}
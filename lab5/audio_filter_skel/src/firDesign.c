@@ -0,0 +1,225 @@
+/**
+ *@file firDesign.c
+ *
+ *@brief
+ *  - runtime FIR design and coefficient cache
+ *
+ *  With m = n - (taps-1)/2 and the cut-offs normalized to the sample rate
+ *  the ideal responses are built from the low-pass sinc
+ *    lp(f, m) = sin(2 pi f m) / (pi m),   lp(f, 0) = 2 f
+ *  as high-pass d(m) - lp(f1), band-pass lp(f2) - lp(f1) and band-stop
+ *  d(m) - band-pass; d(m) only exists on the sample grid, so the shapes
+ *  using it need odd taps. The response is weighted with a Kaiser window,
+ *  beta from the attenuation (Kaiser's formula), scaled to unity gain at
+ *  the reference frequency of the shape and rounded to 1.15.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "tll_common.h"
+#include "firDesign.h"
+#include "q15.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/** modified Bessel function of the first kind, order 0 (power series) */
+static double firDesign_bessel0(double x)
+{
+    double  sum  = 1.0;
+    double  term = 1.0;
+    int     k;
+
+    for ( k = 1; k < 50 && term > 1e-12 * sum; k++ ) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum  += term;
+    }
+    return sum;
+}
+
+/** Kaiser window beta for a stop band attenuation in dB */
+static double firDesign_beta(int atten)
+{
+    if ( atten > 50 ) {
+        return 0.1102 * (atten - 8.7);
+    } else if ( atten >= 21 ) {
+        return 0.5842 * pow(atten - 21, 0.4) + 0.07886 * (atten - 21);
+    }
+    return 0.0;
+}
+
+/** ideal low-pass at normalized cut-off f, offset m from the center */
+static double firDesign_lowpass(double f, double m)
+{
+    return 0.0 == m ? 2.0 * f : sin(2.0 * M_PI * f * m) / (M_PI * m);
+}
+
+/** same spec (cache key) */
+static int firDesign_match(const firDesign_spec_t *pA, const firDesign_spec_t *pB)
+{
+    return pA->shape == pB->shape && pA->rate == pB->rate && pA->f1 == pB->f1
+        && pA->f2 == pB->f2 && pA->taps == pB->taps && pA->atten == pB->atten;
+}
+
+/** Design a filter
+ *
+ * Parameters:
+ * @param pSpec  filter spec
+ * @param coeff  filled with pSpec->taps 1.15 coefficients
+ *
+ * @return Zero on success.
+ * Negative value on failure (invalid spec).
+ */
+int firDesign_design(const firDesign_spec_t *pSpec, fract16 coeff[])
+{
+    double      h[FIRDESIGN_TAPS_MAX];
+    int         taps    = pSpec->taps;
+    int         band    = FIRDESIGN_BANDPASS == pSpec->shape || FIRDESIGN_BANDSTOP == pSpec->shape;
+    int         delta   = FIRDESIGN_HIGHPASS == pSpec->shape || FIRDESIGN_BANDSTOP == pSpec->shape;
+    double      center  = (taps - 1) / 2.0;
+    double      f1, f2, f0, beta, re, im, gain;
+    int         n;
+
+    if ( 0 >= taps || FIRDESIGN_TAPS_MAX < taps || 0 == pSpec->rate
+      || 0 == pSpec->f1 || 2 * pSpec->f1 >= pSpec->rate
+      || (band && (pSpec->f2 <= pSpec->f1 || 2 * pSpec->f2 >= pSpec->rate))
+      || (delta && 0 == (taps & 1)) ) {
+        printf("[FD]: Invalid spec shape %d rate %u f %u/%u taps %d\n",
+               pSpec->shape, pSpec->rate, pSpec->f1, pSpec->f2, taps);
+        return FAIL;
+    }
+    f1   = (double)pSpec->f1 / pSpec->rate;
+    f2   = (double)pSpec->f2 / pSpec->rate;
+    beta = firDesign_beta(pSpec->atten);
+
+    // reference frequency of the unity gain
+    switch ( pSpec->shape ) {
+    case FIRDESIGN_HIGHPASS: f0 = 0.5;               break;
+    case FIRDESIGN_BANDPASS: f0 = (f1 + f2) / 2.0;   break;
+    default:                 f0 = 0.0;               break;
+    }
+
+    re = 0.0;
+    im = 0.0;
+    for ( n = 0; n < taps; n++ ) {
+        double  m = n - center;
+        double  r = 1 < taps ? 2.0 * n / (taps - 1) - 1.0 : 0.0;
+        double  v;
+
+        switch ( pSpec->shape ) {
+        case FIRDESIGN_HIGHPASS:
+            v = (0.0 == m) - firDesign_lowpass(f1, m);
+            break;
+        case FIRDESIGN_BANDPASS:
+            v = firDesign_lowpass(f2, m) - firDesign_lowpass(f1, m);
+            break;
+        case FIRDESIGN_BANDSTOP:
+            v = (0.0 == m) - firDesign_lowpass(f2, m) + firDesign_lowpass(f1, m);
+            break;
+        default:
+            v = firDesign_lowpass(f1, m);
+            break;
+        }
+        h[n] = v * firDesign_bessel0(beta * sqrt(1.0 - r * r)) / firDesign_bessel0(beta);
+        re  += h[n] * cos(2.0 * M_PI * f0 * m);
+        im  -= h[n] * sin(2.0 * M_PI * f0 * m);
+    }
+    gain = sqrt(re * re + im * im);
+    if ( 0.0 == gain ) {
+        return FAIL;
+    }
+
+    for ( n = 0; n < taps; n++ ) {
+        coeff[n] = q15_sat((int)floor(h[n] / gain * 32768.0 + 0.5));
+    }
+    return PASS;
+}
+
+/** Widen a band narrower than the transition width
+ *
+ * Parameters:
+ * @param pSpec  filter spec, f1 and f2 updated
+ *
+ * @return 1 if the band was widened, 0 otherwise
+ */
+int firDesign_fitBand(firDesign_spec_t *pSpec)
+{
+    unsigned int    width;
+    unsigned int    center;
+
+    if ( (FIRDESIGN_BANDPASS != pSpec->shape && FIRDESIGN_BANDSTOP != pSpec->shape)
+      || 1 >= pSpec->taps || pSpec->f2 <= pSpec->f1 ) {
+        return 0;
+    }
+    width = (unsigned int)ceil(pSpec->rate * (pSpec->atten - 7.95)
+                               / (14.36 * (pSpec->taps - 1)));
+    center = (pSpec->f1 + pSpec->f2) / 2;
+    if ( pSpec->f2 - pSpec->f1 >= width || center <= width / 2 ) {
+        return 0;
+    }
+    pSpec->f1 = center - width / 2;
+    pSpec->f2 = pSpec->f1 + width;
+    return 1;
+}
+
+/** Initialize an empty cache
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int firDesign_cacheInit(firDesign_cache_t *pThis)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    return PASS;
+}
+
+/** Coefficients for a spec, designed on a miss
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pSpec  filter spec
+ *
+ * @return pSpec->taps coefficients, NULL for an invalid spec
+ */
+const fract16 *firDesign_get(firDesign_cache_t *pThis, const firDesign_spec_t *pSpec)
+{
+    firDesign_entry_t   *pVictim = &pThis->entry[0];
+    int                 i;
+
+    pThis->clock++;
+    for ( i = 0; i < FIRDESIGN_CACHE_SETS; i++ ) {
+        firDesign_entry_t *pEntry = &pThis->entry[i];
+
+        if ( 0 != pEntry->used && firDesign_match(&pEntry->spec, pSpec) ) {
+            pEntry->used = pThis->clock;
+            pThis->hits++;
+            return pEntry->coeff;
+        }
+        // empty slots have used 0 and go first
+        if ( pEntry->used < pVictim->used ) {
+            pVictim = pEntry;
+        }
+    }
+
+    pThis->misses++;
+    if ( PASS != firDesign_design(pSpec, pVictim->coeff) ) {
+        return NULL;
+    }
+    pVictim->spec = *pSpec;
+    pVictim->used = pThis->clock;
+    return pVictim->coeff;
+}
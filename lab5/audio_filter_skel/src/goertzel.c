@@ -0,0 +1,150 @@
+/**
+ *@file goertzel.c
+ *
+ *@brief
+ *  - Goertzel filter bank
+ *
+ *  Per detector and sample
+ *    s0 = x + c s1 - s2,  s2 = s1,  s1 = s0,   c = 2 cos(2 pi f / rate)
+ *  and at the end of a block of N samples
+ *    |X|^2 = s1^2 + s2^2 - c s1 s2
+ *  A sine of amplitude A on f gives |X|^2 = (N A / 2)^2 and the block
+ *  energy sum x^2 = N A^2 / 2, so power = 2 |X|^2 / (N energy) is the
+ *  share of the block energy at f (1 for a pure tone).
+ *
+ *  c s1 in 32 bit: with s1 = hi 2^16 + lo (lo unsigned 16 bit)
+ *    (c s1) >> 14 = 4 c hi + (c lo) >> 14
+ *  exact, and both products fit while |s1| < 2^29. The states of a tone
+ *  on f grow by about A / (2 sin w) per sample; the input shift keeps the
+ *  lowest detector below 2^29 over a full scale block.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "tll_common.h"
+#include "goertzel.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/** end of a block: results, restart */
+static void goertzel_block(goertzel_t *pThis)
+{
+    float       norm;
+    int         k;
+
+    // 2 / (N energy), states scaled by 2^-shift
+    norm = 0 < pThis->energy
+         ? ldexpf(2.0f / ((float)pThis->blockLen * (float)pThis->energy), 2 * pThis->shift)
+         : 0.0f;
+    for ( k = 0; k < pThis->n; k++ ) {
+        float s1 = (float)pThis->s1[k];
+        float s2 = (float)pThis->s2[k];
+
+        pThis->power[k] = (s1 * s1 + s2 * s2 - pThis->coeff[k] / 16384.0f * s1 * s2) * norm;
+        pThis->s1[k]    = 0;
+        pThis->s2[k]    = 0;
+    }
+    pThis->level  = (float)pThis->energy / pThis->blockLen / (32768.0f * 32768.0f);
+    pThis->energy = 0;
+    pThis->count  = 0;
+    pThis->ready  = 1;
+    pThis->blocks++;
+}
+
+/** Initialize a bank with cleared states
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param rate      sample rate in Hz
+ * @param freq      detector frequencies in Hz, 0 < freq < rate/2
+ * @param n         number of detectors, 1 .. GOERTZEL_MAX
+ * @param blockLen  samples per block, 0 for GOERTZEL_BLOCK_MS
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int goertzel_init(goertzel_t *pThis, unsigned int rate, const float freq[], int n, int blockLen)
+{
+    double      sinMin = 1.0;
+    int         k;
+
+    if ( NULL == pThis || 0 == rate || 0 >= n || GOERTZEL_MAX < n ) {
+        printf("[GZ]: Failed to init %d detectors\n", n);
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->n        = n;
+    pThis->blockLen = 0 < blockLen ? blockLen : (int)(rate * GOERTZEL_BLOCK_MS / 1000.0 + 0.5);
+    for ( k = 0; k < n; k++ ) {
+        double  w = 2.0 * M_PI * freq[k] / rate;
+        int     c = (int)floor(2.0 * cos(w) * 16384.0 + 0.5);
+
+        if ( 0.0f >= freq[k] || 2.0f * freq[k] >= rate ) {
+            printf("[GZ]: Invalid frequency %.1f Hz\n", freq[k]);
+            return FAIL;
+        }
+        pThis->freq[k]  = freq[k];
+        pThis->coeff[k] = c > 32767 ? 32767 : c;
+        sinMin          = sin(w) < sinMin ? sin(w) : sinMin;
+    }
+    // |s| < blockLen * 32768 / (2 sin w) must stay below 2^29
+    while ( pThis->blockLen * 32768.0 / (2.0 * sinMin) / (1 << pThis->shift) >= (1 << 29) ) {
+        pThis->shift++;
+    }
+    return PASS;
+}
+
+/** Feed samples up to the end of the running block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   samples
+ * @param length  number of samples
+ *
+ * @return number of samples consumed
+ */
+int goertzel_feed(goertzel_t *pThis, const fract16 input[], int length)
+{
+    int         *s1 = pThis->s1;
+    int         *s2 = pThis->s2;
+    const int   *c  = pThis->coeff;
+    int         n     = pThis->n;
+    int         shift = pThis->shift;
+    int         todo  = pThis->blockLen - pThis->count;
+    long long   energy = pThis->energy;
+    int         i, k;
+
+    pThis->ready = 0;
+    if ( todo > length ) {
+        todo = length;
+    }
+    for ( i = 0; i < todo; i++ ) {
+        int x = input[i] >> shift;
+
+        energy += input[i] * input[i];
+        // across detectors: independent lanes
+        for ( k = 0; k < n; k++ ) {
+            int hi = s1[k] >> 16;
+            int lo = s1[k] & 0xffff;
+            int s0 = x + 4 * c[k] * hi + ((c[k] * lo) >> 14) - s2[k];
+
+            s2[k] = s1[k];
+            s1[k] = s0;
+        }
+    }
+    pThis->energy = energy;
+    pThis->count += todo;
+    if ( pThis->count == pThis->blockLen ) {
+        goertzel_block(pThis);
+    }
+    return todo;
+}
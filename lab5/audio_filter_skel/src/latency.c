@@ -0,0 +1,180 @@
+/**
+ *@file latency.c
+ *
+ *@brief
+ *  - per stage latency histograms of the audio path
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "latency.h"
+#ifndef __bfin__
+#include <time.h>
+#endif
+
+/** names for the report */
+static const char *latency_name[LATENCY_STAGE_NUM] = {
+    "rx queue", "pre", "filter", "post", "tx queue", "total"
+};
+
+/** stamps that start and end each stage */
+static const unsigned char latency_from[LATENCY_STAGE_NUM] = {
+    CHUNK_STAMP_RX_DONE, CHUNK_STAMP_DEQUEUE, CHUNK_STAMP_FILTER_START,
+    CHUNK_STAMP_FILTER_END, CHUNK_STAMP_TX_ENQUEUE, CHUNK_STAMP_RX_DONE
+};
+static const unsigned char latency_to[LATENCY_STAGE_NUM] = {
+    CHUNK_STAMP_DEQUEUE, CHUNK_STAMP_FILTER_START, CHUNK_STAMP_FILTER_END,
+    CHUNK_STAMP_TX_ENQUEUE, CHUNK_STAMP_TX_START, CHUNK_STAMP_TX_START
+};
+
+
+/** @return histogram bucket of a cycle count */
+static int latency_bucket(unsigned long long cycles)
+{
+    int exp = 0;
+
+    if ( cycles < 16 ) {
+        return (int)cycles;
+    }
+    while ( (cycles >> exp) > 1 ) {
+        exp++;
+    }
+    return 16 + (exp - 4) * 4 + (int)((cycles >> (exp - 2)) & 3);
+}
+
+/** @return largest cycle count falling into a bucket */
+static unsigned long long latency_bucketMax(int bucket)
+{
+    int exp;
+    int sub;
+
+    if ( bucket < 16 ) {
+        return bucket;
+    }
+    exp = (bucket - 16) / 4 + 4;
+    sub = (bucket - 16) % 4;
+    return ((unsigned long long)(4 + sub + 1) << (exp - 2)) - 1;
+}
+
+/** Initialize latency statistics
+ *   - on the host the time stamp counter is calibrated against the
+ *     monotonic clock
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int latency_init(latency_t *pThis)
+{
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+
+#ifdef __bfin__
+    pThis->cyclesPerUs = LATENCY_CCLK_MHZ;
+#else
+    {
+        struct timespec     t0;
+        struct timespec     t1;
+        cycle_t             c0;
+        cycle_t             c1;
+        double              us;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        _GET_CYCLE_COUNT(c0);
+        do {
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            us = (t1.tv_sec - t0.tv_sec) * 1e6 + (t1.tv_nsec - t0.tv_nsec) * 1e-3;
+        } while ( us < 10000.0 );
+        _GET_CYCLE_COUNT(c1);
+        pThis->cyclesPerUs = (c1 - c0) / us;
+    }
+#endif
+    return PASS;
+}
+
+/** Add the intervals of a chunk that just started TX DMA
+ *   - all stamps up to CHUNK_STAMP_TX_START must be set
+ *   - callable from interrupt context
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  time stamped chunk
+ *
+ * @return None 
+ */
+void latency_record(latency_t *pThis, const chunk_t *pChunk)
+{
+    unsigned long long  cycles;
+    int                 stage;
+
+    for ( stage = 0; stage < LATENCY_STAGE_NUM; stage++ ) {
+        cycles = pChunk->stamp[latency_to[stage]] - pChunk->stamp[latency_from[stage]];
+        // negative: stamp missing, e.g. chunk did not take that path
+        if ( (long long)cycles < 0 ) {
+            continue;
+        }
+        pThis->hist[stage][latency_bucket(cycles)]++;
+        pThis->count[stage]++;
+        if ( cycles > pThis->max[stage] ) {
+            pThis->max[stage] = cycles;
+        }
+    }
+}
+
+/** Percentile of one stage
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param stage     interval
+ * @param percent   percentile 0..100
+ *
+ * @return upper bound of the percentile bucket in cycles
+ */
+unsigned long long latency_percentile(latency_t *pThis, latency_stage_t stage, int percent)
+{
+    unsigned long long  target;
+    unsigned long long  sum     = 0;
+    int                 bucket;
+
+    target = ((unsigned long long)pThis->count[stage] * percent + 99) / 100;
+    for ( bucket = 0; bucket < LATENCY_BUCKETS; bucket++ ) {
+        sum += pThis->hist[stage][bucket];
+        if ( sum >= target && 0 < sum ) {
+            break;
+        }
+    }
+    if ( LATENCY_BUCKETS == bucket ) {
+        return 0;
+    }
+    // the bucket bound may exceed the true maximum
+    return latency_bucketMax(bucket) < pThis->max[stage] ? latency_bucketMax(bucket) : pThis->max[stage];
+}
+
+/** Print p50 / p99 / max of every stage
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ *
+ * @return None 
+ */
+void latency_dump(latency_t *pThis)
+{
+    int stage;
+
+    printf("[LAT]: stage           chunks   p50 us   p99 us   max us\n");
+    for ( stage = 0; stage < LATENCY_STAGE_NUM; stage++ ) {
+        printf("[LAT]: %-12s %9lu %8.1f %8.1f %8.1f\n", latency_name[stage], pThis->count[stage],
+               latency_percentile(pThis, stage, 50) / pThis->cyclesPerUs,
+               latency_percentile(pThis, stage, 99) / pThis->cyclesPerUs,
+               pThis->max[stage] / pThis->cyclesPerUs);
+    }
+}
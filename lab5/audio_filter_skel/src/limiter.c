@@ -0,0 +1,391 @@
+/**
+ *@file limiter.c
+ *
+ *@brief
+ *  - look-ahead compressor / limiter
+ *
+ *  The output is the trimmed input delayed by L = LIMITER_LOOKAHEAD
+ *  samples. It is produced in blocks of b <= L samples: the block is taken
+ *  from the line, the new input shifts in behind it. The gain of a block
+ *  ramps linearly from the end gain of the previous block to
+ *    min(release(previous), gain computer(peak of the block and the L
+ *    samples behind it))
+ *  The end gain of a block covers the L samples that follow, so the start
+ *  of every ramp already satisfies its block and the whole ramp, being
+ *  linear, stays below the gain every sample of the block needs.
+ *
+ *  Gain computer, levels as log2 re full scale in Q16:
+ *    g = min(-(level - threshold) (1 - 1/ratio) above the threshold,
+ *            ceiling - level)
+ *  with level = log2(peak) + headroom; log2 and exp2 from 33 entry
+ *  tables with linear interpolation.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "tll_common.h"
+#include "limiter.h"
+#include "q15.h"
+#include <cycle_count.h>
+#include <cycle_count_bf.h>
+
+/**
+ * @def LIMITER_TABLE_ERR
+ * @brief bound of the interpolation error of log2 and exp2 together in
+ *        Q16 (about 0.003 dB), kept below the ceiling; at 24 dB headroom
+ *        it would otherwise show as a few LSB over LIMITER_CEILING
+ */
+#define LIMITER_TABLE_ERR   (32)
+
+
+/** log2(1 + i/32), Q16 */
+static const int limiter_log2Table[33] = {
+         0,   2909,   5732,   8473,  11136,  13727,  16248,  18704,
+     21098,  23433,  25711,  27936,  30109,  32234,  34312,  36346,
+     38336,  40286,  42196,  44068,  45904,  47705,  49472,  51207,
+     52911,  54584,  56229,  57845,  59434,  60997,  62534,  64047,
+     65536
+};
+
+/** 2^(-i/32), Q15 */
+static const int limiter_exp2Table[33] = {
+     32768,  32066,  31379,  30706,  30048,  29405,  28774,  28158,
+     27554,  26964,  26386,  25821,  25268,  24726,  24196,  23678,
+     23170,  22674,  22188,  21713,  21247,  20792,  20347,  19911,
+     19484,  19066,  18658,  18258,  17867,  17484,  17109,  16743,
+     16384
+};
+
+/** index of the highest set bit, v > 0 */
+static inline int limiter_msb(unsigned int v)
+{
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(v);
+#else
+    int         e = 0;
+
+    while ( v >>= 1 ) {
+        e++;
+    }
+    return e;
+#endif
+}
+
+/** log2(v) in Q16, v > 0 */
+static int limiter_log2(unsigned int v)
+{
+    int             e = limiter_msb(v);
+    unsigned int    n = v << (31 - e);          // bit 31 set
+    int             i = (n >> 26) & 31;
+    int             w = (n >> 10) & 0xffff;
+    const int       *t = &limiter_log2Table[i];
+
+    return (e << 16) + t[0] + (((t[1] - t[0]) * w) >> 16);
+}
+
+/** 2^g in Q15 for g <= 0 in Q16, rounded down */
+static int limiter_exp2(int g)
+{
+    int             ip = (-g) >> 16;
+    int             f  = (-g) & 0xffff;
+    const int       *t = &limiter_exp2Table[f >> 11];
+    int             v  = t[0] + (((t[1] - t[0]) * (f & 0x7ff)) >> 11);
+
+    return ip > 15 ? 0 : v >> ip;
+}
+
+/** largest magnitude of n samples */
+static inline int limiter_peak(const fract16 x[], int n)
+{
+    int         m = 0;
+    int         i;
+
+    for ( i = 0; i < n; i++ ) {
+        int a = x[i] < 0 ? -x[i] : x[i];
+
+        m = a > m ? a : m;
+    }
+    return m;
+}
+
+/** Q15 gain the gain computer allows for a trimmed peak */
+static int limiter_gain(const limiter_t *pThis, int peak)
+{
+    int         level;
+    int         g = 0;
+
+    if ( 0 == peak ) {
+        return LIMITER_UNITY;
+    }
+    level = limiter_log2(peak) + ((pThis->headroom - 15) << 16);
+    if ( level > pThis->threshold ) {
+        g = -(int)(((long long)(level - pThis->threshold) * pThis->slope) >> 15);
+    }
+    if ( pThis->ceiling - level < g ) {
+        g = pThis->ceiling - level;
+    }
+    return 0 > g ? limiter_exp2(g) : LIMITER_UNITY;
+}
+
+/** out = in * gain << headroom, gain ramping from g0 to g1 over n samples */
+static void limiter_apply(fract16 out[], const fract16 in[], int n, int g0, int g1, int headroom)
+{
+    int         shift = 15 - headroom;
+    int         round = 1 << (shift - 1);
+    int         step  = ((g1 - g0) << 8) / n;
+    int         acc   = g0 << 8;
+    int         i;
+
+    // round a falling ramp down, it must not end above g1
+    if ( step * n > ((g1 - g0) << 8) ) {
+        step--;
+    }
+    for ( i = 0; i < n; i++ ) {
+        acc   += step;
+        out[i] = q15_sat((in[i] * (acc >> 8) + round) >> shift);
+    }
+}
+
+/** gain reduction of a Q15 gain in 0.1 dB */
+static int limiter_db10(int gain)
+{
+    if ( 0 >= gain ) {
+        return 9999;
+    }
+    // 20 log10(2) = 6.0206 dB per octave
+    return (int)((((15LL << 16) - limiter_log2(gain)) * 60206) >> 16) / 1000;
+}
+
+/** Initialize a limiter (no compression, limit at LIMITER_CEILING)
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param rate      sample rate in Hz
+ * @param headroom  trim shift 0 .. LIMITER_HEADROOM_MAX, 6 dB each
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int limiter_init(limiter_t *pThis, unsigned int rate, int headroom)
+{
+    if ( NULL == pThis || 0 == rate || 0 > headroom || LIMITER_HEADROOM_MAX < headroom ) {
+        printf("[LIM]: Failed to init\n");
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->headroom = headroom;
+    pThis->ceiling  = limiter_log2(LIMITER_CEILING) - (15 << 16) - LIMITER_TABLE_ERR;
+    pThis->gain     = LIMITER_UNITY;
+    pThis->gainMin  = LIMITER_UNITY;
+    limiter_setCurve(pThis, 0, 0);
+    limiter_setRate(pThis, rate);
+    return PASS;
+}
+
+/** Set the compressor curve, the ceiling always applies
+ *
+ * Parameters:
+ * @param pThis        pointer to own object
+ * @param thresholdDb  threshold in dBFS (output level)
+ * @param ratio        input / output dB above the threshold, 0 = none
+ *
+ * @return None
+ */
+void limiter_setCurve(limiter_t *pThis, int thresholdDb, int ratio)
+{
+    pThis->thresholdDb = thresholdDb;
+    pThis->ratio       = 1 < ratio ? ratio : 0;
+    pThis->threshold   = (int)floor(thresholdDb / 6.0206 * 65536.0 + 0.5);
+    pThis->slope       = 0 != pThis->ratio ? LIMITER_UNITY - LIMITER_UNITY / pThis->ratio : 0;
+}
+
+/** Change the sample rate (release time)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param rate   sample rate in Hz
+ *
+ * @return None
+ */
+void limiter_setRate(limiter_t *pThis, unsigned int rate)
+{
+    if ( 0 == rate ) {
+        return;
+    }
+    pThis->rate    = rate;
+    pThis->release = (int)floor(LIMITER_UNITY
+                   * (1.0 - exp(-1000.0 * LIMITER_LOOKAHEAD / LIMITER_RELEASE_MS / rate)) + 0.5);
+}
+
+/** Change the headroom
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param headroom  trim shift 0 .. LIMITER_HEADROOM_MAX, 6 dB each
+ *
+ * @return None
+ */
+void limiter_setHeadroom(limiter_t *pThis, int headroom)
+{
+    int         d = headroom - pThis->headroom;
+    int         i;
+
+    if ( 0 == d || 0 > headroom || LIMITER_HEADROOM_MAX < headroom ) {
+        return;
+    }
+    // the line holds samples trimmed by the old headroom
+    for ( i = 0; i < LIMITER_LOOKAHEAD; i++ ) {
+        pThis->line[i] = 0 < d ? (fract16)((pThis->line[i] + (1 << (d - 1))) >> d)
+                               : q15_sat(pThis->line[i] * (1 << -d));
+    }
+    pThis->headroom = headroom;
+}
+
+/** Trim shift for a chain that boosts by up to boost dB
+ *
+ * Parameters:
+ * @param boost  bound of the boost of the chain in dB
+ *
+ * @return headroom 0 .. LIMITER_HEADROOM_MAX, 6 dB each, the largest if
+ *         the chain can boost by more
+ */
+int limiter_boostHeadroom(int boost)
+{
+    int         headroom = 0 < boost ? (boost + 5) / 6 : 0;
+
+    return LIMITER_HEADROOM_MAX < headroom ? LIMITER_HEADROOM_MAX : headroom;
+}
+
+/** Take a chunk down by the headroom, at the start of the chain
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void limiter_trim(const limiter_t *pThis, chunk_t *pChunk)
+{
+    fract16     *x = pChunk->s16_buff;
+    int         n  = pChunk->len / 2;
+    int         h  = pThis->headroom;
+    int         i;
+
+    if ( 0 == h ) {
+        return;
+    }
+    for ( i = 0; i < n; i++ ) {
+        x[i] = (fract16)((x[i] + (1 << (h - 1))) >> h);
+    }
+}
+
+/** Restore the gain and limit a chunk in place, at the end of the chain
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pChunk  chunk of 16 bit samples
+ *
+ * @return None
+ */
+void limiter_process(limiter_t *pThis, chunk_t *pChunk)
+{
+    fract16     in[LIMITER_LOOKAHEAD];
+    fract16     *x = pChunk->s16_buff;
+    int         n  = pChunk->len / 2;
+    int         g0 = pThis->gain;
+    int         g1;
+    int         peak;
+    int         next;
+    int         req;
+    int         o, b;
+    cycle_t     c0;
+    cycle_t     c1;
+
+    _GET_CYCLE_COUNT(c0);
+    for ( o = 0; o < n; o += b ) {
+        b = n - o < LIMITER_LOOKAHEAD ? n - o : LIMITER_LOOKAHEAD;
+        memcpy(in, &x[o], b * sizeof(fract16));
+
+        // envelope: this block and the L samples behind it
+        peak = limiter_peak(pThis->line, b);
+        next = limiter_peak(&pThis->line[b], LIMITER_LOOKAHEAD - b);
+        peak = next > peak ? next : peak;
+        next = limiter_peak(in, b);
+        peak = next > peak ? next : peak;
+
+        req = limiter_gain(pThis, peak);
+        g1  = g0 + (((LIMITER_UNITY - g0) * pThis->release) >> 15);
+        g1  = req < g1 ? req : g1;
+
+        limiter_apply(&x[o], pThis->line, b, g0, g1, pThis->headroom);
+        memmove(pThis->line, &pThis->line[b], (LIMITER_LOOKAHEAD - b) * sizeof(fract16));
+        memcpy(&pThis->line[LIMITER_LOOKAHEAD - b], in, b * sizeof(fract16));
+
+        pThis->blocks++;
+        if ( LIMITER_UNITY > g1 ) {
+            pThis->limited++;
+            if ( g1 < pThis->gainMin ) {
+                pThis->gainMin = g1;
+            }
+        }
+        g0 = g1;
+    }
+    pThis->gain = g0;
+    _GET_CYCLE_COUNT(c1);
+
+    pThis->calls++;
+    pThis->cycles += c1 - c0;
+    if ( c1 - c0 > pThis->cyclesMax ) {
+        pThis->cyclesMax = c1 - c0;
+    }
+}
+
+/** Gain reduction meter
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param pPeak   if not NULL: largest reduction since the last read in
+ *                0.1 dB, the peak restarts
+ *
+ * @return current gain reduction in 0.1 dB
+ */
+int limiter_meter(limiter_t *pThis, int *pPeak)
+{
+    if ( NULL != pPeak ) {
+        *pPeak         = limiter_db10(pThis->gainMin);
+        pThis->gainMin = pThis->gain;
+    }
+    return limiter_db10(pThis->gain);
+}
+
+/** Print curve, meter and cycles per chunk, restarts the meter peak
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param samples   samples per chunk, for cycles per sample
+ *
+ * @return None
+ */
+void limiter_report(limiter_t *pThis, int samples)
+{
+    unsigned long   limited = pThis->limited;
+    unsigned long   blocks  = pThis->blocks;
+    int             peak;
+    int             now     = limiter_meter(pThis, &peak);
+
+    printf("[LIM]: headroom %d dB, threshold %d dBFS ratio %d%s, gain reduction %d.%d dB"
+           " (peak %d.%d dB), %lu of %lu blocks limited\n",
+           6 * pThis->headroom, pThis->thresholdDb, pThis->ratio,
+           0 == pThis->ratio ? " (off)" : "", now / 10, now % 10, peak / 10, peak % 10,
+           limited, blocks);
+    printf("[LIM]: %lu chunks, cycles per chunk mean %.0f max %llu, %.1f per sample\n",
+           pThis->calls, pThis->calls ? (double)pThis->cycles / pThis->calls : 0.0,
+           pThis->cyclesMax,
+           pThis->calls && 0 < samples ? (double)pThis->cycles / pThis->calls / samples : 0.0);
+}
@@ -0,0 +1,374 @@
+/**
+ *@file multirate.c
+ *
+ *@brief
+ *  - streaming decimators and interpolators
+ *
+ *  As in firBlock the newest inputs of the previous call are copied in
+ *  front of the input in a scratch buffer, so every output reads one
+ *  window w[] (newest sample last) without wrap.
+ *
+ *  Half-band, C = (MULTIRATE_HB_TAPS - 1) / 2, s[k] the tap at C +- (2k+1):
+ *    decimator, every second input:
+ *      y = 1/2 w[C] + sum_k s[k] * (w[C-1-2k] + w[C+1+2k])
+ *    interpolator, window of the (C+1)/2*2 newest inputs, two outputs
+ *    per input (gain 2 for the stuffed zeros):
+ *      y0 = 2 * sum_k s[k] * (w[H+k] + w[H-1-k]),   y1 = w[H]
+ *    with H = (C+1)/2.
+ *  Polyphase, N phases of P = MULTIRATE_POLY_TAPS taps, h the prototype:
+ *    decimator, every Nth input:   y = sum_t h[t] * w[T-1-t]
+ *    interpolator, per input i:    y[N*i+p] = sum_q N*h[p+q*N] * w[P-1-q]
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <string.h>
+#include "tll_common.h"
+#include "multirate.h"
+#include "firDesign.h"
+#include "q15.h"
+#include <cycle_count.h>
+#include <cycle_count_bf.h>
+
+/** center of the half-band filter */
+#define MULTIRATE_HB_CENTER     ((MULTIRATE_HB_TAPS - 1) / 2)
+
+/** inputs read by one half-band interpolator output pair */
+#define MULTIRATE_HB_WINDOW     (2 * MULTIRATE_HB_SIDE)
+
+
+/** half-band 2:1 decimation of up to MULTIRATE_BLOCK inputs
+ *   - the non-zero taps of all outputs read one parity of the input,
+ *     which is copied to a contiguous stream first, so the loops over
+ *     the outputs are plain (vectorizable) multiply-adds
+ */
+static int multirate_hbDecimate(const fract16 side[], multirate_hb_t *pStage,
+                                const fract16 input[], int length, fract16 output[])
+{
+    fract16     x[MULTIRATE_HB_TAPS - 1 + MULTIRATE_BLOCK];
+    fract16     even[MULTIRATE_HB_WINDOW + MULTIRATE_BLOCK / 2]; // parity of the taps
+    int         acc[MULTIRATE_BLOCK / 2 + 1];
+    int         phase = pStage->phase;
+    int         n, i, k;
+
+    memcpy(x, pStage->hist, (MULTIRATE_HB_TAPS - 1) * sizeof(fract16));
+    memcpy(&x[MULTIRATE_HB_TAPS - 1], input, length * sizeof(fract16));
+
+    // output m reads the window x[j .. j + MULTIRATE_HB_TAPS - 1], j = phase + 2m
+    n = length > phase ? (length - phase - 1) / 2 + 1 : 0;
+    for ( i = 0; i < n + MULTIRATE_HB_WINDOW - 1; i++ ) {
+        even[i] = x[phase + 2*i];
+    }
+    for ( i = 0; i < n; i++ ) {
+        acc[i] = x[phase + 2*i + MULTIRATE_HB_CENTER] << 14;
+    }
+    for ( k = 0; k < MULTIRATE_HB_SIDE; k++ ) {
+        const fract16   *pLo = &even[MULTIRATE_HB_SIDE - 1 - k];
+        const fract16   *pHi = &even[MULTIRATE_HB_SIDE + k];
+        int             c    = side[k];
+
+        for ( i = 0; i < n; i++ ) {
+            acc[i] += c * (pLo[i] + pHi[i]);
+        }
+    }
+    for ( i = 0; i < n; i++ ) {
+        output[i] = q15_sat((acc[i] + (1 << 14)) >> 15);
+    }
+    pStage->phase = phase + 2*n - length;
+
+    memcpy(pStage->hist, &x[length], (MULTIRATE_HB_TAPS - 1) * sizeof(fract16));
+    return n;
+}
+
+/** half-band 1:2 interpolation of up to MULTIRATE_BLOCK / 2 inputs */
+static int multirate_hbInterpolate(const fract16 side[], multirate_hb_t *pStage,
+                                   const fract16 input[], int length, fract16 output[])
+{
+    fract16     x[MULTIRATE_HB_WINDOW - 1 + MULTIRATE_BLOCK];
+    int         n = 0;
+    int         j, k;
+
+    memcpy(x, pStage->hist, (MULTIRATE_HB_WINDOW - 1) * sizeof(fract16));
+    memcpy(&x[MULTIRATE_HB_WINDOW - 1], input, length * sizeof(fract16));
+
+    for ( j = 0; j < length; j++ ) {
+        const fract16   *w   = &x[j + MULTIRATE_HB_SIDE];
+        int             acc  = 0;
+
+        for ( k = 0; k < MULTIRATE_HB_SIDE; k++ ) {
+            acc += side[k] * (w[k] + w[-1 - k]);
+        }
+        output[n++] = q15_sat((acc + (1 << 13)) >> 14);
+        output[n++] = w[0];
+    }
+
+    memcpy(pStage->hist, &x[length], (MULTIRATE_HB_WINDOW - 1) * sizeof(fract16));
+    return n;
+}
+
+/** dot product of taps coefficients with taps samples */
+static inline int multirate_dot(const fract16 *pH, const fract16 *pX, int taps)
+{
+    int         acc = 0;
+    int         t;
+
+    for ( t = 0; t < taps; t++ ) {
+        acc += pH[t] * pX[t];
+    }
+    return acc;
+}
+
+/** polyphase N:1 decimation of up to MULTIRATE_BLOCK inputs */
+static int multirate_polyDecimate(multirate_t *pThis, const fract16 input[], int length,
+                                  fract16 output[])
+{
+    fract16     x[MULTIRATE_FACTOR_MAX * MULTIRATE_POLY_TAPS - 1 + MULTIRATE_BLOCK];
+    int         hist = pThis->taps - 1;
+    int         n = 0;
+    int         j;
+
+    memcpy(x, pThis->hist, hist * sizeof(fract16));
+    memcpy(&x[hist], input, length * sizeof(fract16));
+
+    for ( j = pThis->phase; j < length; j += pThis->factor ) {
+        output[n++] = q15_sat((multirate_dot(pThis->coeff, &x[j], pThis->taps) + (1 << 14)) >> 15);
+    }
+    pThis->phase = j - length;
+
+    memcpy(pThis->hist, &x[length], hist * sizeof(fract16));
+    return n;
+}
+
+/** polyphase 1:N interpolation of up to MULTIRATE_BLOCK / N inputs */
+static int multirate_polyInterpolate(multirate_t *pThis, const fract16 input[], int length,
+                                     fract16 output[])
+{
+    fract16     x[MULTIRATE_POLY_TAPS - 1 + MULTIRATE_BLOCK];
+    int         n = 0;
+    int         j, p;
+
+    memcpy(x, pThis->hist, (MULTIRATE_POLY_TAPS - 1) * sizeof(fract16));
+    memcpy(&x[MULTIRATE_POLY_TAPS - 1], input, length * sizeof(fract16));
+
+    for ( j = 0; j < length; j++ ) {
+        for ( p = 0; p < pThis->factor; p++ ) {
+            int acc = multirate_dot(&pThis->coeff[p * MULTIRATE_POLY_TAPS], &x[j],
+                                    MULTIRATE_POLY_TAPS);
+            output[n++] = q15_sat((acc + (1 << 14)) >> 15);
+        }
+    }
+
+    memcpy(pThis->hist, &x[length], (MULTIRATE_POLY_TAPS - 1) * sizeof(fract16));
+    return n;
+}
+
+/** Initialize a decimator or interpolator with cleared history
+ *   - half-band: Kaiser windowed sinc at a quarter of the rate, the even
+ *     offsets are zero by construction, the center is set to exactly 1/2
+ *   - polyphase: low-pass at 0.9 of the lower Nyquist frequency
+ *
+ * Parameters:
+ * @param pThis     pointer to own object
+ * @param dir       decimate or interpolate
+ * @param factor    N
+ * @param halfband  non-zero for the half-band cascade
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int multirate_init(multirate_t *pThis, multirate_dir_t dir, int factor, int halfband)
+{
+    firDesign_spec_t    spec;
+    fract16             h[MULTIRATE_FACTOR_MAX * MULTIRATE_POLY_TAPS];
+    int                 t, q, p;
+
+    if ( NULL == pThis ) {
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->dir      = dir;
+    pThis->factor   = factor;
+    pThis->halfband = halfband ? 1 : 0;
+
+    if ( halfband ) {
+        while ( (1 << pThis->nStages) < factor ) {
+            pThis->nStages++;
+        }
+        if ( 2 > factor || (1 << pThis->nStages) != factor
+          || MULTIRATE_STAGES_MAX < pThis->nStages ) {
+            printf("[MR]: Invalid half-band factor %d\n", factor);
+            return FAIL;
+        }
+        // cut-off rate/4
+        spec.shape = FIRDESIGN_LOWPASS;
+        spec.rate  = 4;
+        spec.f1    = 1;
+        spec.f2    = 0;
+        spec.taps  = MULTIRATE_HB_TAPS;
+        spec.atten = MULTIRATE_ATTEN;
+        if ( PASS != firDesign_design(&spec, h) ) {
+            return FAIL;
+        }
+        for ( t = 0; t < MULTIRATE_HB_SIDE; t++ ) {
+            pThis->side[t] = h[MULTIRATE_HB_CENTER + 1 + 2*t];
+        }
+        for ( t = 0; t < pThis->nStages; t++ ) {
+            pThis->hb[t].phase = 1;
+        }
+        return PASS;
+    }
+
+    if ( 2 > factor || MULTIRATE_FACTOR_MAX < factor ) {
+        printf("[MR]: Invalid polyphase factor %d\n", factor);
+        return FAIL;
+    }
+    // cut-off 0.45 / N of the high rate, integer Hz on a scaled rate
+    pThis->taps = factor * MULTIRATE_POLY_TAPS;
+    spec.shape  = FIRDESIGN_LOWPASS;
+    spec.rate   = 20 * factor;
+    spec.f1     = 9;
+    spec.f2     = 0;
+    spec.taps   = pThis->taps;
+    spec.atten  = MULTIRATE_ATTEN;
+    if ( PASS != firDesign_design(&spec, h) ) {
+        return FAIL;
+    }
+    if ( MULTIRATE_DECIMATE == dir ) {
+        for ( t = 0; t < pThis->taps; t++ ) {
+            pThis->coeff[t] = h[pThis->taps - 1 - t];
+        }
+        pThis->phase = factor - 1;
+    } else {
+        // phase p, tap q at p*P + P-1-q, gain N for the stuffed zeros
+        for ( p = 0; p < factor; p++ ) {
+            for ( q = 0; q < MULTIRATE_POLY_TAPS; q++ ) {
+                pThis->coeff[p * MULTIRATE_POLY_TAPS + MULTIRATE_POLY_TAPS - 1 - q] =
+                    q15_sat(factor * h[p + q * factor]);
+            }
+        }
+    }
+    return PASS;
+}
+
+/** Outputs produced from length inputs at most (to size buffers)
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param length  input samples
+ *
+ * @return number of output samples
+ */
+int multirate_outMax(const multirate_t *pThis, int length)
+{
+    int         st;
+
+    if ( MULTIRATE_INTERPOLATE == pThis->dir ) {
+        return length * pThis->factor;
+    }
+    if ( !pThis->halfband ) {
+        return length > pThis->phase ? (length - pThis->phase - 1) / pThis->factor + 1 : 0;
+    }
+    for ( st = 0; st < pThis->nStages; st++ ) {
+        length = length > pThis->hb[st].phase ? (length - pThis->hb[st].phase - 1) / 2 + 1 : 0;
+    }
+    return length;
+}
+
+/** Convert a block
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param input   input samples
+ * @param length  number of input samples
+ * @param output  output samples, room for multirate_outMax()
+ *
+ * @return number of output samples written
+ */
+int multirate_process(multirate_t *pThis, const fract16 input[], int length, fract16 output[])
+{
+    fract16     tmp[2][MULTIRATE_BLOCK];    // between half-band stages
+    int         step    = MULTIRATE_DECIMATE == pThis->dir ? MULTIRATE_BLOCK
+                                                           : MULTIRATE_BLOCK / pThis->factor;
+    int         done    = 0;
+    int         out     = 0;
+
+    while ( done < length ) {
+        int             blk = length - done < step ? length - done : step;
+        const fract16   *pIn = &input[done];
+        int             n = blk;
+        int             st;
+
+        if ( !pThis->halfband ) {
+            n = MULTIRATE_DECIMATE == pThis->dir
+              ? multirate_polyDecimate(pThis, pIn, blk, &output[out])
+              : multirate_polyInterpolate(pThis, pIn, blk, &output[out]);
+        } else {
+            // stage by stage, the last one writes the output
+            for ( st = 0; st < pThis->nStages; st++ ) {
+                fract16 *pOut = st == pThis->nStages - 1 ? &output[out] : tmp[st & 1];
+
+                n = MULTIRATE_DECIMATE == pThis->dir
+                  ? multirate_hbDecimate(pThis->side, &pThis->hb[st], pIn, n, pOut)
+                  : multirate_hbInterpolate(pThis->side, &pThis->hb[st], pIn, n, pOut);
+                pIn = pOut;
+            }
+        }
+        out  += n;
+        done += blk;
+    }
+    return out;
+}
+
+/** Convert a chunk, counts the cycles of the call
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pIn    input chunk
+ * @param pOut   output chunk (e.g. of a smaller pool), len is set
+ *
+ * @return Zero on success.
+ * Negative value on failure (pOut too small, nothing converted).
+ */
+int multirate_chunk(multirate_t *pThis, const chunk_t *pIn, chunk_t *pOut)
+{
+    int         length  = pIn->len / 2;
+    cycle_t     c0;
+    cycle_t     c1;
+
+    if ( multirate_outMax(pThis, length) > pOut->size / 2 ) {
+        printf("[MR]: Output chunk too small for %d samples\n", multirate_outMax(pThis, length));
+        pOut->len = 0;
+        return FAIL;
+    }
+
+    _GET_CYCLE_COUNT(c0);
+    pOut->len = 2 * multirate_process(pThis, pIn->s16_buff, length, pOut->s16_buff);
+    _GET_CYCLE_COUNT(c1);
+    memcpy(pOut->stamp, pIn->stamp, sizeof(pOut->stamp));
+
+    pThis->calls++;
+    pThis->samples += length;
+    pThis->cycles  += c1 - c0;
+    return PASS;
+}
+
+/** Print the cycles per chunk and per input sample
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pName  label of the stage
+ *
+ * @return None
+ */
+void multirate_report(const multirate_t *pThis, const char *pName)
+{
+    printf("[MR]: %s %s by %d (%s): %lu chunks, %.0f cycles per chunk, %.2f per input sample\n",
+           pName, MULTIRATE_DECIMATE == pThis->dir ? "decimate" : "interpolate",
+           pThis->factor, pThis->halfband ? "half-band" : "polyphase", pThis->calls,
+           pThis->calls ? (double)pThis->cycles / pThis->calls : 0.0,
+           pThis->samples ? (double)pThis->cycles / pThis->samples : 0.0);
+}
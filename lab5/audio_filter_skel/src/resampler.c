@@ -0,0 +1,279 @@
+/**
+ *@file resampler.c
+ *
+ *@brief
+ *  - streaming polyphase sample rate converter
+ *
+ *  Output n sits at time n*M on the grid upsampled by L. With the newest
+ *  input i = floor(n*M / L) and phase p = n*M - i*L it is
+ *    y[n] = sum_t h[p + t*L] * x[i - t],   t = 0..taps-1
+ *  The phases are stored with reversed taps, so every output is a dot
+ *  product over taps contiguous samples of a scratch buffer holding the
+ *  taps-1 newest samples of the previous call in front of the input
+ *  (as in firBlock). Between outputs p advances by M, i by the carry.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "tll_common.h"
+#include "resampler.h"
+#include "q15.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/** greatest common divisor */
+static unsigned int resampler_gcd(unsigned int a, unsigned int b)
+{
+    while ( b ) {
+        unsigned int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/** Blackman windowed sinc of length n at offset t from its center */
+static double resampler_proto(double t, double fc, int n)
+{
+    double  k = t + (n - 1) / 2.0;
+    double  w = 0.42 - 0.5 * cos(2.0 * M_PI * k / (n - 1))
+                     + 0.08 * cos(4.0 * M_PI * k / (n - 1));
+
+    return (0.0 == t ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t)) * w;
+}
+
+/** round and saturate a 32 bit accumulator of 1.15 products */
+static inline fract16 resampler_sat(int acc)
+{
+    return q15_sat((acc + (1 << 14)) >> 15);
+}
+
+/** dot product of one phase with taps samples, taps a multiple of 8 */
+static inline int resampler_dot(const fract16 *pH, const fract16 *pX, int taps)
+{
+#ifdef __SSE2__
+    __m128i     acc = _mm_setzero_si128();
+    int         t;
+
+    // pmaddwd: eight 16x16 products summed pairwise into four 32 bit lanes
+    for ( t = 0; t < taps; t += 8 ) {
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)&pH[t]),
+                                                _mm_loadu_si128((const __m128i *)&pX[t])));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+#else
+    int         acc = 0;
+    int         t;
+
+    for ( t = 0; t < taps; t++ ) {
+        acc += pH[t] * pX[t];
+    }
+    return acc;
+#endif
+}
+
+/** Initialize a resampler with cleared history
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param inRate   input sample rate
+ * @param outRate  output sample rate
+ * @param taps     taps per phase, multiple of 8, max RESAMPLER_TAPS_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure (ratio needs too many phases).
+ */
+int resampler_init(resampler_t *pThis, unsigned int inRate, unsigned int outRate, int taps)
+{
+    if ( NULL == pThis || 0 >= taps || 0 != (taps & 7) || RESAMPLER_TAPS_MAX < taps ) {
+        printf("[RS]: Invalid taps %d\n", taps);
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->taps = taps;
+    return resampler_setRate(pThis, inRate, outRate);
+}
+
+/** Change the ratio of a running stream
+ *   - windowed-sinc prototype (Blackman) of L * taps coefficients with
+ *     the cutoff at RESAMPLER_ROLLOFF of the lower Nyquist frequency,
+ *     normalized to a gain of L so each phase has unity DC gain
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param inRate   input sample rate
+ * @param outRate  output sample rate
+ *
+ * @return Zero on success.
+ * Negative value on failure, the old ratio stays active.
+ */
+int resampler_setRate(resampler_t *pThis, unsigned int inRate, unsigned int outRate)
+{
+    unsigned int    g;
+    int             up, down, taps, n, k;
+    double          fc, center, sum, scale;
+
+    if ( NULL == pThis || 0 == inRate || 0 == outRate ) {
+        return FAIL;
+    }
+    g    = resampler_gcd(inRate, outRate);
+    up   = outRate / g;
+    down = inRate / g;
+    taps = pThis->taps;
+    n    = up * taps;
+    if ( RESAMPLER_COEFF_MAX < n || up > RESAMPLER_COEFF_MAX ) {
+        printf("[RS]: Ratio %d/%d needs %d coefficients, max %d\n",
+               up, down, up * taps, RESAMPLER_COEFF_MAX);
+        return FAIL;
+    }
+
+    // cutoff in cycles per upsampled sample
+    fc     = RESAMPLER_ROLLOFF * 0.5 / (up > down ? up : down);
+    center = (n - 1) / 2.0;
+    sum    = 0.0;
+    for ( k = 0; k < n; k++ ) {
+        sum += resampler_proto(k - center, fc, n);
+    }
+    scale = up * 32768.0 / sum;
+
+    // h[p + t*L] goes to phase p, tap taps-1-t
+    for ( k = 0; k < n; k++ ) {
+        long    q = (long)floor(resampler_proto(k - center, fc, n) * scale + 0.5);
+
+        if ( q > 0x7fff ) {
+            q = 0x7fff;
+        } else if ( q < -0x8000 ) {
+            q = -0x8000;
+        }
+        pThis->coeff[(k % up) * taps + taps - 1 - k / up] = (fract16)q;
+    }
+
+    pThis->inRate  = inRate;
+    pThis->outRate = outRate;
+    pThis->up      = up;
+    pThis->down    = down;
+    pThis->phase   = 0;
+    return PASS;
+}
+
+/** Outputs produced from length inputs at most (to size buffers)
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param length   input samples
+ *
+ * @return number of output samples
+ */
+int resampler_outMax(const resampler_t *pThis, int length)
+{
+    // outputs n with phase + n*M < (length - index) * L
+    long long   room = (long long)(length - pThis->index) * pThis->up - pThis->phase;
+
+    if ( room <= 0 ) {
+        return 0;
+    }
+    return (int)((room + pThis->down - 1) / pThis->down);
+}
+
+/** Convert a block
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param input    input samples
+ * @param pLength  in: input samples available, out: input samples consumed
+ * @param output   output samples
+ * @param nOut     room in output
+ *
+ * @return number of output samples written
+ */
+int resampler_process(resampler_t *pThis, const fract16 input[], int *pLength,
+                      fract16 output[], int nOut)
+{
+    fract16     x[RESAMPLER_TAPS_MAX - 1 + RESAMPLER_BLOCK];    // history + block
+    int         taps    = pThis->taps;
+    int         hist    = taps - 1;
+    int         up      = pThis->up;
+    int         down    = pThis->down;
+    int         phase   = pThis->phase;
+    int         index   = pThis->index;
+    int         length  = *pLength;
+    int         done    = 0;
+    int         out     = 0;
+
+    memcpy(x, pThis->hist, hist * sizeof(fract16));
+
+    while ( done < length ) {
+        int     blk = length - done;
+        int     used;
+
+        if ( blk > RESAMPLER_BLOCK ) {
+            blk = RESAMPLER_BLOCK;
+        }
+        memcpy(&x[hist], &input[done], blk * sizeof(fract16));
+
+        // the newest input of an output is x[index + hist]
+        while ( index < blk && out < nOut ) {
+            output[out++] = resampler_sat(resampler_dot(&pThis->coeff[phase * taps],
+                                                        &x[index], taps));
+            phase += down;
+            if ( phase >= up ) {
+                index += phase / up;
+                phase  = phase % up;
+            }
+        }
+
+        // output full: the input of the next output is passed again
+        used = index < blk ? index : blk;
+        memmove(x, &x[used], hist * sizeof(fract16));
+        index -= used;
+        done  += used;
+        if ( used < blk ) {
+            break;
+        }
+    }
+
+    memcpy(pThis->hist, x, hist * sizeof(fract16));
+    pThis->phase = phase;
+    pThis->index = index;
+    *pLength     = done;
+    return out;
+}
+
+/** Convert a chunk
+ *
+ * Parameters:
+ * @param pThis    pointer to own object
+ * @param pIn      input chunk
+ * @param pOut     output chunk, len is set
+ *
+ * @return Zero on success.
+ * Negative value on failure (pOut too small, input only partly converted).
+ */
+int resampler_chunk(resampler_t *pThis, const chunk_t *pIn, chunk_t *pOut)
+{
+    int         length  = pIn->len / 2;
+
+    pOut->len = 2 * resampler_process(pThis, pIn->s16_buff, &length,
+                                      pOut->s16_buff, pOut->size / 2);
+    memcpy(pOut->stamp, pIn->stamp, sizeof(pOut->stamp));
+    if ( length < pIn->len / 2 ) {
+        printf("[RS]: Output chunk too small, %d of %d samples converted\n",
+               length, pIn->len / 2);
+        return FAIL;
+    }
+    return PASS;
+}
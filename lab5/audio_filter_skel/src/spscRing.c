@@ -0,0 +1,168 @@
+/**
+ *@file spscRing.c
+ *
+ *@brief
+ *  - wait-free single producer / single consumer pointer ring
+ *
+ *  Each side owns one counter: the producer writes the slot, then
+ *  publishes tail (release); the consumer reads tail (acquire) before
+ *  reading the slot, and the other way round for head. On the single
+ *  core Blackfin a compiler barrier is all the ordering needed against
+ *  an interrupt, the host build uses gcc atomics since the simulated
+ *  interrupts run on another thread.
+ *
+ * Target:   TLL6527v1-0
+ * Compiler: VDSP++     Output format: VDSP++ "*.dxe"
+ *
+ * LastChange:
+ * $Id$
+ *
+ *******************************************************************************/
+#include "tll_common.h"
+#include "spscRing.h"
+
+#ifdef __bfin__
+/** acquire: the slots are not read before the counter */
+static inline unsigned int spscRing_load(const unsigned int *p)
+{
+    unsigned int v = *(const volatile unsigned int *)p;
+
+    __asm__ __volatile__("" ::: "memory");
+    return v;
+}
+#define SPSCRING_LOAD(x)        spscRing_load(&(x))
+#define SPSCRING_STORE(x, v)    do { __asm__ __volatile__("" ::: "memory"); \
+                                     *(volatile unsigned int *)&(x) = (v); } while (0)
+#else
+#define SPSCRING_LOAD(x)        __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define SPSCRING_STORE(x, v)    __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#endif
+
+
+/** Initialize ring
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param size   capacity, power of two, at most SPSCRING_SIZE_MAX
+ *
+ * @return Zero on success.
+ * Negative value on failure.
+ */
+int spscRing_init(spscRing_t *pThis, unsigned int size)
+{
+    if ( NULL == pThis || 0 == size || SPSCRING_SIZE_MAX < size || 0 != (size & (size - 1)) ) {
+        printf("[RING]: invalid size %u\n", size);
+        return FAIL;
+    }
+    memset(pThis, 0, sizeof(*pThis));
+    pThis->size = size;
+    pThis->mask = size - 1;
+    return PASS;
+}
+
+/** Append up to n pointers with one index update (producer only)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pData  pointers to store
+ * @param n      number of pointers
+ *
+ * @return number of pointers appended
+ */
+int spscRing_pushBatch(spscRing_t *pThis, void * const pData[], int n)
+{
+    unsigned int tail  = pThis->tail;
+    unsigned int level = tail - SPSCRING_LOAD(pThis->head);
+    int          i;
+
+    if ( n > (int)(pThis->size - level) ) {
+        n = pThis->size - level;
+    }
+    for ( i = 0; i < n; i++ ) {
+        pThis->data[(tail + i) & pThis->mask] = pData[i];
+    }
+    if ( 0 < n ) {
+        SPSCRING_STORE(pThis->tail, tail + n);
+
+        level += n;
+        if ( level > pThis->levelMax ) {
+            pThis->levelMax = level;
+        }
+        pThis->levelSum += level;
+        pThis->nPut     += n;
+    }
+    return n;
+}
+
+/** Remove up to n pointers with one index update (consumer only)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pData  where to store the removed pointers
+ * @param n      maximum number of pointers
+ *
+ * @return number of pointers removed
+ */
+int spscRing_popBatch(spscRing_t *pThis, void *pData[], int n)
+{
+    unsigned int head  = pThis->head;
+    unsigned int level = SPSCRING_LOAD(pThis->tail) - head;
+    int          i;
+
+    if ( n > (int)level ) {
+        n = level;
+    }
+    for ( i = 0; i < n; i++ ) {
+        pData[i] = pThis->data[(head + i) & pThis->mask];
+    }
+    if ( 0 < n ) {
+        SPSCRING_STORE(pThis->head, head + n);
+    }
+    return n;
+}
+
+/** Append one pointer (producer only)
+ *
+ * Parameters:
+ * @param pThis  pointer to own object
+ * @param pData  pointer to store
+ *
+ * @return Zero on success.
+ * Negative value if the ring is full.
+ */
+int spscRing_push(spscRing_t *pThis, void *pData)
+{
+    return 1 == spscRing_pushBatch(pThis, &pData, 1) ? PASS : FAIL;
+}
+
+/** Remove one pointer (consumer only)
+ *
+ * Parameters:
+ * @param pThis   pointer to own object
+ * @param ppData  where to store the removed pointer
+ *
+ * @return Zero on success.
+ * Negative value if the ring is empty.
+ */
+int spscRing_pop(spscRing_t *pThis, void **ppData)
+{
+    return 1 == spscRing_popBatch(pThis, ppData, 1) ? PASS : FAIL;
+}
+
+/** @return number of stored pointers (exact for the calling side) */
+int spscRing_count(spscRing_t *pThis)
+{
+    return SPSCRING_LOAD(pThis->tail) - SPSCRING_LOAD(pThis->head);
+}
+
+/** @return non-zero if the ring is empty */
+int spscRing_isEmpty(spscRing_t *pThis)
+{
+    return 0 == spscRing_count(pThis);
+}
+
+/** @return non-zero if the ring is full */
+int spscRing_isFull(spscRing_t *pThis)
+{
+    return (int)pThis->size == spscRing_count(pThis);
+}
@@ -1,16 +1,42 @@
 /*****************************************************************************
  * Filter_Test.c
+ *
+ * Benchmark harness for the FIR implementations:
+ *  - reads the test wave once into memory
+ *  - runs every engine over the whole wave for warm-up + N iterations,
+ *    each iteration from the same input and a cleared delay line
+ *  - reports min/mean/median/stddev cycles per sample, samples/s and
+ *    the largest deviation from the library FIR (fir_fr16); the biquad
+ *    engines are a 6th order IIR with the same corner, not bit-exact
+ *  - optionally emits CSV or JSON for tracking across builds
+ *  - writes the filter_block output to the filtered wave as before
+ *
+ * usage: filter_test [-i in.wav] [-o out.wav] [-n iterations] [-w warmup]
+ *                    [-f csv|json] [-r report]
  *****************************************************************************/
 
-#include <stdio.h> 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <filter.h>
 #include <cycle_count.h>
+#include <firBlock.h>
+#include <fftConv.h>
+#include <biquad.h>
+#ifndef __bfin__
+#include <time.h>
+#endif
 
 #define DO_CYCLE_COUNTS
 #define FILTER_SIZE		(32)
 #define BUFFER_SIZE		(2048)
 #define WAVE_HEADER_SIZE (108)
+#define WAVE_SAMPLES_MAX (1024*1024)	//largest wave read into memory
+#define ITERATIONS_MAX	(1000)
+#define CCLK_HZ			(600000000.0)	//core clock of the target
+#define IIR_CORNER		(0.058f)		//-3 dB point of the FIR as fraction of fs
+#define IIR_ORDER		(6)
 
 FILE *fileInput;
 FILE *fileOutput;
@@ -18,79 +44,322 @@ FILE *fileOutput;
 //filter functions
 void filter(short *pData, short *pDelay, short *pCoeffs, int length, int nCoeffs);
 void filter_optimized(fract16 *pData, int length, fir_state_fr16 *pState);
- 
-//main function
-int main( void )
-{	
-	//filter coefficients
-	short coeffs[FILTER_SIZE] = {-52,-118,-224,-354,-485,-574,-571,-424,-93,436,1143,1970,2829,3609,4203,4525,4525,4203,3609,2829,1970,1143,436,-93,-424,-571,-574,-485,-354,-224,-118,-52};
-	char header[WAVE_HEADER_SIZE];			//holder array for wav header data
-	short dataIn[BUFFER_SIZE];	//in data buffer
-	short delay[FILTER_SIZE];	//delay line for holding last samples of previous data	
-	fir_state_fr16 filter_state;//filter state variable for optimized filter	
+void filter_block(fract16 *pData, int length, fir_state_fr16 *pState);
+
+//filter coefficients
+short coeffs[FILTER_SIZE] = {-52,-118,-224,-354,-485,-574,-571,-424,-93,436,1143,1970,2829,3609,4203,4525,4525,4203,3609,2829,1970,1143,436,-93,-424,-571,-574,-485,-354,-224,-118,-52};
+
+//test data: wave samples, reference output and work buffer
+short waveIn[WAVE_SAMPLES_MAX];
+short waveRef[WAVE_SAMPLES_MAX];
+short waveOut[WAVE_SAMPLES_MAX];
+
+//engine state, reset before every iteration
+short delay[FILTER_SIZE];			//delay line for the naive filter
+fract16 state_delay[FILTER_SIZE];	//delay line for the optimized filter state
+fir_state_fr16 filter_state;		//filter state variable for optimized filter
+fftConv_t fft_state;				//state of the FFT convolution engines
+biquad_t iir_state;					//state of the biquad engines
+
+/** one filter implementation under test */
+typedef struct {
+	const char *name;
+	void (*reset)(void);						//clear delay lines
+	void (*process)(short *pData, int length);	//filter in place
+	int exact;									//same response as fir_fr16
+} engine_t;
+
+/** results of one engine */
+typedef struct {
+	double min;				//cycles per sample
+	double mean;
+	double median;
+	double stddev;
+	double samplesPerSec;
+	int maxErr;				//largest deviation from fir_fr16, -1 if not comparable
+} result_t;
+
+static void fir_reset(void)
+{
+	memset(delay, 0, sizeof(delay));
+	memset(state_delay, 0, sizeof(state_delay));
+	fir_init(filter_state, coeffs, state_delay, FILTER_SIZE, 1);
+}
+static void fft_fixed_reset(void)
+{
+	fftConv_init(&fft_state, coeffs, state_delay, FILTER_SIZE, BUFFER_SIZE, FFTCONV_FFT_FIXED);
+}
+static void fft_float_reset(void)
+{
+	fftConv_init(&fft_state, coeffs, state_delay, FILTER_SIZE, BUFFER_SIZE, FFTCONV_FFT_FLOAT);
+}
+static void iir_reset(biquad_format_t format)
+{
+	biquad_init(&iir_state, format);
+	biquad_addButterworth(&iir_state, BIQUAD_LOWPASS, IIR_CORNER, IIR_ORDER);
+}
+static void iir_q15_reset(void)
+{
+	iir_reset(BIQUAD_Q15);
+}
+static void iir_q31_reset(void)
+{
+	iir_reset(BIQUAD_Q31);
+}
+static void iir_float_reset(void)
+{
+	iir_reset(BIQUAD_FLOAT);
+}
+static void naive_process(short *pData, int length)
+{
+	filter(pData, delay, coeffs, length, FILTER_SIZE);
+}
+static void optimized_process(short *pData, int length)
+{
+	filter_optimized(pData, length, &filter_state);
+}
+static void block_process(short *pData, int length)
+{
+	filter_block(pData, length, &filter_state);
+}
+static void fft_process(short *pData, int length)
+{
+	fftConv_process(&fft_state, pData, pData, length);
+}
+static void iir_process(short *pData, int length)
+{
+	biquad_filter(&iir_state, pData, pData, length);
+}
+
+//engines in report order, the first one after the reference is written to the output file
+static const engine_t engines[] = {
+	{ "filter_optimized", fir_reset,       optimized_process, 1 },
+	{ "filter_block",     fir_reset,       block_process,     1 },
+	{ "filter",           fir_reset,       naive_process,     1 },
+	{ "fft_fixed",        fft_fixed_reset, fft_process,       1 },
+	{ "fft_float",        fft_float_reset, fft_process,       1 },
+	{ "biquad_q15",       iir_q15_reset,   iir_process,       0 },
+	{ "biquad_q31",       iir_q31_reset,   iir_process,       0 },
+	{ "biquad_float",     iir_float_reset, iir_process,       0 },
+};
+#define ENGINE_NUM	((int)(sizeof(engines)/sizeof(engines[0])))
+
+/** cycle counter ticks per second */
+static double cycles_per_sec(void)
+{
+#ifdef __bfin__
+	return CCLK_HZ;
+#else
+	//calibrate the time stamp counter against the monotonic clock
+	struct timespec t0, t1;
+	cycle_t c0, c1;
+	double sec;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	_GET_CYCLE_COUNT(c0);
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		sec = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+	} while (sec < 0.05);
+	_GET_CYCLE_COUNT(c1);
+	return (c1 - c0) / sec;
+#endif
+}
+
+/** one pass of an engine over the wave in BUFFER_SIZE blocks
+ * @return cycles spent filtering
+ */
+static unsigned long long run_once(const engine_t *pEngine, int samples)
+{
 	cycle_t cycles_init ; //cycle stats start variable
 	cycle_t cycles_fin ; //cycle stats finish variable
-	
-	int count =0;					//variable for valid data buffer length
-	int i = 0;					//counter for cycle averaging	
-	unsigned long total = 0;	//variable to hold number of bytes transfered
-	
-	//open the files	
-	printf("\nOpening the files ...\n");	
-	fileInput = fopen("../200Hz_to_10kHz_44100_16bit.wav", "rb");
+	unsigned long long total = 0;
+	int done, count;
+
+	memcpy(waveOut, waveIn, samples * sizeof(short));
+	pEngine->reset();
+	for (done = 0; done < samples; done += count)
+	{
+		count = samples - done < BUFFER_SIZE ? samples - done : BUFFER_SIZE;
+
+		//start the cycle counter
+		START_CYCLE_COUNT(cycles_init);
+
+		pEngine->process(&waveOut[done], count);
+
+		//stop the cycle counter
+		STOP_CYCLE_COUNT(cycles_fin, cycles_init);
+		total += cycles_fin;
+	}
+	return total;
+}
+
+static int compare_double(const void *pA, const void *pB)
+{
+	double a = *(const double *)pA;
+	double b = *(const double *)pB;
+	return a < b ? -1 : a > b;
+}
+
+/** warm-up and timed iterations of one engine */
+static void bench(const engine_t *pEngine, int samples, int iterations, int warmup,
+                  double cyclesPerSec, result_t *pResult)
+{
+	static double perSample[ITERATIONS_MAX];
+	double sum = 0.0, sq = 0.0;
+	int i, err;
+
+	for (i = 0; i < warmup; i++) {
+		run_once(pEngine, samples);
+	}
+	for (i = 0; i < iterations; i++) {
+		perSample[i] = (double)run_once(pEngine, samples) / samples;
+		sum += perSample[i];
+	}
+	pResult->mean = sum / iterations;
+	for (i = 0; i < iterations; i++) {
+		sq += (perSample[i] - pResult->mean) * (perSample[i] - pResult->mean);
+	}
+	pResult->stddev = iterations > 1 ? sqrt(sq / (iterations - 1)) : 0.0;
+	qsort(perSample, iterations, sizeof(double), compare_double);
+	pResult->min = perSample[0];
+	pResult->median = iterations & 1 ? perSample[iterations/2]
+	                : (perSample[iterations/2 - 1] + perSample[iterations/2]) / 2.0;
+	pResult->samplesPerSec = cyclesPerSec / pResult->median;
+
+	//output of the last iteration against the library FIR (-1: other response)
+	pResult->maxErr = pEngine->exact ? 0 : -1;
+	for (i = 0; pEngine->exact && i < samples; i++) {
+		err = abs(waveOut[i] - waveRef[i]);
+		if (err > pResult->maxErr) {
+			pResult->maxErr = err;
+		}
+	}
+}
+
+static void usage(const char *pName)
+{
+	printf("usage: %s [-i in.wav] [-o out.wav] [-n iterations] [-w warmup]"
+	       " [-f csv|json] [-r report]\n", pName);
+}
+
+//main function
+int main(int argc, char *argv[])
+{
+	char header[WAVE_HEADER_SIZE];			//holder array for wav header data
+	result_t results[ENGINE_NUM];
+	const char *inName = "../200Hz_to_10kHz_44100_16bit.wav";
+	const char *outName = "../filtered_wave.wav";
+	const char *format = NULL;			//machine readable report: csv, json
+	FILE *report = stdout;
+	double cyclesPerSec;
+	int iterations = 10;
+	int warmup = 2;
+	int samples = 0;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (i + 1 >= argc || '-' != argv[i][0]) {
+			usage(argv[0]);
+			return -1;
+		}
+		switch (argv[i][1]) {
+		case 'i': inName = argv[++i]; break;
+		case 'o': outName = argv[++i]; break;
+		case 'n': iterations = atoi(argv[++i]); break;
+		case 'w': warmup = atoi(argv[++i]); break;
+		case 'f': format = argv[++i]; break;
+		case 'r':
+			report = fopen(argv[++i], "w");
+			if ( NULL == report ){
+				perror(argv[i]);
+				return -1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+	if (iterations < 1 || iterations > ITERATIONS_MAX || warmup < 0) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	//open the files
+	printf("\nOpening the files ...\n");
+	fileInput = fopen(inName, "rb");
 	if ( NULL == fileInput ){
 		printf("Input file not found\n");
 		return -1;
 	}
-	fileOutput = fopen("../filtered_wave.wav", "wb");
+	fileOutput = fopen(outName, "wb");
 	if ( NULL == fileOutput ){
 		perror("");
 		return -1;
-	}	
+	}
 	//copy the wav header to the new file
 	printf("Copying header ...\n");
-	fread(header, sizeof(char), 108, fileInput);
-	fwrite(header, sizeof(char), 108, fileOutput);
-	
-	//initialize the optimized filter state for pre 5.6
-
-	
-	//initialize the cycle counter for pre 5.7
-	
-	
-	printf("Filtering ...\n");
-	
-	do
-	{
-		//read the file and save the number of shorts read
-		count = fread(dataIn, sizeof(short), BUFFER_SIZE, fileInput);
-		
-		//start the cycle counter for pre 5.7
-		
-		//filter the data
-		filter(dataIn, delay, coeffs, count, FILTER_SIZE);
-		//filter_optimized(dataIn, count, &filter_state);
-		
-		//stop the cycle counter for pre 5.7
-		
-		//write the data back to a file
-		fwrite(dataIn, sizeof(short), count, fileOutput);
-		
-		//print the bytes that have been transfered
-		total += count*2;
-		printf("%i Bytes filtered\n", total);
-				
-	} while(!feof(fileInput)); //loop untill the file ends
-	
-	printf("\nCycle statistics:\n");
-	
+	fread(header, sizeof(char), WAVE_HEADER_SIZE, fileInput);
+	fwrite(header, sizeof(char), WAVE_HEADER_SIZE, fileOutput);
+
+	//read the whole wave, the timed loops do no file I/O
+	samples = fread(waveIn, sizeof(short), WAVE_SAMPLES_MAX, fileInput);
+	printf("%i samples read\n", samples);
+
+	cyclesPerSec = cycles_per_sec();
+
+	//reference output of the library FIR
+	run_once(&engines[0], samples);
+	memcpy(waveRef, waveOut, samples * sizeof(short));
+
+	printf("Filtering: %i taps, %i iterations after %i warm-up\n", FILTER_SIZE, iterations, warmup);
+	printf("\nCycle statistics (cycles per sample):\n");
+	printf("%-18s %10s %10s %10s %10s %12s %8s\n",
+	       "engine", "min", "mean", "median", "stddev", "samples/s", "max err");
+	for (i = 0; i < ENGINE_NUM; i++) {
+		bench(&engines[i], samples, iterations, warmup, cyclesPerSec, &results[i]);
+		printf("%-18s %10.2f %10.2f %10.2f %10.2f %12.0f %8d\n", engines[i].name,
+		       results[i].min, results[i].mean, results[i].median, results[i].stddev,
+		       results[i].samplesPerSec, results[i].maxErr);
+
+		//write the block engine output back to a file
+		if (1 == i) {
+			fwrite(waveOut, sizeof(short), samples, fileOutput);
+		}
+	}
+
+	if (NULL != format && 0 == strcmp(format, "csv")) {
+		fprintf(report, "engine,taps,samples,iterations,min,mean,median,stddev,samples_per_s,max_err\n");
+		for (i = 0; i < ENGINE_NUM; i++) {
+			fprintf(report, "%s,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.0f,%d\n", engines[i].name,
+			        FILTER_SIZE, samples, iterations, results[i].min, results[i].mean,
+			        results[i].median, results[i].stddev, results[i].samplesPerSec, results[i].maxErr);
+		}
+	} else if (NULL != format && 0 == strcmp(format, "json")) {
+		fprintf(report, "{\"taps\": %d, \"samples\": %d, \"iterations\": %d, \"warmup\": %d, \"engines\": [\n",
+		        FILTER_SIZE, samples, iterations, warmup);
+		for (i = 0; i < ENGINE_NUM; i++) {
+			fprintf(report, "  {\"engine\": \"%s\", \"min\": %.3f, \"mean\": %.3f, \"median\": %.3f,"
+			        " \"stddev\": %.3f, \"samples_per_s\": %.0f, \"max_err\": %d}%s\n", engines[i].name,
+			        results[i].min, results[i].mean, results[i].median, results[i].stddev,
+			        results[i].samplesPerSec, results[i].maxErr, i + 1 < ENGINE_NUM ? "," : "");
+		}
+		fprintf(report, "]}\n");
+	} else if (NULL != format) {
+		printf("Unknown report format %s\n", format);
+	}
+
 	//close the files
 	fclose(fileInput);
 	fclose(fileOutput);
-	
+	if (stdout != report) {
+		fclose(report);
+	}
+
 	//finish the program
 	printf("\nDone.\n");
-	
+
 	return 0;
 }
 
@@ -104,29 +373,41 @@ void filter(short *pData, short *pDelay, short *pCoeffs, int length, int nCoeffs
 	int i = 0;
 	int j = 0;
 	int temp = 0;
-	
+
 	//loop through each data point
 	for(i = 0; i < length; i++)
-	{		
+	{
 		temp = 0;
-		
+
 		//prime the delay line with the new data
-		
+		pDelay[0] = pData[i];
+
 		//sum the coefficients multiplied by the delay line
 		for(j = 0; j < nCoeffs; j++)
-		{				
-
+		{
+			temp += pCoeffs[j] * pDelay[j];
 		}
-		
+
 		//shift the delay line down 1 to make room for the new data short next cycle.
-					
+		for(j = nCoeffs - 1; j > 0; j--)
+		{
+			pDelay[j] = pDelay[j-1];
+		}
+
 		//shift and type cast the data for the output
-		
+		pData[i] = (short)(temp >> 15);
 	}
 }
 
 //optimized filter implementation for pre 5.6
 void filter_optimized(fract16 *pData, int length, fir_state_fr16 *pState)
 {
+	//library FIR, circular delay line in pState
+	fir_fr16(pData, pData, length, pState);
+}
 
+//block FIR engine (firBlock.c), same state as the library FIR
+void filter_block(fract16 *pData, int length, fir_state_fr16 *pState)
+{
+	firBlock_fr16(pData, pData, length, pState);
 }